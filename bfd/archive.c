@@ -726,10 +726,13 @@ _bfd_get_elt_at_filepos (bfd *archive, file_ptr filepos)
 
   n_bfd->arelt_data = new_areldata;
 
-  /* Copy BFD_COMPRESS, BFD_DECOMPRESS and BFD_COMPRESS_GABI flags.  */
+  /* Copy BFD_COMPRESS, BFD_DECOMPRESS, BFD_COMPRESS_GABI,
+     BFD_COMPRESS_CHUNKED and BFD_MMAP flags.  */
   n_bfd->flags |= archive->flags & (BFD_COMPRESS
 				    | BFD_DECOMPRESS
-				    | BFD_COMPRESS_GABI);
+				    | BFD_COMPRESS_GABI
+				    | BFD_COMPRESS_CHUNKED
+				    | BFD_MMAP);
 
   /* Copy is_linker_input.  */
   n_bfd->is_linker_input = archive->is_linker_input;
@@ -632,6 +632,14 @@ extern bfd_boolean bfd_ecoff_write_accumulated_debug
    const struct ecoff_debug_swap *swap,
    struct bfd_link_info *info, file_ptr where);
 
+/* Externally visible DWARF 2 routines.  */
+
+extern bfd_boolean bfd_dwarf2_enumerate_lines
+  (bfd *, struct bfd_symbol **,
+   bfd_boolean (*) (bfd_vma, const char *, unsigned int, const char *,
+		    bfd_boolean, void *),
+   void *);
+
 /* Externally visible ELF routines.  */
 
 struct bfd_link_needed_list
@@ -639,6 +639,14 @@ extern bfd_boolean bfd_ecoff_write_accumulated_debug
    const struct ecoff_debug_swap *swap,
    struct bfd_link_info *info, file_ptr where);
 
+/* Externally visible DWARF 2 routines.  */
+
+extern bfd_boolean bfd_dwarf2_enumerate_lines
+  (bfd *, struct bfd_symbol **,
+   bfd_boolean (*) (bfd_vma, const char *, unsigned int, const char *,
+		    bfd_boolean, void *),
+   void *);
+
 /* Externally visible ELF routines.  */
 
 struct bfd_link_needed_list
@@ -1899,6 +1907,9 @@ bfd_boolean bfd_get_section_contents
 bfd_boolean bfd_malloc_and_get_section
    (bfd *abfd, asection *section, bfd_byte **buf);
 
+bfd_boolean bfd_get_section_contents_view
+   (bfd *abfd, asection *section, const bfd_byte **view);
+
 bfd_boolean bfd_copy_private_section_data
    (bfd *ibfd, asection *isec, bfd *obfd, asection *osec);
 
@@ -6668,6 +6679,13 @@ struct bfd
      least-recently-used list of BFDs.  */
   struct bfd *lru_prev, *lru_next;
 
+  /* The number of threads using IOSTREAM, or -1 while the caching
+     routines close it.  Nonzero CACHE_REFERENCED says that IOSTREAM
+     was used since the caching routines last looked for a file to
+     close.  */
+  int cache_pins;
+  int cache_referenced;
+
   /* When a file is closed by the caching routines, BFD retains
      state information on the file here...  */
   ufile_ptr where;
@@ -6685,7 +6703,7 @@ struct bfd
   ENUM_BITFIELD (bfd_direction) direction : 2;
 
   /* Format_specific flags.  */
-  flagword flags : 21;
+  flagword flags : 23;
 
   /* Values that may appear in the flags field of a BFD.  These also
      appear in the object_flags field of the bfd_target structure, where
@@ -6775,16 +6793,28 @@ struct bfd
   /* BFD contains encrypted sections, GAP specific.  */
 #define BFD_ENCRYPTED 0x100000
 
+  /* Map the whole file into memory on first access and read from the
+     mapping instead of through stdio.  Only used for BFDs opened for
+     reading.  */
+#define BFD_MMAP 0x200000
+
+  /* With BFD_COMPRESS_GABI, compress sections with the
+     ELFCOMPRESS_ZLIB_CHUNKED type, whose index of restart points lets
+     ranges be decompressed without the rest.  */
+#define BFD_COMPRESS_CHUNKED 0x400000
+
   /* Flags bits to be saved in bfd_preserve_save.  */
 #define BFD_FLAGS_SAVED \
   (BFD_IN_MEMORY | BFD_COMPRESS | BFD_DECOMPRESS | BFD_PLUGIN \
-   | BFD_COMPRESS_GABI | BFD_CONVERT_ELF_COMMON | BFD_USE_ELF_STT_COMMON)
+   | BFD_COMPRESS_GABI | BFD_CONVERT_ELF_COMMON | BFD_USE_ELF_STT_COMMON \
+   | BFD_MMAP | BFD_COMPRESS_CHUNKED)
 
   /* Flags bits which are for BFD use only.  */
 #define BFD_FLAGS_FOR_BFD_USE_MASK \
   (BFD_IN_MEMORY | BFD_COMPRESS | BFD_DECOMPRESS | BFD_LINKER_CREATED \
    | BFD_PLUGIN | BFD_TRADITIONAL_FORMAT | BFD_DETERMINISTIC_OUTPUT \
-   | BFD_COMPRESS_GABI | BFD_CONVERT_ELF_COMMON | BFD_USE_ELF_STT_COMMON)
+   | BFD_COMPRESS_GABI | BFD_CONVERT_ELF_COMMON | BFD_USE_ELF_STT_COMMON \
+   | BFD_MMAP | BFD_COMPRESS_CHUNKED)
 
   /* Is the file descriptor being cached?  That is, can it be closed as
      needed, and re-opened when accessed later?  */
@@ -6831,6 +6861,9 @@ struct bfd
   /* Set if this is a plugin output file.  */
   unsigned int lto_output : 1;
 
+  /* Set once BFD_MMAP has tried to map the file.  */
+  unsigned int file_map_tried : 1;
+
   /* Set to dummy BFD created when claimed by a compiler plug-in
      library.  */
   bfd *plugin_dummy_bfd;
@@ -6948,6 +6981,18 @@ struct bfd
 
   /* For input BFDs, the build ID, if the object has one. */
   const struct bfd_build_id *build_id;
+
+  /* Names demangled by bfd_demangle_symbol, created on first use.  */
+  struct bfd_demangle_cache *demangle_cache;
+
+  /* Chunks decompressed by bfd_get_decompressed_section_contents,
+     created on first use.  */
+  struct bfd_decompress_cache *decompress_cache;
+
+  /* The contents of the file and their size, if BFD_MMAP mapped it.
+     Archive elements use the mapping of their archive.  */
+  bfd_byte *file_map;
+  ufile_ptr file_map_size;
 };
 
 /* See note beside bfd_set_section_userdata.  */
@@ -7151,6 +7196,8 @@ void bfd_emul_set_commonpagesize (const char *, bfd_vma);
 
 char *bfd_demangle (bfd *, const char *, int);
 
+const char *bfd_demangle_symbol (bfd *, asymbol *, int);
+
 void bfd_update_compression_header
    (bfd *abfd, bfd_byte *contents, asection *sec);
 
@@ -7698,6 +7745,10 @@ bfd_boolean bfd_get_full_section_contents
 void bfd_cache_section_contents
    (asection *sec, void *contents);
 
+bfd_boolean bfd_get_decompressed_section_contents
+   (bfd *abfd, asection *section, void *location, file_ptr offset,
+    bfd_size_type count);
+
 bfd_boolean bfd_is_section_compressed_with_header
    (bfd *abfd, asection *section,
     int *compression_header_size_p,
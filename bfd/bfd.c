@@ -74,6 +74,13 @@ CODE_FRAGMENT
 .     least-recently-used list of BFDs.  *}
 .  struct bfd *lru_prev, *lru_next;
 .
+.  {* The number of threads using IOSTREAM, or -1 while the caching
+.     routines close it.  Nonzero CACHE_REFERENCED says that IOSTREAM
+.     was used since the caching routines last looked for a file to
+.     close.  *}
+.  int cache_pins;
+.  int cache_referenced;
+.
 .  {* When a file is closed by the caching routines, BFD retains
 .     state information on the file here...  *}
 .  ufile_ptr where;
@@ -91,7 +98,7 @@ CODE_FRAGMENT
 .  ENUM_BITFIELD (bfd_direction) direction : 2;
 .
 .  {* Format_specific flags.  *}
-.  flagword flags : 21;
+.  flagword flags : 23;
 .
 .  {* Values that may appear in the flags field of a BFD.  These also
 .     appear in the object_flags field of the bfd_target structure, where
@@ -181,16 +188,28 @@ CODE_FRAGMENT
 .  {* BFD contains encrypted sections, GAP specific.  *}
 .#define BFD_ENCRYPTED 0x100000
 .
+.  {* Map the whole file into memory on first access and read from the
+.     mapping instead of through stdio.  Only used for BFDs opened for
+.     reading.  *}
+.#define BFD_MMAP 0x200000
+.
+.  {* With BFD_COMPRESS_GABI, compress sections with the
+.     ELFCOMPRESS_ZLIB_CHUNKED type, whose index of restart points lets
+.     ranges be decompressed without the rest.  *}
+.#define BFD_COMPRESS_CHUNKED 0x400000
+.
 .  {* Flags bits to be saved in bfd_preserve_save.  *}
 .#define BFD_FLAGS_SAVED \
 .  (BFD_IN_MEMORY | BFD_COMPRESS | BFD_DECOMPRESS | BFD_PLUGIN \
-.   | BFD_COMPRESS_GABI | BFD_CONVERT_ELF_COMMON | BFD_USE_ELF_STT_COMMON)
+.   | BFD_COMPRESS_GABI | BFD_CONVERT_ELF_COMMON | BFD_USE_ELF_STT_COMMON \
+.   | BFD_MMAP | BFD_COMPRESS_CHUNKED)
 .
 .  {* Flags bits which are for BFD use only.  *}
 .#define BFD_FLAGS_FOR_BFD_USE_MASK \
 .  (BFD_IN_MEMORY | BFD_COMPRESS | BFD_DECOMPRESS | BFD_LINKER_CREATED \
 .   | BFD_PLUGIN | BFD_TRADITIONAL_FORMAT | BFD_DETERMINISTIC_OUTPUT \
-.   | BFD_COMPRESS_GABI | BFD_CONVERT_ELF_COMMON | BFD_USE_ELF_STT_COMMON)
+.   | BFD_COMPRESS_GABI | BFD_CONVERT_ELF_COMMON | BFD_USE_ELF_STT_COMMON \
+.   | BFD_MMAP | BFD_COMPRESS_CHUNKED)
 .
 .  {* Is the file descriptor being cached?  That is, can it be closed as
 .     needed, and re-opened when accessed later?  *}
@@ -237,6 +256,9 @@ CODE_FRAGMENT
 .  {* Set if this is a plugin output file.  *}
 .  unsigned int lto_output : 1;
 .
+.  {* Set once BFD_MMAP has tried to map the file.  *}
+.  unsigned int file_map_tried : 1;
+.
 .  {* Set to dummy BFD created when claimed by a compiler plug-in
 .     library.  *}
 .  bfd *plugin_dummy_bfd;
@@ -354,6 +376,18 @@ CODE_FRAGMENT
 .
 .  {* For input BFDs, the build ID, if the object has one. *}
 .  const struct bfd_build_id *build_id;
+.
+.  {* Names demangled by bfd_demangle_symbol, created on first use.  *}
+.  struct bfd_demangle_cache *demangle_cache;
+.
+.  {* Chunks decompressed by bfd_get_decompressed_section_contents,
+.     created on first use.  *}
+.  struct bfd_decompress_cache *decompress_cache;
+.
+.  {* The contents of the file and their size, if BFD_MMAP mapped it.
+.     Archive elements use the mapping of their archive.  *}
+.  bfd_byte *file_map;
+.  ufile_ptr file_map_size;
 .};
 .
 .{* See note beside bfd_set_section_userdata.  *}
@@ -372,6 +406,8 @@ CODE_FRAGMENT
 #include "bfdver.h"
 #include "libiberty.h"
 #include "demangle.h"
+#include "hashtab.h"
+#include "obstack.h"
 #include "safe-ctype.h"
 #include "bfdlink.h"
 #include "libbfd.h"
@@ -447,9 +483,17 @@ CODE_FRAGMENT
 .
 */
 
-static bfd_error_type bfd_error = bfd_error_no_error;
-static bfd *input_bfd = NULL;
-static bfd_error_type input_error = bfd_error_no_error;
+/* Where the compiler supports it, the error state is kept per thread,
+   so that threads working on distinct BFDs see their own errors.  */
+#if defined (__GNUC__) && defined (__ELF__)
+#define ERROR_STATE_TLS __thread
+#else
+#define ERROR_STATE_TLS
+#endif
+
+static ERROR_STATE_TLS bfd_error_type bfd_error = bfd_error_no_error;
+static ERROR_STATE_TLS bfd *input_bfd = NULL;
+static ERROR_STATE_TLS bfd_error_type input_error = bfd_error_no_error;
 
 const char *const bfd_errmsgs[] =
 {
@@ -1829,23 +1873,11 @@ bfd_emul_set_commonpagesize (const char *emul, bfd_vma size)
 				    commonpagesize), target);
 }
 
-/*
-FUNCTION
-	bfd_demangle
-
-SYNOPSIS
-	char *bfd_demangle (bfd *, const char *, int);
-
-DESCRIPTION
-	Wrapper around cplus_demangle.  Strips leading underscores and
-	other such chars that would otherwise confuse the demangler.
-	If passed a g++ v3 ABI mangled name, returns a buffer allocated
-	with malloc holding the demangled name.  Returns NULL otherwise
-	and on memory alloc failure.
-*/
+/* Demangle NAME for ABFD as bfd_demangle describes.  The result is
+   allocated on OB, or with malloc if OB is NULL.  */
 
-char *
-bfd_demangle (bfd *abfd, const char *name, int options)
+static char *
+demangle_name (bfd *abfd, const char *name, int options, struct obstack *ob)
 {
   char *res, *alloc;
   const char *pre, *suf;
@@ -1880,7 +1912,10 @@ bfd_demangle (bfd *abfd, const char *name, int options)
       name = alloc;
     }
 
-  res = cplus_demangle (name, options);
+  if (ob != NULL)
+    res = cplus_demangle_obstack (name, options, ob);
+  else
+    res = cplus_demangle (name, options);
 
   if (alloc != NULL)
     free (alloc);
@@ -1890,6 +1925,9 @@ bfd_demangle (bfd *abfd, const char *name, int options)
       if (skip_lead)
 	{
 	  size_t len = strlen (pre) + 1;
+
+	  if (ob != NULL)
+	    return (char *) obstack_copy (ob, pre, len);
 	  alloc = (char *) bfd_malloc (len);
 	  if (alloc == NULL)
 	    return NULL;
@@ -1910,6 +1948,15 @@ bfd_demangle (bfd *abfd, const char *name, int options)
       if (suf == NULL)
 	suf = res + len;
       suf_len = strlen (suf) + 1;
+      if (ob != NULL)
+	{
+	  /* RES stays on the obstack, unused.  This is rare enough not
+	     to matter.  */
+	  obstack_grow (ob, pre, pre_len);
+	  obstack_grow (ob, res, len);
+	  obstack_grow (ob, suf, suf_len);
+	  return (char *) obstack_finish (ob);
+	}
       final = (char *) bfd_malloc (pre_len + len + suf_len);
       if (final != NULL)
 	{
@@ -1924,6 +1971,148 @@ bfd_demangle (bfd *abfd, const char *name, int options)
   return res;
 }
 
+/*
+FUNCTION
+	bfd_demangle
+
+SYNOPSIS
+	char *bfd_demangle (bfd *, const char *, int);
+
+DESCRIPTION
+	Wrapper around cplus_demangle.  Strips leading underscores and
+	other such chars that would otherwise confuse the demangler.
+	If passed a g++ v3 ABI mangled name, returns a buffer allocated
+	with malloc holding the demangled name.  Returns NULL otherwise
+	and on memory alloc failure.
+*/
+
+char *
+bfd_demangle (bfd *abfd, const char *name, int options)
+{
+  return demangle_name (abfd, name, options, NULL);
+}
+
+/* The names bfd_demangle_symbol has demangled for a BFD.  Both the
+   entries and the names live on OB.  */
+
+struct bfd_demangle_cache
+{
+  htab_t htab;
+  struct obstack ob;
+};
+
+struct bfd_demangle_cache_entry
+{
+  /* The key.  NAME is checked as well as SYM so that a symbol freed
+     and replaced by another one at the same address is not confused
+     with it.  */
+  const asymbol *sym;
+  const char *name;
+  int options;
+
+  /* The demangled name, or NULL if NAME is not mangled.  */
+  const char *demangled;
+};
+
+static hashval_t
+demangle_cache_hash (const void *p)
+{
+  const struct bfd_demangle_cache_entry *e
+    = (const struct bfd_demangle_cache_entry *) p;
+
+  return htab_hash_pointer (e->sym) ^ htab_hash_pointer (e->name) ^ e->options;
+}
+
+static int
+demangle_cache_eq (const void *p1, const void *p2)
+{
+  const struct bfd_demangle_cache_entry *e1
+    = (const struct bfd_demangle_cache_entry *) p1;
+  const struct bfd_demangle_cache_entry *e2
+    = (const struct bfd_demangle_cache_entry *) p2;
+
+  return (e1->sym == e2->sym
+	  && e1->name == e2->name
+	  && e1->options == e2->options);
+}
+
+/*
+FUNCTION
+	bfd_demangle_symbol
+
+SYNOPSIS
+	const char *bfd_demangle_symbol (bfd *, asymbol *, int);
+
+DESCRIPTION
+	Like <<bfd_demangle>> applied to the name of the symbol, but
+	the result belongs to the BFD and is remembered, so asking
+	again for the same symbol and options costs only a hash
+	lookup.  The result stays valid until the BFD is closed or
+	<<bfd_free_cached_info>> is called on it.  Returns NULL if
+	the name is not mangled, and on memory alloc failure.
+*/
+
+#define obstack_chunk_alloc malloc
+#define obstack_chunk_free free
+
+const char *
+bfd_demangle_symbol (bfd *abfd, asymbol *sym, int options)
+{
+  struct bfd_demangle_cache *cache = abfd->demangle_cache;
+  struct bfd_demangle_cache_entry key, *ent;
+  void **slot;
+  const char *demangled;
+
+  if (cache == NULL)
+    {
+      cache = (struct bfd_demangle_cache *) bfd_malloc (sizeof (*cache));
+      if (cache == NULL)
+	return NULL;
+      cache->htab = htab_create_alloc (1024, demangle_cache_hash,
+				       demangle_cache_eq, NULL,
+				       calloc, free);
+      if (cache->htab == NULL)
+	{
+	  free (cache);
+	  return NULL;
+	}
+      obstack_init (&cache->ob);
+      abfd->demangle_cache = cache;
+    }
+
+  key.sym = sym;
+  key.name = bfd_asymbol_name (sym);
+  key.options = options;
+  slot = htab_find_slot (cache->htab, &key, INSERT);
+  if (slot == NULL)
+    return NULL;
+  if (*slot != NULL)
+    return ((struct bfd_demangle_cache_entry *) *slot)->demangled;
+
+  demangled = demangle_name (abfd, key.name, options, &cache->ob);
+  ent = (struct bfd_demangle_cache_entry *) obstack_alloc (&cache->ob,
+							   sizeof (*ent));
+  *ent = key;
+  ent->demangled = demangled;
+  *slot = ent;
+  return demangled;
+}
+
+/* Free the names remembered by bfd_demangle_symbol for ABFD.  */
+
+void
+_bfd_free_demangle_cache (bfd *abfd)
+{
+  struct bfd_demangle_cache *cache = abfd->demangle_cache;
+
+  if (cache == NULL)
+    return;
+  htab_delete (cache->htab);
+  obstack_free (&cache->ob, NULL);
+  free (cache);
+  abfd->demangle_cache = NULL;
+}
+
 /*
 FUNCTION
 	bfd_update_compression_header
@@ -2032,7 +2221,8 @@ bfd_check_compression_header (bfd *abfd, bfd_byte *contents,
 	  chdr.ch_size = bfd_get_64 (abfd, &echdr->ch_size);
 	  chdr.ch_addralign = bfd_get_64 (abfd, &echdr->ch_addralign);
 	}
-      if (chdr.ch_type == ELFCOMPRESS_ZLIB
+      if ((chdr.ch_type == ELFCOMPRESS_ZLIB
+	   || chdr.ch_type == ELFCOMPRESS_ZLIB_CHUNKED)
 	  && chdr.ch_addralign == 1U << sec->alignment_power)
 	{
 	  *uncompressed_size = chdr.ch_size;
@@ -2210,14 +2400,14 @@ bfd_convert_section_contents (bfd *ibfd, sec_ptr isec, bfd *obfd,
   if (ohdr_size == sizeof (Elf32_External_Chdr))
     {
       Elf32_External_Chdr *echdr = (Elf32_External_Chdr *) contents;
-      bfd_put_32 (obfd, ELFCOMPRESS_ZLIB, &echdr->ch_type);
+      bfd_put_32 (obfd, chdr.ch_type, &echdr->ch_type);
       bfd_put_32 (obfd, chdr.ch_size, &echdr->ch_size);
       bfd_put_32 (obfd, chdr.ch_addralign, &echdr->ch_addralign);
     }
   else
     {
       Elf64_External_Chdr *echdr = (Elf64_External_Chdr *) contents;
-      bfd_put_32 (obfd, ELFCOMPRESS_ZLIB, &echdr->ch_type);
+      bfd_put_32 (obfd, chdr.ch_type, &echdr->ch_type);
       bfd_put_32 (obfd, 0, &echdr->ch_reserved);
       bfd_put_64 (obfd, chdr.ch_size, &echdr->ch_size);
       bfd_put_64 (obfd, chdr.ch_addralign, &echdr->ch_addralign);
@@ -2233,6 +2423,25 @@ bfd_convert_section_contents (bfd *ibfd, sec_ptr isec, bfd *obfd,
       *ptr = contents;
     }
 
+  /* The index of restart points of a chunked section has the same size
+     in both classes, but may need to change byte order.  */
+  if (chdr.ch_type == ELFCOMPRESS_ZLIB_CHUNKED
+      && bfd_big_endian (ibfd) != bfd_big_endian (obfd))
+    {
+      bfd_byte *p = contents + ohdr_size;
+      bfd_size_type n_chunks, i;
+
+      if (size - ohdr_size < 8)
+	return FALSE;
+      n_chunks = bfd_get_32 (ibfd, p + 4);
+      if (n_chunks > (size - ohdr_size - 8) / 8)
+	return FALSE;
+      bfd_put_32 (obfd, bfd_get_32 (ibfd, p), p);
+      bfd_put_32 (obfd, n_chunks, p + 4);
+      for (i = 0, p += 8; i < n_chunks; i++, p += 8)
+	bfd_put_64 (obfd, bfd_get_64 (ibfd, p), p);
+    }
+
   *ptr_size = size;
   return TRUE;
 }
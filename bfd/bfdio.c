@@ -28,6 +28,10 @@
 
 #include <stdio.h>
 
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
+
 #ifndef S_IXUSR
 #define S_IXUSR 0100    /* Execute by owner.  */
 #endif
@@ -173,12 +177,74 @@ DESCRIPTION
 */
 
 
+/* Return the BFD whose iostream holds the file ABFD is read from,
+   and set *ORIGIN to the position of ABFD in that file.  */
+
+static bfd *
+file_owner (bfd *abfd, ufile_ptr *origin)
+{
+  *origin = 0;
+  while (abfd->my_archive != NULL
+	 && !bfd_is_thin_archive (abfd->my_archive))
+    {
+      *origin += abfd->origin;
+      abfd = abfd->my_archive;
+    }
+  return abfd;
+}
+
+/* Return TRUE if the file of OWNER, as returned by file_owner, is
+   mapped.  If OWNER has BFD_MMAP set, try to map it the first time
+   round; if that fails, OWNER goes on reading through its iovec.  */
+
+static bfd_boolean
+file_mapped_p (bfd *owner)
+{
+  if (owner->file_map != NULL)
+    return TRUE;
+  if ((owner->flags & BFD_MMAP) == 0 || owner->file_map_tried)
+    return FALSE;
+
+  owner->file_map_tried = 1;
+#ifdef HAVE_MMAP
+  if (owner->direction == read_direction
+      && (owner->flags & BFD_IN_MEMORY) == 0
+      && owner->iovec != NULL)
+    {
+      bfd_error_type err = bfd_get_error ();
+      struct stat st;
+      void *map_addr;
+      bfd_size_type map_len;
+      void *ret;
+
+      if (owner->iovec->bstat (owner, &st) == 0
+	  && st.st_size > 0
+	  && (size_t) st.st_size == (ufile_ptr) st.st_size)
+	{
+	  ret = owner->iovec->bmmap (owner, NULL, st.st_size, PROT_READ,
+				     MAP_PRIVATE, 0, &map_addr, &map_len);
+	  if (ret != (void *) -1)
+	    {
+	      owner->file_map = (bfd_byte *) ret;
+	      owner->file_map_size = st.st_size;
+	    }
+	}
+
+      /* Failing to map is not an error; the reads will use stdio.  */
+      bfd_set_error (err);
+    }
+#endif
+  return owner->file_map != NULL;
+}
+
 /* Return value is amount read.  */
 
 bfd_size_type
 bfd_bread (void *ptr, bfd_size_type size, bfd *abfd)
 {
   size_t nread;
+  ufile_ptr origin;
+  bfd *owner;
 
   /* If this is an archive element, don't read past the end of
      this element.  */
@@ -194,10 +260,26 @@ bfd_bread (void *ptr, bfd_size_type size, bfd *abfd)
         }
     }
 
-  if (abfd->iovec)
-    nread = abfd->iovec->bread (abfd, ptr, size);
-  else
+  owner = file_owner (abfd, &origin);
+  if (abfd->iovec == NULL)
     nread = 0;
+  else if (file_mapped_p (owner))
+    {
+      ufile_ptr pos = origin + abfd->where;
+      bfd_size_type avail = 0;
+
+      if (pos < owner->file_map_size)
+	avail = owner->file_map_size - pos;
+      if (size > avail)
+	{
+	  size = avail;
+	  bfd_set_error (bfd_error_file_truncated);
+	}
+      memcpy (ptr, owner->file_map + pos, size);
+      nread = size;
+    }
+  else
+    nread = abfd->iovec->bread (abfd, ptr, size);
   if (nread != (size_t) -1)
     abfd->where += nread;
 
@@ -230,6 +312,11 @@ file_ptr
 bfd_tell (bfd *abfd)
 {
   file_ptr ptr;
+  ufile_ptr origin;
+
+  /* The position in a mapped file is only kept in WHERE.  */
+  if (abfd->iovec && file_mapped_p (file_owner (abfd, &origin)))
+    return abfd->where;
 
   if (abfd->iovec)
     {
@@ -283,6 +370,7 @@ bfd_seek (bfd *abfd, file_ptr position, int direction)
 {
   int result;
   file_ptr file_position;
+  ufile_ptr origin;
   /* For the time being, a BFD may not seek to it's end.  The problem
      is that we don't easily have a way to recognize the end of an
      element in an archive.  */
@@ -292,6 +380,19 @@ bfd_seek (bfd *abfd, file_ptr position, int direction)
   if (direction == SEEK_CUR && position == 0)
     return 0;
 
+  if (abfd->iovec && file_mapped_p (file_owner (abfd, &origin)))
+    {
+      if (direction == SEEK_CUR)
+	position += abfd->where;
+      if (position < 0)
+	{
+	  bfd_set_error (bfd_error_file_truncated);
+	  return -1;
+	}
+      abfd->where = position;
+      return 0;
+    }
+
   if (abfd->my_archive == NULL || bfd_is_thin_archive (abfd->my_archive))
     {
       if (direction == SEEK_SET && (bfd_vma) position == abfd->where)
@@ -467,6 +568,72 @@ bfd_mmap (bfd *abfd, void *addr, bfd_size_type len,
                              map_addr, map_len);
 }
 
+/*
+INTERNAL_FUNCTION
+	_bfd_get_file_view
+
+SYNOPSIS
+	const bfd_byte *_bfd_get_file_view
+	  (bfd *abfd, file_ptr offset, bfd_size_type size);
+
+DESCRIPTION
+	Return a pointer to the @var{size} bytes at @var{offset} in
+	@var{abfd}, if its file has been mapped because of
+	<<BFD_MMAP>>.  The pointer stays valid until the BFD owning
+	the file is closed.  Return NULL, without setting
+	<<bfd_error>>, if the file is not mapped or the bytes are not
+	all inside it; the caller should then read them with
+	<<bfd_bread>>.
+*/
+
+const bfd_byte *
+_bfd_get_file_view (bfd *abfd, file_ptr offset, bfd_size_type size)
+{
+  ufile_ptr origin;
+  bfd *owner;
+
+  if (abfd->iovec == NULL || offset < 0)
+    return NULL;
+
+  owner = file_owner (abfd, &origin);
+  if (!file_mapped_p (owner))
+    return NULL;
+
+  if (abfd->arelt_data != NULL
+      && ((bfd_size_type) offset > arelt_size (abfd)
+	  || size > arelt_size (abfd) - offset))
+    return NULL;
+
+  if (origin + offset > owner->file_map_size
+      || size > owner->file_map_size - (origin + offset))
+    return NULL;
+
+  return owner->file_map + origin + offset;
+}
+
+/*
+INTERNAL_FUNCTION
+	_bfd_unmap_file
+
+SYNOPSIS
+	void _bfd_unmap_file (bfd *abfd);
+
+DESCRIPTION
+	Release the mapping <<BFD_MMAP>> made of the file of
+	@var{abfd}, if any.
+*/
+
+void
+_bfd_unmap_file (bfd *abfd)
+{
+#ifdef HAVE_MMAP
+  if (abfd->file_map != NULL)
+    munmap (abfd->file_map, abfd->file_map_size);
+#endif
+  abfd->file_map = NULL;
+  abfd->file_map_size = 0;
+}
+
 /* Memory file I/O operations.  */
 
 static file_ptr
@@ -29,12 +29,43 @@ SECTION
 	the application to open as many BFDs as it wants without
 	regard to the underlying operating system's file descriptor
 	limit (often as low as 20 open files).  The module in
-	<<cache.c>> maintains a least recently used list of
-	<<bfd_cache_max_open>> files, and exports the name
+	<<cache.c>> maintains a list of at most
+	<<bfd_cache_max_open>> open files, and exports the name
 	<<bfd_cache_lookup>>, which runs around and makes sure that
 	the required BFD is open. If not, then it chooses a file to
 	close, closes it and opens the one wanted, returning its file
-	handle.
+	handle.  A file that has been used since the cache last looked
+	for one to close is given a second chance before it is closed.
+
+	A file that BFD opened for reading is read with <<pread>>
+	where the host has it, at the position BFD keeps for each BFD.
+	Reading therefore neither depends on nor changes the position
+	of the stream, which is shared by the elements of an archive.
+	Looking up an open file takes no lock: the file is pinned
+	while it is used, and a pinned file is never closed to make
+	room for another.  Opening and closing files to stay within
+	the limit is serialized by a lock.
+
+	This makes the following safe to call from several threads at
+	once, provided that each thread works on its own BFDs and that
+	no two threads use elements of the same archive:
+	<<bfd_bread>>, <<bfd_seek>>, <<bfd_tell>>, <<bfd_stat>>,
+	<<bfd_get_size>>, <<bfd_get_file_size>>, <<bfd_mmap>>,
+	<<bfd_get_section_contents>>,
+	<<bfd_get_full_section_contents>>,
+	<<bfd_get_section_contents_view>>,
+	<<bfd_get_symtab_upper_bound>>, <<bfd_canonicalize_symtab>>,
+	<<bfd_get_dynamic_symtab_upper_bound>>,
+	<<bfd_canonicalize_dynamic_symtab>>,
+	<<bfd_get_reloc_upper_bound>>, <<bfd_canonicalize_reloc>>,
+	<<bfd_get_error>>, <<bfd_set_error>> and <<bfd_errmsg>>.
+	The error state is kept per thread on hosts where the
+	compiler supports thread-local storage.
+
+	Opening, recognizing and closing BFDs, including
+	<<bfd_check_format>> and <<bfd_openr_next_archived_file>>,
+	assigns identifiers from global counters and must still be
+	done by one thread at a time, as must linking.
 
 SUBSECTION
 	Caching functions
@@ -49,6 +80,61 @@ SUBSECTION
 #ifdef HAVE_MMAP
 #include <sys/mman.h>
 #endif
+#ifdef HAVE_SCHED_YIELD
+#include <sched.h>
+#endif
+
+/* Read files opened for reading with pread where we can, rather than
+   by seeking the stream and reading from it.  */
+#if defined (HAVE_FILENO) && defined (_POSIX_VERSION) \
+    && _POSIX_VERSION >= 200112L && !(defined (__VAX) && defined (VMS))
+#define USE_PREAD 1
+#endif
+
+/* Access to the fields shared between threads: the pin count and the
+   stream of an open BFD, and the lock taken to open or close a file.
+   Without the GCC atomic builtins the cache is only usable from one
+   thread.  */
+#if defined (__GNUC__) \
+    && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7))
+#define cache_load(p) __atomic_load_n (p, __ATOMIC_ACQUIRE)
+#define cache_store(p, v) __atomic_store_n (p, v, __ATOMIC_RELEASE)
+#define cache_cas(p, oldp, v) \
+  __atomic_compare_exchange_n (p, oldp, v, 0, __ATOMIC_ACQ_REL, \
+			       __ATOMIC_ACQUIRE)
+#define cache_add(p, v) __atomic_add_fetch (p, v, __ATOMIC_ACQ_REL)
+
+static char cache_lock_flag;
+
+/* The lock is held while a file is opened or closed, which takes
+   a system call or two, so give the holder the processor rather than
+   spinning.  */
+static void
+cache_lock (void)
+{
+  while (__atomic_test_and_set (&cache_lock_flag, __ATOMIC_ACQUIRE))
+    while (__atomic_load_n (&cache_lock_flag, __ATOMIC_RELAXED))
+#ifdef HAVE_SCHED_YIELD
+      sched_yield ();
+#else
+      ;
+#endif
+}
+
+static void
+cache_unlock (void)
+{
+  __atomic_clear (&cache_lock_flag, __ATOMIC_RELEASE);
+}
+#else
+#define cache_load(p) (*(p))
+#define cache_store(p, v) (*(p) = (v))
+#define cache_cas(p, oldp, v) \
+  (*(p) == *(oldp) ? (*(p) = (v), 1) : (*(oldp) = *(p), 0))
+#define cache_add(p, v) (*(p) += (v))
+#define cache_lock()
+#define cache_unlock()
+#endif
 
 /* In some cases we can optimize cache operation when reopening files.
    For instance, a flush is entirely unnecessary if the file is already
@@ -118,9 +204,8 @@ bfd_cache_max_open (void)
 
 static int open_files;
 
-/* Zero, or a pointer to the topmost BFD on the chain.  This is
-   used by the <<bfd_cache_lookup>> macro in @file{libbfd.h} to
-   determine when it can avoid a function call.  */
+/* Zero, or a pointer to the most recently inserted BFD on the chain.
+   The files are only ever relinked with the lock held.  */
 
 static bfd *bfd_last_cache = NULL;
 
@@ -159,7 +244,58 @@ snip (bfd *abfd)
     }
 }
 
-/* Close a BFD and remove it from the cache.  */
+/* Return the BFD holding the stream ABFD is read from, and set
+   *ORIGIN to the offset of ABFD's contents in that stream.  */
+
+static bfd *
+cache_owner (bfd *abfd, file_ptr *origin)
+{
+  *origin = 0;
+  while (abfd->my_archive != NULL
+	 && !bfd_is_thin_archive (abfd->my_archive))
+    {
+      *origin += abfd->origin;
+      abfd = abfd->my_archive;
+    }
+  return abfd;
+}
+
+/* Return TRUE if the stream of OWNER, as returned by cache_owner, is
+   read with pread, in which case its position is meaningless and
+   the position of each BFD reading it is in the BFD's WHERE.  */
+
+static bfd_boolean
+cache_pread_p (bfd *owner ATTRIBUTE_UNUSED)
+{
+#ifdef USE_PREAD
+  return owner->direction == read_direction;
+#else
+  return FALSE;
+#endif
+}
+
+/* Stop the stream of ABFD being closed to make room for another,
+   unless that is already under way.  */
+
+static bfd_boolean
+pin (bfd *abfd)
+{
+  int pins = cache_load (&abfd->cache_pins);
+
+  while (pins >= 0)
+    if (cache_cas (&abfd->cache_pins, &pins, pins + 1))
+      return TRUE;
+  return FALSE;
+}
+
+static void
+unpin (bfd *abfd)
+{
+  cache_add (&abfd->cache_pins, -1);
+}
+
+/* Close a BFD and remove it from the cache.  Called with the lock
+   held.  */
 
 static bfd_boolean
 bfd_cache_delete (bfd *abfd)
@@ -176,97 +312,116 @@ bfd_cache_delete (bfd *abfd)
 
   snip (abfd);
 
-  abfd->iostream = NULL;
+  cache_store (&abfd->iostream, NULL);
   --open_files;
 
   return ret;
 }
 
-/* We need to open a new file, and the cache is full.  Find the least
-   recently used cacheable BFD and close it.  */
+/* We need to open a new file, and the cache is full.  Close the least
+   recently inserted cacheable BFD which no thread is using and which
+   has not been used since the last call, moving the BFDs that were
+   used to the front of the list.  Called with the lock held.  */
 
 static bfd_boolean
 close_one (void)
 {
-  register bfd *to_kill;
+  bfd *to_kill = NULL;
+  int scan;
+  bfd_boolean ret;
 
-  if (bfd_last_cache == NULL)
-    to_kill = NULL;
-  else
+  for (scan = 2 * open_files + 1;
+       scan > 0 && bfd_last_cache != NULL;
+       scan--)
     {
-      for (to_kill = bfd_last_cache->lru_prev;
-	   ! to_kill->cacheable;
-	   to_kill = to_kill->lru_prev)
+      bfd *abfd = bfd_last_cache->lru_prev;
+      int pins = 0;
+
+      if (abfd->cacheable
+	  && !cache_load (&abfd->cache_referenced)
+	  && cache_cas (&abfd->cache_pins, &pins, -1))
 	{
-	  if (to_kill == bfd_last_cache)
-	    {
-	      to_kill = NULL;
-	      break;
-	    }
+	  to_kill = abfd;
+	  break;
 	}
+      cache_store (&abfd->cache_referenced, 0);
+      bfd_last_cache = abfd;
     }
 
   if (to_kill == NULL)
     {
-      /* There are no open cacheable BFD's.  */
+      /* There are no open cacheable BFDs which are not in use.  */
       return TRUE;
     }
 
-  to_kill->where = real_ftell ((FILE *) to_kill->iostream);
+  if (!cache_pread_p (to_kill))
+    to_kill->where = real_ftell ((FILE *) to_kill->iostream);
 
-  return bfd_cache_delete (to_kill);
+  ret = bfd_cache_delete (to_kill);
+  cache_store (&to_kill->cache_pins, 0);
+  return ret;
 }
 
-/* Check to see if the required BFD is the same as the last one
-   looked up. If so, then it can use the stream in the BFD with
-   impunity, since it can't have changed since the last lookup;
-   otherwise, it has to perform the complicated lookup function.  */
+static FILE *open_file (bfd *);
 
-#define bfd_cache_lookup(x, flag) \
-  ((x) == bfd_last_cache			\
-   ? (FILE *) (bfd_last_cache->iostream)	\
-   : bfd_cache_lookup_worker (x, flag))
-
-/* Called when the macro <<bfd_cache_lookup>> fails to find a
-   quick answer.  Find a file descriptor for @var{abfd}.  If
-   necessary, it open it.  If there are already more than
-   <<bfd_cache_max_open>> files open, it tries to close one first, to
-   avoid running out of file descriptors.  It will return NULL
-   if it is unable to (re)open the @var{abfd}.  */
+/* Find a file descriptor for @var{abfd}, opening it if necessary, and
+   pin it for the caller, who must call bfd_cache_release when done
+   with it.  If there are already more than <<bfd_cache_max_open>>
+   files open, it tries to close one first, to avoid running out of
+   file descriptors.  It will return NULL if it is unable to (re)open
+   the @var{abfd}.  */
 
 static FILE *
-bfd_cache_lookup_worker (bfd *abfd, enum cache_flag flag)
+bfd_cache_lookup (bfd *abfd, enum cache_flag flag)
 {
   bfd *orig_bfd = abfd;
+  file_ptr origin;
+  FILE *f;
+
   if ((abfd->flags & BFD_IN_MEMORY) != 0)
     abort ();
 
-  while (abfd->my_archive != NULL
-	 && !bfd_is_thin_archive (abfd->my_archive))
-    abfd = abfd->my_archive;
+  abfd = cache_owner (abfd, &origin);
 
-  if (abfd->iostream != NULL)
+  /* The usual case, the file is open.  Pin it and note that it has
+     been used, without taking the lock.  */
+  if (pin (abfd))
     {
-      /* Move the file to the start of the cache.  */
-      if (abfd != bfd_last_cache)
+      f = (FILE *) cache_load (&abfd->iostream);
+      if (f != NULL)
 	{
-	  snip (abfd);
-	  insert (abfd);
+	  if (!cache_load (&abfd->cache_referenced))
+	    cache_store (&abfd->cache_referenced, 1);
+	  return f;
 	}
-      return (FILE *) abfd->iostream;
+      unpin (abfd);
     }
 
   if (flag & CACHE_NO_OPEN)
     return NULL;
 
-  if (bfd_open_file (abfd) == NULL)
-    ;
-  else if (!(flag & CACHE_NO_SEEK)
-	   && real_fseek ((FILE *) abfd->iostream, abfd->where, SEEK_SET) != 0
-	   && !(flag & CACHE_NO_SEEK_ERROR))
-    bfd_set_error (bfd_error_system_call);
-  else
-    return (FILE *) abfd->iostream;
+  cache_lock ();
+  f = (FILE *) abfd->iostream;
+  if (f == NULL)
+    {
+      f = open_file (abfd);
+      if (f != NULL
+	  && !cache_pread_p (abfd)
+	  && !(flag & CACHE_NO_SEEK)
+	  && real_fseek (f, abfd->where, SEEK_SET) != 0
+	  && !(flag & CACHE_NO_SEEK_ERROR))
+	{
+	  bfd_set_error (bfd_error_system_call);
+	  f = NULL;
+	}
+    }
+  /* Nobody closes a file without the lock, so it cannot be closing.  */
+  if (f != NULL)
+    cache_add (&abfd->cache_pins, 1);
+  cache_unlock ();
+
+  if (f != NULL)
+    return f;
 
   /* xgettext:c-format */
   _bfd_error_handler (_("reopening %B: %s\n"),
@@ -274,22 +429,65 @@ bfd_cache_lookup_worker (bfd *abfd, enum cache_flag flag)
   return NULL;
 }
 
+/* Unpin the file returned by bfd_cache_lookup for ABFD.  */
+
+static void
+bfd_cache_release (bfd *abfd)
+{
+  file_ptr origin;
+
+  unpin (cache_owner (abfd, &origin));
+}
+
 static file_ptr
 cache_btell (struct bfd *abfd)
 {
-  FILE *f = bfd_cache_lookup (abfd, CACHE_NO_OPEN);
+  file_ptr origin;
+  file_ptr ptr;
+  FILE *f;
+
+  if (cache_pread_p (cache_owner (abfd, &origin)))
+    return abfd->where + origin;
+
+  f = bfd_cache_lookup (abfd, CACHE_NO_OPEN);
   if (f == NULL)
     return abfd->where;
-  return real_ftell (f);
+  ptr = real_ftell (f);
+  bfd_cache_release (abfd);
+  return ptr;
 }
 
 static int
 cache_bseek (struct bfd *abfd, file_ptr offset, int whence)
 {
-  FILE *f = bfd_cache_lookup (abfd, whence != SEEK_CUR ? CACHE_NO_SEEK : CACHE_NORMAL);
+  file_ptr origin;
+  FILE *f;
+  int ret;
+
+  if (whence != SEEK_END && cache_pread_p (cache_owner (abfd, &origin)))
+    {
+      /* Only check the position, which bfd_seek records, and make
+	 sure that the file is open.  */
+      if (whence == SEEK_CUR)
+	offset += abfd->where + origin;
+      if (offset < 0)
+	{
+	  errno = EINVAL;
+	  return -1;
+	}
+      f = bfd_cache_lookup (abfd, CACHE_NO_SEEK);
+      if (f == NULL)
+	return -1;
+      bfd_cache_release (abfd);
+      return 0;
+    }
+
+  f = bfd_cache_lookup (abfd, whence != SEEK_CUR ? CACHE_NO_SEEK : CACHE_NORMAL);
   if (f == NULL)
     return -1;
-  return real_fseek (f, offset, whence);
+  ret = real_fseek (f, offset, whence);
+  bfd_cache_release (abfd);
+  return ret;
 }
 
 /* Note that archive entries don't have streams; they share their parent's.
@@ -297,13 +495,17 @@ cache_bseek (struct bfd *abfd, file_ptr offset, int whence)
 
    Also, note that the origin pointer points to the beginning of a file's
    contents (0 for non-archive elements).  For archive entries this is the
-   first octet in the file, NOT the beginning of the archive header.  */
+   first octet in the file, NOT the beginning of the archive header.
+
+   DONE is the number of bytes already read at the current position,
+   which a stream read from with pread does not record.  */
 
 static file_ptr
-cache_bread_1 (struct bfd *abfd, void *buf, file_ptr nbytes)
+cache_bread_1 (struct bfd *abfd, void *buf, file_ptr nbytes, file_ptr done)
 {
   FILE *f;
   file_ptr nread;
+  file_ptr origin;
   /* FIXME - this looks like an optimization, but it's really to cover
      up for a feature of some OSs (not solaris - sigh) that
      ld/pe-dll.c takes advantage of (apparently) when it creates BFDs
@@ -320,10 +522,50 @@ cache_bread_1 (struct bfd *abfd, void *buf, file_ptr nbytes)
   if (f == NULL)
     return 0;
 
+#ifdef USE_PREAD
+  if (cache_pread_p (cache_owner (abfd, &origin)))
+    {
+      file_ptr pos = origin + abfd->where + done;
+
+      if ((off_t) pos != pos)
+	{
+	  bfd_cache_release (abfd);
+	  bfd_set_error (bfd_error_file_too_big);
+	  return -1;
+	}
+      nread = 0;
+      while (nread < nbytes)
+	{
+	  ssize_t n = pread (fileno (f), (char *) buf + nread,
+			     nbytes - nread, pos + nread);
+
+	  if (n < 0 && errno == EINTR)
+	    continue;
+	  if (n < 0)
+	    {
+	      bfd_cache_release (abfd);
+	      bfd_set_error (bfd_error_system_call);
+	      return nread;
+	    }
+	  if (n == 0)
+	    break;
+	  nread += n;
+	}
+      bfd_cache_release (abfd);
+      if (nread < nbytes)
+	bfd_set_error (bfd_error_file_truncated);
+      return nread;
+    }
+#else
+  (void) origin;
+  (void) done;
+#endif
+
 #if defined (__VAX) && defined (VMS)
   /* Apparently fread on Vax VMS does not keep the record length
      information.  */
   nread = read (fileno (f), buf, nbytes);
+  bfd_cache_release (abfd);
   /* Set bfd_error if we did not read as much data as we expected.  If
      the read failed due to an error set the bfd_error_system_call,
      else set bfd_error_file_truncated.  */
@@ -339,9 +581,11 @@ cache_bread_1 (struct bfd *abfd, void *buf, file_ptr nbytes)
      else set bfd_error_file_truncated.  */
   if (nread < nbytes && ferror (f))
     {
+      bfd_cache_release (abfd);
       bfd_set_error (bfd_error_system_call);
       return nread;
     }
+  bfd_cache_release (abfd);
 #endif
   if (nread < nbytes)
     /* This may or may not be an error, but in case the calling code
@@ -367,7 +611,8 @@ cache_bread (struct bfd *abfd, void *buf, file_ptr nbytes)
       if (chunk_size > max_chunk_size)
         chunk_size = max_chunk_size;
 
-      chunk_nread = cache_bread_1 (abfd, (char *) buf + nread, chunk_size);
+      chunk_nread = cache_bread_1 (abfd, (char *) buf + nread, chunk_size,
+				    nread);
 
       /* Update the nread count.
 
@@ -398,9 +643,11 @@ cache_bwrite (struct bfd *abfd, const void *where, file_ptr nbytes)
   nwrite = fwrite (where, 1, nbytes, f);
   if (nwrite < nbytes && ferror (f))
     {
+      bfd_cache_release (abfd);
       bfd_set_error (bfd_error_system_call);
       return -1;
     }
+  bfd_cache_release (abfd);
   return nwrite;
 }
 
@@ -419,6 +666,7 @@ cache_bflush (struct bfd *abfd)
   if (f == NULL)
     return 0;
   sts = fflush (f);
+  bfd_cache_release (abfd);
   if (sts < 0)
     bfd_set_error (bfd_error_system_call);
   return sts;
@@ -433,6 +681,7 @@ cache_bstat (struct bfd *abfd, struct stat *sb)
   if (f == NULL)
     return -1;
   sts = fstat (fileno (f), sb);
+  bfd_cache_release (abfd);
   if (sts < 0)
     bfd_set_error (bfd_error_system_call);
   return sts;
@@ -477,6 +726,7 @@ cache_bmmap (struct bfd *abfd ATTRIBUTE_UNUSED,
       pg_len = (len + (offset - pg_offset) + pagesize_m1) & ~pagesize_m1;
 
       ret = mmap (addr, pg_len, prot, flags, fileno (f), pg_offset);
+      bfd_cache_release (abfd);
       if (ret == (void *) -1)
 	bfd_set_error (bfd_error_system_call);
       else
@@ -508,8 +758,8 @@ DESCRIPTION
 	Add a newly opened BFD to the cache.
 */
 
-bfd_boolean
-bfd_cache_init (bfd *abfd)
+static bfd_boolean
+cache_init (bfd *abfd)
 {
   BFD_ASSERT (abfd->iostream != NULL);
   if (open_files >= bfd_cache_max_open ())
@@ -523,6 +773,17 @@ bfd_cache_init (bfd *abfd)
   return TRUE;
 }
 
+bfd_boolean
+bfd_cache_init (bfd *abfd)
+{
+  bfd_boolean ret;
+
+  cache_lock ();
+  ret = cache_init (abfd);
+  cache_unlock ();
+  return ret;
+}
+
 /*
 INTERNAL_FUNCTION
 	bfd_cache_close
@@ -542,15 +803,22 @@ RETURNS
 bfd_boolean
 bfd_cache_close (bfd *abfd)
 {
+  bfd_boolean ret;
+
   if (abfd->iovec != &cache_iovec)
     return TRUE;
 
+  cache_lock ();
   if (abfd->iostream == NULL)
     /* Previously closed.  */
-    return TRUE;
-
+    ret = TRUE;
+  else
+    {
 /* MYDUMP */ // printf("bfd_cache_close: %s, flags: 0x%8x\n", abfd->filename?abfd->filename:"<NoName>", abfd->flags);
-  return bfd_cache_delete (abfd);
+      ret = bfd_cache_delete (abfd);
+    }
+  cache_unlock ();
+  return ret;
 }
 
 /*
@@ -574,8 +842,10 @@ bfd_cache_close_all (void)
 {
   bfd_boolean ret = TRUE;
 
+  cache_lock ();
   while (bfd_last_cache != NULL)
-    ret &= bfd_cache_close (bfd_last_cache);
+    ret &= bfd_cache_delete (bfd_last_cache);
+  cache_unlock ();
 
   return ret;
 }
@@ -597,6 +867,19 @@ DESCRIPTION
 
 FILE *
 bfd_open_file (bfd *abfd)
+{
+  FILE *f;
+
+  cache_lock ();
+  f = open_file (abfd);
+  cache_unlock ();
+  return f;
+}
+
+/* The worker for bfd_open_file, called with the lock held.  */
+
+static FILE *
+open_file (bfd *abfd)
 {
   abfd->cacheable = TRUE;	/* Allow it to be closed later.  */
 
@@ -663,7 +946,7 @@ bfd_open_file (bfd *abfd)
     bfd_set_error (bfd_error_system_call);
   else
     {
-      if (! bfd_cache_init (abfd))
+      if (! cache_init (abfd))
 	return NULL;
     }
 
@@ -22,6 +22,7 @@
 #include <zlib.h>
 #include "bfd.h"
 #include "libbfd.h"
+#include "elf/common.h"
 #include "safe-ctype.h"
 
 #define MAX_COMPRESSION_HEADER_SIZE 24
@@ -64,6 +65,110 @@ decompress_contents (bfd_byte *compressed_buffer,
   return rc == Z_OK && strm.avail_out == 0;
 }
 
+/* With BFD_COMPRESS_CHUNKED, sections are compressed with an ELF
+   compression header of type ELFCOMPRESS_ZLIB_CHUNKED.  The header is
+   followed by an index of restart points: the chunk size and the
+   number of chunks, four bytes each, then for each chunk the eight
+   byte offset of its compressed data from the start of the zlib
+   stream, all in the byte order of the target.  The index is followed
+   by a zlib stream which is flushed with Z_FULL_FLUSH every chunk
+   size bytes of input.  Each flush is a restart point: the data from
+   there to the next one inflates as a raw deflate stream, with no need
+   for what precedes.  The index has the same size in ELF32 and ELF64
+   files.  Tools which do not know the compression type report the
+   section as unsupported rather than misreading it.  */
+
+#define CHUNK_SIZE 0x10000
+
+/* Return the size of the index at INDEX, given that SIZE bytes of the
+   section follow the compression header and that it decompresses to
+   UNCOMPRESSED_SIZE bytes.  The first 8 bytes at INDEX must be
+   readable.  Return 0 if the index is not valid.  */
+
+static bfd_size_type
+chunk_index_size (bfd *abfd, const bfd_byte *index, bfd_size_type size,
+		  bfd_size_type uncompressed_size)
+{
+  bfd_size_type chunk_size = bfd_get_32 (abfd, index);
+  bfd_size_type n_chunks = bfd_get_32 (abfd, index + 4);
+
+  if (chunk_size == 0
+      || n_chunks == 0
+      || n_chunks != (uncompressed_size + chunk_size - 1) / chunk_size
+      || size < 8
+      || n_chunks > (size - 8) / 8)
+    return 0;
+  return 8 + n_chunks * 8;
+}
+
+/* Return TRUE if HEADER, an ELF compression header, says the section
+   is chunked.  The type is the first word in both classes.  */
+
+static bfd_boolean
+chunked_header_p (bfd *abfd, const bfd_byte *header)
+{
+  return bfd_get_32 (abfd, header) == ELFCOMPRESS_ZLIB_CHUNKED;
+}
+
+/* Return an upper bound on the bytes a chunked section of SIZE bytes
+   needs beyond what compressBound allows for: the index, and the
+   flushes at the restart points.  */
+
+static bfd_size_type
+chunked_overhead (bfd_size_type size)
+{
+  bfd_size_type n_chunks = (size + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+  return 8 + n_chunks * (8 + 16);
+}
+
+/* Compress SIZE bytes at IN into OUT, which has room for *OUT_SIZE
+   bytes, as the index and stream of a chunked section.  Set *OUT_SIZE
+   to the number of bytes used.  */
+
+static bfd_boolean
+compress_chunked (bfd *abfd, bfd_byte *out, uLong *out_size,
+		  const bfd_byte *in, bfd_size_type size)
+{
+  bfd_size_type n_chunks = (size + CHUNK_SIZE - 1) / CHUNK_SIZE;
+  bfd_size_type index_size = 8 + n_chunks * 8;
+  bfd_size_type i;
+  z_stream strm;
+  int rc;
+
+  if (n_chunks == 0 || n_chunks > 0xffffffff || index_size >= *out_size)
+    return FALSE;
+
+  bfd_put_32 (abfd, CHUNK_SIZE, out);
+  bfd_put_32 (abfd, n_chunks, out + 4);
+
+  memset (&strm, 0, sizeof strm);
+  strm.next_out = (Bytef *) out + index_size;
+  strm.avail_out = *out_size - index_size;
+  rc = deflateInit (&strm, Z_DEFAULT_COMPRESSION);
+  for (i = 0; i < n_chunks && rc == Z_OK; i++)
+    {
+      bfd_size_type start = i * CHUNK_SIZE;
+
+      /* The first chunk starts after the two-byte zlib header, the
+	 others at the flush ending the previous chunk.  */
+      bfd_put_64 (abfd, i == 0 ? 2 : strm.total_out, out + 8 + i * 8);
+      strm.next_in = (Bytef *) in + start;
+      strm.avail_in = size - start < CHUNK_SIZE ? size - start : CHUNK_SIZE;
+      if (i + 1 < n_chunks)
+	{
+	  rc = deflate (&strm, Z_FULL_FLUSH);
+	  if (rc == Z_OK && (strm.avail_in != 0 || strm.avail_out == 0))
+	    rc = Z_BUF_ERROR;
+	}
+      else if (deflate (&strm, Z_FINISH) != Z_STREAM_END)
+	rc = Z_BUF_ERROR;
+    }
+  *out_size = index_size + strm.total_out;
+  rc |= deflateEnd (&strm);
+  return rc == Z_OK;
+}
+
 /* Compress data of the size specified in @var{uncompressed_size}
    and pointed to by @var{uncompressed_buffer} using zlib and store
    as the contents field.  This function assumes the contents
@@ -89,6 +194,8 @@ bfd_compress_section_contents (bfd *abfd, sec_ptr sec,
     = bfd_is_section_compressed_with_header (abfd, sec,
 					     &orig_compression_header_size,
 					     &orig_uncompressed_size);
+  bfd_boolean chunked = (header_size != 0
+			 && (abfd->flags & BFD_COMPRESS_CHUNKED) != 0);
 
   /* Either ELF compression header or the 12-byte, "ZLIB" + 8-byte size,
      overhead in .zdebug* section.  */
@@ -122,7 +229,11 @@ bfd_compress_section_contents (bfd *abfd, sec_ptr sec,
       compressed_size = zlib_size + header_size;
     }
   else
-    compressed_size = compressBound (uncompressed_size) + header_size;
+    {
+      compressed_size = compressBound (uncompressed_size) + header_size;
+      if (chunked)
+	compressed_size += chunked_overhead (uncompressed_size);
+    }
 
   /* Uncompress if it leads to smaller size.  */
   if (compressed && compressed_size > orig_uncompressed_size)
@@ -167,10 +278,14 @@ bfd_compress_section_contents (bfd *abfd, sec_ptr sec,
     }
   else
     {
-      if (compress ((Bytef*) buffer + header_size,
-		    &compressed_size,
-		    (const Bytef*) uncompressed_buffer,
-		    uncompressed_size) != Z_OK)
+      compressed_size -= header_size;
+      if (chunked
+	  ? !compress_chunked (abfd, buffer + header_size, &compressed_size,
+			       uncompressed_buffer, uncompressed_size)
+	  : compress ((Bytef*) buffer + header_size,
+		      &compressed_size,
+		      (const Bytef*) uncompressed_buffer,
+		      uncompressed_size) != Z_OK)
 	{
 	  bfd_release (abfd, buffer);
 	  bfd_set_error (bfd_error_bad_value);
@@ -181,7 +296,11 @@ bfd_compress_section_contents (bfd *abfd, sec_ptr sec,
       /* PR binutils/18087: If compression didn't make the section smaller,
 	 just keep it uncompressed.  */
       if (compressed_size < uncompressed_size)
-	bfd_update_compression_header (abfd, buffer, sec);
+	{
+	  bfd_update_compression_header (abfd, buffer, sec);
+	  if (chunked)
+	    bfd_put_32 (abfd, ELFCOMPRESS_ZLIB_CHUNKED, buffer);
+	}
       else
 	{
 	  /* NOTE: There is a small memory leak here since
@@ -228,7 +347,7 @@ bfd_get_full_section_contents (bfd *abfd, sec_ptr sec, bfd_byte **ptr)
   bfd_size_type save_size;
   bfd_size_type save_rawsize;
   bfd_byte *compressed_buffer;
-  unsigned int compression_header_size;
+  bfd_size_type compression_header_size;
 
   if (abfd->direction != write_direction && sec->rawsize != 0)
     sz = sec->rawsize;
@@ -299,8 +418,29 @@ bfd_get_full_section_contents (bfd *abfd, sec_ptr sec, bfd_byte **ptr)
 	/* Set header size to the zlib header size if it is a
 	   SHF_COMPRESSED section.  */
 	compression_header_size = 12;
+      else if (chunked_header_p (abfd, compressed_buffer))
+	{
+	  /* Skip the index of a chunked section.  */
+	  bfd_size_type index_size = 0;
+
+	  if (sec->compressed_size >= compression_header_size + 8)
+	    index_size
+	      = chunk_index_size (abfd,
+				  compressed_buffer + compression_header_size,
+				  sec->compressed_size - compression_header_size,
+				  sz);
+	  if (index_size == 0)
+	    {
+	      bfd_set_error (bfd_error_bad_value);
+	      if (p != *ptr)
+		free (p);
+	      goto fail_compressed;
+	    }
+	  compression_header_size += index_size;
+	}
       if (!decompress_contents (compressed_buffer + compression_header_size,
-				sec->compressed_size, p, sz))
+				sec->compressed_size - compression_header_size,
+				p, sz))
 	{
 	  bfd_set_error (bfd_error_bad_value);
 	  if (p != *ptr)
@@ -356,6 +496,450 @@ bfd_cache_section_contents (asection *sec, void *contents)
   sec->flags |= SEC_IN_MEMORY;
 }
 
+/* The index of a section read with bfd_get_decompressed_section_contents.
+   A section which is not chunked has one chunk, which is decompressed
+   as a whole.  */
+
+struct compressed_index
+{
+  struct compressed_index *next;
+  asection *sec;
+  bfd_boolean chunked;
+  bfd_size_type chunk_size;
+  bfd_size_type n_chunks;
+  /* For a chunked section, N_CHUNKS + 1 offsets in the compressed
+     contents: where the data of each chunk starts, and where the
+     stream ends.  */
+  bfd_size_type *offsets;
+  /* Otherwise, where the zlib stream starts.  */
+  bfd_size_type data_start;
+};
+
+/* A decompressed chunk, on the list of the most recently used.  */
+
+struct decompressed_chunk
+{
+  struct decompressed_chunk *prev, *next;
+  struct compressed_index *index;
+  bfd_size_type chunk;
+  bfd_size_type size;
+  bfd_byte *data;
+};
+
+struct bfd_decompress_cache
+{
+  struct compressed_index *indexes;
+  /* The chunks, most recently used first.  */
+  struct decompressed_chunk *first, *last;
+  /* The number of bytes in the chunks.  */
+  bfd_size_type size;
+};
+
+/* Chunks are dropped from the cache, least recently used first, while
+   it holds more than this many bytes.  The chunk being read is kept
+   whatever its size.  */
+#define DECOMPRESS_CACHE_SIZE (4 * 1024 * 1024)
+
+/* Read COUNT bytes at OFFSET in the compressed contents of SEC.  */
+
+static bfd_boolean
+read_compressed (bfd *abfd, asection *sec, bfd_byte *buf,
+		 bfd_size_type offset, bfd_size_type count)
+{
+  bfd_size_type save_size = sec->size;
+  bfd_size_type save_rawsize = sec->rawsize;
+  bfd_boolean ret;
+
+  sec->rawsize = 0;
+  sec->size = sec->compressed_size;
+  sec->compress_status = COMPRESS_SECTION_NONE;
+  ret = bfd_get_section_contents (abfd, sec, buf, offset, count);
+  sec->rawsize = save_rawsize;
+  sec->size = save_size;
+  sec->compress_status = DECOMPRESS_SECTION_SIZED;
+  return ret;
+}
+
+/* Fill in INDEX from the index of restart points which follows the
+   HEADER_SIZE byte compression header of the chunked section SEC.  */
+
+static bfd_boolean
+read_chunk_index (bfd *abfd, asection *sec, int header_size,
+		  struct compressed_index *index)
+{
+  bfd_byte head[8];
+  bfd_size_type size, index_size, n_chunks, start, i;
+  bfd_byte *buf = NULL;
+  bfd_size_type *offsets = NULL;
+
+  size = sec->compressed_size - header_size;
+  if (sec->compressed_size < (bfd_size_type) header_size + 8
+      || !read_compressed (abfd, sec, head, header_size, 8))
+    goto fail;
+  index_size = chunk_index_size (abfd, head, size, sec->size);
+  if (index_size == 0)
+    goto fail;
+
+  n_chunks = (index_size - 8) / 8;
+  start = header_size + index_size;
+  buf = (bfd_byte *) bfd_malloc (index_size - 8);
+  offsets = (bfd_size_type *) bfd_malloc ((n_chunks + 1)
+					  * sizeof (*offsets));
+  if (buf == NULL
+      || offsets == NULL
+      || !read_compressed (abfd, sec, buf, header_size + 8, index_size - 8))
+    goto fail;
+
+  for (i = 0; i < n_chunks; i++)
+    {
+      bfd_uint64_t off = bfd_get_64 (abfd, buf + i * 8);
+
+      if (off >= sec->compressed_size - start
+	  || (i != 0 && start + off <= offsets[i - 1]))
+	goto fail;
+      offsets[i] = start + off;
+    }
+  offsets[n_chunks] = sec->compressed_size;
+  free (buf);
+
+  index->chunked = TRUE;
+  index->chunk_size = bfd_get_32 (abfd, head);
+  index->n_chunks = n_chunks;
+  index->offsets = offsets;
+  return TRUE;
+
+ fail:
+  free (buf);
+  free (offsets);
+  bfd_set_error (bfd_error_bad_value);
+  return FALSE;
+}
+
+/* Return the index of the compressed section SEC, reading it if it is
+   not in CACHE.  */
+
+static struct compressed_index *
+get_compressed_index (bfd *abfd, asection *sec,
+		      struct bfd_decompress_cache *cache)
+{
+  bfd_byte header[MAX_COMPRESSION_HEADER_SIZE];
+  struct compressed_index *index;
+  int header_size;
+
+  for (index = cache->indexes; index != NULL; index = index->next)
+    if (index->sec == sec)
+      return index;
+
+  index = (struct compressed_index *) bfd_zmalloc (sizeof (*index));
+  if (index == NULL)
+    return NULL;
+  index->sec = sec;
+
+  header_size = bfd_get_compression_header_size (abfd, sec);
+  if (header_size != 0)
+    {
+      if (!read_compressed (abfd, sec, header, 0, header_size))
+	{
+	  free (index);
+	  return NULL;
+	}
+      if (chunked_header_p (abfd, header))
+	{
+	  if (!read_chunk_index (abfd, sec, header_size, index))
+	    {
+	      free (index);
+	      return NULL;
+	    }
+	}
+      else
+	index->data_start = header_size;
+    }
+  else
+    /* The "ZLIB" and size header of a .zdebug section.  */
+    index->data_start = 12;
+
+  if (!index->chunked)
+    {
+      index->chunk_size = sec->size;
+      index->n_chunks = 1;
+    }
+
+  index->next = cache->indexes;
+  cache->indexes = index;
+  return index;
+}
+
+/* Inflate the IN_SIZE bytes of raw deflate data at IN, which must
+   produce OUT_SIZE bytes, into OUT.  */
+
+static bfd_boolean
+inflate_chunk (bfd_byte *in, bfd_size_type in_size,
+	       bfd_byte *out, bfd_size_type out_size)
+{
+  z_stream strm;
+  int rc;
+
+  memset (&strm, 0, sizeof strm);
+  strm.next_in = (Bytef *) in;
+  strm.avail_in = in_size;
+  strm.next_out = (Bytef *) out;
+  strm.avail_out = out_size;
+  rc = inflateInit2 (&strm, -MAX_WBITS);
+  if (rc == Z_OK)
+    {
+      rc = inflate (&strm, Z_SYNC_FLUSH);
+      if (rc == Z_STREAM_END)
+	rc = Z_OK;
+    }
+  rc |= inflateEnd (&strm);
+  return rc == Z_OK && strm.avail_out == 0;
+}
+
+static void
+unlink_chunk (struct bfd_decompress_cache *cache,
+	      struct decompressed_chunk *c)
+{
+  if (c->prev != NULL)
+    c->prev->next = c->next;
+  else
+    cache->first = c->next;
+  if (c->next != NULL)
+    c->next->prev = c->prev;
+  else
+    cache->last = c->prev;
+}
+
+static void
+link_chunk_first (struct bfd_decompress_cache *cache,
+		  struct decompressed_chunk *c)
+{
+  c->prev = NULL;
+  c->next = cache->first;
+  if (cache->first != NULL)
+    cache->first->prev = c;
+  else
+    cache->last = c;
+  cache->first = c;
+}
+
+/* Return chunk CHUNK of the section described by INDEX, decompressing
+   it if it is not in CACHE.  */
+
+static struct decompressed_chunk *
+get_chunk (bfd *abfd, struct bfd_decompress_cache *cache,
+	   struct compressed_index *index, bfd_size_type chunk)
+{
+  asection *sec = index->sec;
+  struct decompressed_chunk *c;
+  bfd_size_type start, in_size;
+  bfd_byte *in;
+  bfd_boolean ok;
+
+  for (c = cache->first; c != NULL; c = c->next)
+    if (c->index == index && c->chunk == chunk)
+      {
+	if (c != cache->first)
+	  {
+	    unlink_chunk (cache, c);
+	    link_chunk_first (cache, c);
+	  }
+	return c;
+      }
+
+  c = (struct decompressed_chunk *) bfd_malloc (sizeof (*c));
+  if (c == NULL)
+    return NULL;
+  c->index = index;
+  c->chunk = chunk;
+  start = chunk * index->chunk_size;
+  c->size = sec->size - start;
+  if (c->size > index->chunk_size)
+    c->size = index->chunk_size;
+  c->data = (bfd_byte *) bfd_malloc (c->size);
+
+  if (index->chunked)
+    {
+      start = index->offsets[chunk];
+      in_size = index->offsets[chunk + 1] - start;
+    }
+  else
+    {
+      start = index->data_start;
+      in_size = sec->compressed_size - start;
+    }
+  in = (bfd_byte *) bfd_malloc (in_size);
+
+  ok = (c->data != NULL
+	&& in != NULL
+	&& read_compressed (abfd, sec, in, start, in_size));
+  if (ok)
+    {
+      if (index->chunked)
+	ok = inflate_chunk (in, in_size, c->data, c->size);
+      else
+	ok = decompress_contents (in, in_size, c->data, c->size);
+      if (!ok)
+	bfd_set_error (bfd_error_bad_value);
+    }
+  free (in);
+  if (!ok)
+    {
+      free (c->data);
+      free (c);
+      return NULL;
+    }
+
+  link_chunk_first (cache, c);
+  cache->size += c->size;
+  while (cache->size > DECOMPRESS_CACHE_SIZE && cache->last != c)
+    {
+      struct decompressed_chunk *old = cache->last;
+
+      unlink_chunk (cache, old);
+      cache->size -= old->size;
+      free (old->data);
+      free (old);
+    }
+  return c;
+}
+
+/*
+FUNCTION
+	bfd_get_decompressed_section_contents
+
+SYNOPSIS
+	bfd_boolean bfd_get_decompressed_section_contents
+	  (bfd *abfd, asection *section, void *location, file_ptr offset,
+	   bfd_size_type count);
+
+DESCRIPTION
+	Read @var{count} bytes at @var{offset} in the contents of
+	@var{section} in BFD @var{abfd} into @var{location}, as
+	<<bfd_get_full_section_contents>> would return them.
+
+	When the section was compressed with <<BFD_COMPRESS_CHUNKED>>,
+	only the chunks holding the bytes asked for are decompressed.
+	Other compressed sections are decompressed as a whole.  Either
+	way, BFD keeps the most recently used decompressed data, up to a
+	few megabytes, for the following reads.
+*/
+
+bfd_boolean
+bfd_get_decompressed_section_contents (bfd *abfd, sec_ptr sec,
+				       void *location, file_ptr offset,
+				       bfd_size_type count)
+{
+  struct bfd_decompress_cache *cache;
+  struct compressed_index *index;
+  bfd_byte *out = (bfd_byte *) location;
+  bfd_size_type pos;
+
+  if (sec->compress_status != DECOMPRESS_SECTION_SIZED)
+    {
+      if (sec->compress_status == COMPRESS_SECTION_DONE
+	  && sec->contents != NULL)
+	{
+	  if (offset < 0
+	      || (bfd_size_type) offset > sec->size
+	      || count > sec->size - offset)
+	    {
+	      bfd_set_error (bfd_error_bad_value);
+	      return FALSE;
+	    }
+	  memcpy (location, sec->contents + offset, count);
+	  return TRUE;
+	}
+      return bfd_get_section_contents (abfd, sec, location, offset, count);
+    }
+
+  if (offset < 0
+      || (bfd_size_type) offset > sec->size
+      || count > sec->size - offset)
+    {
+      bfd_set_error (bfd_error_bad_value);
+      return FALSE;
+    }
+  if (count == 0)
+    return TRUE;
+
+  cache = abfd->decompress_cache;
+  if (cache == NULL)
+    {
+      cache = (struct bfd_decompress_cache *) bfd_zmalloc (sizeof (*cache));
+      if (cache == NULL)
+	return FALSE;
+      abfd->decompress_cache = cache;
+    }
+
+  index = get_compressed_index (abfd, sec, cache);
+  if (index == NULL)
+    return FALSE;
+
+  for (pos = offset; pos < offset + count; )
+    {
+      bfd_size_type chunk = pos / index->chunk_size;
+      bfd_size_type in_chunk = pos - chunk * index->chunk_size;
+      bfd_size_type n;
+      struct decompressed_chunk *c = get_chunk (abfd, cache, index, chunk);
+
+      if (c == NULL)
+	return FALSE;
+      n = c->size - in_chunk;
+      if (n > offset + count - pos)
+	n = offset + count - pos;
+      memcpy (out, c->data + in_chunk, n);
+      out += n;
+      pos += n;
+    }
+  return TRUE;
+}
+
+/* Free the decompressed chunks and indexes kept for ABFD.  */
+
+void
+_bfd_free_decompress_cache (bfd *abfd)
+{
+  struct bfd_decompress_cache *cache = abfd->decompress_cache;
+  struct decompressed_chunk *c, *next_c;
+  struct compressed_index *index, *next_index;
+
+  if (cache == NULL)
+    return;
+  for (c = cache->first; c != NULL; c = next_c)
+    {
+      next_c = c->next;
+      free (c->data);
+      free (c);
+    }
+  for (index = cache->indexes; index != NULL; index = next_index)
+    {
+      next_index = index->next;
+      free (index->offsets);
+      free (index);
+    }
+  free (cache);
+  abfd->decompress_cache = NULL;
+}
+
+/* Return the size of the index of restart points of SEC, a chunked
+   section whose HEADER_SIZE byte compression header says it
+   decompresses to UNCOMPRESSED_SIZE bytes, reading it from the file.
+   SEC must not be set up for decompression.  Return 0 if the index is
+   not valid.  */
+
+static bfd_size_type
+read_chunk_index_size (bfd *abfd, asection *sec, int header_size,
+		       bfd_size_type uncompressed_size)
+{
+  bfd_byte head[8];
+
+  if (sec->size < (bfd_size_type) header_size + 8
+      || !bfd_get_section_contents (abfd, sec, head, header_size, 8))
+    return 0;
+  return chunk_index_size (abfd, head, sec->size - header_size,
+			   uncompressed_size);
+}
+
 /*
 FUNCTION
 	bfd_is_section_compressed_with_header
@@ -414,6 +998,20 @@ bfd_is_section_compressed_with_header (bfd *abfd, sec_ptr sec,
 	  if (!bfd_check_compression_header (abfd, header, sec,
 					     uncompressed_size_p))
 	    compression_header_size = -1;
+	  else if (chunked_header_p (abfd, header))
+	    {
+	      /* Count the index of a chunked section as part of the
+		 header, so that it is dropped with the header when the
+		 section is converted to another compression.  */
+	      bfd_size_type index_size
+		= read_chunk_index_size (abfd, sec, compression_header_size,
+					 *uncompressed_size_p);
+
+	      if (index_size == 0 || index_size > 0x7fffffff)
+		compression_header_size = -1;
+	      else
+		compression_header_size += index_size;
+	    }
 	}
       /* Check for the pathalogical case of a debug string section that
 	 contains the string ZLIB.... as the first entry.  We assume that
@@ -508,7 +1106,10 @@ bfd_init_section_decompress_status (bfd *abfd, sec_ptr sec)
       uncompressed_size = bfd_getb64 (header + 4);
     }
   else if (!bfd_check_compression_header (abfd, header, sec,
-					 &uncompressed_size))
+					 &uncompressed_size)
+	   || (chunked_header_p (abfd, header)
+	       && read_chunk_index_size (abfd, sec, compression_header_size,
+					 uncompressed_size) == 0))
     {
       bfd_set_error (bfd_error_wrong_format);
       return FALSE;
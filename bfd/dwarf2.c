@@ -4063,6 +4063,425 @@ _bfd_dwarf2_find_symbol_bias (asymbol ** symbols, void ** pinfo)
   return 0;
 }
 
+/* Read the next compilation unit from the .debug_info section(s) of
+   STASH and add it to the list of units in STASH.  ADDR_SIZE is as for
+   _bfd_dwarf2_find_nearest_line, but must not be zero.  Returns FALSE
+   when there are no more units, or when the debug information is
+   damaged and should not be trusted any more.  Otherwise sets
+   *UNIT_PTR to the new unit, or to NULL for an empty unit, and returns
+   TRUE.  */
+
+static bfd_boolean
+stash_read_next_comp_unit (struct dwarf2_debug *stash,
+			   unsigned int addr_size,
+			   struct comp_unit **unit_ptr)
+{
+  bfd_vma length;
+  unsigned int offset_size = addr_size;
+  bfd_byte *info_ptr_unit = stash->info_ptr;
+  bfd_byte *new_ptr;
+  struct comp_unit *each;
+
+  *unit_ptr = NULL;
+  if (stash->info_ptr >= stash->info_ptr_end)
+    return FALSE;
+
+  length = read_4_bytes (stash->bfd_ptr, stash->info_ptr, stash->info_ptr_end);
+  /* A 0xffffff length is the DWARF3 way of indicating
+     we use 64-bit offsets, instead of 32-bit offsets.  */
+  if (length == 0xffffffff)
+    {
+      offset_size = 8;
+      length = read_8_bytes (stash->bfd_ptr, stash->info_ptr + 4, stash->info_ptr_end);
+      stash->info_ptr += 12;
+    }
+  /* A zero length is the IRIX way of indicating 64-bit offsets,
+     mostly because the 64-bit length will generally fit in 32
+     bits, and the endianness helps.  */
+  else if (length == 0)
+    {
+      offset_size = 8;
+      length = read_4_bytes (stash->bfd_ptr, stash->info_ptr + 4, stash->info_ptr_end);
+      stash->info_ptr += 8;
+    }
+  /* In the absence of the hints above, we assume 32-bit DWARF2
+     offsets even for targets with 64-bit addresses, because:
+       a) most of the time these targets will not have generated
+	  more than 2Gb of debug info and so will not need 64-bit
+	  offsets,
+     and
+       b) if they do use 64-bit offsets but they are not using
+	  the size hints that are tested for above then they are
+	  not conforming to the DWARF3 standard anyway.  */
+  else if (addr_size == 8)
+    {
+      offset_size = 4;
+      stash->info_ptr += 4;
+    }
+  else
+    stash->info_ptr += 4;
+
+  if (length == 0)
+    return TRUE;
+
+  each = parse_comp_unit (stash, length, info_ptr_unit, offset_size);
+  if (!each)
+    /* The dwarf information is damaged, don't trust it any
+       more.  */
+    return FALSE;
+
+  new_ptr = stash->info_ptr + length;
+  /* PR 17512: file: 1500698c.  */
+  if (new_ptr < stash->info_ptr)
+    /* A corrupt length value - do not trust the info any more.  */
+    return FALSE;
+  stash->info_ptr = new_ptr;
+
+  if (stash->all_comp_units)
+    stash->all_comp_units->prev_unit = each;
+  else
+    stash->last_comp_unit = each;
+
+  each->next_unit = stash->all_comp_units;
+  stash->all_comp_units = each;
+
+  if ((bfd_vma) (stash->info_ptr - stash->sec_info_ptr)
+      == stash->sec->size)
+    {
+      stash->sec = find_debug_info (stash->bfd_ptr, stash->debug_sections,
+				    stash->sec);
+      stash->sec_info_ptr = stash->info_ptr;
+    }
+
+  *unit_ptr = each;
+  return TRUE;
+}
+
+/* A row of a line table, for bfd_dwarf2_enumerate_lines.  END is set
+   for the last row of a sequence, which bfd_find_nearest_line takes as
+   its end whether or not it has the end_sequence flag.  */
+
+struct enumerate_line
+{
+  struct line_info *line;
+  bfd_boolean end;
+};
+
+/* Compare two rows by address.  The end of one sequence sorts before
+   the start of another at the same address.  */
+
+static int
+compare_enumerate_lines (const void *a, const void *b)
+{
+  const struct enumerate_line *l1 = (const struct enumerate_line *) a;
+  const struct enumerate_line *l2 = (const struct enumerate_line *) b;
+
+  if (l1->line->address < l2->line->address)
+    return -1;
+  if (l1->line->address > l2->line->address)
+    return 1;
+  if (l1->end != l2->end)
+    return l1->end ? -1 : 1;
+  if (l1->line->line < l2->line->line)
+    return -1;
+  if (l1->line->line > l2->line->line)
+    return 1;
+  return 0;
+}
+
+/* An address range of a function, for bfd_dwarf2_enumerate_lines.  */
+
+struct enumerate_func_range
+{
+  bfd_vma low;
+  bfd_vma high;
+  struct funcinfo *func;
+};
+
+/* Sort function ranges by start address, and ranges that start at the
+   same address outermost first.  */
+
+static int
+compare_enumerate_func_ranges (const void *a, const void *b)
+{
+  const struct enumerate_func_range *r1
+    = (const struct enumerate_func_range *) a;
+  const struct enumerate_func_range *r2
+    = (const struct enumerate_func_range *) b;
+
+  if (r1->low != r2->low)
+    return r1->low < r2->low ? -1 : 1;
+  if (r1->high != r2->high)
+    return r1->high > r2->high ? -1 : 1;
+  if (r1->func != r2->func)
+    return r1->func < r2->func ? -1 : 1;
+  return 0;
+}
+
+static int
+compare_vmas (const void *a, const void *b)
+{
+  bfd_vma l = *(const bfd_vma *) a;
+  bfd_vma r = *(const bfd_vma *) b;
+
+  return l < r ? -1 : l > r;
+}
+
+/* Return the name of the innermost of the sorted RANGES that contains
+   ADDR, or NULL.  ADDR must not decrease from one call to the next.
+   ACTIVE holds the indexes of the ranges that have started and may
+   not have ended, NUM_ACTIVE their number, and NEXT_RANGE the index of
+   the next range to start.  Inlined subroutines nest within their
+   callers, so once the ranges that ended are popped off, the top one
+   is the innermost.  */
+
+static const char *
+enumerate_lines_function (struct enumerate_func_range *ranges,
+			  bfd_size_type num_ranges, bfd_size_type *active,
+			  bfd_size_type *num_active, bfd_size_type *next_range,
+			  bfd_vma addr)
+{
+  while (*next_range < num_ranges && ranges[*next_range].low <= addr)
+    active[(*num_active)++] = (*next_range)++;
+  while (*num_active != 0 && ranges[active[*num_active - 1]].high <= addr)
+    (*num_active)--;
+  if (*num_active == 0)
+    return NULL;
+  return ranges[active[*num_active - 1]].func->name;
+}
+
+/* Call FUNC for each row of the DWARF 2 line number tables of ABFD, in
+   order of increasing address.  FUNC is passed the address, file name
+   and line number of the row, the name of the innermost function or
+   inlined subroutine whose range contains the address (or NULL if
+   there is none), whether the row is the last of a sequence of
+   instructions (in which case the address is one past the last
+   instruction, and there is no line information from there on), and
+   DATA.  FUNC may return FALSE to stop the
+   enumeration early.  SYMBOLS contains the symbol table for ABFD.
+
+   Where the innermost function changes between two rows, FUNC is also
+   called for the address of the change, with the file and line of the
+   row before it, so that every address at which the file, line or
+   function changes is passed.  The function name is that of the DWARF
+   function entry.  Unlike bfd_find_nearest_line, it is not replaced by
+   the name of the symbol at the start of the function when the entry
+   has no linkage name, nor by that of the symbol around the address
+   when no entry covers it.
+
+   A row is skipped when the next row of its sequence has the same
+   address, as bfd_find_nearest_line never returns it, so each address
+   is passed at most once per sequence; the line of an address is that
+   of the last row passed at or before it.  Sequences that overlap,
+   such as one nested within another, are passed interleaved, although
+   bfd_find_nearest_line only uses one of them.  Addresses are only
+   meaningful for final linked executables and shared libraries.
+   Returns FALSE if ABFD has no DWARF 2 line information or it could
+   not be read.  */
+
+bfd_boolean
+bfd_dwarf2_enumerate_lines (bfd *abfd, asymbol **symbols,
+			    bfd_boolean (*func) (bfd_vma, const char *,
+						 unsigned int, const char *,
+						 bfd_boolean, void *),
+			    void *data)
+{
+  void *local_info = NULL;
+  void **pinfo = &local_info;
+  struct dwarf2_debug *stash;
+  struct comp_unit *each;
+  struct enumerate_line *lines = NULL;
+  bfd_size_type num_lines = 0;
+  bfd_size_type max_lines = 0;
+  struct enumerate_func_range *ranges = NULL;
+  bfd_size_type num_ranges = 0;
+  bfd_size_type max_ranges = 0;
+  bfd_size_type *active = NULL;
+  bfd_size_type num_active = 0;
+  bfd_size_type next_range = 0;
+  bfd_vma *bounds = NULL;
+  bfd_size_type num_bounds = 0;
+  bfd_size_type i, j;
+  struct line_info *prev;
+  const char *prev_name;
+  bfd_boolean ret = FALSE;
+
+  /* For linked ELF files, share the stash used by bfd_find_nearest_line
+     so that units decoded here need not be decoded again by later
+     lookups.  Relocatable files would need their sections placed, and
+     that is undone again after each lookup.  */
+  if (bfd_get_flavour (abfd) == bfd_target_elf_flavour
+      && (abfd->flags & (EXEC_P | DYNAMIC)) != 0
+      && elf_tdata (abfd) != NULL)
+    pinfo = &elf_tdata (abfd)->dwarf2_find_line_info;
+
+  if (! _bfd_dwarf2_slurp_debug_info (abfd, NULL, dwarf_debug_sections,
+				      symbols, pinfo, FALSE))
+    goto out;
+
+  stash = (struct dwarf2_debug *) *pinfo;
+  if (! stash->info_ptr)
+    goto out;
+
+  /* Read all the remaining comp. units.  */
+  while (stash_read_next_comp_unit (stash, 4, &each))
+    ;
+
+  for (each = stash->all_comp_units; each; each = each->next_unit)
+    {
+      struct line_info_table *table;
+      struct funcinfo *fn;
+      unsigned int seq;
+
+      if (! comp_unit_maybe_decode_line_info (each, stash))
+	continue;
+
+      for (fn = each->function_table; fn != NULL; fn = fn->prev_func)
+	{
+	  struct arange *arange;
+
+	  if (fn->name == NULL)
+	    continue;
+	  for (arange = &fn->arange; arange != NULL; arange = arange->next)
+	    {
+	      if (arange->low >= arange->high)
+		continue;
+	      if (num_ranges == max_ranges)
+		{
+		  struct enumerate_func_range *tmp;
+
+		  max_ranges = max_ranges ? max_ranges * 2 : 256;
+		  tmp = (struct enumerate_func_range *)
+		    bfd_realloc (ranges, max_ranges * sizeof (*ranges));
+		  if (tmp == NULL)
+		    goto out;
+		  ranges = tmp;
+		}
+	      ranges[num_ranges].low = arange->low;
+	      ranges[num_ranges].high = arange->high;
+	      ranges[num_ranges].func = fn;
+	      num_ranges++;
+	    }
+	}
+
+      table = each->line_table;
+      for (seq = 0; seq < table->num_sequences; seq++)
+	{
+	  struct line_info *line;
+	  struct line_info *next = NULL;
+
+	  for (line = table->sequences[seq].last_line;
+	       line != NULL && line->address >= table->sequences[seq].low_pc;
+	       next = line, line = line->prev_line)
+	    {
+	      /* A row followed by another at the same address covers
+		 nothing, and the rows at the end address of the sequence
+		 only mark its end.  An end row need not be the last of
+		 the list, as add_line_info sorts a row at the same
+		 address after it and then continues the sequence.  */
+	      if (next != NULL && next->address == line->address)
+		continue;
+
+	      if (num_lines == max_lines)
+		{
+		  struct enumerate_line *tmp;
+
+		  max_lines = max_lines ? max_lines * 2 : 1024;
+		  tmp = (struct enumerate_line *)
+		    bfd_realloc (lines, max_lines * sizeof (*lines));
+		  if (tmp == NULL)
+		    goto out;
+		  lines = tmp;
+		}
+	      lines[num_lines].line = line;
+	      lines[num_lines].end = next == NULL || line->end_sequence;
+	      num_lines++;
+	    }
+	}
+    }
+
+  if (num_lines == 0)
+    goto out;
+
+  qsort (lines, num_lines, sizeof (*lines), compare_enumerate_lines);
+
+  /* The addresses at which a function range starts or ends are where
+     the innermost function may change between rows.  */
+  if (num_ranges != 0)
+    {
+      qsort (ranges, num_ranges, sizeof (*ranges),
+	     compare_enumerate_func_ranges);
+      active = (bfd_size_type *) bfd_malloc (num_ranges * sizeof (*active));
+      bounds = (bfd_vma *) bfd_malloc (2 * num_ranges * sizeof (*bounds));
+      if (active == NULL || bounds == NULL)
+	goto out;
+      for (i = 0; i < num_ranges; i++)
+	{
+	  bounds[2 * i] = ranges[i].low;
+	  bounds[2 * i + 1] = ranges[i].high;
+	}
+      qsort (bounds, 2 * num_ranges, sizeof (*bounds), compare_vmas);
+      for (i = j = 0; i < 2 * num_ranges; i++)
+	if (j == 0 || bounds[i] != bounds[j - 1])
+	  bounds[j++] = bounds[i];
+      num_bounds = j;
+    }
+
+  ret = TRUE;
+  prev = NULL;
+  prev_name = NULL;
+  for (i = j = 0; i < num_lines;)
+    {
+      struct line_info *line = lines[i].line;
+      const char *name;
+
+      if (j < num_bounds && bounds[j] < line->address)
+	{
+	  bfd_vma addr = bounds[j++];
+
+	  if (prev == NULL)
+	    continue;
+	  name = enumerate_lines_function (ranges, num_ranges, active,
+					   &num_active, &next_range, addr);
+	  if (name != prev_name)
+	    {
+	      if (! (*func) (addr, prev->filename, prev->line, name, FALSE,
+			     data))
+		break;
+	      prev_name = name;
+	    }
+	  continue;
+	}
+
+      if (j < num_bounds && bounds[j] == line->address)
+	j++;
+      name = enumerate_lines_function (ranges, num_ranges, active,
+				       &num_active, &next_range,
+				       line->address);
+      if (lines[i].end)
+	name = NULL;
+      if (! (*func) (line->address, line->filename, line->line, name,
+		     lines[i].end, data))
+	break;
+      prev = lines[i].end ? NULL : line;
+      i++;
+      prev_name = name;
+    }
+
+ out:
+  if (lines != NULL)
+    free (lines);
+  if (ranges != NULL)
+    free (ranges);
+  if (active != NULL)
+    free (active);
+  if (bounds != NULL)
+    free (bounds);
+  if (pinfo == &local_info)
+    _bfd_dwarf2_cleanup_debug_info (abfd, pinfo);
+  return ret;
+}
+
 /* Find the source code location of SYMBOL.  If SYMBOL is NULL
    then find the nearest source code location corresponding to
    the address SECTION + OFFSET.
@@ -4243,111 +4662,36 @@ _bfd_dwarf2_find_nearest_line (bfd *abfd,
   BFD_ASSERT (addr_size == 4 || addr_size == 8);
 
   /* Read each remaining comp. units checking each as they are read.  */
-  while (stash->info_ptr < stash->info_ptr_end)
+  while (stash_read_next_comp_unit (stash, addr_size, &each))
     {
-      bfd_vma length;
-      unsigned int offset_size = addr_size;
-      bfd_byte *info_ptr_unit = stash->info_ptr;
-
-      length = read_4_bytes (stash->bfd_ptr, stash->info_ptr, stash->info_ptr_end);
-      /* A 0xffffff length is the DWARF3 way of indicating
-	 we use 64-bit offsets, instead of 32-bit offsets.  */
-      if (length == 0xffffffff)
-	{
-	  offset_size = 8;
-	  length = read_8_bytes (stash->bfd_ptr, stash->info_ptr + 4, stash->info_ptr_end);
-	  stash->info_ptr += 12;
-	}
-      /* A zero length is the IRIX way of indicating 64-bit offsets,
-	 mostly because the 64-bit length will generally fit in 32
-	 bits, and the endianness helps.  */
-      else if (length == 0)
-	{
-	  offset_size = 8;
-	  length = read_4_bytes (stash->bfd_ptr, stash->info_ptr + 4, stash->info_ptr_end);
-	  stash->info_ptr += 8;
-	}
-      /* In the absence of the hints above, we assume 32-bit DWARF2
-	 offsets even for targets with 64-bit addresses, because:
-	   a) most of the time these targets will not have generated
-	      more than 2Gb of debug info and so will not need 64-bit
-	      offsets,
-	 and
-	   b) if they do use 64-bit offsets but they are not using
-	      the size hints that are tested for above then they are
-	      not conforming to the DWARF3 standard anyway.  */
-      else if (addr_size == 8)
-	{
-	  offset_size = 4;
-	  stash->info_ptr += 4;
-	}
+      if (each == NULL)
+	continue;
+
+      /* DW_AT_low_pc and DW_AT_high_pc are optional for
+	 compilation units.  If we don't have them (i.e.,
+	 unit->high == 0), we need to consult the line info table
+	 to see if a compilation unit contains the given
+	 address.  */
+      if (do_line)
+	found = (((symbol->flags & BSF_FUNCTION) == 0
+		  || each->arange.high == 0
+		  || comp_unit_contains_address (each, addr))
+		 && comp_unit_find_line (each, symbol, addr,
+					 filename_ptr,
+					 linenumber_ptr,
+					 stash));
       else
-	stash->info_ptr += 4;
-
-      if (length > 0)
-	{
-	  bfd_byte * new_ptr;
-
-	  each = parse_comp_unit (stash, length, info_ptr_unit,
-				  offset_size);
-	  if (!each)
-	    /* The dwarf information is damaged, don't trust it any
-	       more.  */
-	    break;
-
-	  new_ptr = stash->info_ptr + length;
-	  /* PR 17512: file: 1500698c.  */
-	  if (new_ptr < stash->info_ptr)
-	    {
-	      /* A corrupt length value - do not trust the info any more.  */
-	      found = FALSE;
-	      break;
-	    }
-	  else
-	    stash->info_ptr = new_ptr;
-
-	  if (stash->all_comp_units)
-	    stash->all_comp_units->prev_unit = each;
-	  else
-	    stash->last_comp_unit = each;
-
-	  each->next_unit = stash->all_comp_units;
-	  stash->all_comp_units = each;
-
-	  /* DW_AT_low_pc and DW_AT_high_pc are optional for
-	     compilation units.  If we don't have them (i.e.,
-	     unit->high == 0), we need to consult the line info table
-	     to see if a compilation unit contains the given
-	     address.  */
-	  if (do_line)
-	    found = (((symbol->flags & BSF_FUNCTION) == 0
-		      || each->arange.high == 0
-		      || comp_unit_contains_address (each, addr))
-		     && comp_unit_find_line (each, symbol, addr,
-					     filename_ptr,
-					     linenumber_ptr,
-					     stash));
-	  else
-	    found = ((each->arange.high == 0
-		      || comp_unit_contains_address (each, addr))
-		     && comp_unit_find_nearest_line (each, addr,
-						     filename_ptr,
-						     &function,
-						     linenumber_ptr,
-						     discriminator_ptr,
-						     stash) != 0);
-
-	  if ((bfd_vma) (stash->info_ptr - stash->sec_info_ptr)
-	      == stash->sec->size)
-	    {
-	      stash->sec = find_debug_info (stash->bfd_ptr, debug_sections,
-					    stash->sec);
-	      stash->sec_info_ptr = stash->info_ptr;
-	    }
-
-	  if (found)
-	    goto done;
-	}
+	found = ((each->arange.high == 0
+		  || comp_unit_contains_address (each, addr))
+		 && comp_unit_find_nearest_line (each, addr,
+						 filename_ptr,
+						 &function,
+						 linenumber_ptr,
+						 discriminator_ptr,
+						 stash) != 0);
+
+      if (found)
+	goto done;
     }
 
  done:
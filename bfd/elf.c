@@ -383,9 +383,11 @@ bfd_elf_get_elf_syms (bfd *ibfd,
 {
   Elf_Internal_Shdr *shndx_hdr;
   void *alloc_ext;
+  const bfd_byte *extsyms;
   const bfd_byte *esym;
   Elf_External_Sym_Shndx *alloc_extshndx;
-  Elf_External_Sym_Shndx *shndx;
+  const Elf_External_Sym_Shndx *extshndxs;
+  const Elf_External_Sym_Shndx *shndx;
   Elf_Internal_Sym *alloc_intsym;
   Elf_Internal_Sym *isym;
   Elf_Internal_Sym *isymend;
@@ -439,37 +441,53 @@ bfd_elf_get_elf_syms (bfd *ibfd,
   extsym_size = bed->s->sizeof_sym;
   amt = (bfd_size_type) symcount * extsym_size;
   pos = symtab_hdr->sh_offset + symoffset * extsym_size;
+
+  /* If the file is mapped and the caller does not want the external
+     symbols, convert them straight from the mapping.  */
+  extsyms = NULL;
   if (extsym_buf == NULL)
+    extsyms = _bfd_get_file_view (ibfd, pos, amt);
+  if (extsyms == NULL)
     {
-      alloc_ext = bfd_malloc2 (symcount, extsym_size);
-      extsym_buf = alloc_ext;
-    }
-  if (extsym_buf == NULL
-      || bfd_seek (ibfd, pos, SEEK_SET) != 0
-      || bfd_bread (extsym_buf, amt, ibfd) != amt)
-    {
-      intsym_buf = NULL;
-      goto out;
+      if (extsym_buf == NULL)
+	{
+	  alloc_ext = bfd_malloc2 (symcount, extsym_size);
+	  extsym_buf = alloc_ext;
+	}
+      if (extsym_buf == NULL
+	  || bfd_seek (ibfd, pos, SEEK_SET) != 0
+	  || bfd_bread (extsym_buf, amt, ibfd) != amt)
+	{
+	  intsym_buf = NULL;
+	  goto out;
+	}
+      extsyms = (const bfd_byte *) extsym_buf;
     }
 
-  if (shndx_hdr == NULL || shndx_hdr->sh_size == 0)
-    extshndx_buf = NULL;
-  else
+  extshndxs = NULL;
+  if (shndx_hdr != NULL && shndx_hdr->sh_size != 0)
     {
       amt = (bfd_size_type) symcount * sizeof (Elf_External_Sym_Shndx);
       pos = shndx_hdr->sh_offset + symoffset * sizeof (Elf_External_Sym_Shndx);
       if (extshndx_buf == NULL)
+	extshndxs = ((const Elf_External_Sym_Shndx *)
+		     _bfd_get_file_view (ibfd, pos, amt));
+      if (extshndxs == NULL)
 	{
-	  alloc_extshndx = (Elf_External_Sym_Shndx *)
-              bfd_malloc2 (symcount, sizeof (Elf_External_Sym_Shndx));
-	  extshndx_buf = alloc_extshndx;
-	}
-      if (extshndx_buf == NULL
-	  || bfd_seek (ibfd, pos, SEEK_SET) != 0
-	  || bfd_bread (extshndx_buf, amt, ibfd) != amt)
-	{
-	  intsym_buf = NULL;
-	  goto out;
+	  if (extshndx_buf == NULL)
+	    {
+	      alloc_extshndx = (Elf_External_Sym_Shndx *)
+		bfd_malloc2 (symcount, sizeof (Elf_External_Sym_Shndx));
+	      extshndx_buf = alloc_extshndx;
+	    }
+	  if (extshndx_buf == NULL
+	      || bfd_seek (ibfd, pos, SEEK_SET) != 0
+	      || bfd_bread (extshndx_buf, amt, ibfd) != amt)
+	    {
+	      intsym_buf = NULL;
+	      goto out;
+	    }
+	  extshndxs = extshndx_buf;
 	}
     }
 
@@ -484,13 +502,12 @@ bfd_elf_get_elf_syms (bfd *ibfd,
 
   /* Convert the symbols to internal form.  */
   isymend = intsym_buf + symcount;
-  for (esym = (const bfd_byte *) extsym_buf, isym = intsym_buf,
-           shndx = extshndx_buf;
+  for (esym = extsyms, isym = intsym_buf, shndx = extshndxs;
        isym < isymend;
        esym += extsym_size, isym++, shndx = shndx != NULL ? shndx + 1 : NULL)
     if (!(*bed->s->swap_symbol_in) (ibfd, esym, shndx, isym))
       {
-	symoffset += (esym - (bfd_byte *) extsym_buf) / extsym_size;
+	symoffset += (esym - extsyms) / extsym_size;
 	/* xgettext:c-format */
 	_bfd_error_handler (_("%B symbol number %lu references "
 			      "nonexistent SHT_SYMTAB_SHNDX section"),
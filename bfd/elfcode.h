@@ -1392,22 +1392,28 @@ elf_slurp_reloc_table_from_section (bfd *abfd,
 {
   const struct elf_backend_data * const ebd = get_elf_backend_data (abfd);
   void *allocated = NULL;
-  bfd_byte *native_relocs;
+  const bfd_byte *native_relocs;
   arelent *relent;
   unsigned int i;
   int entsize;
   unsigned int symcount;
 
-  allocated = bfd_malloc (rel_hdr->sh_size);
-  if (allocated == NULL)
-    goto error_return;
+  /* Convert straight from the file if it is mapped.  */
+  native_relocs = _bfd_get_file_view (abfd, rel_hdr->sh_offset,
+				      rel_hdr->sh_size);
+  if (native_relocs == NULL)
+    {
+      allocated = bfd_malloc (rel_hdr->sh_size);
+      if (allocated == NULL)
+	goto error_return;
 
-  if (bfd_seek (abfd, rel_hdr->sh_offset, SEEK_SET) != 0
-      || (bfd_bread (allocated, rel_hdr->sh_size, abfd)
-	  != rel_hdr->sh_size))
-    goto error_return;
+      if (bfd_seek (abfd, rel_hdr->sh_offset, SEEK_SET) != 0
+	  || (bfd_bread (allocated, rel_hdr->sh_size, abfd)
+	      != rel_hdr->sh_size))
+	goto error_return;
 
-  native_relocs = (bfd_byte *) allocated;
+      native_relocs = (const bfd_byte *) allocated;
+    }
 
   entsize = rel_hdr->sh_entsize;
   BFD_ASSERT (entsize == sizeof (Elf_External_Rel)
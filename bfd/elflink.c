@@ -2296,7 +2296,8 @@ _bfd_elf_link_assign_sym_version (struct elf_link_hash_entry *h, void *data)
    translated into RELA relocations and stored in INTERNAL_RELOCS,
    which should have already been allocated to contain enough space.
    The EXTERNAL_RELOCS are a buffer where the external form of the
-   relocations should be stored.
+   relocations should be stored, or NULL if the file is mapped and
+   they can be read from there.
 
    Returns FALSE if something goes wrong.  */
 
@@ -2315,13 +2316,25 @@ elf_link_read_relocs_from_section (bfd *abfd,
   Elf_Internal_Shdr *symtab_hdr;
   size_t nsyms;
 
-  /* Position ourselves at the start of the section.  */
-  if (bfd_seek (abfd, shdr->sh_offset, SEEK_SET) != 0)
-    return FALSE;
+  if (external_relocs == NULL)
+    {
+      /* Use the relocations in the mapped file.  */
+      erela = _bfd_get_file_view (abfd, shdr->sh_offset, shdr->sh_size);
+      if (erela == NULL)
+	return FALSE;
+    }
+  else
+    {
+      /* Position ourselves at the start of the section.  */
+      if (bfd_seek (abfd, shdr->sh_offset, SEEK_SET) != 0)
+	return FALSE;
 
-  /* Read the relocations.  */
-  if (bfd_bread (external_relocs, shdr->sh_size, abfd) != shdr->sh_size)
-    return FALSE;
+      /* Read the relocations.  */
+      if (bfd_bread (external_relocs, shdr->sh_size, abfd) != shdr->sh_size)
+	return FALSE;
+
+      erela = (const bfd_byte *) external_relocs;
+    }
 
   symtab_hdr = &elf_tdata (abfd)->symtab_hdr;
   nsyms = NUM_SHDR_ENTRIES (symtab_hdr);
@@ -2339,7 +2352,6 @@ elf_link_read_relocs_from_section (bfd *abfd,
       return FALSE;
     }
 
-  erela = (const bfd_byte *) external_relocs;
   erelaend = erela + shdr->sh_size;
   irela = internal_relocs;
   while (erela < erelaend)
@@ -2382,6 +2394,17 @@ elf_link_read_relocs_from_section (bfd *abfd,
   return TRUE;
 }
 
+/* Return TRUE if there are no relocations in SHDR, which may be
+   NULL, or if they can be read from the mapping of ABFD's file.  */
+
+static bfd_boolean
+elf_link_relocs_mapped_p (bfd *abfd, Elf_Internal_Shdr *shdr)
+{
+  return (shdr == NULL
+	  || _bfd_get_file_view (abfd, shdr->sh_offset,
+				 shdr->sh_size) != NULL);
+}
+
 /* Read and swap the relocs for a section O.  They may have been
    cached.  If the EXTERNAL_RELOCS and INTERNAL_RELOCS arguments are
    not NULL, they are used as buffers to read into.  They are known to
@@ -2425,7 +2448,9 @@ _bfd_elf_link_read_relocs (bfd *abfd,
 	goto error_return;
     }
 
-  if (external_relocs == NULL)
+  if (external_relocs == NULL
+      && (!elf_link_relocs_mapped_p (abfd, esdo->rel.hdr)
+	  || !elf_link_relocs_mapped_p (abfd, esdo->rela.hdr)))
     {
       bfd_size_type size = 0;
 
@@ -2447,8 +2472,9 @@ _bfd_elf_link_read_relocs (bfd *abfd,
 					      external_relocs,
 					      internal_relocs))
 	goto error_return;
-      external_relocs = (((bfd_byte *) external_relocs)
-			 + esdo->rel.hdr->sh_size);
+      if (external_relocs != NULL)
+	external_relocs = (((bfd_byte *) external_relocs)
+			   + esdo->rel.hdr->sh_size);
       internal_rela_relocs += (NUM_SHDR_ENTRIES (esdo->rel.hdr)
 			       * bed->s->int_rels_per_ext_rel);
     }
@@ -46,10 +46,100 @@ SUBSECTION
 #include "sysdep.h"
 #include "bfd.h"
 #include "libbfd.h"
+#include "elf-bfd.h"
 
 /* IMPORT from targets.c.  */
 extern const size_t _bfd_target_vector_entries;
 
+/* The start of the file being recognized, read once so that targets
+   which cannot possibly match it are skipped without being asked.
+   SIZE is -1 when the probe could not be read; nothing is skipped
+   then, and every target sees the error for itself.  */
+
+struct format_probe
+{
+  bfd_byte buf[sizeof (Elf64_External_Ehdr)];
+  bfd_signed_vma size;
+};
+
+static void
+format_probe_read (bfd *abfd, struct format_probe *probe)
+{
+  bfd_error_type save_error = bfd_get_error ();
+
+  probe->size = -1;
+  if (bfd_seek (abfd, (file_ptr) 0, SEEK_SET) == 0)
+    probe->size = bfd_bread (probe->buf, sizeof (probe->buf), abfd);
+  bfd_set_error (save_error);
+}
+
+/* Return TRUE if TARGET is an ELF target whose object_p is sure to
+   fail with bfd_error_wrong_format on the file described by PROBE.
+   The tests are the header checks elf_object_p makes before it looks
+   any further, so skipping TARGET does not change the outcome.  */
+
+static bfd_boolean
+format_probe_excludes (const struct format_probe *probe,
+		       const bfd_target *target)
+{
+  const struct elf_backend_data *ebd;
+  const bfd_byte *e_ident = probe->buf;
+  unsigned int ehdr_size, elf_class, arch_size;
+  int machine;
+
+  if (probe->size < 0)
+    return FALSE;
+
+  if (target->_bfd_check_format[bfd_object] == bfd_elf32_object_p)
+    {
+      ehdr_size = sizeof (Elf32_External_Ehdr);
+      elf_class = ELFCLASS32;
+      arch_size = 32;
+    }
+#ifdef BFD64
+  else if (target->_bfd_check_format[bfd_object] == bfd_elf64_object_p)
+    {
+      ehdr_size = sizeof (Elf64_External_Ehdr);
+      elf_class = ELFCLASS64;
+      arch_size = 64;
+    }
+#endif
+  else
+    return FALSE;
+
+  ebd = (const struct elf_backend_data *) target->backend_data;
+  if ((bfd_size_type) probe->size < ehdr_size
+      || e_ident[EI_MAG0] != ELFMAG0
+      || e_ident[EI_MAG1] != ELFMAG1
+      || e_ident[EI_MAG2] != ELFMAG2
+      || e_ident[EI_MAG3] != ELFMAG3
+      || e_ident[EI_VERSION] != EV_CURRENT
+      || e_ident[EI_CLASS] != elf_class
+      || ebd->s->arch_size != arch_size)
+    return TRUE;
+
+  switch (e_ident[EI_DATA])
+    {
+    case ELFDATA2MSB:
+      if (target->header_byteorder != BFD_ENDIAN_BIG)
+	return TRUE;
+      machine = bfd_getb16 (probe->buf + 18);
+      break;
+    case ELFDATA2LSB:
+      if (target->header_byteorder != BFD_ENDIAN_LITTLE)
+	return TRUE;
+      machine = bfd_getl16 (probe->buf + 18);
+      break;
+    default:
+      return TRUE;
+    }
+
+  return (ebd->elf_machine_code != EM_NONE
+	  && machine != ebd->elf_machine_code
+	  && (ebd->elf_machine_alt1 == 0 || machine != ebd->elf_machine_alt1)
+	  && (ebd->elf_machine_alt2 == 0 || machine != ebd->elf_machine_alt2));
+}
+
 /*
 FUNCTION
 	bfd_check_format
@@ -215,6 +305,7 @@ bfd_check_format_matches (bfd *abfd, bfd_format format, char ***matching)
   int match_count, best_count, best_match;
   int ar_match_index;
   struct bfd_preserve preserve;
+  struct format_probe probe;
 
   if (matching != NULL)
     *matching = NULL;
@@ -281,6 +372,10 @@ bfd_check_format_matches (bfd *abfd, bfd_format format, char ***matching)
   match_count = 0;
   ar_match_index = _bfd_target_vector_entries;
 
+  probe.size = -1;
+  if (format == bfd_object)
+    format_probe_read (abfd, &probe);
+
   for (target = bfd_target_vector; *target != NULL; target++)
     {
       const bfd_target *temp;
@@ -288,7 +383,8 @@ bfd_check_format_matches (bfd *abfd, bfd_format format, char ***matching)
       /* Don't check the default target twice.  */
       if (*target == &binary_vec
 	  || (!abfd->target_defaulted && *target == save_targ)
-	  || (*target)->match_priority > best_match)
+	  || (*target)->match_priority > best_match
+	  || format_probe_excludes (&probe, *target))
 	continue;
 
       /* If we already tried a match, the bfd is modified and may
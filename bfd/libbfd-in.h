@@ -177,6 +177,11 @@ bfd * _bfd_new_bfd
   (void);
 bfd_boolean _bfd_free_cached_info
   (bfd *);
+void _bfd_free_demangle_cache
+  (bfd *);
+
+void _bfd_free_decompress_cache
+  (bfd *);
 
 bfd_boolean bfd_false
   (bfd *ignore);
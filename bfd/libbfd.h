@@ -182,6 +182,11 @@ bfd * _bfd_new_bfd
   (void);
 bfd_boolean _bfd_free_cached_info
   (bfd *);
+void _bfd_free_demangle_cache
+  (bfd *);
+
+void _bfd_free_decompress_cache
+  (bfd *);
 
 bfd_boolean bfd_false
   (bfd *ignore);
@@ -897,6 +902,11 @@ struct bfd_iovec
                   void **map_addr, bfd_size_type *map_len);
 };
 extern const struct bfd_iovec _bfd_memory_iovec;
+const bfd_byte *_bfd_get_file_view
+   (bfd *abfd, file_ptr offset, bfd_size_type size);
+
+void _bfd_unmap_file (bfd *abfd);
+
 /* Extracted from bfdwin.c.  */
 struct _bfd_window_internal {
   struct _bfd_window_internal *next;
@@ -120,6 +120,9 @@ _bfd_new_bfd_contained_in (bfd *obfd)
 static void
 _bfd_delete_bfd (bfd *abfd)
 {
+  _bfd_free_demangle_cache (abfd);
+  _bfd_free_decompress_cache (abfd);
+  _bfd_unmap_file (abfd);
   if (abfd->memory)
     {
       bfd_hash_table_free (&abfd->section_htab);
@@ -137,6 +140,10 @@ _bfd_delete_bfd (bfd *abfd)
 bfd_boolean
 _bfd_free_cached_info (bfd *abfd)
 {
+  /* The cache is keyed on symbols, which are about to go.  */
+  _bfd_free_demangle_cache (abfd);
+  /* And this one on sections.  */
+  _bfd_free_decompress_cache (abfd);
   if (abfd->memory)
     {
       bfd_hash_table_free (&abfd->section_htab);
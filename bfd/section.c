@@ -2789,6 +2789,69 @@ bfd_malloc_and_get_section (bfd *abfd, sec_ptr sec, bfd_byte **buf)
   *buf = NULL;
   return bfd_get_full_section_contents (abfd, sec, buf);
 }
+
+/*
+FUNCTION
+	bfd_get_section_contents_view
+
+SYNOPSIS
+	bfd_boolean bfd_get_section_contents_view
+	  (bfd *abfd, asection *section, const bfd_byte **view);
+
+DESCRIPTION
+	Point *@var{view} at the contents of @var{section} in BFD
+	@var{abfd}, as <<bfd_malloc_and_get_section>> would read
+	them, and return TRUE, if they are available without a copy:
+	cached in the section, or in the mapping of a file opened with
+	<<BFD_MMAP>>.  The contents must not be modified through
+	@var{view}, which stays valid until the BFD is closed or the
+	section contents are changed.
+
+	Otherwise, for instance for a compressed or empty section,
+	return FALSE without setting <<bfd_error>>; the caller should
+	then read the contents with <<bfd_malloc_and_get_section>>.
+*/
+
+bfd_boolean
+bfd_get_section_contents_view (bfd *abfd, sec_ptr section,
+			       const bfd_byte **view)
+{
+  bfd_size_type sz;
+
+  *view = NULL;
+
+  if (abfd->direction != write_direction && section->rawsize != 0)
+    sz = section->rawsize;
+  else
+    sz = section->size;
+
+  if (sz == 0
+      || (section->flags & SEC_CONSTRUCTOR) != 0
+      || (section->flags & SEC_HAS_CONTENTS) == 0
+      || section->compress_status != COMPRESS_SECTION_NONE)
+    return FALSE;
+
+  /* Encrypted code goes through the decryption in
+     bfd_get_section_contents.  */
+  if ((section->flags & SEC_CODE) != 0
+      && (abfd->flags & BFD_ENCRYPTED) != 0)
+    return FALSE;
+
+  if ((section->flags & SEC_IN_MEMORY) != 0)
+    {
+      *view = section->contents;
+      return *view != NULL;
+    }
+
+  /* Targets with their own way of reading section contents may not
+     return the bytes at FILEPOS.  */
+  if (abfd->xvec->_bfd_get_section_contents
+      != _bfd_generic_get_section_contents)
+    return FALSE;
+
+  *view = _bfd_get_file_view (abfd, section->filepos, sz);
+  return *view != NULL;
+}
 /*
 FUNCTION
 	bfd_copy_private_section_data
@@ -160,6 +160,7 @@ static int show_version = 0;	/* Show the version number.  */
 static int show_stats = 0;	/* Show statistics.  */
 static int show_synthetic = 0;	/* Display synthesized symbols too.  */
 static int line_numbers = 0;	/* Print line numbers for symbols.  */
+static int use_mmap = 0;	/* Read the files through a mapping.  */
 static int allow_special_symbols = 0;  /* Allow special symbols.  */
 static int with_symbol_versions = 0; /* Include symbol version information in the output.  */
 
@@ -208,6 +209,7 @@ static struct option long_options[] =
   {"format", required_argument, 0, 'f'},
   {"help", no_argument, 0, 'h'},
   {"line-numbers", no_argument, 0, 'l'},
+  {"mmap", no_argument, &use_mmap, 1},
   {"no-cplus", no_argument, &do_demangle, 0},  /* Linux compatibility.  */
   {"no-demangle", no_argument, &do_demangle, 0},
   {"no-sort", no_argument, 0, 'p'},
@@ -255,6 +257,7 @@ usage (FILE *stream, int status)
   -g, --extern-only      Display only external symbols\n\
   -l, --line-numbers     Use debugging information to find a filename and\n\
                            line number for each symbol\n\
+      --mmap             Read the files through a mapping of their contents\n\
   -n, --numeric-sort     Sort symbols numerically by address\n\
   -o                     Same as -A\n\
   -p, --no-sort          Do not sort the symbols\n\
@@ -1308,6 +1311,9 @@ display_file (char *filename)
   if (line_numbers)
     file->flags |= BFD_DECOMPRESS;
 
+  if (use_mmap)
+    file->flags |= BFD_MMAP;
+
   if (bfd_check_format (file, bfd_archive))
     {
       display_archive (file);
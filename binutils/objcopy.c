@@ -217,7 +217,8 @@ static enum
   compress_zlib = compress | 1 << 1,
   compress_gnu_zlib = compress | 1 << 2,
   compress_gabi_zlib = compress | 1 << 3,
-  decompress = 1 << 4
+  decompress = 1 << 4,
+  compress_chunked_zlib = compress | 1 << 5
 } do_debug_sections = nothing;
 
 /* Whether to generate ELF common symbols with the STT_COMMON type.  */
@@ -629,7 +630,7 @@ copy_usage (FILE *stream, int exit_status)
                                    <commit>\n\
      --subsystem <name>[:<version>]\n\
                                    Set PE subsystem to <name> [& <version>]\n\
-     --compress-debug-sections[={none|zlib|zlib-gnu|zlib-gabi}]\n\
+     --compress-debug-sections[={none|zlib|zlib-gnu|zlib-gabi|zlib-chunked}]\n\
                                    Compress DWARF debug sections using zlib\n\
      --decompress-debug-sections   Decompress DWARF debug sections using zlib\n\
      --elf-stt-common=[yes|no]     Generate ELF common symbols with STT_COMMON\n\
@@ -1864,7 +1865,7 @@ copy_object (bfd *ibfd, bfd *obfd, const bfd_arch_info_type *input_arch)
       if ((do_debug_sections & compress) != 0
 	  && do_debug_sections != compress)
 	{
-	  non_fatal (_("--compress-debug-sections=[zlib|zlib-gnu|zlib-gabi] is unsupported on `%s'"),
+	  non_fatal (_("--compress-debug-sections=[zlib|zlib-gnu|zlib-gabi|zlib-chunked] is unsupported on `%s'"),
 		     bfd_get_archive_filename (ibfd));
 	  return FALSE;
 	}
@@ -2803,11 +2804,14 @@ copy_file (const char *input_filename, const char *output_filename,
     case compress_zlib:
     case compress_gnu_zlib:
     case compress_gabi_zlib:
+    case compress_chunked_zlib:
       ibfd->flags |= BFD_COMPRESS;
       /* Don't check if input is ELF here since this information is
 	 only available after bfd_check_format_matches is called.  */
       if (do_debug_sections != compress_gnu_zlib)
 	ibfd->flags |= BFD_COMPRESS_GABI;
+      if (do_debug_sections == compress_chunked_zlib)
+	ibfd->flags |= BFD_COMPRESS_CHUNKED;
       break;
     case decompress:
       ibfd->flags |= BFD_DECOMPRESS;
@@ -4345,6 +4349,8 @@ copy_main (int argc, char *argv[])
 		do_debug_sections = compress_gnu_zlib;
 	      else if (strcasecmp (optarg, "zlib-gabi") == 0)
 		do_debug_sections = compress_gabi_zlib;
+	      else if (strcasecmp (optarg, "zlib-chunked") == 0)
+		do_debug_sections = compress_chunked_zlib;
 	      else
 		fatal (_("unrecognized --compress-debug-sections type `%s'"),
 		       optarg);
@@ -86,6 +86,7 @@ static char *default_target = NULL;	/* Default at runtime.  */
    command line.  */
 static int show_version = 0;		/* Show the version number.  */
 static int dump_section_contents;	/* -s */
+static int decompressed_dumps;		/* -Z */
 static int dump_section_headers;	/* -h */
 static bfd_boolean dump_file_header;	/* -f */
 static int dump_symtab;			/* -t */
@@ -116,6 +117,7 @@ static int suppress_bfd_header;
 static int dump_special_syms = 0;	/* --special-syms */
 static bfd_vma adjust_section_vma = 0;	/* --adjust-vma */
 static int file_start_context = 0;      /* --file-start-context */
+static int use_mmap = 0;		/* --mmap */
 static bfd_boolean display_file_offsets;/* -F */
 static const char *prefix;		/* --prefix */
 static int prefix_strip;		/* --prefix-strip */
@@ -213,6 +215,7 @@ usage (FILE *stream, int status)
   -D, --disassemble-all    Display assembler contents of all sections\n\
   -S, --source             Intermix source code with disassembly\n\
   -s, --full-contents      Display the full contents of all sections requested\n\
+  -Z, --decompress         Decompress section(s) before displaying their contents\n\
   -g, --debugging          Display debug information in object file\n\
   -e, --debugging-tags     Display debug information using ctags style\n\
   -G, --stabs              Display (in raw form) any STABS info in the file\n\
@@ -247,6 +250,7 @@ usage (FILE *stream, int status)
   -I, --include=DIR              Add DIR to search list for source files\n\
   -l, --line-numbers             Include line numbers and filenames in output\n\
   -F, --file-offsets             Include file offsets when displaying information\n\
+      --mmap                     Read the files through a mapping of their contents\n\
   -C, --demangle[=STYLE]         Decode mangled/processed symbol names\n\
                                   The STYLE, if specified, can be `auto', `gnu',\n\
                                   `lucid', `arm', `hp', `edg', `gnu-v3', `java'\n\
@@ -313,6 +317,7 @@ static struct option long_options[]=
   {"archive-headers", no_argument, NULL, 'a'},
   {"debugging", no_argument, NULL, 'g'},
   {"debugging-tags", no_argument, NULL, 'e'},
+  {"decompress", no_argument, NULL, 'Z'},
   {"demangle", optional_argument, NULL, 'C'},
   {"disassemble", no_argument, NULL, 'd'},
   {"disassemble-all", no_argument, NULL, 'D'},
@@ -329,6 +334,7 @@ static struct option long_options[]=
   {"help", no_argument, NULL, 'H'},
   {"info", no_argument, NULL, 'i'},
   {"line-numbers", no_argument, NULL, 'l'},
+  {"mmap", no_argument, &use_mmap, 1},
   {"no-show-raw-insn", no_argument, &show_raw_insn, -1},
   {"prefix-addresses", no_argument, &prefix_addresses, 1},
   {"reloc", no_argument, NULL, 'r'},
@@ -838,18 +844,18 @@ static void
 objdump_print_symname (bfd *abfd, struct disassemble_info *inf,
 		       asymbol *sym)
 {
-  char *alloc;
   const char *name, *version_string = NULL;
   bfd_boolean hidden = FALSE;
 
-  alloc = NULL;
   name = bfd_asymbol_name (sym);
   if (do_demangle && name[0] != '\0')
     {
-      /* Demangle the name.  */
-      alloc = bfd_demangle (abfd, name, DMGL_ANSI | DMGL_PARAMS);
-      if (alloc != NULL)
-	name = alloc;
+      /* Demangle the name.  Disassembly prints the same symbols over
+	 and over, so let BFD remember the result.  */
+      const char *demangled
+	= bfd_demangle_symbol (abfd, sym, DMGL_ANSI | DMGL_PARAMS);
+      if (demangled != NULL)
+	name = demangled;
     }
 
   if ((sym->flags & BSF_SYNTHETIC) == 0)
@@ -871,9 +877,6 @@ objdump_print_symname (bfd *abfd, struct disassemble_info *inf,
       if (version_string && *version_string != '\0')
 	printf (hidden ? "@%s" : "@@%s", version_string);
     }
-
-  if (alloc != NULL)
-    free (alloc);
 }
 
 /* Locate a symbol given a bfd and a section (from INFO->application_data),
@@ -2028,6 +2031,8 @@ disassemble_section (bfd *abfd, asection *section, void *inf)
   struct objdump_disasm_info * paux;
   unsigned int                 opb = pinfo->octets_per_byte;
   bfd_byte *                   data = NULL;
+  bfd_byte *                   alloc = NULL;
+  const bfd_byte *             view;
   bfd_size_type                datasize = 0;
   arelent **                   rel_pp = NULL;
   arelent **                   rel_ppstart = NULL;
@@ -2115,9 +2120,16 @@ disassemble_section (bfd *abfd, asection *section, void *inf)
     }
   rel_ppend = rel_pp + rel_count;
 
-  data = (bfd_byte *) xmalloc (datasize);
-
-  bfd_get_section_contents (abfd, section, data, 0, datasize);
+  /* The disassemblers only read the buffer, so they can be given
+     the contents in place if the file is mapped.  */
+  if (bfd_get_section_contents_view (abfd, section, &view)
+      && (section->rawsize == 0 || section->rawsize >= datasize))
+    data = (bfd_byte *) view;
+  else
+    {
+      data = alloc = (bfd_byte *) xmalloc (datasize);
+      bfd_get_section_contents (abfd, section, data, 0, datasize);
+    }
 
   paux->sec = section;
   pinfo->buffer = data;
@@ -2252,7 +2264,7 @@ disassemble_section (bfd *abfd, asection *section, void *inf)
       sym = nextsym;
     }
 
-  free (data);
+  free (alloc);
 
   if (rel_ppstart != NULL)
     free (rel_ppstart);
@@ -2915,8 +2927,11 @@ dump_target_specific (bfd *abfd)
 static void
 dump_section (bfd *abfd, asection *section, void *dummy ATTRIBUTE_UNUSED)
 {
-  bfd_byte *data = 0;
+  const bfd_byte *data;
+  bfd_byte *alloc = NULL;
   bfd_size_type datasize;
+  /* The offset in the section of DATA[0].  */
+  bfd_size_type data_start = 0;
   bfd_vma addr_offset;
   bfd_vma start_offset;
   bfd_vma stop_offset;
@@ -2965,11 +2980,32 @@ dump_section (bfd *abfd, asection *section, void *dummy ATTRIBUTE_UNUSED)
 	    (unsigned long) (section->filepos + start_offset));
   printf ("\n");
 
-  if (!bfd_get_full_section_contents (abfd, section, &data))
+  if (section->compress_status == DECOMPRESS_SECTION_SIZED)
     {
-      non_fatal (_("Reading section %s failed because: %s"),
-		 section->name, bfd_errmsg (bfd_get_error ()));
-      return;
+      /* Only decompress the part of the section we display.  */
+      bfd_size_type count = (stop_offset - start_offset) * opb;
+
+      data_start = start_offset * opb;
+      alloc = (bfd_byte *) xmalloc (count);
+      if (!bfd_get_decompressed_section_contents (abfd, section, alloc,
+						  data_start, count))
+	{
+	  non_fatal (_("Reading section %s failed because: %s"),
+		     section->name, bfd_errmsg (bfd_get_error ()));
+	  free (alloc);
+	  return;
+	}
+      data = alloc;
+    }
+  else if (!bfd_get_section_contents_view (abfd, section, &data))
+    {
+      if (!bfd_get_full_section_contents (abfd, section, &alloc))
+	{
+	  non_fatal (_("Reading section %s failed because: %s"),
+		     section->name, bfd_errmsg (bfd_get_error ()));
+	  return;
+	}
+      data = alloc;
     }
 
   width = 4;
@@ -3019,7 +3055,7 @@ dump_section (bfd *abfd, asection *section, void *dummy ATTRIBUTE_UNUSED)
 	   j < addr_offset * opb + onaline; j++)
 	{
 	  if (j < stop_offset * opb)
-	    printf ("%02x", (unsigned) (data[j]));
+	    printf ("%02x", (unsigned) (data[j - data_start]));
 	  else
 	    printf ("  ");
 	  if ((j & 3) == 3)
@@ -3033,11 +3069,12 @@ dump_section (bfd *abfd, asection *section, void *dummy ATTRIBUTE_UNUSED)
 	  if (j >= stop_offset * opb)
 	    printf (" ");
 	  else
-	    printf ("%c", ISPRINT (data[j]) ? data[j] : '.');
+	    printf ("%c", (ISPRINT (data[j - data_start])
+			   ? data[j - data_start] : '.'));
 	}
       putchar ('\n');
     }
-  free (data);
+  free (alloc);
 }
 
 /* Actually display the various requested regions.  */
@@ -3092,21 +3129,19 @@ dump_symbols (bfd *abfd ATTRIBUTE_UNUSED, bfd_boolean dynamic)
 
 	  if (do_demangle && name != NULL && *name != '\0')
 	    {
-	      char *alloc;
+	      const char *demangled;
 
 	      /* If we want to demangle the name, we demangle it
 		 here, and temporarily clobber it while calling
 		 bfd_print_symbol.  FIXME: This is a gross hack.  */
-	      alloc = bfd_demangle (cur_bfd, name, DMGL_ANSI | DMGL_PARAMS);
-	      if (alloc != NULL)
-		(*current)->name = alloc;
+	      demangled = bfd_demangle_symbol (cur_bfd, *current,
+					       DMGL_ANSI | DMGL_PARAMS);
+	      if (demangled != NULL)
+		(*current)->name = demangled;
 	      bfd_print_symbol (cur_bfd, stdout, *current,
 				bfd_print_symbol_all);
-	      if (alloc != NULL)
-		{
-		  (*current)->name = name;
-		  free (alloc);
-		}
+	      if (demangled != NULL)
+		(*current)->name = name;
 	    }
 	  else
 	    bfd_print_symbol (cur_bfd, stdout, *current,
@@ -3610,10 +3645,15 @@ display_object_bfd (bfd *abfd)
 static void
 display_any_bfd (bfd *file, int level)
 {
-  /* Decompress sections unless dumping the section contents.  */
-  if (!dump_section_contents)
+  /* Decompress sections unless dumping the raw section contents.  */
+  if (!dump_section_contents || decompressed_dumps)
     file->flags |= BFD_DECOMPRESS;
 
+  /* If asked, read the file through a mapping, and use its contents
+     in place.  */
+  if (use_mmap)
+    file->flags |= BFD_MMAP;
+
   /* If the file is an archive, process all of its elements.  */
   if (bfd_check_format (file, bfd_archive))
     {
@@ -3734,7 +3774,7 @@ main (int argc, char **argv)
   set_default_bfd_target ();
 
   while ((c = getopt_long (argc, argv,
-			   "pP:ib:m:M:VvCdDlfFaHhrRtTxsSI:j:wE:zgeGW::",
+			   "pP:ib:m:M:VvCdDlfFaHhrRtTxsSI:j:wE:zZgeGW::",
 			   long_options, (int *) 0))
 	 != EOF)
     {
@@ -3939,6 +3979,9 @@ main (int argc, char **argv)
 	  dump_section_contents = TRUE;
 	  seenflag = TRUE;
 	  break;
+	case 'Z':
+	  decompressed_dumps = TRUE;
+	  break;
 	case 'r':
 	  dump_reloc_info = TRUE;
 	  seenflag = TRUE;
@@ -5732,6 +5732,24 @@ get_compression_header (Elf_Internal_Chdr *chdr, unsigned char *buf)
     }
 }
 
+/* Return the size of the index of restart points which follows the
+   compression header of a section compressed with
+   ELFCOMPRESS_ZLIB_CHUNKED, or 0 if it does not fit in the SIZE bytes
+   at START.  */
+
+static dwarf_size_type
+get_chunk_index_size (unsigned char *start, dwarf_size_type size)
+{
+  dwarf_size_type n_chunks;
+
+  if (size < 8)
+    return 0;
+  n_chunks = byte_get (start + 4, 4);
+  if (n_chunks > (size - 8) / 8)
+    return 0;
+  return 8 + n_chunks * 8;
+}
+
 static int
 process_section_headers (FILE * file)
 {
@@ -6310,6 +6328,8 @@ process_section_headers (FILE * file)
 
 		  if (chdr.ch_type == ELFCOMPRESS_ZLIB)
 		    printf ("       ZLIB, ");
+		  else if (chdr.ch_type == ELFCOMPRESS_ZLIB_CHUNKED)
+		    printf ("       ZLIB_CHUNKED, ");
 		  else
 		    printf (_("       [<unknown>: 0x%x], "),
 			    chdr.ch_type);
@@ -12552,7 +12572,8 @@ dump_section_as_strings (Elf_Internal_Shdr * section, FILE * file)
 	  unsigned int compression_header_size
 	    = get_compression_header (& chdr, (unsigned char *) start);
 
-	  if (chdr.ch_type != ELFCOMPRESS_ZLIB)
+	  if (chdr.ch_type != ELFCOMPRESS_ZLIB
+	      && chdr.ch_type != ELFCOMPRESS_ZLIB_CHUNKED)
 	    {
 	      warn (_("section '%s' has unsupported compress type: %d\n"),
 		    printable_section_name (section), chdr.ch_type);
@@ -12567,6 +12588,21 @@ dump_section_as_strings (Elf_Internal_Shdr * section, FILE * file)
 	  uncompressed_size = chdr.ch_size;
 	  start += compression_header_size;
 	  new_size -= compression_header_size;
+	  if (chdr.ch_type == ELFCOMPRESS_ZLIB_CHUNKED)
+	    {
+	      /* Skip the index of restart points.  */
+	      dwarf_size_type index_size
+		= get_chunk_index_size (start, new_size);
+
+	      if (index_size == 0)
+		{
+		  warn (_("compressed section '%s' is corrupted\n"),
+			printable_section_name (section));
+		  return;
+		}
+	      start += index_size;
+	      new_size -= index_size;
+	    }
 	}
       else if (new_size > 12 && streq ((char *) start, "ZLIB"))
 	{
@@ -12686,7 +12722,8 @@ dump_section_as_bytes (Elf_Internal_Shdr * section,
 	  unsigned int compression_header_size
 	    = get_compression_header (& chdr, start);
 
-	  if (chdr.ch_type != ELFCOMPRESS_ZLIB)
+	  if (chdr.ch_type != ELFCOMPRESS_ZLIB
+	      && chdr.ch_type != ELFCOMPRESS_ZLIB_CHUNKED)
 	    {
 	      warn (_("section '%s' has unsupported compress type: %d\n"),
 		    printable_section_name (section), chdr.ch_type);
@@ -12701,6 +12738,21 @@ dump_section_as_bytes (Elf_Internal_Shdr * section,
 	  uncompressed_size = chdr.ch_size;
 	  start += compression_header_size;
 	  new_size -= compression_header_size;
+	  if (chdr.ch_type == ELFCOMPRESS_ZLIB_CHUNKED)
+	    {
+	      /* Skip the index of restart points.  */
+	      dwarf_size_type index_size
+		= get_chunk_index_size (start, new_size);
+
+	      if (index_size == 0)
+		{
+		  warn (_("compressed section '%s' is corrupted\n"),
+			printable_section_name (section));
+		  return;
+		}
+	      start += index_size;
+	      new_size -= index_size;
+	    }
 	}
       else if (new_size > 12 && streq ((char *) start, "ZLIB"))
 	{
@@ -12839,7 +12891,8 @@ load_specific_debug_section (enum dwarf_section_display_enum debug,
 
 	  compression_header_size = get_compression_header (&chdr, start);
 
-	  if (chdr.ch_type != ELFCOMPRESS_ZLIB)
+	  if (chdr.ch_type != ELFCOMPRESS_ZLIB
+	      && chdr.ch_type != ELFCOMPRESS_ZLIB_CHUNKED)
 	    {
 	      warn (_("section '%s' has unsupported compress type: %d\n"),
 		    section->name, chdr.ch_type);
@@ -12854,6 +12907,21 @@ load_specific_debug_section (enum dwarf_section_display_enum debug,
 	  uncompressed_size = chdr.ch_size;
 	  start += compression_header_size;
 	  size -= compression_header_size;
+	  if (chdr.ch_type == ELFCOMPRESS_ZLIB_CHUNKED)
+	    {
+	      /* Skip the index of restart points.  */
+	      dwarf_size_type index_size
+		= get_chunk_index_size (start, size);
+
+	      if (index_size == 0)
+		{
+		  warn (_("compressed section '%s' is corrupted\n"),
+			section->name);
+		  return 0;
+		}
+	      start += index_size;
+	      size -= index_size;
+	    }
 	}
       else if (size > 12 && streq ((char *) start, "ZLIB"))
 	{
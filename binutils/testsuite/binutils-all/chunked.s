@@ -0,0 +1,5 @@
+	.section .debug_str,"",%progbits
+	.rept 16384
+	.ascii "zlib-chunked section contents.\n"
+	.byte 0
+	.endr
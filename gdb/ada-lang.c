@@ -1142,7 +1142,8 @@ ada_remove_Xbn_suffix (const char *encoded, int *len)
    the decoded form of ENCODED.  Otherwise, return "<%s>" where "%s" is
    replaced by ENCODED.
 
-   The resulting string is valid until the next call of ada_decode.
+   The resulting string is valid until the next call of ada_decode
+   in the same thread.
    If the string is unchanged by decoding, the original string pointer
    is returned.  */
 
@@ -1154,8 +1155,9 @@ ada_decode (const char *encoded)
   const char *p;
   char *decoded;
   int at_start_name;
-  static char *decoding_buffer = NULL;
-  static size_t decoding_buffer_size = 0;
+  /* Per thread, as minimal symbols are demangled by worker
+     threads.  */
+  static thread_local std::string decoding_buffer;
 
   /* The name of the Ada main procedure starts with "_ada_".
      This prefix is not part of the decoded name, so skip this part
@@ -1209,8 +1211,9 @@ ada_decode (const char *encoded)
 
   /* Make decoded big enough for possible expansion by operator name.  */
 
-  GROW_VECT (decoding_buffer, decoding_buffer_size, 2 * len0 + 1);
-  decoded = decoding_buffer;
+  if (decoding_buffer.size () < (size_t) (2 * len0 + 1))
+    decoding_buffer.resize (2 * len0 + 1);
+  decoded = &decoding_buffer[0];
 
   /* Remove trailing __{digit}+ or trailing ${digit}+.  */
 
@@ -1383,12 +1386,13 @@ ada_decode (const char *encoded)
     return decoded;
 
 Suppress:
-  GROW_VECT (decoding_buffer, decoding_buffer_size, strlen (encoded) + 3);
-  decoded = decoding_buffer;
+  if (decoding_buffer.size () < strlen (encoded) + 3)
+    decoding_buffer.resize (strlen (encoded) + 3);
+  decoded = &decoding_buffer[0];
   if (encoded[0] == '<')
     strcpy (decoded, encoded);
   else
-    xsnprintf (decoded, decoding_buffer_size, "<%s>", encoded);
+    xsnprintf (decoded, decoding_buffer.size (), "<%s>", encoded);
   return decoded;
 
 }
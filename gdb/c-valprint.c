@@ -28,6 +28,7 @@
 #include "cp-abi.h"
 #include "target.h"
 #include "objfiles.h"
+#include <algorithm>
 
 
 /* A helper for c_textual_element_type.  This checks the name of the
@@ -248,6 +249,10 @@ c_val_print_array (struct type *type, const gdb_byte *valaddr,
       struct gdbarch *gdbarch = get_type_arch (type);
       enum bfd_endian byte_order = gdbarch_byte_order (gdbarch);
       unsigned int i = 0;	/* Number of characters printed.  */
+      /* Length in bytes of the leading part of the array that was
+	 read from the target; see value_fetch_lazy_limited.  */
+      LONGEST fetched_length = TYPE_LENGTH (type);
+      int fetched_len;
 
       if (!get_array_bounds (type, &low_bound, &high_bound))
 	error (_("Could not determine the array high bound"));
@@ -259,17 +264,59 @@ c_val_print_array (struct type *type, const gdb_byte *valaddr,
 	  print_spaces_filtered (2 + 2 * recurse, stream);
 	}
 
+      if (value_limited_length (original_value) > 0)
+	{
+	  fetched_len = val_print_fetch_elements (original_value,
+						  embedded_offset,
+						  eltlen / unit_size, 0,
+						  options->print_max, len);
+	  fetched_length = (LONGEST) fetched_len * eltlen;
+	}
+      else
+	fetched_len = fetched_length / eltlen;
+
+      /* If the characters at the end of the part that was read are
+	 all the same and will be printed as a repeat block, read on
+	 until they stop, so that the repeat count is right.  */
+      if (fetched_len > 0 && fetched_len < len
+	  && c_textual_element_type (unresolved_elttype, options->format))
+	{
+	  LONGEST eltunits = eltlen / unit_size;
+	  unsigned int start = fetched_len - 1;
+
+	  while (start > 0
+		 && value_contents_eq (original_value,
+				       embedded_offset
+				       + (start - 1) * eltunits,
+				       original_value,
+				       embedded_offset
+				       + (fetched_len - 1) * eltunits,
+				       eltunits))
+	    --start;
+
+	  if (start < options->print_max)
+	    {
+	      fetched_len = val_print_fetch_repeats (original_value,
+						     embedded_offset,
+						     eltunits, start,
+						     fetched_len, len);
+	      fetched_length = (LONGEST) fetched_len * eltlen;
+	    }
+	}
+
       /* Print arrays of textual chars with a string syntax, as
-	 long as the entire array is valid.  */
+	 long as the entire array, or the part of it that was read, is
+	 valid.  */
       if (c_textual_element_type (unresolved_elttype,
 				  options->format)
 	  && value_bytes_available (original_value, embedded_offset,
-				    TYPE_LENGTH (type))
+				    fetched_length)
 	  && !value_bits_any_optimized_out (original_value,
 					    TARGET_CHAR_BIT * embedded_offset,
-					    TARGET_CHAR_BIT * TYPE_LENGTH (type)))
+					    TARGET_CHAR_BIT * fetched_length))
 	{
-	  int force_ellipses = 0;
+	  /* Print ellipses if the array was not read in full.  */
+	  int force_ellipses = fetched_len < len;
 
 	  /* If requested, look for the first null char and only
 	     print elements up to it.  */
@@ -278,7 +325,7 @@ c_val_print_array (struct type *type, const gdb_byte *valaddr,
 	      unsigned int temp_len;
 
 	      for (temp_len = 0;
-		   (temp_len < len
+		   (temp_len < fetched_len
 		    && temp_len < options->print_max
 		    && extract_unsigned_integer (valaddr
 						 + embedded_offset * unit_size
@@ -290,7 +337,9 @@ c_val_print_array (struct type *type, const gdb_byte *valaddr,
 	      /* Force LA_PRINT_STRING to print ellipses if
 		 we've printed the maximum characters and
 		 the next character is not \000.  */
-	      if (temp_len == options->print_max && temp_len < len)
+	      if (temp_len < fetched_len)
+		force_ellipses = 0;
+	      if (temp_len == options->print_max && temp_len < fetched_len)
 		{
 		  ULONGEST val
 		    = extract_unsigned_integer (valaddr
@@ -303,6 +352,8 @@ c_val_print_array (struct type *type, const gdb_byte *valaddr,
 
 	      len = temp_len;
 	    }
+	  else
+	    len = fetched_len;
 
 	  LA_PRINT_STRING (stream, unresolved_elttype,
 			   valaddr + embedded_offset * unit_size, len,
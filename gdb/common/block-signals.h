@@ -0,0 +1,67 @@
+/* Block signals used by gdb
+
+   Copyright (C) 2017 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef COMMON_BLOCK_SIGNALS_H
+#define COMMON_BLOCK_SIGNALS_H
+
+#if CXX_STD_THREAD
+
+#include <signal.h>
+#include <pthread.h>
+
+namespace gdb
+{
+
+/* An RAII class that blocks all signals in the calling thread, and
+   restores the previous mask when destroyed.  A thread inherits the
+   signal mask of the thread which starts it, so this is used around
+   starting worker threads: GDB's handlers for SIGINT, SIGCHLD and the
+   like must only ever run in the main thread.  */
+
+class block_signals
+{
+public:
+
+  block_signals ()
+  {
+    sigset_t mask;
+
+    sigfillset (&mask);
+    pthread_sigmask (SIG_BLOCK, &mask, &m_old_mask);
+  }
+
+  ~block_signals ()
+  {
+    pthread_sigmask (SIG_SETMASK, &m_old_mask, NULL);
+  }
+
+private:
+
+  block_signals (const block_signals &);
+  block_signals &operator= (const block_signals &);
+
+  /* The signal mask to restore.  */
+  sigset_t m_old_mask;
+};
+
+}
+
+#endif /* CXX_STD_THREAD */
+
+#endif /* COMMON_BLOCK_SIGNALS_H */
@@ -0,0 +1,110 @@
+/* Parallel for loops
+
+   Copyright (C) 2017 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef COMMON_PARALLEL_FOR_H
+#define COMMON_PARALLEL_FOR_H
+
+#include <algorithm>
+#if CXX_STD_THREAD
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include "common/block-signals.h"
+#endif
+
+namespace gdb
+{
+
+/* A very simple "parallel for".  This splits the range [FIRST, LAST)
+   into at most N_THREADS + 1 contiguous sub-ranges and calls CALLBACK
+   once per sub-range, as CALLBACK (BEGIN, END).  All but one of the
+   calls are made from freshly started threads; the last sub-range is
+   handled by the calling thread.  This returns once every sub-range
+   has been processed.
+
+   CALLBACK must not throw, must not call into code that can throw a
+   GDB exception (this includes QUIT), and may only touch state that
+   is either private to the sub-range or safe to read concurrently.
+
+   If N_THREADS is zero, if the range is smaller than MIN_ELEMENTS
+   per thread, or if the host refuses to start a thread, the remaining
+   work is simply done serially in the calling thread.  The same goes
+   if configure found that std::thread does not work on this host.
+   The worker threads are started with all signals blocked, so that
+   signals are only ever handled by the calling thread.  */
+
+template<class RandomIt, class RangeFunction>
+void
+parallel_for_each (unsigned n_threads, RandomIt first, RandomIt last,
+		   RangeFunction callback, size_t min_elements = 1)
+{
+#if CXX_STD_THREAD
+  size_t n_elements = last - first;
+
+  if (min_elements == 0)
+    min_elements = 1;
+  n_threads = std::min<size_t> (n_threads, n_elements / min_elements);
+
+  std::vector<std::thread> threads;
+  std::string failure;
+  if (n_threads > 0)
+    {
+      size_t elts_per_thread = n_elements / (n_threads + 1);
+      block_signals blocker;
+
+      threads.reserve (n_threads);
+      for (unsigned i = 0; i < n_threads; ++i)
+	{
+	  RandomIt end = first + elts_per_thread;
+
+	  try
+	    {
+	      threads.emplace_back (callback, first, end);
+	    }
+	  catch (const std::system_error &e)
+	    {
+	      /* Could not start another thread; do the rest here.  The
+		 failure is reported once the threads are joined, since
+		 printing the warning may throw.  */
+	      failure = e.what ();
+	      break;
+	    }
+	  first = end;
+	}
+    }
+
+  /* Process all the remaining elements in the calling thread.  */
+  callback (first, last);
+
+  for (std::thread &thread : threads)
+    thread.join ();
+
+  if (!failure.empty ())
+    warning (_("Could not start a worker thread (%s); "
+	       "continuing with %u worker threads."),
+	     failure.c_str (), (unsigned) threads.size ());
+#else
+  callback (first, last);
+#endif
+}
+
+}
+
+#endif /* COMMON_PARALLEL_FOR_H */
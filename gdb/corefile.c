@@ -414,12 +414,14 @@ write_memory (CORE_ADDR memaddr,
     memory_error (TARGET_XFER_E_IO, memaddr);
 }
 
-/* Same as write_memory, but notify 'memory_changed' observers.  */
+/* Same as write_memory, but notify 'memory_about_to_change' and
+   'memory_changed' observers.  */
 
 void
 write_memory_with_notification (CORE_ADDR memaddr, const bfd_byte *myaddr,
 				ssize_t len)
 {
+  observer_notify_memory_about_to_change (current_inferior (), memaddr, len);
   write_memory (memaddr, myaddr, len);
   observer_notify_memory_changed (current_inferior (), memaddr, len, myaddr);
 }
@@ -36,6 +36,9 @@
 #include <signal.h>
 #include "gdb_setjmp.h"
 #include "safe-ctype.h"
+#if CXX_STD_THREAD
+#include <thread>
+#endif
 
 #define d_left(dc) (dc)->u.s_binary.left
 #define d_right(dc) (dc)->u.s_binary.right
@@ -1496,6 +1499,22 @@ static int catch_demangler_crashes = 1;
 
 static SIGJMP_BUF gdb_demangle_jmp_buf;
 
+#if CXX_STD_THREAD
+/* Signal dispositions are shared by all threads, so only one thread
+   can catch demangler crashes: the one that initialized this file.
+   Demangling in worker threads is not protected; they run with all
+   signals blocked (see gdb::parallel_for_each), so a crash there
+   takes the default action.  */
+
+static std::thread::id gdb_demangle_main_thread;
+#endif
+
+/* Nonzero while this thread is in a demangle that catches crashes.
+   A crash anywhere else that reaches the handler is not ours to
+   recover from.  */
+
+static thread_local int gdb_demangle_catching;
+
 /* If nonzero, attempt to dump core from the signal handler.  */
 
 static int gdb_demangle_attempt_core_dump = 1;
@@ -1505,6 +1524,13 @@ static int gdb_demangle_attempt_core_dump = 1;
 static void
 gdb_demangle_signal_handler (int signo)
 {
+  if (!gdb_demangle_catching)
+    {
+      /* Let the fault happen again with the default action.  */
+      signal (signo, SIG_DFL);
+      return;
+    }
+
   if (gdb_demangle_attempt_core_dump)
     {
       if (fork () == 0)
@@ -1534,6 +1560,11 @@ gdb_demangle (const char *name, int options)
 #endif
   static int core_dump_allowed = -1;
 
+#if CXX_STD_THREAD
+  if (std::this_thread::get_id () != gdb_demangle_main_thread)
+    return bfd_demangle (NULL, name, options);
+#endif
+
   if (core_dump_allowed == -1)
     {
       core_dump_allowed = can_dump_core (LIMIT_CUR);
@@ -1557,6 +1588,7 @@ gdb_demangle (const char *name, int options)
       ofunc = signal (SIGSEGV, gdb_demangle_signal_handler);
 #endif
 
+      gdb_demangle_catching = 1;
       crash_signal = SIGSETJMP (gdb_demangle_jmp_buf);
     }
 #endif
@@ -1567,6 +1599,7 @@ gdb_demangle (const char *name, int options)
 #ifdef HAVE_WORKING_FORK
   if (catch_demangler_crashes)
     {
+      gdb_demangle_catching = 0;
 #if defined (HAVE_SIGACTION) && defined (SA_RESTART)
       sigaction (SIGSEGV, &old_sa, NULL);
 #else
@@ -1677,6 +1710,10 @@ info_vtbl_command (char *arg, int from_tty)
 void
 _initialize_cp_support (void)
 {
+#if defined (HAVE_WORKING_FORK) && CXX_STD_THREAD
+  gdb_demangle_main_thread = std::this_thread::get_id ();
+#endif
+
   add_prefix_cmd ("cplus", class_maintenance,
 		  maint_cplus_command,
 		  _("C++ maintenance commands."),
@@ -97,6 +97,7 @@ struct dcache_block
 
   CORE_ADDR addr;		/* address of data */
   int refs;			/* # hits */
+  int prefetched;		/* read by dcache_prefetch */
   gdb_byte data[1];		/* line_size bytes at given address */
 };
 
@@ -115,6 +116,10 @@ struct dcache_struct
 
   /* The ptid of last inferior to use cache or null_ptid.  */
   ptid_t ptid;
+
+  /* Nonzero if dcache_prefetch was called since the cache was last
+     invalidated.  */
+  int prefetched_p;
 };
 
 typedef void (block_func) (struct dcache_block *block, void *param);
@@ -252,6 +257,7 @@ dcache_invalidate (DCACHE *dcache)
   dcache->oldest = NULL;
   dcache->size = 0;
   dcache->ptid = null_ptid;
+  dcache->prefetched_p = 0;
 
   if (dcache->line_size != dcache_line_size)
     {
@@ -379,6 +385,7 @@ dcache_alloc (DCACHE *dcache, CORE_ADDR addr)
 
   db->addr = MASK (dcache, addr);
   db->refs = 0;
+  db->prefetched = 0;
 
   /* Put DB at the end of the list, it's the newest.  */
   append_block (&dcache->oldest, db);
@@ -456,6 +463,7 @@ dcache_init (void)
   dcache->size = 0;
   dcache->line_size = dcache_line_size;
   dcache->ptid = null_ptid;
+  dcache->prefetched_p = 0;
 
   return dcache;
 }
@@ -507,6 +515,122 @@ dcache_read_memory_partial (struct target_ops *ops, DCACHE *dcache,
     }
 }
 
+/* Read the LEN bytes at MEMADDR into DCACHE, with a single target
+   access for each run of lines that are not cached yet instead of one
+   per line, and mark the lines for dcache_read_prefetched.  At most
+   as much as fits in the cache is read.  Return the number of bytes
+   from MEMADDR that are now in the cache.  */
+
+ULONGEST
+dcache_prefetch (DCACHE *dcache, CORE_ADDR memaddr, ULONGEST len)
+{
+  ULONGEST max_len = (ULONGEST) (dcache_size - 1) * dcache->line_size;
+  CORE_ADDR addr, end;
+
+  /* If this is a different inferior from what we've recorded,
+     flush the cache.  */
+
+  if (! ptid_equal (inferior_ptid, dcache->ptid))
+    {
+      dcache_invalidate (dcache);
+      dcache->ptid = inferior_ptid;
+    }
+
+  if (len > max_len)
+    len = max_len;
+  addr = MASK (dcache, memaddr);
+  end = MASK (dcache, memaddr + len + dcache->line_size - 1);
+  if (len == 0 || end <= addr)
+    return 0;
+
+  dcache->prefetched_p = 1;
+
+  while (addr < end)
+    {
+      struct dcache_block *db = dcache_hit (dcache, addr);
+      struct mem_region *region;
+      CORE_ADDR run_start, run_end;
+      gdb_byte *buf;
+
+      if (db != NULL)
+	{
+	  db->prefetched = 1;
+	  addr += dcache->line_size;
+	  continue;
+	}
+
+      /* Find the run of lines missing from the cache.  */
+      for (run_end = addr + dcache->line_size;
+	   run_end < end
+	     && splay_tree_lookup (dcache->tree,
+				   (splay_tree_key) run_end) == NULL;
+	   run_end += dcache->line_size)
+	;
+
+      /* Stop at the end of the memory region, and at memory which
+	 must not be cached.  Like other reads, memory with the default
+	 attributes may be prefetched.  */
+      region = lookup_mem_region (addr);
+      if (region->attrib.mode == MEM_WO
+	  || (!region->attrib.cache && mem_region_defined_p (region)))
+	break;
+      if (region->hi != 0 && run_end > region->hi)
+	{
+	  run_end = MASK (dcache, region->hi);
+	  if (run_end <= addr)
+	    break;
+	}
+
+      buf = (gdb_byte *) xmalloc (run_end - addr);
+      if (target_read_raw_memory (addr, buf, run_end - addr) != 0)
+	{
+	  xfree (buf);
+	  break;
+	}
+
+      for (run_start = addr; addr < run_end; addr += dcache->line_size)
+	{
+	  db = dcache_alloc (dcache, addr);
+	  memcpy (db->data, buf + (addr - run_start), dcache->line_size);
+	  db->prefetched = 1;
+	}
+      xfree (buf);
+    }
+
+  if (addr <= memaddr)
+    return 0;
+  return std::min ((ULONGEST) (addr - memaddr), len);
+}
+
+/* Copy to MYADDR the bytes from MEMADDR on that dcache_prefetch put
+   in DCACHE, up to LEN of them.  Return how many were copied.  */
+
+ULONGEST
+dcache_read_prefetched (DCACHE *dcache, CORE_ADDR memaddr, gdb_byte *myaddr,
+			ULONGEST len)
+{
+  ULONGEST done = 0;
+
+  if (!dcache->prefetched_p || ! ptid_equal (inferior_ptid, dcache->ptid))
+    return 0;
+
+  while (done < len)
+    {
+      struct dcache_block *db = dcache_hit (dcache, memaddr + done);
+      ULONGEST offset, chunk;
+
+      if (db == NULL || !db->prefetched)
+	break;
+
+      offset = XFORM (dcache, memaddr + done);
+      chunk = std::min (len - done, (ULONGEST) (dcache->line_size - offset));
+      memcpy (myaddr + done, db->data + offset, chunk);
+      done += chunk;
+    }
+
+  return done;
+}
+
 /* FIXME: There would be some benefit to making the cache write-back and
    moving the writeback operation to a higher layer, as it could occur
    after a sequence of smaller writes have been completed (as when a stack
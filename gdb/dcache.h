@@ -43,4 +43,9 @@ void dcache_update (DCACHE *dcache, enum target_xfer_status status,
 		    CORE_ADDR memaddr, const gdb_byte *myaddr,
 		    ULONGEST len);
 
+ULONGEST dcache_prefetch (DCACHE *dcache, CORE_ADDR memaddr, ULONGEST len);
+
+ULONGEST dcache_read_prefetched (DCACHE *dcache, CORE_ADDR memaddr,
+				 gdb_byte *myaddr, ULONGEST len);
+
 #endif /* DCACHE_H */
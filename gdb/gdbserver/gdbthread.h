@@ -80,6 +80,11 @@ struct thread_info *get_first_thread (void);
 
 struct thread_info *find_thread_ptid (ptid_t ptid);
 
+/* Find the thread whose ptid has LWP as its (non-zero) LWP number.
+   Returns NULL if none is found.  This does not walk the thread
+   list.  */
+struct thread_info *find_thread_lwp (long lwp);
+
 /* Find any thread of the PID process.  Returns NULL if none is
    found.  */
 struct thread_info *find_any_thread_of_pid (int pid);
@@ -21,10 +21,17 @@
 #include "server.h"
 #include "gdbthread.h"
 #include "dll.h"
+#include <unordered_map>
 
 struct inferior_list all_processes;
 struct inferior_list all_threads;
 
+/* Index of the entries of ALL_THREADS whose ptid has a non-zero LWP
+   number, keyed by that number.  Native targets look up the thread of
+   every wait status by LWP, and walking the thread list for each of
+   them makes stopping thousands of threads quadratic.  */
+static std::unordered_multimap<long, struct thread_info *> thread_lwp_map;
+
 struct thread_info *current_thread;
 
 #define get_thread(inf) ((struct thread_info *)(inf))
@@ -112,6 +119,8 @@ add_thread (ptid_t thread_id, void *target_data)
   new_thread->last_status.kind = TARGET_WAITKIND_IGNORE;
 
   add_inferior_to_list (&all_threads, &new_thread->entry);
+  if (ptid_get_lwp (thread_id) != 0)
+    thread_lwp_map.emplace (ptid_get_lwp (thread_id), new_thread);
 
   if (current_thread == NULL)
     current_thread = new_thread;
@@ -141,6 +150,18 @@ find_thread_ptid (ptid_t ptid)
   return (struct thread_info *) find_inferior_id (&all_threads, ptid);
 }
 
+/* See gdbthread.h.  */
+
+struct thread_info *
+find_thread_lwp (long lwp)
+{
+  auto it = thread_lwp_map.find (lwp);
+
+  if (it == thread_lwp_map.end ())
+    return NULL;
+  return it->second;
+}
+
 /* Predicate function for matching thread entry's pid to the given
    pid value passed by address in ARGS.  */
 
@@ -209,6 +230,15 @@ remove_thread (struct thread_info *thread)
 
   discard_queued_stop_replies (ptid_of (thread));
   remove_inferior (&all_threads, (struct inferior_list_entry *) thread);
+
+  auto range = thread_lwp_map.equal_range (ptid_get_lwp (ptid_of (thread)));
+  for (auto it = range.first; it != range.second; ++it)
+    if (it->second == thread)
+      {
+	thread_lwp_map.erase (it);
+	break;
+      }
+
   free_one_thread (&thread->entry);
   if (current_thread == thread)
     current_thread = NULL;
@@ -298,6 +328,17 @@ find_inferior_id (struct inferior_list *list, ptid_t id)
 {
   struct inferior_list_entry *inf = list->head;
 
+  /* Threads with an LWP number are indexed; see thread_lwp_map.  */
+  if (list == &all_threads && ptid_get_lwp (id) != 0)
+    {
+      auto range = thread_lwp_map.equal_range (ptid_get_lwp (id));
+
+      for (auto it = range.first; it != range.second; ++it)
+	if (ptid_equal (it->second->entry.id, id))
+	  return &it->second->entry;
+      return NULL;
+    }
+
   while (inf != NULL)
     {
       if (ptid_equal (inf->id, id))
@@ -354,6 +395,7 @@ clear_inferiors (void)
 {
   for_each_inferior (&all_threads, free_one_thread);
   clear_inferior_list (&all_threads);
+  thread_lwp_map.clear ();
 
   clear_dlls ();
 
@@ -1825,33 +1825,27 @@ status_pending_p_callback (struct inferior_list_entry *entry, void *arg)
   return lp->status_pending_p;
 }
 
-static int
-same_lwp (struct inferior_list_entry *entry, void *data)
+struct lwp_info *
+find_lwp_pid (ptid_t ptid)
 {
-  ptid_t ptid = *(ptid_t *) data;
-  int lwp;
+  struct thread_info *thread;
+  long lwp;
 
   if (ptid_get_lwp (ptid) != 0)
     lwp = ptid_get_lwp (ptid);
   else
     lwp = ptid_get_pid (ptid);
 
-  if (ptid_get_lwp (entry->id) == lwp)
-    return 1;
-
-  return 0;
-}
-
-struct lwp_info *
-find_lwp_pid (ptid_t ptid)
-{
-  struct inferior_list_entry *thread
-    = find_inferior (&all_threads, same_lwp, &ptid);
+  /* All LWPs have a non-zero LWP number, so there is nothing to find
+     if LWP is zero.  */
+  if (lwp == 0)
+    return NULL;
 
+  thread = find_thread_lwp (lwp);
   if (thread == NULL)
     return NULL;
 
-  return get_thread_lwp ((struct thread_info *) thread);
+  return get_thread_lwp (thread);
 }
 
 /* Return the number of known LWPs in the tgid given by PID.  */
@@ -2809,10 +2803,16 @@ linux_wait_for_event_filtered (ptid_t wait_ptid, ptid_t filter_ptid,
 	for_each_inferior (&all_threads, resume_stopped_resumed_lwps);
 
       /* ... and find an LWP with a status to report to the core, if
-	 any.  */
-      event_thread = (struct thread_info *)
-	find_inferior_in_random (&all_threads, status_pending_p_callback,
-				 &filter_ptid);
+	 any.  A null FILTER_PTID matches no LWP, so there is no point
+	 walking the whole thread list (twice) for one; with thousands
+	 of threads being stopped, those walks after each batch of
+	 events used to dominate wait_for_sigstop.  */
+      if (ptid_equal (filter_ptid, null_ptid))
+	event_thread = NULL;
+      else
+	event_thread = (struct thread_info *)
+	  find_inferior_in_random (&all_threads, status_pending_p_callback,
+				   &filter_ptid);
       if (event_thread != NULL)
 	{
 	  event_child = get_thread_lwp (event_thread);
@@ -4124,6 +4124,77 @@ lwp_is_marked_dead (struct lwp_info *lwp)
 	      || WIFSIGNALED (lwp->status_pending)));
 }
 
+/* Callback for find_inferior.  Add the LWP of ENTRY to the VEC (int)
+   pointed to by DATA if it has yet to stop.  */
+
+static int
+collect_running_lwp_callback (struct inferior_list_entry *entry, void *data)
+{
+  struct thread_info *thread = (struct thread_info *) entry;
+  VEC (int) **lwps = (VEC (int) **) data;
+
+  if (!get_thread_lwp (thread)->stopped)
+    VEC_safe_push (int, *lwps, lwpid_of (thread));
+  return 0;
+}
+
+/* Wait for the LWPs that were running when the SIGSTOPs were queued
+   to stop.  Each time SIGCHLD arrives, pull every status the kernel
+   has out with waitpid and leave them pending, then drop the LWPs
+   that have stopped or gone from the end of the list of those still
+   awaited.  The work per wakeup is then independent of the number of
+   threads, unlike the scan of the whole thread list that
+   linux_wait_for_event_filtered does after each batch of events.  */
+
+static void
+wait_for_running_lwps_to_stop (void)
+{
+  VEC (int) *lwps = NULL;
+  struct cleanup *old_chain = make_cleanup (VEC_cleanup (int), &lwps);
+  sigset_t block_mask, prev_mask;
+  int wstat;
+  int ret;
+
+  find_inferior (&all_threads, collect_running_lwp_callback, &lwps);
+
+  /* Make sure SIGCHLD is blocked until the sigsuspend below.  */
+  sigfillset (&block_mask);
+  sigprocmask (SIG_BLOCK, &block_mask, &prev_mask);
+
+  while (1)
+    {
+      while ((ret = my_waitpid (-1, &wstat, __WALL | WNOHANG)) > 0)
+	{
+	  if (debug_threads)
+	    debug_printf ("wait_for_sigstop: waitpid %ld received %s\n",
+			  (long) ret, status_to_str (wstat));
+	  linux_low_filter_event (ret, wstat);
+	}
+
+      while (!VEC_empty (int, lwps))
+	{
+	  struct lwp_info *lwp
+	    = find_lwp_pid (pid_to_ptid (VEC_last (int, lwps)));
+
+	  if (lwp != NULL && !lwp->stopped)
+	    break;
+	  VEC_pop (int, lwps);
+	}
+
+      if (VEC_empty (int, lwps))
+	break;
+
+      /* A thread group leader that exited while other threads are
+	 still around never reports a stop.  */
+      check_zombie_leaders ();
+
+      sigsuspend (&prev_mask);
+    }
+
+  sigprocmask (SIG_SETMASK, &prev_mask, NULL);
+  do_cleanups (old_chain);
+}
+
 /* Wait for all children to stop for the SIGSTOPs we just queued.  */
 
 static void
@@ -4143,9 +4214,12 @@ wait_for_sigstop (void)
   if (debug_threads)
     debug_printf ("wait_for_sigstop: pulling events\n");
 
+  wait_for_running_lwps_to_stop ();
+
   /* Passing NULL_PTID as filter indicates we want all events to be
      left pending.  Eventually this returns when there are no
-     unwaited-for children left.  */
+     unwaited-for children left.  This also catches the LWPs that
+     appeared while the others were stopping.  */
   ret = linux_wait_for_event_filtered (minus_one_ptid, null_ptid,
 				       &wstat, __WALL);
   gdb_assert (ret == -1);
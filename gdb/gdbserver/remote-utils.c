@@ -1104,10 +1104,61 @@ outreg (struct regcache *regcache, int regno, char *buf)
   return buf;
 }
 
+/* Write a "thread-regs" stop reply field with the expedited registers
+   of THREAD to BUF, unless it would go past LIMIT or the registers
+   cannot be read.  Returns the end of what was written.  */
+
+static char *
+outthreadregs (struct thread_info *thread, char *buf, const char *limit)
+{
+  const struct target_desc *tdesc = get_thread_process (thread)->tdesc;
+  const char **regp;
+  char *start = buf;
+  size_t len;
+
+  /* The field name, the longest ptid, and one "regno:value,"
+     entry per register.  */
+  len = strlen ("thread-regs:") + 40;
+  for (regp = tdesc->expedite_regs; *regp != NULL; regp++)
+    len += 5 + 2 * register_size (tdesc, find_regno (tdesc, *regp));
+
+  if (tdesc->expedite_regs[0] == NULL || buf + len >= limit)
+    return buf;
+
+  TRY
+    {
+      struct regcache *regcache = get_thread_regcache (thread, 1);
+
+      strcpy (buf, "thread-regs:");
+      buf += strlen (buf);
+      buf = write_ptid (buf, ptid_of (thread));
+      for (regp = tdesc->expedite_regs; *regp != NULL; regp++)
+	{
+	  *buf++ = ',';
+	  /* OUTREG ends each register with a ';', which only the
+	     last one keeps.  */
+	  buf = outreg (regcache, find_regno (tdesc, *regp), buf) - 1;
+	}
+      *buf++ = ';';
+    }
+  CATCH (ex, RETURN_MASK_ERROR)
+    {
+      /* The thread may be gone already; GDB will ask for its
+	 registers itself if it still needs them.  */
+      buf = start;
+    }
+  END_CATCH
+
+  *buf = '\0';
+  return buf;
+}
+
 void
 prepare_resume_reply (char *buf, ptid_t ptid,
 		      struct target_waitstatus *status)
 {
+  char *reply = buf;
+
   if (debug_threads)
     debug_printf ("Writing resume reply for %s:%d\n",
 		  target_pid_to_str (ptid), status->kind);
@@ -1272,6 +1323,30 @@ prepare_resume_reply (char *buf, ptid_t ptid,
 	      }
 	  }
 
+	/* In all-stop mode, every other thread of the process stopped
+	   too, and GDB would otherwise fetch the registers of each one
+	   it looks at with a packet of its own.  Send their expedited
+	   registers along while they fit, leaving room for the
+	   "library" field.  */
+	if (thread_regs_feature && !non_stop
+	    && the_target->thread_stopped != NULL)
+	  {
+	    struct inferior_list_entry *inf, *tmp;
+	    const char *limit = reply + PBUFSIZ - 1 - strlen ("library:;");
+
+	    ALL_INFERIORS (&all_threads, inf, tmp)
+	      {
+		struct thread_info *thread = (struct thread_info *) inf;
+
+		if (ptid_equal (ptid_of (thread), ptid)
+		    || ptid_get_pid (ptid_of (thread)) != ptid_get_pid (ptid)
+		    || !thread_stopped (thread))
+		  continue;
+
+		buf = outthreadregs (thread, buf, limit);
+	      }
+	  }
+
 	if (dlls_changed)
 	  {
 	    strcpy (buf, "library:;");
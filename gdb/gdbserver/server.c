@@ -68,6 +68,7 @@ static int report_no_resumed;
 int non_stop;
 int swbreak_feature;
 int hwbreak_feature;
+int thread_regs_feature;
 
 /* True if the "vContSupported" feature is active.  In that case, GDB
    wants us to report whether single step is supported in the reply to
@@ -2227,6 +2228,12 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
 		  if (target_supports_stopped_by_hw_breakpoint ())
 		    hwbreak_feature = 1;
 		}
+	      else if (strcmp (p, "thread-regs+") == 0)
+		{
+		  /* GDB wants the registers of every stopped thread
+		     in the stop reply.  */
+		  thread_regs_feature = 1;
+		}
 	      else if (strcmp (p, "fork-events+") == 0)
 		{
 		  /* GDB supports and wants fork events if possible.  */
@@ -2369,6 +2376,8 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
       if (target_supports_stopped_by_hw_breakpoint ())
 	strcat (own_buf, ";hwbreak+");
 
+      strcat (own_buf, ";thread-regs+");
+
       if (the_target->pid_to_exec_file != NULL)
 	strcat (own_buf, ";qXfer:exec-file:read+");
 
@@ -3741,6 +3750,7 @@ captured_main (int argc, char *argv[])
       cont_thread = null_ptid;
       swbreak_feature = 0;
       hwbreak_feature = 0;
+      thread_regs_feature = 0;
       vCont_supported = 0;
 
       remote_open (port);
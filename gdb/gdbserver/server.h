@@ -103,6 +103,11 @@ extern int swbreak_feature;
    Only enabled if the target supports it.  */
 extern int hwbreak_feature;
 
+/* True if the "thread-regs+" feature is active.  In that case, GDB
+   wants the stop reply to carry the expedited registers of the other
+   stopped threads of the process too.  */
+extern int thread_regs_feature;
+
 extern int disable_randomization;
 
 #if USE_WIN32API
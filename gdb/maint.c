@@ -43,6 +43,9 @@
 #include "cli/cli-decode.h"
 #include "cli/cli-utils.h"
 #include "cli/cli-setshow.h"
+#if CXX_STD_THREAD
+#include <thread>
+#endif
 
 extern void _initialize_maint_cmds (void);
 
@@ -944,6 +947,46 @@ show_per_command_cmd (char *args, int from_tty)
 }
 
 
+/* The number of worker threads GDB may use, as set by the user.  -1
+   means "unlimited", i.e. one per host CPU.  */
+
+static int n_worker_threads = -1;
+
+/* See maint.h.  */
+
+unsigned int
+worker_thread_count (void)
+{
+#if CXX_STD_THREAD
+  if (n_worker_threads >= 0)
+    return n_worker_threads;
+
+  /* Leave one CPU for the main thread.  hardware_concurrency may
+     return zero if the value is not computable.  */
+  unsigned int n_cpus = std::thread::hardware_concurrency ();
+  return n_cpus > 1 ? n_cpus - 1 : 0;
+#else
+  /* Configure found that std::thread does not work here.  */
+  return 0;
+#endif
+}
+
+/* Implement "maintenance show worker-threads".  */
+
+static void
+show_worker_threads (struct ui_file *file, int from_tty,
+		     struct cmd_list_element *c, const char *value)
+{
+  if (n_worker_threads == -1)
+    fprintf_filtered (file, _("The number of worker threads GDB "
+			      "can use is unlimited (currently %u).\n"),
+		      worker_thread_count ());
+  else
+    fprintf_filtered (file, _("The number of worker threads GDB "
+			      "can use is %s.\n"), value);
+}
+
+
 /* The "maintenance selftest" command.  */
 
 static void
@@ -1151,4 +1194,18 @@ When enabled GDB is profiled."),
 			   show_maintenance_profile_p,
 			   &maintenance_set_cmdlist,
 			   &maintenance_show_cmdlist);
+
+  add_setshow_zuinteger_unlimited_cmd ("worker-threads", class_maintenance,
+				       &n_worker_threads, _("\
+Set the number of worker threads GDB can use."), _("\
+Show the number of worker threads GDB can use."), _("\
+GDB may use multiple threads to speed up certain CPU-intensive\n\
+operations, such as demangling minimal symbols and regular\n\
+expression symbol searches.\n\
+Zero means to do all such work in the main thread; \"unlimited\"\n\
+means to use one thread per host CPU."),
+				       NULL,
+				       show_worker_threads,
+				       &maintenance_set_cmdlist,
+				       &maintenance_show_cmdlist);
 }
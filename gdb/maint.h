@@ -26,6 +26,13 @@ extern void set_per_command_time (int);
 
 extern void set_per_command_space (int);
 
+/* Return the number of worker threads, in addition to the main
+   thread, that GDB may use for parallelizable internal work such as
+   symbol searches.  This is controlled by "maint set worker-threads";
+   zero means that all such work is done in the main thread.  */
+
+extern unsigned int worker_thread_count (void);
+
 /* Records a run time and space usage to be used as a base for
    reporting elapsed time or change in space.  */
 
@@ -289,6 +289,20 @@ lookup_mem_region (CORE_ADDR addr)
   return &region;
 }
 
+/* See memattr.h.  */
+
+int
+mem_region_defined_p (const struct mem_region *region)
+{
+  struct mem_region *m;
+  int ix;
+
+  for (ix = 0; VEC_iterate (mem_region_s, mem_region_list, ix, m); ix++)
+    if (m == region)
+      return 1;
+  return 0;
+}
+
 /* Invalidate any memory regions fetched from the target.  */
 
 void
@@ -100,6 +100,12 @@ DEF_VEC_O(mem_region_s);
 
 extern struct mem_region *lookup_mem_region(CORE_ADDR);
 
+/* Return nonzero if REGION, as returned by lookup_mem_region, is one
+   of the memory regions defined by the user or the target, rather than
+   the default attributes of the memory outside them.  */
+
+extern int mem_region_defined_p (const struct mem_region *region);
+
 void invalidate_target_mem_regions (void);
 
 void mem_region_init (struct mem_region *);
@@ -51,6 +51,9 @@
 #include "language.h"
 #include "cli/cli-utils.h"
 #include "symbol.h"
+#include "maint.h"
+#include "common/parallel-for.h"
+#include <vector>
 
 /* Accumulate the minimal symbols for each objfile in bunches of BUNCH_SIZE.
    At the end, copy them all into one newly allocated location on an objfile's
@@ -912,6 +915,7 @@ minimal_symbol_reader::minimal_symbol_reader (struct objfile *obj)
   m_msym_bunch_index (BUNCH_SIZE),
   m_msym_count (0)
 {
+  obstack_init (&m_temp_names);
 }
 
 /* Discard the currently collected minimal symbols, if any.  If we wish
@@ -932,6 +936,7 @@ minimal_symbol_reader::~minimal_symbol_reader ()
       xfree (m_msym_bunch);
       m_msym_bunch = next;
     }
+  obstack_free (&m_temp_names, NULL);
 }
 
 /* See minsyms.h.  */
@@ -1007,7 +1012,18 @@ minimal_symbol_reader::record_full (const char *name, int name_len,
   msymbol = &m_msym_bunch->contents[m_msym_bunch_index];
   MSYMBOL_SET_LANGUAGE (msymbol, language_auto,
 			&m_objfile->per_bfd->storage_obstack);
-  MSYMBOL_SET_NAMES (msymbol, name, name_len, copy_name, m_objfile);
+
+  /* The name is entered into the demangled name hash by install, once
+     all the symbols are known, so that they can be demangled
+     together.  Until then NAME must stay valid.  */
+  if (copy_name || name[name_len] != '\0')
+    {
+      name = (const char *) obstack_copy0 (&m_temp_names, name, name_len);
+      copy_name = true;
+    }
+  msymbol->mginfo.name = name;
+  msymbol->name_set = 0;
+  msymbol->name_copy = copy_name;
 
   SET_MSYMBOL_VALUE_ADDRESS (msymbol, address);
   MSYMBOL_SECTION (msymbol) = section;
@@ -1175,6 +1191,60 @@ build_minimal_symbol_hash_tables (struct objfile *objfile)
     }
 }
 
+/* Enter the names of the symbols in MSYMBOLS[0..MCOUNT) that were
+   recorded since the last install into the demangled name hash of
+   OBJFILE's BFD, demangling those not already there.  Demangling is
+   by far the most expensive part of reading minimal symbols and
+   touches nothing but the symbol itself, so it is done by worker
+   threads where the host has them (see gdb::parallel_for_each); the
+   hash is then filled in by this thread in table order, so the result
+   does not depend on the number of threads.  */
+
+static void
+set_minimal_symbol_names (struct objfile *objfile,
+			  struct minimal_symbol *msymbols, int mcount)
+{
+  std::vector<struct minimal_symbol *> todo;
+  int i;
+
+  for (i = 0; i < mcount; i++)
+    if (!msymbols[i].name_set
+	&& !symbol_demangled_name_cached_p (objfile,
+					    MSYMBOL_LINKAGE_NAME (&msymbols[i])))
+      todo.push_back (&msymbols[i]);
+
+  std::vector<char *> demangled (todo.size ());
+
+  gdb::parallel_for_each (worker_thread_count (),
+			  (size_t) 0, todo.size (),
+			  [&] (size_t begin, size_t end)
+    {
+      for (size_t j = begin; j < end; j++)
+	demangled[j]
+	  = symbol_find_demangled_name (&todo[j]->mginfo,
+					MSYMBOL_LINKAGE_NAME (todo[j]));
+    }, 1000);
+
+  size_t next = 0;
+  for (i = 0; i < mcount; i++)
+    {
+      struct minimal_symbol *msym = &msymbols[i];
+      const char *name = MSYMBOL_LINKAGE_NAME (msym);
+
+      if (msym->name_set)
+	continue;
+
+      if (next < todo.size () && todo[next] == msym)
+	symbol_set_names_demangled (&msym->mginfo, name, strlen (name),
+				    msym->name_copy, objfile,
+				    demangled[next++]);
+      else
+	symbol_set_names (&msym->mginfo, name, strlen (name),
+			  msym->name_copy, objfile);
+      msym->name_set = 1;
+    }
+}
+
 /* Add the minimal symbols in the existing bunches to the objfile's official
    minimal symbol table.  In most cases there is no minimal symbol table yet
    for this objfile, and the existing bunches are used to create one.  Once
@@ -1276,6 +1346,8 @@ minimal_symbol_reader::install ()
 
       memset (&msymbols[mcount], 0, sizeof (struct minimal_symbol));
 
+      set_minimal_symbol_names (m_objfile, msymbols, mcount);
+
       /* Attach the minimal symbol table to the specified objfile.
          The strings themselves are also located in the storage_obstack
          of this objfile.  */
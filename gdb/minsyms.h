@@ -20,6 +20,8 @@
 #ifndef MINSYMS_H
 #define MINSYMS_H
 
+#include "gdb_obstack.h"
+
 /* Several lookup functions return both a minimal symbol and the
    objfile in which it is found.  This structure is used in these
    cases.  */
@@ -70,7 +72,8 @@ class minimal_symbol_reader
   ~minimal_symbol_reader ();
 
   /* Install the minimal symbols that have been collected into the
-     given objfile.  */
+     given objfile.  This is also when their names are demangled, see
+     record_full.  */
 
   void install ();
 
@@ -80,7 +83,8 @@ class minimal_symbol_reader
      This returns a new minimal symbol.  It is ok to modify the returned
      minimal symbol (though generally not necessary).  It is not ok,
      though, to stash the pointer anywhere; as minimal symbols may be
-     moved after creation.  The memory for the returned minimal symbol
+     moved after creation.  Its demangled name is not known until the
+     symbols are installed.  The memory for the returned minimal symbol
      is still owned by the minsyms.c code, and should not be freed.
    
      Arguments are:
@@ -146,6 +150,12 @@ class minimal_symbol_reader
      objfile.  */
 
   int m_msym_count;
+
+  /* Copies of the names recorded with COPY_NAME set.  They are only
+     needed until install enters them into the objfile's demangled
+     name hash, which makes its own copy.  */
+
+  struct obstack m_temp_names;
 };
 
 /* Create the terminating entry of OBJFILE's minimal symbol table.
@@ -38,6 +38,7 @@
 #include <fcntl.h>
 #include "gdb_obstack.h"
 #include "hashtab.h"
+#include "ghashtab.h"
 
 #include "breakpoint.h"
 #include "block.h"
@@ -170,7 +171,7 @@ free_objfile_per_bfd_storage (struct objfile_per_bfd_storage *storage)
   bcache_xfree (storage->filename_cache);
   bcache_xfree (storage->macro_cache);
   if (storage->demangled_names_hash)
-    htab_delete (storage->demangled_names_hash);
+    ghtab_delete (storage->demangled_names_hash);
   obstack_free (&storage->storage_obstack, 0);
 }
 
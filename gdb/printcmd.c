@@ -1256,6 +1256,15 @@ print_command_1 (const char *exp, int voidprint)
   else
     val = access_value_history (0);
 
+  /* Of a large array, only read the elements that will be printed.  */
+  if (val != NULL && value_lazy (val))
+    {
+      struct value_print_options opts;
+
+      get_user_print_options (&opts);
+      value_fetch_lazy_limited (val, opts.print_max);
+    }
+
   if (voidprint || (val && value_type (val) &&
 		    TYPE_CODE (value_type (val)) != TYPE_CODE_VOID))
     print_value (val, &fmt);
@@ -1311,6 +1320,9 @@ output_command_const (const char *exp, int from_tty)
 
   get_formatted_print_options (&opts, format);
   opts.raw = fmt.raw;
+
+  if (value_lazy (val))
+    value_fetch_lazy_limited (val, opts.print_max);
   print_formatted (val, fmt.size, &opts, gdb_stdout);
 
   annotate_value_end ();
@@ -38,6 +38,9 @@ class PrettyPrinter(object):
             attribute, and, potentially, "enabled" attribute.
             Or this is None if there are no subprinters.
         enabled: A boolean indicating if the printer is enabled.
+        cacheable: A boolean indicating if the printer recognizes values
+            by their type alone, so that gdb need not ask it again for
+            other values of the same type.
 
     Subprinters are for situations where "one" pretty-printer is actually a
     collection of several printers.  E.g., The libstdc++ pretty-printer has
@@ -52,6 +55,7 @@ class PrettyPrinter(object):
         self.name = name
         self.subprinters = subprinters
         self.enabled = True
+        self.cacheable = False
 
     def __call__(self, val):
         # The subclass must define this.
@@ -153,6 +157,7 @@ def register_pretty_printer(obj, printer, replace=False):
             i = i + 1
 
     obj.pretty_printers.insert(0, printer)
+    gdb.invalidate_cached_pretty_printers()
 
 
 class RegexpCollectionPrettyPrinter(PrettyPrinter):
@@ -176,6 +181,8 @@ class RegexpCollectionPrettyPrinter(PrettyPrinter):
 
     def __init__(self, name):
         super(RegexpCollectionPrettyPrinter, self).__init__(name, [])
+        # Printers are chosen on the name of the type.
+        self.cacheable = True
 
     def add_printer(self, name, regexp, gen_printer):
         """Add a printer to the list.
@@ -199,6 +206,7 @@ class RegexpCollectionPrettyPrinter(PrettyPrinter):
 
         self.subprinters.append(self.RegexpSubprinter(name, regexp,
                                                       gen_printer))
+        gdb.invalidate_cached_pretty_printers()
 
     def __call__(self, val):
         """Lookup the pretty-printer for the provided value."""
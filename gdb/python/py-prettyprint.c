@@ -25,6 +25,7 @@
 #include "extension-priv.h"
 #include "python.h"
 #include "python-internal.h"
+#include "observer.h"
 
 /* Return type of print_string_repr.  */
 
@@ -38,141 +39,406 @@ enum string_repr_result
     string_repr_ok
   };
 
-/* Helper function for find_pretty_printer which iterates over a list,
-   calls each function and inspects output.  This will return a
-   printer object if one recognizes VALUE.  If no printer is found, it
-   will return None.  On error, it will set the Python error and
-   return NULL.  */
+/* Return 1 if the lookup function FUNCTION is enabled, 0 if it has
+   been disabled.  On error, set the Python error and return -1.  */
+
+static int
+pp_function_enabled_p (PyObject *function)
+{
+  PyObject *attr;
+  int cmp;
+
+  if (! PyObject_HasAttr (function, gdbpy_enabled_cst))
+    return 1;
+
+  attr = PyObject_GetAttr (function, gdbpy_enabled_cst);
+  if (!attr)
+    return -1;
+  cmp = PyObject_IsTrue (attr);
+  Py_DECREF (attr);
+  return cmp;
+}
+
+/* Return nonzero if the lookup function FUNCTION has a true
+   "cacheable" attribute, promising that whether it recognizes a value
+   only depends on the type of the value.  Errors count as "no".  */
+
+static int
+pp_function_cacheable_p (PyObject *function)
+{
+  PyObject *attr;
+  int cmp;
+
+  if (! PyObject_HasAttr (function, gdbpy_cacheable_cst))
+    return 0;
+
+  attr = PyObject_GetAttr (function, gdbpy_cacheable_cst);
+  if (!attr)
+    {
+      PyErr_Clear ();
+      return 0;
+    }
+  cmp = PyObject_IsTrue (attr);
+  Py_DECREF (attr);
+  if (cmp == -1)
+    {
+      PyErr_Clear ();
+      return 0;
+    }
+  return cmp;
+}
+
+/* Return a new list of the pretty-printer lists find_pretty_printer
+   searches, in order: that of each objfile in the current program
+   space, that of the current program space, and gdb.pretty_printers.
+   On error, set the Python error and return NULL.  */
 
 static PyObject *
-search_pp_list (PyObject *list, PyObject *value)
+get_pretty_printer_lists (void)
 {
-  Py_ssize_t pp_list_size, list_index;
-  PyObject *function, *printer = NULL;
+  PyObject *lists, *pp_list, *obj;
+  struct objfile *objfile;
+
+  lists = PyList_New (0);
+  if (lists == NULL)
+    return NULL;
+
+  ALL_OBJFILES (objfile)
+  {
+    PyObject *objf = objfile_to_objfile_object (objfile);
+    if (!objf)
+      {
+	/* Ignore the error and continue.  */
+	PyErr_Clear ();
+	continue;
+      }
+
+    pp_list = objfpy_get_printers (objf, NULL);
+    if (pp_list == NULL || PyList_Append (lists, pp_list) < 0)
+      goto fail;
+    Py_DECREF (pp_list);
+  }
 
-  pp_list_size = PyList_Size (list);
-  for (list_index = 0; list_index < pp_list_size; list_index++)
+  obj = pspace_to_pspace_object (current_program_space);
+  if (!obj)
+    goto fail_lists;
+  pp_list = pspy_get_printers (obj, NULL);
+  if (pp_list == NULL || PyList_Append (lists, pp_list) < 0)
+    goto fail;
+  Py_DECREF (pp_list);
+
+  /* The global pretty printer list.  */
+  if (gdb_python_module != NULL
+      && PyObject_HasAttrString (gdb_python_module, "pretty_printers"))
     {
-      function = PyList_GetItem (list, list_index);
-      if (! function)
+      pp_list = PyObject_GetAttrString (gdb_python_module, "pretty_printers");
+      if (pp_list != NULL && PyList_Check (pp_list)
+	  && PyList_Append (lists, pp_list) < 0)
+	goto fail;
+      if (pp_list == NULL)
+	PyErr_Clear ();
+      Py_XDECREF (pp_list);
+    }
+
+  return lists;
+
+ fail:
+  Py_XDECREF (pp_list);
+ fail_lists:
+  Py_DECREF (lists);
+  return NULL;
+}
+
+/* Helper function for find_pretty_printer which iterates over LISTS,
+   as returned by get_pretty_printer_lists, calls each function and
+   inspects output.  This will return a printer object if one
+   recognizes VALUE.  If no printer is found, it will return None.  On
+   error, it will set the Python error and return NULL.
+
+   If FUNCTIONS is not NULL, also append to it the functions that
+   cannot be skipped when looking for a printer for another value of
+   the same type (see struct pp_cache_entry), and set *FOUND to 1 if
+   the last of them is a cacheable function which recognized VALUE, to
+   -1 if another function recognized VALUE, and to 0 otherwise.  */
+
+static PyObject *
+search_pp_lists (PyObject *lists, PyObject *value, PyObject *functions,
+		 int *found)
+{
+  Py_ssize_t nr_lists, lists_index, pp_list_size, list_index;
+  PyObject *list, *function, *printer = NULL;
+
+  if (functions != NULL)
+    *found = 0;
+
+  nr_lists = PyList_Size (lists);
+  for (lists_index = 0; lists_index < nr_lists; lists_index++)
+    {
+      list = PyList_GetItem (lists, lists_index);
+      if (! list)
 	return NULL;
 
-      /* Skip if disabled.  */
-      if (PyObject_HasAttr (function, gdbpy_enabled_cst))
+      pp_list_size = PyList_Size (list);
+      for (list_index = 0; list_index < pp_list_size; list_index++)
 	{
-	  PyObject *attr = PyObject_GetAttr (function, gdbpy_enabled_cst);
-	  int cmp;
+	  int enabled, cacheable;
+
+	  function = PyList_GetItem (list, list_index);
+	  if (! function)
+	    return NULL;
 
-	  if (!attr)
+	  enabled = pp_function_enabled_p (function);
+	  if (enabled == -1)
 	    return NULL;
-	  cmp = PyObject_IsTrue (attr);
-	  Py_DECREF (attr);
-	  if (cmp == -1)
+
+	  /* A disabled function may be enabled again, and only those
+	     that promise to are assumed to answer the same for every
+	     value of a type.  */
+	  cacheable = functions != NULL && pp_function_cacheable_p (function);
+	  if (functions != NULL && (!enabled || !cacheable)
+	      && PyList_Append (functions, function) < 0)
 	    return NULL;
 
-	  if (!cmp)
+	  /* Skip if disabled.  */
+	  if (!enabled)
 	    continue;
-	}
 
-      printer = PyObject_CallFunctionObjArgs (function, value, NULL);
-      if (! printer)
-	return NULL;
-      else if (printer != Py_None)
-	return printer;
+	  printer = PyObject_CallFunctionObjArgs (function, value, NULL);
+	  if (! printer)
+	    return NULL;
+	  else if (printer != Py_None)
+	    {
+	      if (functions != NULL)
+		{
+		  if (cacheable && PyList_Append (functions, function) < 0)
+		    {
+		      Py_DECREF (printer);
+		      return NULL;
+		    }
+		  *found = cacheable ? 1 : -1;
+		}
+	      return printer;
+	    }
 
-      Py_DECREF (printer);
+	  Py_DECREF (printer);
+	}
     }
 
   Py_RETURN_NONE;
 }
 
-/* Subroutine of find_pretty_printer to simplify it.
-   Look for a pretty-printer to print VALUE in all objfiles.
-   The result is NULL if there's an error and the search should be terminated.
-   The result is Py_None, suitably inc-ref'd, if no pretty-printer was found.
-   Otherwise the result is the pretty-printer function, suitably inc-ref'd.  */
+/* Printing a large container calls find_pretty_printer for each of
+   its elements, which are all of the same type, and each call goes
+   through every lookup function of every list.  So remember for each
+   type which functions have to be called again: those which are not
+   cacheable or were disabled, and the cacheable function which
+   recognized the type, if any.
 
-static PyObject *
-find_pretty_printer_from_objfiles (PyObject *value)
+   The cache is keyed on the type of the value, and is flushed when the
+   lists it was filled from, or their lengths, change, when objfiles are
+   loaded or freed, and by gdb.invalidate_cached_pretty_printers.  */
+
+struct pp_cache_entry
 {
-  PyObject *pp_list;
-  PyObject *function;
-  struct objfile *obj;
+  struct type *type;
 
-  ALL_OBJFILES (obj)
-  {
-    PyObject *objf = objfile_to_objfile_object (obj);
-    if (!objf)
-      {
-	/* Ignore the error and continue.  */
-	PyErr_Clear ();
-	continue;
-      }
+  /* A tuple of the functions to call, in order.  */
+  PyObject *functions;
 
-    pp_list = objfpy_get_printers (objf, NULL);
-    function = search_pp_list (pp_list, value);
-    Py_XDECREF (pp_list);
+  /* Nonzero if the last function in FUNCTIONS is cacheable and
+     recognized TYPE.  */
+  int found;
+};
 
-    /* If there is an error in any objfile list, abort the search and exit.  */
-    if (! function)
-      return NULL;
+/* The cache, of struct pp_cache_entry.  */
+static htab_t pp_cache;
 
-    if (function != Py_None)
-      return function;
+/* The lists the cache was filled from, and their lengths at the
+   time.  */
+static PyObject *pp_cache_lists;
+static Py_ssize_t *pp_cache_sizes;
 
-    Py_DECREF (function);
-  }
+/* Incremented whenever the cache is flushed.  */
+static unsigned int pp_cache_generation;
 
-  Py_RETURN_NONE;
+/* Set when the cache must be flushed before it is next used.  This
+   can be set without holding the Python GIL.  */
+static int pp_cache_stale;
+
+static hashval_t
+pp_cache_hash (const void *p)
+{
+  const struct pp_cache_entry *entry = (const struct pp_cache_entry *) p;
+
+  return htab_hash_pointer (entry->type);
 }
 
-/* Subroutine of find_pretty_printer to simplify it.
-   Look for a pretty-printer to print VALUE in the current program space.
-   The result is NULL if there's an error and the search should be terminated.
-   The result is Py_None, suitably inc-ref'd, if no pretty-printer was found.
-   Otherwise the result is the pretty-printer function, suitably inc-ref'd.  */
+static int
+pp_cache_eq (const void *p1, const void *p2)
+{
+  const struct pp_cache_entry *e1 = (const struct pp_cache_entry *) p1;
+  const struct pp_cache_entry *e2 = (const struct pp_cache_entry *) p2;
 
-static PyObject *
-find_pretty_printer_from_progspace (PyObject *value)
+  return e1->type == e2->type;
+}
+
+static void
+pp_cache_del (void *p)
 {
-  PyObject *pp_list;
-  PyObject *function;
-  PyObject *obj = pspace_to_pspace_object (current_program_space);
+  struct pp_cache_entry *entry = (struct pp_cache_entry *) p;
 
-  if (!obj)
-    return NULL;
-  pp_list = pspy_get_printers (obj, NULL);
-  function = search_pp_list (pp_list, value);
-  Py_XDECREF (pp_list);
-  return function;
+  Py_DECREF (entry->functions);
+  xfree (entry);
+}
+
+/* Return nonzero if the cache was filled from LISTS, as returned by
+   get_pretty_printer_lists.  */
+
+static int
+pp_cache_valid_p (PyObject *lists)
+{
+  Py_ssize_t i, nr_lists = PyList_Size (lists);
+
+  if (pp_cache_stale || pp_cache_lists == NULL
+      || PyList_Size (pp_cache_lists) != nr_lists)
+    return 0;
+
+  for (i = 0; i < nr_lists; i++)
+    {
+      PyObject *list = PyList_GetItem (lists, i);
+
+      if (list != PyList_GetItem (pp_cache_lists, i)
+	  || PyList_Size (list) != pp_cache_sizes[i])
+	return 0;
+    }
+
+  return 1;
+}
+
+/* Flush the cache, and fill it from LISTS from now on.  */
+
+static void
+pp_cache_reset (PyObject *lists)
+{
+  Py_ssize_t i, nr_lists = PyList_Size (lists);
+
+  if (pp_cache == NULL)
+    pp_cache = htab_create_alloc (64, pp_cache_hash, pp_cache_eq,
+				  pp_cache_del, xcalloc, xfree);
+  else
+    htab_empty (pp_cache);
+
+  Py_INCREF (lists);
+  Py_XDECREF (pp_cache_lists);
+  pp_cache_lists = lists;
+  pp_cache_sizes = XRESIZEVEC (Py_ssize_t, pp_cache_sizes, nr_lists);
+  for (i = 0; i < nr_lists; i++)
+    pp_cache_sizes[i] = PyList_Size (PyList_GetItem (lists, i));
+
+  pp_cache_generation++;
+  pp_cache_stale = 0;
+}
+
+/* Record FUNCTIONS and FOUND, as set by search_pp_lists, for TYPE.
+   Errors are ignored; the type is then just not cached.  */
+
+static void
+pp_cache_insert (struct type *type, PyObject *functions, int found)
+{
+  struct pp_cache_entry *entry;
+  PyObject *tuple;
+  void **slot;
+
+  tuple = PyList_AsTuple (functions);
+  if (tuple == NULL)
+    {
+      PyErr_Clear ();
+      return;
+    }
+
+  entry = XNEW (struct pp_cache_entry);
+  entry->type = type;
+  entry->functions = tuple;
+  entry->found = found;
+
+  slot = htab_find_slot (pp_cache, entry, INSERT);
+  if (*slot != NULL)
+    pp_cache_del (*slot);
+  *slot = entry;
 }
 
-/* Subroutine of find_pretty_printer to simplify it.
-   Look for a pretty-printer to print VALUE in the gdb module.
-   The result is NULL if there's an error and the search should be terminated.
-   The result is Py_None, suitably inc-ref'd, if no pretty-printer was found.
-   Otherwise the result is the pretty-printer function, suitably inc-ref'd.  */
+/* Look for a pretty-printer for VALUE by calling FUNCTIONS, a tuple
+   from a cache entry, with FOUND as in that entry.  Return as
+   find_pretty_printer, except that if the entry turns out to be out of
+   date, set *STALE and return NULL without setting the Python
+   error.  */
 
 static PyObject *
-find_pretty_printer_from_gdb (PyObject *value)
+search_pp_cache_functions (PyObject *functions, int found, PyObject *value,
+			   int *stale)
 {
-  PyObject *pp_list;
-  PyObject *function;
-
-  /* Fetch the global pretty printer list.  */
-  if (gdb_python_module == NULL
-      || ! PyObject_HasAttrString (gdb_python_module, "pretty_printers"))
-    Py_RETURN_NONE;
-  pp_list = PyObject_GetAttrString (gdb_python_module, "pretty_printers");
-  if (pp_list == NULL || ! PyList_Check (pp_list))
+  Py_ssize_t nr_functions, i;
+  PyObject *function, *printer;
+
+  *stale = 0;
+  nr_functions = PyTuple_Size (functions);
+  for (i = 0; i < nr_functions; i++)
     {
-      Py_XDECREF (pp_list);
-      Py_RETURN_NONE;
+      int last = found && i == nr_functions - 1;
+      int enabled;
+
+      function = PyTuple_GetItem (functions, i);
+      if (! function)
+	return NULL;
+
+      enabled = pp_function_enabled_p (function);
+      if (enabled == -1)
+	return NULL;
+      if (!enabled)
+	{
+	  if (last)
+	    {
+	      *stale = 1;
+	      return NULL;
+	    }
+	  continue;
+	}
+
+      printer = PyObject_CallFunctionObjArgs (function, value, NULL);
+      if (! printer)
+	return NULL;
+      else if (printer != Py_None)
+	return printer;
+
+      Py_DECREF (printer);
+
+      /* A function which said it was cacheable changed its mind.  */
+      if (last)
+	{
+	  *stale = 1;
+	  return NULL;
+	}
     }
 
-  function = search_pp_list (pp_list, value);
-  Py_XDECREF (pp_list);
-  return function;
+  Py_RETURN_NONE;
+}
+
+/* Observer for the new_objfile and free_objfile events.  Types may
+   be freed along with an objfile and their addresses reused.  */
+
+static void
+pp_cache_objfile_changed (struct objfile *objfile)
+{
+  pp_cache_stale = 1;
+}
+
+/* Implementation of gdb.invalidate_cached_pretty_printers.  */
+
+PyObject *
+gdbpy_invalidate_cached_pretty_printers (PyObject *self, PyObject *args)
+{
+  pp_cache_stale = 1;
+  Py_RETURN_NONE;
 }
 
 /* Find the pretty-printing constructor function for VALUE.  If no
@@ -182,23 +448,59 @@ find_pretty_printer_from_gdb (PyObject *value)
 static PyObject *
 find_pretty_printer (PyObject *value)
 {
-  PyObject *function;
-
-  /* Look at the pretty-printer list for each objfile
-     in the current program-space.  */
-  function = find_pretty_printer_from_objfiles (value);
-  if (function == NULL || function != Py_None)
-    return function;
-  Py_DECREF (function);
-
-  /* Look at the pretty-printer list for the current program-space.  */
-  function = find_pretty_printer_from_progspace (value);
-  if (function == NULL || function != Py_None)
-    return function;
-  Py_DECREF (function);
-
-  /* Look at the pretty-printer list in the gdb module.  */
-  function = find_pretty_printer_from_gdb (value);
+  struct value *val = value_object_to_value (value);
+  PyObject *lists, *functions, *function, *cached;
+  struct pp_cache_entry key, *entry;
+  unsigned int generation;
+  int found;
+
+  lists = get_pretty_printer_lists ();
+  if (lists == NULL)
+    return NULL;
+
+  if (val == NULL)
+    {
+      function = search_pp_lists (lists, value, NULL, NULL);
+      Py_DECREF (lists);
+      return function;
+    }
+
+  if (! pp_cache_valid_p (lists))
+    pp_cache_reset (lists);
+
+  key.type = value_type (val);
+  entry = (struct pp_cache_entry *) htab_find (pp_cache, &key);
+  if (entry != NULL)
+    {
+      int stale;
+
+      /* The functions may well flush the cache under our feet.  */
+      cached = entry->functions;
+      Py_INCREF (cached);
+      function = search_pp_cache_functions (cached, entry->found, value,
+					    &stale);
+      Py_DECREF (cached);
+      if (!stale)
+	{
+	  Py_DECREF (lists);
+	  return function;
+	}
+    }
+
+  functions = PyList_New (0);
+  if (functions == NULL)
+    {
+      Py_DECREF (lists);
+      return NULL;
+    }
+
+  generation = pp_cache_generation;
+  function = search_pp_lists (lists, value, functions, &found);
+  if (function != NULL && found != -1 && generation == pp_cache_generation)
+    pp_cache_insert (key.type, functions, found);
+
+  Py_DECREF (functions);
+  Py_DECREF (lists);
   return function;
 }
 
@@ -480,6 +782,7 @@ print_children (PyObject *printer, const char *hint,
   int is_map, is_array, done_flag, pretty;
   unsigned int i;
   PyObject *children, *iter;
+  struct value_readahead readahead = { 0 };
 #ifndef IS_PY3K
   PyObject *frame;
 #endif
@@ -665,7 +968,11 @@ print_children (PyObject *printer, const char *hint,
 	      error (_("Error while executing Python code."));
 	    }
 	  else
-	    common_val_print (value, stream, recurse + 1, options, language);
+	    {
+	      value_readahead (&readahead, value, options->print_max - i);
+	      common_val_print (value, stream, recurse + 1, options,
+				language);
+	    }
 	}
 
       if (is_map && i % 2 == 0)
@@ -850,3 +1157,11 @@ gdbpy_default_visualizer (PyObject *self, PyObject *args)
   cons = find_pretty_printer (val_obj);
   return cons;
 }
+
+int
+gdbpy_initialize_prettyprint (void)
+{
+  observer_attach_new_objfile (pp_cache_objfile_changed);
+  observer_attach_free_objfile (pp_cache_objfile_changed);
+  return 0;
+}
@@ -990,6 +990,37 @@ valpy_fetch_lazy (PyObject *self, PyObject *args)
   Py_RETURN_NONE;
 }
 
+/* Implements gdb.Value.prefetch ([count]).  */
+
+static PyObject *
+valpy_prefetch (PyObject *self, PyObject *args)
+{
+  struct value *value = ((value_object *) self)->value;
+  gdb_py_longest count = 1;
+  ULONGEST done = 0;
+
+  if (!PyArg_ParseTuple (args, "|" GDB_PY_LL_ARG, &count))
+    return NULL;
+
+  TRY
+    {
+      struct cleanup *cleanup = make_cleanup_value_free_to_mark (value_mark ());
+
+      /* For a pointer, prefetch what it points to.  */
+      if (TYPE_CODE (check_typedef (value_type (value))) == TYPE_CODE_PTR)
+	value = value_ind (value);
+      done = value_prefetch (value, count);
+      do_cleanups (cleanup);
+    }
+  CATCH (except, RETURN_MASK_ALL)
+    {
+      GDB_PY_HANDLE_EXCEPTION (except);
+    }
+  END_CATCH
+
+  return gdb_py_long_from_ulongest (done);
+}
+
 /* Calculate and return the address of the PyObject as the value of
    the builtin __hash__ call.  */
 static Py_hash_t
@@ -1786,6 +1817,10 @@ Return a lazy string representation of the value." },
 Return Unicode string representation of the value." },
   { "fetch_lazy", valpy_fetch_lazy, METH_NOARGS,
     "Fetches the value from the inferior, if it was lazy." },
+  { "prefetch", valpy_prefetch, METH_VARARGS,
+    "prefetch ([count]) -> int\n\
+Read COUNT objects starting at the value, or at what it points to if it\n\
+is a pointer, from the inferior at once." },
   {NULL}  /* Sentinel */
 };
 
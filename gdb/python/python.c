@@ -120,6 +120,7 @@ PyObject *gdbpy_children_cst;
 PyObject *gdbpy_display_hint_cst;
 PyObject *gdbpy_doc_cst;
 PyObject *gdbpy_enabled_cst;
+PyObject *gdbpy_cacheable_cst;
 PyObject *gdbpy_value_cst;
 
 /* The GdbError exception.  */
@@ -1818,7 +1819,8 @@ message == an error message without a stack will be printed."),
       || gdbpy_initialize_clear_objfiles_event ()  < 0
       || gdbpy_initialize_arch () < 0
       || gdbpy_initialize_xmethods () < 0
-      || gdbpy_initialize_unwind () < 0)
+      || gdbpy_initialize_unwind () < 0
+      || gdbpy_initialize_prettyprint () < 0)
     goto fail;
 
   gdbpy_to_string_cst = PyString_FromString ("to_string");
@@ -1836,6 +1838,9 @@ message == an error message without a stack will be printed."),
   gdbpy_enabled_cst = PyString_FromString ("enabled");
   if (gdbpy_enabled_cst == NULL)
     goto fail;
+  gdbpy_cacheable_cst = PyString_FromString ("cacheable");
+  if (gdbpy_cacheable_cst == NULL)
+    goto fail;
   gdbpy_value_cst = PyString_FromString ("value");
   if (gdbpy_value_cst == NULL)
     goto fail;
@@ -2073,6 +2078,10 @@ Return a tuple containing all inferiors." },
     "invalidate_cached_frames () -> None.\n\
 Invalidate any cached frame objects in gdb.\n\
 Intended for internal use only." },
+  { "invalidate_cached_pretty_printers",
+    gdbpy_invalidate_cached_pretty_printers, METH_NOARGS,
+    "invalidate_cached_pretty_printers () -> None.\n\
+Forget which pretty-printer lookup functions recognized which types." },
 
   {NULL, NULL, 0, NULL}
 };
@@ -83,22 +83,12 @@ struct record_full_mem_entry
   /* Set this flag if target memory for this entry
      can no longer be accessed.  */
   int mem_entry_not_accessible;
-  union
-  {
-    gdb_byte *ptr;
-    gdb_byte buf[sizeof (gdb_byte *)];
-  } u;
 };
 
 struct record_full_reg_entry
 {
   unsigned short num;
   unsigned short len;
-  union 
-  {
-    gdb_byte *ptr;
-    gdb_byte buf[2 * sizeof (gdb_byte *)];
-  } u;
 };
 
 struct record_full_end_entry
@@ -128,7 +118,8 @@ enum record_full_type
    Each list element (struct record_full_entry), in addition to next
    and prev pointers, consists of a union of three entry types: mem,
    reg, and end.  A field called "type" determines which entry type is
-   represented by a given list element.
+   represented by a given list element.  The values of the mem and reg
+   entries are kept apart, in record_full_data.
 
    Each instruction that is added to the execution log is represented
    by a variable number of list elements ('entries').  The instruction
@@ -142,7 +133,24 @@ struct record_full_entry
 {
   struct record_full_entry *prev;
   struct record_full_entry *next;
-  enum record_full_type type;
+  ENUM_BITFIELD (record_full_type) type : 8;
+
+  /* Set when the entry is released, until its slot is reclaimed.  */
+  unsigned int released : 1;
+
+  /* For a reg or mem entry, clear if the value is kept whole: it is
+     what executing the entry writes back.  Set if the value is kept
+     as the XOR of the contents before and after the instruction, for
+     the DATA_LEN bytes from DATA_START on; the other bytes are the
+     same before and after.  */
+  unsigned int delta : 1;
+
+  /* Offset of the value in record_full_data, the first byte of the
+     register or memory it covers, and its length.  */
+  unsigned int data;
+  unsigned int data_start;
+  unsigned int data_len;
+
   union
   {
     /* reg */
@@ -233,6 +241,335 @@ static void record_full_goto_insn (struct record_full_entry *entry,
 static void record_full_save (struct target_ops *self,
 			      const char *recfilename);
 
+/* The entries live in a ring of slots, and the values of the reg and
+   mem entries in a ring of bytes.  Instructions enter the log at one
+   end and leave it at the other, or are cut off the end when the log
+   is truncated, so both rings are used in order, and the space of the
+   oldest instruction is reused for the next one.  A ring only grows
+   when an instruction does not fit, which stops once the log holds
+   record_full_insn_max_num instructions, and is compacted when that
+   limit is lowered.  Both are freed when the last entry is released.
+
+   A value is kept whole when it is recorded.  Once the instruction
+   has run, record_full_pack_insn replaces it with the bytes that
+   changed, XORed with their new value, so that most registers take a
+   byte or two and values that did not change take none.  */
+
+#define RECORD_FULL_RING_SLOTS 4096
+#define RECORD_FULL_RING_BYTES 65536
+
+/* The ring of entries: its slots, the index of the oldest entry, and
+   the number of slots from it to the newest, released or not.  */
+static struct record_full_entry *record_full_slots;
+static unsigned int record_full_slots_size;
+static unsigned int record_full_slots_head;
+static unsigned int record_full_slots_used;
+
+/* The ring of values.  The values in use start at
+   record_full_data_head and end at record_full_data_tail; if
+   record_full_data_wrapped, they go on from the end of the ring to
+   its start.  */
+static gdb_byte *record_full_data;
+static unsigned int record_full_data_size;
+static unsigned int record_full_data_head;
+static unsigned int record_full_data_tail;
+static int record_full_data_wrapped;
+
+/* The thread whose registers the last instruction of the log
+   recorded.  */
+static ptid_t record_full_pack_ptid;
+
+/* Return the entry in slot I of the ring, counting from the oldest.  */
+
+static inline struct record_full_entry *
+record_full_slot (unsigned int i)
+{
+  return &record_full_slots[(record_full_slots_head + i)
+			    % record_full_slots_size];
+}
+
+/* Set the bounds of the values in use from the oldest and the newest
+   entries that hold a value.  */
+
+static void
+record_full_data_update (void)
+{
+  struct record_full_entry *first = NULL, *last = NULL;
+  unsigned int i, j;
+
+  for (i = 0; i < record_full_slots_used; i++)
+    {
+      struct record_full_entry *rec = record_full_slot (i);
+
+      if (!rec->released && rec->data_len != 0)
+	{
+	  first = rec;
+	  break;
+	}
+    }
+  for (j = record_full_slots_used; first != NULL && j > i; j--)
+    {
+      struct record_full_entry *rec = record_full_slot (j - 1);
+
+      if (!rec->released && rec->data_len != 0)
+	{
+	  last = rec;
+	  break;
+	}
+    }
+
+  if (first == NULL)
+    {
+      record_full_data_head = 0;
+      record_full_data_tail = 0;
+      record_full_data_wrapped = 0;
+    }
+  else
+    {
+      record_full_data_head = first->data;
+      record_full_data_tail = last->data + last->data_len;
+      record_full_data_wrapped = last->data < first->data;
+    }
+}
+
+/* Take LEN bytes at the end of the ring of values.  Set *OFFSET to
+   their offset and return 1, or return 0 if they do not fit.  */
+
+static int
+record_full_data_alloc (unsigned int len, unsigned int *offset)
+{
+  if (!record_full_data_wrapped)
+    {
+      if (record_full_data_size - record_full_data_tail >= len)
+	{
+	  *offset = record_full_data_tail;
+	  record_full_data_tail += len;
+	  return 1;
+	}
+      if (record_full_data_head >= len)
+	{
+	  *offset = 0;
+	  record_full_data_tail = len;
+	  record_full_data_wrapped = 1;
+	  return 1;
+	}
+      return 0;
+    }
+
+  if (record_full_data_head - record_full_data_tail >= len)
+    {
+      *offset = record_full_data_tail;
+      record_full_data_tail += len;
+      return 1;
+    }
+  return 0;
+}
+
+/* Return the number of bytes of values in use.  */
+
+static ULONGEST
+record_full_data_used (void)
+{
+  ULONGEST used = 0;
+  unsigned int i;
+
+  for (i = 0; i < record_full_slots_used; i++)
+    {
+      struct record_full_entry *rec = record_full_slot (i);
+
+      if (!rec->released)
+	used += rec->data_len;
+    }
+  return used;
+}
+
+/* Move the entries and their values in use to new rings of SLOTS
+   slots and BYTES bytes, which must be large enough, in order from
+   the start of each, and fix up the links between them.  */
+
+static void
+record_full_ring_resize (unsigned int slots, unsigned int bytes)
+{
+  struct record_full_entry *new_slots = XNEWVEC (struct record_full_entry,
+						 slots);
+  gdb_byte *new_data = (gdb_byte *) xmalloc (bytes);
+  unsigned int *map = XNEWVEC (unsigned int, record_full_slots_used + 1);
+  unsigned int i, n = 0, pos = 0;
+
+/* Return where the entry REC of the old ring went.  */
+#define RECORD_FULL_RELOC(rec)						\
+  ((rec) == NULL || (rec) == &record_full_first				\
+   ? (rec)								\
+   : &new_slots[map[((rec) - record_full_slots + record_full_slots_size	\
+		     - record_full_slots_head) % record_full_slots_size]])
+
+  for (i = 0; i < record_full_slots_used; i++)
+    {
+      struct record_full_entry *rec = record_full_slot (i);
+
+      if (rec->released)
+	continue;
+
+      gdb_assert (n < slots && pos + rec->data_len <= bytes);
+      map[i] = n;
+      new_slots[n] = *rec;
+      if (rec->data_len != 0)
+	{
+	  memcpy (new_data + pos, record_full_data + rec->data,
+		  rec->data_len);
+	  new_slots[n].data = pos;
+	  pos += rec->data_len;
+	}
+      n++;
+    }
+
+  for (i = 0; i < n; i++)
+    {
+      new_slots[i].prev = RECORD_FULL_RELOC (new_slots[i].prev);
+      new_slots[i].next = RECORD_FULL_RELOC (new_slots[i].next);
+    }
+  record_full_first.next = RECORD_FULL_RELOC (record_full_first.next);
+  record_full_list = RECORD_FULL_RELOC (record_full_list);
+  record_full_arch_list_head = RECORD_FULL_RELOC (record_full_arch_list_head);
+  record_full_arch_list_tail = RECORD_FULL_RELOC (record_full_arch_list_tail);
+
+#undef RECORD_FULL_RELOC
+
+  xfree (map);
+  xfree (record_full_slots);
+  xfree (record_full_data);
+
+  record_full_slots = new_slots;
+  record_full_slots_size = slots;
+  record_full_slots_head = 0;
+  record_full_slots_used = n;
+  record_full_data = new_data;
+  record_full_data_size = bytes;
+  record_full_data_head = 0;
+  record_full_data_tail = pos;
+  record_full_data_wrapped = 0;
+}
+
+/* Return the smallest size from MIN on, doubling, that is at least
+   NEEDED.  */
+
+static unsigned int
+record_full_ring_size (unsigned int min, ULONGEST needed)
+{
+  ULONGEST size = min;
+
+  while (size < needed)
+    size *= 2;
+  if (size > UINT_MAX / 2)
+    error (_("Process record: the execution log is too large."));
+  return size;
+}
+
+/* Make room for one more entry with a value of LEN bytes.  */
+
+static void
+record_full_ring_grow (unsigned int len)
+{
+  unsigned int slots = record_full_slots_size;
+  unsigned int bytes = record_full_data_size;
+
+  if (record_full_slots_used == record_full_slots_size)
+    slots = record_full_ring_size (RECORD_FULL_RING_SLOTS,
+				   (ULONGEST) record_full_slots_size + 1);
+  else
+    bytes = std::max (bytes,
+		      record_full_ring_size (RECORD_FULL_RING_BYTES,
+					     2 * (record_full_data_used ()
+						  + len)));
+  record_full_ring_resize (slots, bytes);
+}
+
+/* Shrink the rings to twice what is in use, after the log lost
+   instructions.  */
+
+static void
+record_full_ring_shrink (void)
+{
+  unsigned int slots, bytes;
+
+  if (record_full_slots_used == 0)
+    return;
+
+  slots = record_full_ring_size (RECORD_FULL_RING_SLOTS,
+				 2 * (ULONGEST) record_full_slots_used);
+  bytes = record_full_ring_size (RECORD_FULL_RING_BYTES,
+				 2 * record_full_data_used ());
+  /* No instruction is being recorded; the arch list may still point
+     to entries released since.  */
+  record_full_arch_list_head = NULL;
+  record_full_arch_list_tail = NULL;
+
+  if (slots < record_full_slots_size || bytes < record_full_data_size)
+    record_full_ring_resize (std::min (slots, record_full_slots_size),
+			     std::min (bytes, record_full_data_size));
+}
+
+/* Return a cleared entry of type TYPE, with a whole value of LEN
+   bytes.  */
+
+static struct record_full_entry *
+record_full_entry_new (enum record_full_type type, unsigned int len)
+{
+  struct record_full_entry *rec;
+  unsigned int offset = 0;
+
+  while (record_full_slots_used == record_full_slots_size
+	 || (len != 0 && !record_full_data_alloc (len, &offset)))
+    record_full_ring_grow (len);
+
+  rec = record_full_slot (record_full_slots_used++);
+  memset (rec, 0, sizeof (*rec));
+  rec->type = type;
+  rec->data = offset;
+  rec->data_len = len;
+  return rec;
+}
+
+/* Release REC, and reclaim the slots and the values of the released
+   entries at either end of the rings.  Free the rings once no entry
+   is left.  */
+
+static void
+record_full_entry_delete (struct record_full_entry *rec)
+{
+  int had_data = 0;
+
+  rec->released = 1;
+
+  while (record_full_slots_used != 0 && record_full_slot (0)->released)
+    {
+      had_data |= record_full_slot (0)->data_len != 0;
+      record_full_slots_head
+	= (record_full_slots_head + 1) % record_full_slots_size;
+      record_full_slots_used--;
+    }
+  while (record_full_slots_used != 0
+	 && record_full_slot (record_full_slots_used - 1)->released)
+    {
+      had_data |= record_full_slot (record_full_slots_used - 1)->data_len != 0;
+      record_full_slots_used--;
+    }
+
+  if (record_full_slots_used == 0)
+    {
+      xfree (record_full_slots);
+      record_full_slots = NULL;
+      record_full_slots_size = 0;
+      record_full_slots_head = 0;
+      xfree (record_full_data);
+      record_full_data = NULL;
+      record_full_data_size = 0;
+      record_full_data_update ();
+    }
+  else if (had_data)
+    record_full_data_update ();
+}
+
 /* Alloc and free functions for record_full_reg, record_full_mem, and
    record_full_end entries.  */
 
@@ -244,12 +581,10 @@ record_full_reg_alloc (struct regcache *regcache, int regnum)
   struct record_full_entry *rec;
   struct gdbarch *gdbarch = get_regcache_arch (regcache);
 
-  rec = XCNEW (struct record_full_entry);
-  rec->type = record_full_reg;
+  rec = record_full_entry_new (record_full_reg,
+			       register_size (gdbarch, regnum));
   rec->u.reg.num = regnum;
   rec->u.reg.len = register_size (gdbarch, regnum);
-  if (rec->u.reg.len > sizeof (rec->u.reg.u.buf))
-    rec->u.reg.u.ptr = (gdb_byte *) xmalloc (rec->u.reg.len);
 
   return rec;
 }
@@ -260,9 +595,7 @@ static inline void
 record_full_reg_release (struct record_full_entry *rec)
 {
   gdb_assert (rec->type == record_full_reg);
-  if (rec->u.reg.len > sizeof (rec->u.reg.u.buf))
-    xfree (rec->u.reg.u.ptr);
-  xfree (rec);
+  record_full_entry_delete (rec);
 }
 
 /* Alloc a record_full_mem record entry.  */
@@ -272,12 +605,9 @@ record_full_mem_alloc (CORE_ADDR addr, int len)
 {
   struct record_full_entry *rec;
 
-  rec = XCNEW (struct record_full_entry);
-  rec->type = record_full_mem;
+  rec = record_full_entry_new (record_full_mem, len);
   rec->u.mem.addr = addr;
   rec->u.mem.len = len;
-  if (rec->u.mem.len > sizeof (rec->u.mem.u.buf))
-    rec->u.mem.u.ptr = (gdb_byte *) xmalloc (len);
 
   return rec;
 }
@@ -288,9 +618,7 @@ static inline void
 record_full_mem_release (struct record_full_entry *rec)
 {
   gdb_assert (rec->type == record_full_mem);
-  if (rec->u.mem.len > sizeof (rec->u.mem.u.buf))
-    xfree (rec->u.mem.u.ptr);
-  xfree (rec);
+  record_full_entry_delete (rec);
 }
 
 /* Alloc a record_full_end record entry.  */
@@ -300,8 +628,7 @@ record_full_end_alloc (void)
 {
   struct record_full_entry *rec;
 
-  rec = XCNEW (struct record_full_entry);
-  rec->type = record_full_end;
+  rec = record_full_entry_new (record_full_end, 0);
 
   return rec;
 }
@@ -311,7 +638,7 @@ record_full_end_alloc (void)
 static inline void
 record_full_end_release (struct record_full_entry *rec)
 {
-  xfree (rec);
+  record_full_entry_delete (rec);
 }
 
 /* Free one record entry, any type.
@@ -442,22 +769,159 @@ record_full_arch_list_add (struct record_full_entry *rec)
 static inline gdb_byte *
 record_full_get_loc (struct record_full_entry *rec)
 {
-  switch (rec->type) {
-  case record_full_mem:
-    if (rec->u.mem.len > sizeof (rec->u.mem.u.buf))
-      return rec->u.mem.u.ptr;
-    else
-      return rec->u.mem.u.buf;
-  case record_full_reg:
-    if (rec->u.reg.len > sizeof (rec->u.reg.u.buf))
-      return rec->u.reg.u.ptr;
-    else
-      return rec->u.reg.u.buf;
-  case record_full_end:
-  default:
-    gdb_assert_not_reached ("unexpected record_full_entry type");
-    return NULL;
-  }
+  gdb_assert (rec->type != record_full_end);
+  return record_full_data + rec->data;
+}
+
+/* XOR the LEN bytes of DELTA into BUF.  */
+
+static void
+record_full_xor (gdb_byte *buf, const gdb_byte *delta, unsigned int len)
+{
+  unsigned int i;
+
+  for (i = 0; i < len; i++)
+    buf[i] ^= delta[i];
+}
+
+/* Return in BUF the value that executing REC would write back, given
+   the current contents of its register or memory.  */
+
+static void
+record_full_entry_value (struct regcache *regcache, struct gdbarch *gdbarch,
+			 struct record_full_entry *rec, gdb_byte *buf)
+{
+  if (!rec->delta)
+    {
+      memcpy (buf, record_full_get_loc (rec), rec->data_len);
+      return;
+    }
+
+  if (rec->type == record_full_reg)
+    regcache_cooked_read (regcache, rec->u.reg.num, buf);
+  else if (rec->u.mem.mem_entry_not_accessible
+	   || record_read_memory (gdbarch, rec->u.mem.addr, buf,
+				  rec->u.mem.len))
+    memset (buf, 0, rec->u.mem.len);
+  record_full_xor (buf + rec->data_start, record_full_get_loc (rec),
+		   rec->data_len);
+}
+
+/* Replace the whole values of the reg and mem entries of the
+   instruction that ends with the end entry END by the bytes it
+   changed, XORed with their new value, and move them together at the
+   end of the ring of values if they are the last ones there.  The
+   registers are read from REGCACHE, or kept whole if it is NULL.
+   The inferior must be in the state right after the instruction.  */
+
+static void
+record_full_pack_insn (struct record_full_entry *end,
+		       struct regcache *regcache)
+{
+  struct gdbarch *gdbarch = target_gdbarch ();
+  struct record_full_entry *first, *rec, *later;
+  gdb_byte *buf = NULL;
+  struct cleanup *old_cleanups = make_cleanup (free_current_contents, &buf);
+  unsigned int pos;
+
+  for (first = end;
+       first->prev != NULL && first->prev != &record_full_first
+	 && first->prev->type != record_full_end;
+       first = first->prev)
+    ;
+
+  for (rec = first; rec != end; rec = rec->next)
+    {
+      gdb_byte *loc = record_full_get_loc (rec);
+      unsigned int start, stop;
+
+      if (rec->delta || rec->data_len == 0)
+	continue;
+
+      buf = (gdb_byte *) xrealloc (buf, rec->data_len);
+      if (rec->type == record_full_reg)
+	{
+	  if (regcache == NULL)
+	    continue;
+	  regcache_raw_read (regcache, rec->u.reg.num, buf);
+	}
+      else if (rec->u.mem.mem_entry_not_accessible
+	       || record_read_memory (gdbarch, rec->u.mem.addr, buf,
+				      rec->u.mem.len))
+	continue;
+
+      record_full_xor (buf, loc, rec->data_len);
+
+      /* Going backward, the bytes that a later entry of the
+	 instruction also covers are back to their old value when REC
+	 is reached; going forward, they only change after it.  */
+      for (later = rec->next; later != end; later = later->next)
+	if (later->type != rec->type)
+	  continue;
+	else if (rec->type == record_full_reg)
+	  {
+	    if (later->u.reg.num == rec->u.reg.num)
+	      memset (buf, 0, rec->data_len);
+	  }
+	else
+	  {
+	    CORE_ADDR lo = std::max (rec->u.mem.addr, later->u.mem.addr);
+	    CORE_ADDR hi = std::min (rec->u.mem.addr + rec->u.mem.len,
+				     later->u.mem.addr + later->u.mem.len);
+
+	    if (lo < hi)
+	      memset (buf + (lo - rec->u.mem.addr), 0, hi - lo);
+	  }
+
+      for (start = 0; start < rec->data_len && buf[start] == 0; start++)
+	;
+      for (stop = rec->data_len; stop > start && buf[stop - 1] == 0; stop--)
+	;
+      memcpy (loc, buf + start, stop - start);
+      rec->delta = 1;
+      rec->data_start = start;
+      rec->data_len = stop - start;
+    }
+
+  do_cleanups (old_cleanups);
+
+  /* Close the gaps the values left, unless later entries hold values
+     after them.  A value that is before the previous one in the ring
+     starts the part that wrapped around.  */
+  if (end != record_full_slot (record_full_slots_used - 1))
+    return;
+
+  pos = UINT_MAX;
+  for (rec = first; rec != end; rec = rec->next)
+    {
+      if (rec->data_len == 0)
+	continue;
+      if (pos != UINT_MAX && rec->data >= pos)
+	{
+	  memmove (record_full_data + pos, record_full_data + rec->data,
+		   rec->data_len);
+	  rec->data = pos;
+	}
+      pos = rec->data + rec->data_len;
+    }
+  record_full_data_update ();
+}
+
+/* Pack the last instruction of the log, when recording.  */
+
+static void
+record_full_pack_last_insn (void)
+{
+  struct regcache *regcache = NULL;
+
+  if (record_full_list == &record_full_first
+      || record_full_list->next != NULL
+      || record_full_list->type != record_full_end)
+    return;
+
+  if (ptid_equal (record_full_pack_ptid, inferior_ptid))
+    regcache = get_current_regcache ();
+  record_full_pack_insn (record_full_list, regcache);
 }
 
 /* Record the value of a register NUM to record_full_arch_list.  */
@@ -571,6 +1035,9 @@ record_full_message (struct regcache *regcache, enum gdb_signal signal)
   struct cleanup *old_cleanups
     = make_cleanup (record_full_arch_list_cleanups, 0);
 
+  /* The previous instruction has run.  */
+  record_full_pack_last_insn ();
+
   record_full_arch_list_head = NULL;
   record_full_arch_list_tail = NULL;
 
@@ -626,6 +1093,7 @@ record_full_message (struct regcache *regcache, enum gdb_signal signal)
   record_full_list->next = record_full_arch_list_head;
   record_full_arch_list_head->prev = record_full_list;
   record_full_list = record_full_arch_list_tail;
+  record_full_pack_ptid = inferior_ptid;
 
   if (record_full_insn_num == record_full_insn_max_num)
     record_full_list_release_first ();
@@ -707,6 +1175,17 @@ record_full_exec_insn (struct regcache *regcache,
                               entry->u.reg.num);
 
         regcache_cooked_read (regcache, entry->u.reg.num, reg);
+	if (entry->delta)
+	  {
+	    /* The same delta takes the register either way.  */
+	    if (entry->data_len != 0)
+	      {
+		record_full_xor (reg + entry->data_start,
+				 record_full_get_loc (entry), entry->data_len);
+		regcache_cooked_write (regcache, entry->u.reg.num, reg);
+	      }
+	    break;
+	  }
         regcache_cooked_write (regcache, entry->u.reg.num, 
 			       record_full_get_loc (entry));
         memcpy (record_full_get_loc (entry), reg, entry->u.reg.len);
@@ -715,10 +1194,16 @@ record_full_exec_insn (struct regcache *regcache,
 
     case record_full_mem: /* mem */
       {
-	/* Nothing to do if the entry is flagged not_accessible.  */
-        if (!entry->u.mem.mem_entry_not_accessible)
+	/* Nothing to do if the entry is flagged not_accessible, or if
+	   it is a delta of memory that did not change.  */
+        if (!entry->u.mem.mem_entry_not_accessible
+	    && (!entry->delta || entry->data_len != 0))
           {
-            gdb_byte *mem = (gdb_byte *) xmalloc (entry->u.mem.len);
+	    /* A delta only covers the bytes that changed, and the
+	       same delta takes them either way.  */
+	    CORE_ADDR addr = entry->u.mem.addr + entry->data_start;
+	    int len = entry->delta ? entry->data_len : entry->u.mem.len;
+            gdb_byte *mem = (gdb_byte *) xmalloc (len);
             struct cleanup *cleanup = make_cleanup (xfree, mem);
 
             if (record_debug > 1)
@@ -729,14 +1214,16 @@ record_full_exec_insn (struct regcache *regcache,
                                   paddress (gdbarch, entry->u.mem.addr),
                                   entry->u.mem.len);
 
-            if (record_read_memory (gdbarch,
-				    entry->u.mem.addr, mem, entry->u.mem.len))
+            if (record_read_memory (gdbarch, addr, mem, len))
 	      entry->u.mem.mem_entry_not_accessible = 1;
             else
               {
-                if (target_write_memory (entry->u.mem.addr, 
-					 record_full_get_loc (entry),
-					 entry->u.mem.len))
+		if (entry->delta)
+		  record_full_xor (mem, record_full_get_loc (entry), len);
+                if (target_write_memory (addr,
+					 entry->delta
+					 ? mem : record_full_get_loc (entry),
+					 len))
                   {
                     entry->u.mem.mem_entry_not_accessible = 1;
                     if (record_debug)
@@ -747,8 +1234,8 @@ record_full_exec_insn (struct regcache *regcache,
                   }
                 else
 		  {
-		    memcpy (record_full_get_loc (entry), mem,
-			    entry->u.mem.len);
+		    if (!entry->delta)
+		      memcpy (record_full_get_loc (entry), mem, len);
 
 		    /* We've changed memory --- check if a hardware
 		       watchpoint should trap.  Note that this
@@ -759,8 +1246,7 @@ record_full_exec_insn (struct regcache *regcache,
 		       not doing the change at all if the watchpoint
 		       traps.  */
 		    if (hardware_watchpoint_inserted_in_range
-			(get_regcache_aspace (regcache),
-			 entry->u.mem.addr, entry->u.mem.len))
+			(get_regcache_aspace (regcache), addr, len))
 		      record_full_stop_reason = TARGET_STOPPED_BY_WATCHPOINT;
 		  }
               }
@@ -983,6 +1469,10 @@ record_full_resume (struct target_ops *ops, ptid_t ptid, int step,
       /* Make sure the target beneath reports all signals.  */
       target_pass_signals (0, NULL);
 
+      /* Each instruction must be recorded before it is executed, so
+	 the target beneath must not step through a whole range.  */
+      inferior_thread ()->control.may_range_step = 0;
+
       ops->beneath->to_resume (ops->beneath, ptid, step, signal);
     }
 
@@ -1411,6 +1901,8 @@ record_full_supports_stopped_by_hw_breakpoint (struct target_ops *ops)
 static void
 record_full_registers_change (struct regcache *regcache, int regnum)
 {
+  record_full_pack_last_insn ();
+
   /* Check record_full_insn_num.  */
   record_full_check_insn_num ();
 
@@ -1446,6 +1938,7 @@ record_full_registers_change (struct regcache *regcache, int regnum)
   record_full_list->next = record_full_arch_list_head;
   record_full_arch_list_head->prev = record_full_list;
   record_full_list = record_full_arch_list_tail;
+  record_full_pack_ptid = inferior_ptid;
 
   if (record_full_insn_num == record_full_insn_max_num)
     record_full_list_release_first ();
@@ -1537,6 +2030,8 @@ record_full_xfer_partial (struct target_ops *ops, enum target_object object,
 	  record_full_list_release_following (record_full_list);
 	}
 
+      record_full_pack_last_insn ();
+
       /* Check record_full_insn_num */
       record_full_check_insn_num ();
 
@@ -1564,6 +2059,7 @@ record_full_xfer_partial (struct target_ops *ops, enum target_object object,
       record_full_list->next = record_full_arch_list_head;
       record_full_arch_list_head->prev = record_full_list;
       record_full_list = record_full_arch_list_tail;
+      record_full_pack_ptid = inferior_ptid;
 
       if (record_full_insn_num == record_full_insn_max_num)
 	record_full_list_release_first ();
@@ -2564,6 +3060,7 @@ record_full_save (struct target_ops *self, const char *recfilename)
   int save_size = 0;
   asection *osec = NULL;
   int bfd_offset = 0;
+  gdb_byte *buf = NULL;
 
   /* Open the save file.  */
   if (record_debug)
@@ -2583,6 +3080,7 @@ record_full_save (struct target_ops *self, const char *recfilename)
 
   /* Disable the GDB operation record.  */
   set_cleanups = record_full_gdb_operation_disable_set ();
+  make_cleanup (free_current_contents, &buf);
 
   /* Reverse execute to the begin of record list.  */
   while (1)
@@ -2672,8 +3170,10 @@ record_full_save (struct target_ops *self, const char *recfilename)
 			     sizeof (regnum), &bfd_offset);
 
               /* Write regval.  */
-              bfdcore_write (obfd, osec,
-			     record_full_get_loc (record_full_list),
+	      buf = (gdb_byte *) xrealloc (buf, record_full_list->u.reg.len);
+	      record_full_entry_value (regcache, gdbarch, record_full_list,
+				       buf);
+              bfdcore_write (obfd, osec, buf,
 			     record_full_list->u.reg.len, &bfd_offset);
               break;
 
@@ -2698,8 +3198,10 @@ record_full_save (struct target_ops *self, const char *recfilename)
 			     sizeof (addr), &bfd_offset);
 
 	      /* Write memval.  */
-	      bfdcore_write (obfd, osec,
-			     record_full_get_loc (record_full_list),
+	      buf = (gdb_byte *) xrealloc (buf, record_full_list->u.mem.len);
+	      record_full_entry_value (regcache, gdbarch, record_full_list,
+				       buf);
+	      bfdcore_write (obfd, osec, buf,
 			     record_full_list->u.mem.len, &bfd_offset);
               break;
 
@@ -2803,6 +3305,7 @@ set_record_full_insn_max_num (char *args, int from_tty,
          record_full_list_release_first ();
          record_full_insn_num--;
        }
+      record_full_ring_shrink ();
     }
 }
 
@@ -40,6 +40,8 @@
 #include "arch-utils.h"
 #include "readline/readline.h"
 #include "gdbthread.h"
+#include "breakpoint.h"
+#include "ax.h"
 
 /* Prototypes */
 
@@ -122,6 +124,15 @@ struct sim_inferior_data {
 
   /* Flag which indicates whether resume should step or not.  */
   int resume_step;
+
+  /* If RESUME_STEP, the range the simulator may step through without
+     stopping, or an empty range.  */
+  CORE_ADDR resume_range_start;
+  CORE_ADDR resume_range_end;
+
+  /* Nonzero if the simulator implements sim_insert_breakpoint, and can
+     evaluate breakpoint conditions.  */
+  int sim_breakpoints;
 };
 
 /* Flag indicating the "open" status of this module.  It's set to 1
@@ -172,6 +183,7 @@ static struct sim_inferior_data *
 get_sim_inferior_data (struct inferior *inf, int sim_instance_needed)
 {
   SIM_DESC sim_desc = NULL;
+  int sim_breakpoints = 0;
   struct sim_inferior_data *sim_data
     = (struct sim_inferior_data *) inferior_data (inf, sim_inferior_data_key);
 
@@ -204,6 +216,10 @@ get_sim_inferior_data (struct inferior *inf, int sim_instance_needed)
    "(This simulator does not support the running of more than one inferior.)"),
 		 inf->num, idup->num);
 	}
+
+      /* Find out once, now that the simulator is opened, whether it
+	 keeps breakpoints itself.  */
+      sim_breakpoints = sim_breakpoints_supported (sim_desc);
     }
 
   if (sim_data == NULL)
@@ -218,6 +234,7 @@ get_sim_inferior_data (struct inferior *inf, int sim_instance_needed)
       /* Initialize the other instance variables.  */
       sim_data->program_loaded = 0;
       sim_data->gdbsim_desc = sim_desc;
+      sim_data->sim_breakpoints = sim_breakpoints;
       sim_data->resume_siggnal = GDB_SIGNAL_0;
       sim_data->resume_step = 0;
     }
@@ -226,6 +243,7 @@ get_sim_inferior_data (struct inferior *inf, int sim_instance_needed)
       /* This handles the case where sim_data was allocated prior to
 	 needing a sim instance.  */
       sim_data->gdbsim_desc = sim_desc;
+      sim_data->sim_breakpoints = sim_breakpoints;
     }
 
 
@@ -843,6 +861,11 @@ struct resume_data
 {
   enum gdb_signal siggnal;
   int step;
+
+  /* The range to step through, for the inferior of PID.  */
+  int pid;
+  CORE_ADDR range_start;
+  CORE_ADDR range_end;
 };
 
 static int
@@ -856,6 +879,16 @@ gdbsim_resume_inferior (struct inferior *inf, void *arg)
     {
       sim_data->resume_siggnal = rd->siggnal;
       sim_data->resume_step = rd->step;
+      if (rd->step && inf->pid == rd->pid)
+	{
+	  sim_data->resume_range_start = rd->range_start;
+	  sim_data->resume_range_end = rd->range_end;
+	}
+      else
+	{
+	  sim_data->resume_range_start = 0;
+	  sim_data->resume_range_end = 0;
+	}
 
       if (remote_debug)
 	fprintf_unfiltered (gdb_stdlog,
@@ -880,6 +913,21 @@ gdbsim_resume (struct target_ops *ops,
   rd.siggnal = siggnal;
   rd.step = step;
 
+  /* Let the simulator step the whole line if it can.  */
+  rd.pid = ptid_get_pid (inferior_ptid);
+  rd.range_start = 0;
+  rd.range_end = 0;
+  if (step)
+    {
+      struct thread_info *tp = find_thread_ptid (inferior_ptid);
+
+      if (tp != NULL && tp->control.may_range_step)
+	{
+	  rd.range_start = tp->control.step_range_start;
+	  rd.range_end = tp->control.step_range_end;
+	}
+    }
+
   /* We don't access any sim_data members within this function.
      What's of interest is whether or not the call to
      get_sim_inferior_data_by_ptid(), above, is able to obtain a
@@ -1008,14 +1056,27 @@ gdbsim_wait (struct target_ops *ops,
 #else
   prev_sigint = signal (SIGINT, gdbsim_cntrl_c);
 #endif
-  sim_resume (sim_data->gdbsim_desc, sim_data->resume_step,
-	      sim_data->resume_siggnal);
+  if (!(sim_data->resume_step
+	&& sim_data->resume_range_start < sim_data->resume_range_end
+	&& sim_resume_range (sim_data->gdbsim_desc,
+			     sim_data->resume_range_start,
+			     sim_data->resume_range_end,
+			     sim_data->resume_siggnal)))
+    sim_resume (sim_data->gdbsim_desc, sim_data->resume_step,
+		sim_data->resume_siggnal);
 
   signal (SIGINT, prev_sigint);
   sim_data->resume_step = 0;
+  sim_data->resume_range_start = 0;
+  sim_data->resume_range_end = 0;
 
   sim_stop_reason (sim_data->gdbsim_desc, &reason, &sigrc);
 
+  if (remote_debug)
+    fprintf_unfiltered (gdb_stdlog,
+			"gdbsim_wait: stop reason %d, signal %d\n",
+			(int) reason, sigrc);
+
   switch (reason)
     {
     case sim_exited:
@@ -1141,6 +1202,144 @@ gdbsim_xfer_partial (struct target_ops *ops, enum target_object object,
     }
 }
 
+/* Return nonzero if the breakpoints of GDBARCH can be left to the
+   simulator of SIM_DATA.  It stops with the PC at the breakpoint
+   address, as if the architecture did not adjust the PC after a
+   breakpoint.  */
+
+static int
+gdbsim_use_sim_breakpoints (struct sim_inferior_data *sim_data,
+			    struct gdbarch *gdbarch)
+{
+  return (sim_data != NULL
+	  && sim_data->sim_breakpoints
+	  && gdbarch_decr_pc_after_break (gdbarch) == 0);
+}
+
+/* Copy the agent expression AX to BYTES, with GDB's register numbers
+   replaced by the simulator's.  Return false if the simulator could not
+   make sense of it.  */
+
+static bool
+gdbsim_translate_condition (struct gdbarch *gdbarch, struct agent_expr *ax,
+			    std::vector<unsigned char> &bytes)
+{
+  int pc = 0;
+
+  bytes.assign (ax->buf, ax->buf + ax->len);
+  while (pc < ax->len)
+    {
+      int op = ax->buf[pc];
+
+      /* The operands of printf are not described by the map.  */
+      if (op >= aop_last || aop_map[op].name == NULL || op == aop_printf)
+	return false;
+      if (pc + 1 + aop_map[op].op_size > ax->len)
+	return false;
+
+      if (op == aop_reg)
+	{
+	  int regnum = (ax->buf[pc + 1] << 8) | ax->buf[pc + 2];
+	  int sim_regno;
+
+	  if (regnum >= gdbarch_num_regs (gdbarch))
+	    return false;
+	  sim_regno = gdbarch_register_sim_regno (gdbarch, regnum);
+	  if (sim_regno < 0 || sim_regno > 0xffff)
+	    return false;
+	  bytes[pc + 1] = sim_regno >> 8;
+	  bytes[pc + 2] = sim_regno & 0xff;
+	}
+
+      pc += 1 + aop_map[op].op_size;
+    }
+
+  return true;
+}
+
+/* Target to_insert_breakpoint implementation.  When the simulator keeps
+   breakpoints itself, hand it the breakpoint and its conditions, so
+   that it only stops when one of them holds.  */
+
+static int
+gdbsim_insert_breakpoint (struct target_ops *ops, struct gdbarch *gdbarch,
+			  struct bp_target_info *bp_tgt)
+{
+  struct sim_inferior_data *sim_data
+    = get_sim_inferior_data (current_inferior (), SIM_INSTANCE_NEEDED);
+  std::vector<std::vector<unsigned char>> conditions;
+  std::vector<const unsigned char *> condition_ptrs;
+  std::vector<int> lengths;
+
+  if (!gdbsim_use_sim_breakpoints (sim_data, gdbarch))
+    return memory_insert_breakpoint (ops, gdbarch, bp_tgt);
+
+  for (agent_expr *ax : bp_tgt->conditions)
+    {
+      conditions.emplace_back ();
+      if (!gdbsim_translate_condition (gdbarch, ax, conditions.back ()))
+	{
+	  /* Stop every time and let GDB evaluate the conditions.  */
+	  conditions.clear ();
+	  break;
+	}
+    }
+  for (const std::vector<unsigned char> &bytes : conditions)
+    {
+      condition_ptrs.push_back (bytes.data ());
+      lengths.push_back (bytes.size ());
+    }
+
+  bp_tgt->placed_address = bp_tgt->reqstd_address;
+  bp_tgt->shadow_len = 0;
+  if (!sim_insert_breakpoint (sim_data->gdbsim_desc, bp_tgt->placed_address,
+			      conditions.size (), condition_ptrs.data (),
+			      lengths.data ()))
+    return 1;
+
+  if (remote_debug)
+    fprintf_unfiltered (gdb_stdlog,
+			"gdbsim_insert_breakpoint: %s, %d condition(s)\n",
+			paddress (gdbarch, bp_tgt->placed_address),
+			(int) conditions.size ());
+  return 0;
+}
+
+/* Target to_remove_breakpoint implementation.  */
+
+static int
+gdbsim_remove_breakpoint (struct target_ops *ops, struct gdbarch *gdbarch,
+			  struct bp_target_info *bp_tgt,
+			  enum remove_bp_reason reason)
+{
+  struct sim_inferior_data *sim_data
+    = get_sim_inferior_data (current_inferior (), SIM_INSTANCE_NEEDED);
+
+  if (!gdbsim_use_sim_breakpoints (sim_data, gdbarch))
+    return memory_remove_breakpoint (ops, gdbarch, bp_tgt, reason);
+
+  return !sim_remove_breakpoint (sim_data->gdbsim_desc,
+				 bp_tgt->placed_address);
+}
+
+/* Target to_supports_evaluation_of_breakpoint_conditions
+   implementation.  This is only a question, so like simulator_command
+   it does not open a simulator if there is none yet; without one there
+   is nobody to evaluate the conditions.  */
+
+static int
+gdbsim_supports_evaluation_of_breakpoint_conditions (struct target_ops *ops)
+{
+  struct sim_inferior_data *sim_data
+    = ((struct sim_inferior_data *)
+       inferior_data (current_inferior (), sim_inferior_data_key));
+
+  if (sim_data == NULL || sim_data->gdbsim_desc == NULL)
+    return 0;
+
+  return gdbsim_use_sim_breakpoints (sim_data, target_gdbarch ());
+}
+
 static void
 gdbsim_files_info (struct target_ops *target)
 {
@@ -1320,8 +1519,10 @@ init_gdbsim_ops (void)
   gdbsim_ops.to_prepare_to_store = gdbsim_prepare_to_store;
   gdbsim_ops.to_xfer_partial = gdbsim_xfer_partial;
   gdbsim_ops.to_files_info = gdbsim_files_info;
-  gdbsim_ops.to_insert_breakpoint = memory_insert_breakpoint;
-  gdbsim_ops.to_remove_breakpoint = memory_remove_breakpoint;
+  gdbsim_ops.to_insert_breakpoint = gdbsim_insert_breakpoint;
+  gdbsim_ops.to_remove_breakpoint = gdbsim_remove_breakpoint;
+  gdbsim_ops.to_supports_evaluation_of_breakpoint_conditions
+    = gdbsim_supports_evaluation_of_breakpoint_conditions;
   gdbsim_ops.to_kill = gdbsim_kill;
   gdbsim_ops.to_load = gdbsim_load;
   gdbsim_ops.to_create_inferior = gdbsim_create_inferior;
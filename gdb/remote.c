@@ -1521,6 +1521,9 @@ enum {
   /* Support TARGET_WAITKIND_NO_RESUMED.  */
   PACKET_no_resumed,
 
+  /* Support for thread-regs+ feature.  */
+  PACKET_thread_regs_feature,
+
   PACKET_MAX
 };
 
@@ -4682,6 +4685,8 @@ static const struct protocol_feature remote_protocol_features[] = {
     PACKET_Qbtrace_conf_bts_size },
   { "swbreak", PACKET_DISABLE, remote_supported_packet, PACKET_swbreak_feature },
   { "hwbreak", PACKET_DISABLE, remote_supported_packet, PACKET_hwbreak_feature },
+  { "thread-regs", PACKET_DISABLE, remote_supported_packet,
+    PACKET_thread_regs_feature },
   { "fork-events", PACKET_DISABLE, remote_supported_packet,
     PACKET_fork_event_feature },
   { "vfork-events", PACKET_DISABLE, remote_supported_packet,
@@ -4766,6 +4771,9 @@ remote_query_supported (void)
 	q = remote_query_supported_append (q, "swbreak+");
       if (packet_set_cmd_state (PACKET_hwbreak_feature) != AUTO_BOOLEAN_FALSE)
 	q = remote_query_supported_append (q, "hwbreak+");
+      if (packet_set_cmd_state (PACKET_thread_regs_feature)
+	  != AUTO_BOOLEAN_FALSE)
+	q = remote_query_supported_append (q, "thread-regs+");
 
       q = remote_query_supported_append (q, "qRelocInsn+");
 
@@ -6311,6 +6319,17 @@ typedef struct cached_reg
 
 DEF_VEC_O(cached_reg_t);
 
+/* An expedited register of a thread other than the one that
+   reported the stop.  */
+
+typedef struct cached_thread_reg
+{
+  ptid_t ptid;
+  cached_reg_t reg;
+} cached_thread_reg_t;
+
+DEF_VEC_O(cached_thread_reg_t);
+
 typedef struct stop_reply
 {
   struct notif_event base;
@@ -6331,6 +6350,10 @@ typedef struct stop_reply
      fetch them is avoided).  */
   VEC(cached_reg_t) *regcache;
 
+  /* Expedited registers of the other threads that stopped with this
+     one, sent in "thread-regs" fields.  */
+  VEC(cached_thread_reg_t) *thread_regs;
+
   enum target_stop_reason stop_reason;
 
   CORE_ADDR watch_data_address;
@@ -6404,6 +6427,7 @@ stop_reply_dtr (struct notif_event *event)
   struct stop_reply *r = (struct stop_reply *) event;
 
   VEC_free (cached_reg_t, r->regcache);
+  VEC_free (cached_thread_reg_t, r->thread_regs);
 }
 
 static struct notif_event *
@@ -6803,6 +6827,7 @@ remote_parse_stop_reply (char *buf, struct stop_reply *event)
   event->ws.value.integer = 0;
   event->stop_reason = TARGET_STOPPED_BY_NO_REASON;
   event->regcache = NULL;
+  event->thread_regs = NULL;
   event->core = -1;
 
   switch (buf[0])
@@ -6953,6 +6978,52 @@ Packet: '%s'\n"),
 	      event->ws.kind = TARGET_WAITKIND_THREAD_CREATED;
 	      p = strchrnul (p1 + 1, ';');
 	    }
+	  else if (strprefix (p, p1, "thread-regs"))
+	    {
+	      cached_thread_reg_t thread_reg;
+
+	      /* Make sure the stub doesn't forget to indicate support
+		 with qSupported.  */
+	      if (packet_support (PACKET_thread_regs_feature) != PACKET_ENABLE)
+		error (_("Unexpected thread-regs field"));
+
+	      if (skipregs)
+		{
+		  p = strchrnul (p1 + 1, ';');
+		  p++;
+		  continue;
+		}
+
+	      /* The thread, then a "regno:value" pair for each of its
+		 registers, all separated by commas.  */
+	      thread_reg.ptid = read_ptid (++p1, &p);
+	      while (*p == ',')
+		{
+		  ULONGEST pnum;
+		  struct packet_reg *reg;
+
+		  p1 = unpack_varlen_hex (++p, &pnum);
+		  reg = packet_reg_from_pnum (rsa, pnum);
+		  if (*p1 != ':' || reg == NULL)
+		    error (_("Remote sent bad register number %s: %s\n\
+Packet: '%s'\n"),
+			   hex_string (pnum), p, buf);
+
+		  thread_reg.reg.num = reg->regnum;
+
+		  p = p1 + 1;
+		  fieldsize = hex2bin (p, thread_reg.reg.data,
+				       register_size (target_gdbarch (),
+						      reg->regnum));
+		  p += 2 * fieldsize;
+		  if (fieldsize < register_size (target_gdbarch (),
+						 reg->regnum))
+		    warning (_("Remote reply is too short: %s"), buf);
+
+		  VEC_safe_push (cached_thread_reg_t, event->thread_regs,
+				 &thread_reg);
+		}
+	    }
 	  else
 	    {
 	      ULONGEST pnum;
@@ -7215,6 +7286,30 @@ process_stop_reply (struct stop_reply *stop_reply,
 	  VEC_free (cached_reg_t, stop_reply->regcache);
 	}
 
+      /* Expedited registers of the other stopped threads.  Those
+	 GDB does not know about yet are left alone; their registers
+	 are fetched when they are added.  */
+      if (stop_reply->thread_regs)
+	{
+	  cached_thread_reg_t *thread_reg;
+	  int ix;
+
+	  for (ix = 0;
+	       VEC_iterate(cached_thread_reg_t, stop_reply->thread_regs,
+			   ix, thread_reg);
+	       ix++)
+	    if (find_thread_ptid (thread_reg->ptid) != NULL)
+	      {
+		struct regcache *regcache
+		  = get_thread_arch_regcache (thread_reg->ptid,
+					      target_gdbarch ());
+
+		regcache_raw_supply (regcache, thread_reg->reg.num,
+				     thread_reg->reg.data);
+	      }
+	  VEC_free (cached_thread_reg_t, stop_reply->thread_regs);
+	}
+
       remote_notice_new_inferior (ptid, 0);
       remote_thr = get_private_info_ptid (ptid);
       remote_thr->core = stop_reply->core;
@@ -14279,6 +14374,9 @@ Show the maximum size of the address (in bits) in a memory packet."), NULL,
   add_packet_config_cmd (&remote_protocol_packets[PACKET_hwbreak_feature],
                          "hwbreak-feature", "hwbreak-feature", 0);
 
+  add_packet_config_cmd (&remote_protocol_packets[PACKET_thread_regs_feature],
+			 "thread-regs-feature", "thread-regs-feature", 0);
+
   add_packet_config_cmd (&remote_protocol_packets[PACKET_fork_event_feature],
 			 "fork-event-feature", "fork-event-feature", 0);
 
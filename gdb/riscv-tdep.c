@@ -60,6 +60,8 @@
 #include "user-regs.h"
 #include "valprint.h"
 #include "common-defs.h"
+#include "record.h"
+#include "record-full.h"
 #include "opcode/riscv-opc.h"
 #include <algorithm>
 
@@ -1222,6 +1224,455 @@ static const struct frame_unwind riscv_frame_unwind =
   /*.prev_arch     =*/ NULL,
 };
 
+/* Process record support.  */
+
+/* Record register REGNUM, unless the target has no such register, in
+   which case the instruction cannot change it either.  */
+
+static int
+riscv_record_reg (struct regcache *regcache, int regnum)
+{
+  if (regnum == RISCV_ZERO_REGNUM)
+    return 0;
+  if (regnum != RISCV_PC_REGNUM && !RiscvRegExist[regnum])
+    return 0;
+  return record_full_arch_list_add_reg (regcache, regnum);
+}
+
+static int
+riscv_record_csr (struct regcache *regcache, int csr)
+{
+  return riscv_record_reg (regcache, RISCV_FIRST_CSR_REGNUM + csr);
+}
+
+/* Record the LEN bytes at BASE + OFFSET, where BASE is the value of
+   register BASE_REGNUM.  */
+
+static int
+riscv_record_mem (struct regcache *regcache, int base_regnum,
+		  LONGEST offset, int len)
+{
+  ULONGEST base;
+
+  regcache_raw_read_unsigned (regcache, base_regnum, &base);
+  return record_full_arch_list_add_mem (base + offset, len);
+}
+
+/* Record the accrued exceptions of a floating-point instruction.  */
+
+static int
+riscv_record_fflags (struct regcache *regcache)
+{
+#ifdef CSR_FCSR
+  if (riscv_record_csr (regcache, CSR_FFLAGS)
+      || riscv_record_csr (regcache, CSR_FCSR))
+    return -1;
+#endif
+  return 0;
+}
+
+/* The size of the "struct kernel_stat" of the RISC-V newlib/libgloss
+   port, which "stat", "fstat" and "lstat" fill in.  */
+
+#define RISCV_KERNEL_STAT_SIZE 128
+
+/* Record what an ECALL changes.  This follows the system call numbers
+   of the newlib/libgloss port, as the RISC-V simulator maps them (see
+   sim/common/nltvals.def): "read", "stat", "fstat" and "lstat" write
+   to memory, and all of them return in A0.  The simulator fails the
+   calls it does not implement, such as "gettimeofday", without doing
+   anything else.  Return -1 for a call the port does not define, since
+   we cannot know what it changes.  */
+
+static int
+riscv_record_ecall (struct gdbarch *gdbarch, struct regcache *regcache)
+{
+  ULONGEST num, arg1, arg2;
+
+  regcache_raw_read_unsigned (regcache, RISCV_A0_REGNUM + 7, &num);
+  regcache_raw_read_unsigned (regcache, RISCV_A0_REGNUM + 1, &arg1);
+  regcache_raw_read_unsigned (regcache, RISCV_A0_REGNUM + 2, &arg2);
+
+  switch (num)
+    {
+    case 63:	/* read */
+      if (arg2 > 0 && record_full_arch_list_add_mem (arg1, arg2))
+	return -1;
+      break;
+
+    case 80:	/* fstat */
+    case 1038:	/* stat */
+    case 1039:	/* lstat */
+      if (record_full_arch_list_add_mem (arg1, RISCV_KERNEL_STAT_SIZE))
+	return -1;
+      break;
+
+    case 17:	/* getcwd */
+    case 23:	/* dup */
+    case 25:	/* fcntl */
+    case 48:	/* faccessat */
+    case 49:	/* chdir */
+    case 56:	/* openat */
+    case 57:	/* close */
+    case 61:	/* getdents */
+    case 62:	/* lseek */
+    case 64:	/* write */
+    case 66:	/* writev */
+    case 67:	/* pread */
+    case 68:	/* pwrite */
+    case 79:	/* fstatat */
+    case 93:	/* exit */
+    case 94:	/* exit_group */
+    case 129:	/* kill */
+    case 134:	/* rt_sigaction */
+    case 153:	/* times */
+    case 160:	/* uname */
+    case 169:	/* gettimeofday */
+    case 172:	/* getpid */
+    case 174:	/* getuid */
+    case 175:	/* geteuid */
+    case 176:	/* getgid */
+    case 177:	/* getegid */
+    case 214:	/* brk */
+    case 215:	/* munmap */
+    case 216:	/* mremap */
+    case 222:	/* mmap */
+    case 1024:	/* open */
+    case 1025:	/* link */
+    case 1026:	/* unlink */
+    case 1030:	/* mkdir */
+    case 1033:	/* access */
+    case 1062:	/* time */
+    case 2011:	/* getmainvars */
+      break;
+
+    default:
+      printf_unfiltered (_("Process record and replay target doesn't "
+			   "support syscall number %s\n"),
+			 pulongest (num));
+      return -1;
+    }
+
+  return riscv_record_reg (regcache, RISCV_A0_REGNUM);
+}
+
+/* Record the hardware loop counter that the instruction ending at NEXT
+   decrements, if it is the last one of an Xpulp hardware loop.  */
+
+static int
+riscv_record_hwloops (struct regcache *regcache, CORE_ADDR addr,
+		      CORE_ADDR next)
+{
+#ifdef CSR_LPS0
+  static const int lpend[2] = { CSR_LPE0, CSR_LPE1 };
+  static const int lpcount[2] = { CSR_LPC0, CSR_LPC1 };
+  int i;
+
+  for (i = 0; i < 2; i++)
+    {
+      ULONGEST count, end;
+
+      if (regcache_raw_read_unsigned (regcache,
+				      RISCV_FIRST_CSR_REGNUM + lpcount[i],
+				      &count) != REG_VALID
+	  || count == 0)
+	continue;
+      if (regcache_raw_read_unsigned (regcache,
+				      RISCV_FIRST_CSR_REGNUM + lpend[i],
+				      &end) != REG_VALID)
+	continue;
+      if ((end == addr || end == next)
+	  && riscv_record_csr (regcache, lpcount[i]))
+	return -1;
+    }
+#endif
+
+  return 0;
+}
+
+/* Record a 16-bit instruction of the C extension.  Return 1 if it is
+   not recognized.  */
+
+static int
+riscv_record_compressed (struct gdbarch *gdbarch, struct regcache *regcache,
+			 ULONGEST insn)
+{
+  int xlen = riscv_isa_regsize (gdbarch);
+  int rd = (insn >> OP_SH_RD) & OP_MASK_RD;
+  int rs1s = 8 + ((insn >> OP_SH_CRS1S) & OP_MASK_CRS1S);
+  int rs2s = 8 + ((insn >> OP_SH_CRS2S) & OP_MASK_CRS2S);
+  int funct3 = (insn >> 13) & 7;
+
+  switch (insn & 3)
+    {
+    case 0:
+      switch (funct3)
+	{
+	case 0:	/* c.addi4spn */
+	case 2:	/* c.lw */
+	  return riscv_record_reg (regcache, rs2s);
+	case 1:	/* c.fld */
+	  return riscv_record_reg (regcache, RISCV_FIRST_FP_REGNUM + rs2s);
+	case 3:	/* c.ld, c.flw */
+	  if (xlen == 8)
+	    return riscv_record_reg (regcache, rs2s);
+	  return riscv_record_reg (regcache, RISCV_FIRST_FP_REGNUM + rs2s);
+	case 5:	/* c.fsd */
+	  return riscv_record_mem (regcache, rs1s, EXTRACT_RVC_LD_IMM (insn),
+				   8);
+	case 6:	/* c.sw */
+	  return riscv_record_mem (regcache, rs1s, EXTRACT_RVC_LW_IMM (insn),
+				   4);
+	case 7:	/* c.sd, c.fsw */
+	  if (xlen == 8)
+	    return riscv_record_mem (regcache, rs1s,
+				     EXTRACT_RVC_LD_IMM (insn), 8);
+	  return riscv_record_mem (regcache, rs1s, EXTRACT_RVC_LW_IMM (insn),
+				   4);
+	}
+      return 1;
+
+    case 1:
+      switch (funct3)
+	{
+	case 0:	/* c.addi */
+	case 2:	/* c.li */
+	case 3:	/* c.addi16sp, c.lui */
+	  return riscv_record_reg (regcache, rd);
+	case 1:	/* c.jal, c.addiw */
+	  return riscv_record_reg (regcache, xlen == 4 ? RISCV_RA_REGNUM : rd);
+	case 4:	/* c.srli, c.srai, c.andi, c.sub, ... */
+	  return riscv_record_reg (regcache, rs1s);
+	case 5:	/* c.j */
+	case 6:	/* c.beqz */
+	case 7:	/* c.bnez */
+	  return 0;
+	}
+      return 1;
+
+    case 2:
+      switch (funct3)
+	{
+	case 0:	/* c.slli */
+	case 2:	/* c.lwsp */
+	  return riscv_record_reg (regcache, rd);
+	case 1:	/* c.fldsp */
+	  return riscv_record_reg (regcache, RISCV_FIRST_FP_REGNUM + rd);
+	case 3:	/* c.ldsp, c.flwsp */
+	  if (xlen == 8)
+	    return riscv_record_reg (regcache, rd);
+	  return riscv_record_reg (regcache, RISCV_FIRST_FP_REGNUM + rd);
+	case 4:
+	  if (((insn >> OP_SH_CRS2) & OP_MASK_CRS2) != 0)
+	    return riscv_record_reg (regcache, rd);	/* c.mv, c.add */
+	  if ((insn & 0x1000) == 0 || rd == 0)
+	    return 0;	/* c.jr, c.ebreak */
+	  return riscv_record_reg (regcache, RISCV_RA_REGNUM);	/* c.jalr */
+	case 5:	/* c.fsdsp */
+	  return riscv_record_mem (regcache, RISCV_SP_REGNUM,
+				   EXTRACT_RVC_SDSP_IMM (insn), 8);
+	case 6:	/* c.swsp */
+	  return riscv_record_mem (regcache, RISCV_SP_REGNUM,
+				   EXTRACT_RVC_SWSP_IMM (insn), 4);
+	case 7:	/* c.sdsp, c.fswsp */
+	  if (xlen == 8)
+	    return riscv_record_mem (regcache, RISCV_SP_REGNUM,
+				     EXTRACT_RVC_SDSP_IMM (insn), 8);
+	  return riscv_record_mem (regcache, RISCV_SP_REGNUM,
+				   EXTRACT_RVC_SWSP_IMM (insn), 4);
+	}
+      return 1;
+    }
+
+  return 1;
+}
+
+/* Record a 32-bit instruction of the I, M, A, F and D extensions, or
+   of Xpulp.  Return 1 if it is not recognized.  */
+
+static int
+riscv_record_insn (struct gdbarch *gdbarch, struct regcache *regcache,
+		   ULONGEST insn)
+{
+  int rd = (insn >> OP_SH_RD) & OP_MASK_RD;
+  int rs1 = (insn >> OP_SH_RS1) & OP_MASK_RS1;
+  int funct3 = (insn >> 12) & 7;
+  int funct5 = (insn >> 27) & 0x1f;
+
+  switch (insn & 0x7f)
+    {
+    case 0x37:	/* lui */
+    case 0x17:	/* auipc */
+    case 0x6f:	/* jal */
+    case 0x67:	/* jalr */
+    case 0x03:	/* loads, and Xpulp register-register loads */
+    case 0x13:	/* OP-IMM */
+    case 0x1b:	/* OP-IMM-32 */
+    case 0x33:	/* OP, M, and the Xpulp ALU extensions */
+    case 0x3b:	/* OP-32 */
+    case 0x57:	/* Xpulp SIMD */
+    case 0x5b:	/* Xpulp multiply-accumulate */
+      return riscv_record_reg (regcache, rd);
+
+    case 0x0b:	/* Xpulp post-increment loads */
+      if (riscv_record_reg (regcache, rd))
+	return -1;
+      return riscv_record_reg (regcache, rs1);
+
+    case 0x63:	/* branches */
+    case 0x0f:	/* fence, fence.i */
+      return 0;
+
+    case 0x23:	/* stores */
+      if (funct3 < 4)
+	return riscv_record_mem (regcache, rs1, EXTRACT_STYPE_IMM (insn),
+				 1 << funct3);
+      else if (funct3 < 7)
+	{
+	  /* Xpulp register-register store, to RS1 + RS3.  */
+	  ULONGEST offset;
+
+	  regcache_raw_read_unsigned (regcache,
+				      EXTRACT_OPERAND (RS3I, insn), &offset);
+	  return riscv_record_mem (regcache, rs1, offset, 1 << (funct3 - 4));
+	}
+      return 1;
+
+    case 0x2b:	/* Xpulp post-increment stores, to RS1 */
+      if (funct3 == 3 || funct3 == 7)
+	return 1;
+      if (riscv_record_mem (regcache, rs1, 0, 1 << (funct3 & 3)))
+	return -1;
+      return riscv_record_reg (regcache, rs1);
+
+#ifdef CSR_LPS0
+    case 0x7b:	/* Xpulp hardware loop setup */
+      {
+	int loop = rd & 1;
+
+	switch (funct3)
+	  {
+	  case 0:	/* lp.starti */
+	    return riscv_record_csr (regcache, loop ? CSR_LPS1 : CSR_LPS0);
+	  case 1:	/* lp.endi */
+	    return riscv_record_csr (regcache, loop ? CSR_LPE1 : CSR_LPE0);
+	  case 2:	/* lp.count */
+	  case 3:	/* lp.counti */
+	    return riscv_record_csr (regcache, loop ? CSR_LPC1 : CSR_LPC0);
+	  case 4:	/* lp.setup */
+	  case 5:	/* lp.setupi */
+	    if (riscv_record_csr (regcache, loop ? CSR_LPS1 : CSR_LPS0)
+		|| riscv_record_csr (regcache, loop ? CSR_LPE1 : CSR_LPE0)
+		|| riscv_record_csr (regcache, loop ? CSR_LPC1 : CSR_LPC0))
+	      return -1;
+	    return 0;
+	  }
+	return 1;
+      }
+#endif
+
+    case 0x2f:	/* A */
+      if (funct3 != 2 && funct3 != 3)
+	return 1;
+      if (riscv_record_reg (regcache, rd))
+	return -1;
+      if (funct5 == 0x02)	/* lr */
+	return 0;
+      return riscv_record_mem (regcache, rs1, 0, funct3 == 2 ? 4 : 8);
+
+    case 0x07:	/* flw, fld */
+      return riscv_record_reg (regcache, RISCV_FIRST_FP_REGNUM + rd);
+
+    case 0x27:	/* fsw, fsd */
+      if (funct3 != 2 && funct3 != 3)
+	return 1;
+      return riscv_record_mem (regcache, rs1, EXTRACT_STYPE_IMM (insn),
+			       funct3 == 2 ? 4 : 8);
+
+    case 0x43:	/* fmadd */
+    case 0x47:	/* fmsub */
+    case 0x4b:	/* fnmsub */
+    case 0x4f:	/* fnmadd */
+      if (riscv_record_reg (regcache, RISCV_FIRST_FP_REGNUM + rd))
+	return -1;
+      return riscv_record_fflags (regcache);
+
+    case 0x53:	/* OP-FP */
+      switch (funct5)
+	{
+	case 0x14:	/* feq, flt, fle */
+	case 0x18:	/* fcvt.w, fcvt.l and unsigned */
+	case 0x1c:	/* fmv.x, fclass */
+	  if (riscv_record_reg (regcache, rd))
+	    return -1;
+	  break;
+	default:
+	  if (riscv_record_reg (regcache, RISCV_FIRST_FP_REGNUM + rd))
+	    return -1;
+	  break;
+	}
+      return riscv_record_fflags (regcache);
+
+    case 0x73:	/* SYSTEM */
+      if (funct3 == 0)
+	{
+	  if (insn == MATCH_ECALL)
+	    return riscv_record_ecall (gdbarch, regcache);
+	  if (insn == MATCH_EBREAK || insn == MATCH_WFI)
+	    return 0;
+	  return 1;
+	}
+      if (funct3 == 4)
+	return 1;
+      if (riscv_record_reg (regcache, rd))
+	return -1;
+      return riscv_record_csr (regcache, (insn >> 20) & 0xfff);
+    }
+
+  return 1;
+}
+
+/* Implement the process_record gdbarch method.  Parse the instruction
+   at ADDR and record the registers and memory it changes.  Return -1
+   if the instruction cannot be recorded.  */
+
+static int
+riscv_process_record (struct gdbarch *gdbarch, struct regcache *regcache,
+		      CORE_ADDR addr)
+{
+  ULONGEST insn;
+  int len, ret;
+
+  insn = riscv_fetch_instruction (gdbarch, addr);
+  len = riscv_insn_length (insn);
+
+  if (record_debug > 1)
+    fprintf_unfiltered (gdb_stdlog, "Process record: riscv_process_record "
+			"addr = %s\n", paddress (gdbarch, addr));
+
+  if (len == 2)
+    ret = riscv_record_compressed (gdbarch, regcache, insn);
+  else if (len == 4)
+    ret = riscv_record_insn (gdbarch, regcache, insn);
+  else
+    ret = 1;
+
+  if (ret > 0)
+    {
+      printf_unfiltered (_("Process record does not support instruction "
+			   "0x%s at address %s.\n"),
+			 phex_nz (insn, len), paddress (gdbarch, addr));
+      return -1;
+    }
+  if (ret < 0
+      || riscv_record_hwloops (regcache, addr, addr + len)
+      || record_full_arch_list_add_reg (regcache, RISCV_PC_REGNUM)
+      || record_full_arch_list_add_end ())
+    return -1;
+
+  return 0;
+}
+
 static struct gdbarch *
 riscv_gdbarch_init (struct gdbarch_info info,
 		    struct gdbarch_list *arches)
@@ -1322,6 +1773,9 @@ riscv_gdbarch_init (struct gdbarch_info info,
   set_gdbarch_push_dummy_call (gdbarch, riscv_push_dummy_call);
   set_gdbarch_dummy_id (gdbarch, riscv_dummy_id);
 
+  /* Support reverse debugging.  */
+  set_gdbarch_process_record (gdbarch, riscv_process_record);
+
   /* Frame unwinders.  Use DWARF debug info if available, otherwise use our own
      unwinder.  */
   dwarf2_append_unwinders (gdbarch);
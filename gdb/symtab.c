@@ -43,6 +43,7 @@
 #include "cli/cli-utils.h"
 #include "fnmatch.h"
 #include "hashtab.h"
+#include "ghashtab.h"
 
 #include "gdb_obstack.h"
 #include "block.h"
@@ -61,6 +62,11 @@
 
 #include "parser-defs.h"
 #include "completer.h"
+#include "maint.h"
+#include "common/parallel-for.h"
+#include <atomic>
+#include <unordered_set>
+#include <vector>
 
 /* Forward declarations for local functions.  */
 
@@ -691,6 +697,8 @@ symbol_set_language (struct general_symbol_info *gsymbol,
 struct demangled_name_entry
 {
   const char *mangled;
+  /* The language symbol_find_demangled_name picked for MANGLED.  */
+  ENUM_BITFIELD(language) language : LANGUAGE_BITS;
   char demangled[1];
 };
 
@@ -726,22 +734,18 @@ static void
 create_demangled_names_hash (struct objfile *objfile)
 {
   /* Choose 256 as the starting size of the hash table, somewhat arbitrarily.
-     The hash table code will round this up to the next prime number.
+     The hash table code will round this up to the next power of two.
      Choosing a much larger table size wastes memory, and saves only about
      1% in symbol reading.  */
 
-  objfile->per_bfd->demangled_names_hash = htab_create_alloc
+  objfile->per_bfd->demangled_names_hash = ghtab_create_alloc
     (256, hash_demangled_name_entry, eq_demangled_name_entry,
      NULL, xcalloc, xfree);
 }
 
-/* Try to determine the demangled name for a symbol, based on the
-   language of that symbol.  If the language is set to language_auto,
-   it will attempt to find any demangling algorithm that works and
-   then set the language appropriately.  The returned name is allocated
-   by the demangler and should be xfree'd.  */
+/* See symtab.h.  */
 
-static char *
+char *
 symbol_find_demangled_name (struct general_symbol_info *gsymbol,
 			    const char *mangled)
 {
@@ -775,21 +779,31 @@ symbol_find_demangled_name (struct general_symbol_info *gsymbol,
   return NULL;
 }
 
-/* Set both the mangled and demangled (if any) names for GSYMBOL based
-   on LINKAGE_NAME and LEN.  Ordinarily, NAME is copied onto the
-   objfile's obstack; but if COPY_NAME is 0 and if NAME is
-   NUL-terminated, then this function assumes that NAME is already
-   correctly saved (either permanently or with a lifetime tied to the
-   objfile), and it will not be copied.
+/* See symtab.h.  */
 
-   The hash table corresponding to OBJFILE is used, and the memory
-   comes from the per-BFD storage_obstack.  LINKAGE_NAME is copied,
-   so the pointer can be discarded after calling this function.  */
+int
+symbol_demangled_name_cached_p (struct objfile *objfile,
+				const char *linkage_name)
+{
+  struct demangled_name_entry entry;
 
-void
-symbol_set_names (struct general_symbol_info *gsymbol,
-		  const char *linkage_name, int len, int copy_name,
-		  struct objfile *objfile)
+  if (objfile->per_bfd->demangled_names_hash == NULL)
+    return 0;
+
+  entry.mangled = linkage_name;
+  return ghtab_find (objfile->per_bfd->demangled_names_hash, &entry) != NULL;
+}
+
+/* Worker for symbol_set_names and symbol_set_names_demangled.  If
+   DEMANGLED_KNOWN is true, DEMANGLED is what symbol_find_demangled_name
+   returned for LINKAGE_NAME; it is used if a demangled name is needed,
+   and freed.  */
+
+static void
+symbol_set_names_1 (struct general_symbol_info *gsymbol,
+		    const char *linkage_name, int len, int copy_name,
+		    struct objfile *objfile, bool demangled_known,
+		    char *demangled)
 {
   struct demangled_name_entry **slot;
   /* A 0-terminated copy of the linkage name.  */
@@ -813,6 +827,7 @@ symbol_set_names (struct general_symbol_info *gsymbol,
 	  gsymbol->name = name;
 	}
       symbol_set_demangled_name (gsymbol, NULL, &per_bfd->storage_obstack);
+      xfree (demangled);
 
       return;
     }
@@ -835,8 +850,8 @@ symbol_set_names (struct general_symbol_info *gsymbol,
 
   entry.mangled = linkage_name_copy;
   slot = ((struct demangled_name_entry **)
-	  htab_find_slot (per_bfd->demangled_names_hash,
-			  &entry, INSERT));
+	  ghtab_find_slot (per_bfd->demangled_names_hash,
+			   &entry, INSERT));
 
   /* If this name is not in the hash table, add it.  */
   if (*slot == NULL
@@ -845,9 +860,18 @@ symbol_set_names (struct general_symbol_info *gsymbol,
       || (gsymbol->language == language_go
 	  && (*slot)->demangled[0] == '\0'))
     {
-      char *demangled_name = symbol_find_demangled_name (gsymbol,
-							 linkage_name_copy);
-      int demangled_len = demangled_name ? strlen (demangled_name) : 0;
+      char *demangled_name;
+      int demangled_len;
+
+      if (demangled_known)
+	{
+	  demangled_name = demangled;
+	  demangled = NULL;
+	}
+      else
+	demangled_name = symbol_find_demangled_name (gsymbol,
+						     linkage_name_copy);
+      demangled_len = demangled_name ? strlen (demangled_name) : 0;
 
       /* Suppose we have demangled_name==NULL, copy_name==0, and
 	 linkage_name_copy==linkage_name.  In this case, we already have the
@@ -884,6 +908,7 @@ symbol_set_names (struct general_symbol_info *gsymbol,
 	  (*slot)->mangled = mangled_ptr;
 	}
 
+      (*slot)->language = gsymbol->language;
       if (demangled_name != NULL)
 	{
 	  strcpy ((*slot)->demangled, demangled_name);
@@ -892,6 +917,14 @@ symbol_set_names (struct general_symbol_info *gsymbol,
       else
 	(*slot)->demangled[0] = '\0';
     }
+  else if (gsymbol->language == language_auto
+	   && (*slot)->demangled[0] != '\0')
+    {
+      /* Demangling the name again would have picked the same
+	 language.  */
+      gsymbol->language = (*slot)->language;
+    }
+  xfree (demangled);
 
   gsymbol->name = (*slot)->mangled;
   if ((*slot)->demangled[0] != '\0')
@@ -901,6 +934,37 @@ symbol_set_names (struct general_symbol_info *gsymbol,
     symbol_set_demangled_name (gsymbol, NULL, &per_bfd->storage_obstack);
 }
 
+/* Set both the mangled and demangled (if any) names for GSYMBOL based
+   on LINKAGE_NAME and LEN.  Ordinarily, NAME is copied onto the
+   objfile's obstack; but if COPY_NAME is 0 and if NAME is
+   NUL-terminated, then this function assumes that NAME is already
+   correctly saved (either permanently or with a lifetime tied to the
+   objfile), and it will not be copied.
+
+   The hash table corresponding to OBJFILE is used, and the memory
+   comes from the per-BFD storage_obstack.  LINKAGE_NAME is copied,
+   so the pointer can be discarded after calling this function.  */
+
+void
+symbol_set_names (struct general_symbol_info *gsymbol,
+		  const char *linkage_name, int len, int copy_name,
+		  struct objfile *objfile)
+{
+  symbol_set_names_1 (gsymbol, linkage_name, len, copy_name, objfile,
+		      false, NULL);
+}
+
+/* See symtab.h.  */
+
+void
+symbol_set_names_demangled (struct general_symbol_info *gsymbol,
+			    const char *linkage_name, int len, int copy_name,
+			    struct objfile *objfile, char *demangled)
+{
+  symbol_set_names_1 (gsymbol, linkage_name, len, copy_name, objfile,
+		      true, demangled);
+}
+
 /* Return the source code name of a symbol.  In languages where
    demangling is necessary, this is the demangled name.  */
 
@@ -4286,12 +4350,31 @@ sort_search_symbols_remove_dups (struct symbol_search *found, int nfound,
    expand_symtabs_matching method.  */
 struct search_symbols_data
 {
+  search_symbols_data ()
+    : nfiles (0), files (NULL), preg_p (0), next_worker_preg (0)
+  {
+  }
+
+  ~search_symbols_data ()
+  {
+    for (regex_t &r : worker_preg)
+      regfree (&r);
+  }
+
   int nfiles;
   const char **files;
 
   /* It is true if PREG contains valid data, false otherwise.  */
   unsigned preg_p : 1;
   regex_t preg;
+
+  /* Private copies of PREG, one per worker thread of a parallel scan.
+     The regex matcher is not guaranteed to be reentrant on a shared
+     pattern buffer, so threads never share one.  */
+  std::vector<regex_t> worker_preg;
+
+  /* The index of the next unused entry of WORKER_PREG.  */
+  std::atomic<unsigned> next_worker_preg;
 };
 
 /* A callback for expand_symtabs_matching.  */
@@ -4315,6 +4398,159 @@ search_symbols_name_matches (const char *symname, void *user_data)
   return !data->preg_p || regexec (&data->preg, symname, 0, NULL, 0) == 0;
 }
 
+/* Return the pattern buffer that one call of the callback of a
+   parallel scan of DATA should match with, or NULL if every name
+   matches.  The scans start no more threads than DATA has private
+   copies of the pattern, so gdb::parallel_for_each makes at most one
+   call more than there are copies.  Calls claim the copies in the
+   order they get here, which need not be the order the threads were
+   started in, and the one call left over, if any, gets the original
+   pattern.  No two calls of one scan get the same buffer; the caller
+   resets NEXT_WORKER_PREG before each scan.  */
+
+static regex_t *
+search_symbols_claim_preg (struct search_symbols_data *data)
+{
+  if (!data->preg_p)
+    return NULL;
+
+  unsigned idx = data->next_worker_preg++;
+
+  if (idx >= data->worker_preg.size ())
+    return &data->preg;
+  return &data->worker_preg[idx];
+}
+
+/* Return non-zero if SYM, found in block BLOCK (GLOBAL_BLOCK or
+   STATIC_BLOCK), is a match of kind KIND for the search described by
+   DATA.  PREG is the pattern buffer to match with, as returned by
+   search_symbols_claim_preg.  MATCHING_SYMTABS is the set of symtabs
+   whose file name matched, if the search is restricted to files.
+
+   This is called from worker threads: it must not throw, and may only
+   read symbol table data.  The natural names of symbols whose
+   language decodes them lazily must already have been computed, see
+   search_symbols_prepare_names.  */
+
+static int
+search_symbols_symbol_matches (struct search_symbols_data *data,
+			       regex_t *preg,
+			       const std::unordered_set<struct symtab *>
+				 &matching_symtabs,
+			       enum search_domain kind, struct symbol *sym)
+{
+  if (data->nfiles != 0
+      && matching_symtabs.find (symbol_symtab (sym)) == matching_symtabs.end ())
+    return 0;
+
+  return ((preg == NULL
+	   || regexec (preg, SYMBOL_NATURAL_NAME (sym), 0, NULL, 0) == 0)
+	  && ((kind == VARIABLES_DOMAIN
+	       && SYMBOL_CLASS (sym) != LOC_TYPEDEF
+	       && SYMBOL_CLASS (sym) != LOC_UNRESOLVED
+	       && SYMBOL_CLASS (sym) != LOC_BLOCK
+	       /* LOC_CONST can be used for more than just enums,
+		  e.g., c++ static const members.
+		  We only want to skip enums here.  */
+	       && !(SYMBOL_CLASS (sym) == LOC_CONST
+		    && (TYPE_CODE (SYMBOL_TYPE (sym))
+			== TYPE_CODE_ENUM)))
+	      || (kind == FUNCTIONS_DOMAIN
+		  && SYMBOL_CLASS (sym) == LOC_BLOCK)
+	      || (kind == TYPES_DOMAIN
+		  && SYMBOL_CLASS (sym) == LOC_TYPEDEF)));
+}
+
+/* Compute, in the calling thread, the natural names of the symbols in
+   the global and static blocks of COMPUNITS that are decoded lazily.
+   ada_decode_symbol caches the decoded name in the symbol and on the
+   objfile obstack the first time it is asked for, which the worker
+   threads of search_symbols must not do.  */
+
+static void
+search_symbols_prepare_names (const std::vector<struct compunit_symtab *>
+				&compunits)
+{
+  for (struct compunit_symtab *cust : compunits)
+    {
+      const struct blockvector *bv = COMPUNIT_BLOCKVECTOR (cust);
+
+      for (int i = GLOBAL_BLOCK; i <= STATIC_BLOCK; i++)
+	{
+	  struct block *b = BLOCKVECTOR_BLOCK (bv, i);
+	  struct block_iterator iter;
+	  struct symbol *sym;
+
+	  ALL_BLOCK_SYMBOLS (b, iter, sym)
+	    if (SYMBOL_LANGUAGE (sym) == language_ada)
+	      SYMBOL_NATURAL_NAME (sym);
+	}
+    }
+}
+
+/* Return the minimal symbols, over all objfiles, whose type is one of
+   TYPES and whose natural name matches the search described by DATA.
+   The symbols are returned in the order ALL_MSYMBOLS visits them.
+   The regular expression is evaluated in parallel.  */
+
+static std::vector<struct bound_minimal_symbol>
+search_minsyms_matching (struct search_symbols_data *data,
+			 const enum minimal_symbol_type types[4])
+{
+  std::vector<struct bound_minimal_symbol> candidates;
+  /* The natural names of CANDIDATES, computed here rather than in the
+     worker threads since that may update the symbol.  */
+  std::vector<const char *> names;
+  struct objfile *objfile;
+  struct minimal_symbol *msymbol;
+
+  ALL_MSYMBOLS (objfile, msymbol)
+    {
+      if (msymbol->created_by_gdb)
+	continue;
+
+      if (MSYMBOL_TYPE (msymbol) == types[0]
+	  || MSYMBOL_TYPE (msymbol) == types[1]
+	  || MSYMBOL_TYPE (msymbol) == types[2]
+	  || MSYMBOL_TYPE (msymbol) == types[3])
+	{
+	  struct bound_minimal_symbol bmsym = { msymbol, objfile };
+
+	  candidates.push_back (bmsym);
+	  if (data->preg_p)
+	    names.push_back (MSYMBOL_NATURAL_NAME (msymbol));
+	}
+    }
+
+  if (!data->preg_p)
+    return candidates;
+
+  std::vector<char> matched (candidates.size ());
+  typedef std::vector<struct bound_minimal_symbol>::iterator iter_type;
+
+  data->next_worker_preg = 0;
+  gdb::parallel_for_each (data->worker_preg.size (),
+			  candidates.begin (), candidates.end (),
+			  [&] (iter_type first, iter_type last)
+    {
+      regex_t *preg = search_symbols_claim_preg (data);
+
+      for (iter_type it = first; it != last; ++it)
+	matched[it - candidates.begin ()]
+	  = regexec (preg, names[it - candidates.begin ()],
+		     0, NULL, 0) == 0;
+    }, 1000);
+
+  QUIT;
+
+  std::vector<struct bound_minimal_symbol> result;
+  for (size_t i = 0; i < candidates.size (); ++i)
+    if (matched[i])
+      result.push_back (candidates[i]);
+
+  return result;
+}
+
 /* Search the symbol table for matches to the regular expression REGEXP,
    returning the results in *MATCHES.
 
@@ -4329,7 +4565,11 @@ search_symbols_name_matches (const char *symname, void *user_data)
 
    Within each file the results are sorted locally; each symtab's global and
    static blocks are separately alphabetized.
-   Duplicate entries are removed.  */
+   Duplicate entries are removed.
+
+   Once the symtabs that may hold matches have been expanded, the
+   blocks of the compunits are scanned by "maint set worker-threads"
+   threads in parallel; the results are identical to a serial scan.  */
 
 void
 search_symbols (const char *regexp, enum search_domain kind,
@@ -4337,13 +4577,7 @@ search_symbols (const char *regexp, enum search_domain kind,
 		struct symbol_search **matches)
 {
   struct compunit_symtab *cust;
-  const struct blockvector *bv;
-  struct block *b;
-  int i = 0;
-  struct block_iterator iter;
-  struct symbol *sym;
   struct objfile *objfile;
-  struct minimal_symbol *msymbol;
   int found_misc = 0;
   static const enum minimal_symbol_type types[]
     = {mst_data, mst_text, mst_abs};
@@ -4353,13 +4587,11 @@ search_symbols (const char *regexp, enum search_domain kind,
     = {mst_file_data, mst_solib_trampoline, mst_abs};
   static const enum minimal_symbol_type types4[]
     = {mst_file_bss, mst_text_gnu_ifunc, mst_abs};
-  enum minimal_symbol_type ourtype;
-  enum minimal_symbol_type ourtype2;
-  enum minimal_symbol_type ourtype3;
-  enum minimal_symbol_type ourtype4;
+  enum minimal_symbol_type ourtypes[4];
   struct symbol_search *found;
   struct symbol_search *tail;
   struct search_symbols_data datum;
+  std::vector<struct bound_minimal_symbol> minsym_matches;
   int nfound;
 
   /* OLD_CHAIN .. RETVAL_CHAIN is always freed, RETVAL_CHAIN .. current
@@ -4369,13 +4601,12 @@ search_symbols (const char *regexp, enum search_domain kind,
 
   gdb_assert (kind <= TYPES_DOMAIN);
 
-  ourtype = types[kind];
-  ourtype2 = types2[kind];
-  ourtype3 = types3[kind];
-  ourtype4 = types4[kind];
+  ourtypes[0] = types[kind];
+  ourtypes[1] = types2[kind];
+  ourtypes[2] = types3[kind];
+  ourtypes[3] = types4[kind];
 
   *matches = NULL;
-  datum.preg_p = 0;
 
   if (regexp != NULL)
     {
@@ -4385,6 +4616,8 @@ search_symbols (const char *regexp, enum search_domain kind,
          and <TYPENAME> or <OPERATOR>.  */
       const char *opend;
       const char *opname = operator_chars (regexp, &opend);
+      int cflags = REG_NOSUB | (case_sensitivity == case_sensitive_off
+				? REG_ICASE : 0);
       int errcode;
 
       if (*opname)
@@ -4414,9 +4647,7 @@ search_symbols (const char *regexp, enum search_domain kind,
 	    }
 	}
 
-      errcode = regcomp (&datum.preg, regexp,
-			 REG_NOSUB | (case_sensitivity == case_sensitive_off
-				      ? REG_ICASE : 0));
+      errcode = regcomp (&datum.preg, regexp, cflags);
       if (errcode != 0)
 	{
 	  char *err = get_regcomp_error (errcode, &datum.preg);
@@ -4426,6 +4657,20 @@ search_symbols (const char *regexp, enum search_domain kind,
 	}
       datum.preg_p = 1;
       make_regfree_cleanup (&datum.preg);
+
+      /* Give every worker thread its own copy of the pattern.  If the
+	 regex library runs out of memory, just use fewer threads.  */
+      unsigned int n_workers = worker_thread_count ();
+
+      datum.worker_preg.reserve (n_workers);
+      for (unsigned int i = 0; i < n_workers; ++i)
+	{
+	  regex_t copy;
+
+	  if (regcomp (&copy, regexp, cflags) != 0)
+	    break;
+	  datum.worker_preg.push_back (copy);
+	}
     }
 
   /* Search through the partial symtabs *first* for all symbols
@@ -4454,39 +4699,33 @@ search_symbols (const char *regexp, enum search_domain kind,
      any matching symbols without debug info.
      We only search the objfile the msymbol came from, we no longer search
      all objfiles.  In large programs (1000s of shared libs) searching all
-     objfiles is not worth the pain.  */
+     objfiles is not worth the pain.
+
+     The regexp is only evaluated once per minimal symbol; the matches
+     are reused by the scan for symbols without debug info below.  */
+
+  if (nfiles == 0)
+    minsym_matches = search_minsyms_matching (&datum, ourtypes);
 
   if (nfiles == 0 && (kind == VARIABLES_DOMAIN || kind == FUNCTIONS_DOMAIN))
     {
-      ALL_MSYMBOLS (objfile, msymbol)
-      {
-        QUIT;
+      for (const struct bound_minimal_symbol &bmsym : minsym_matches)
+	{
+	  struct minimal_symbol *msymbol = bmsym.minsym;
 
-	if (msymbol->created_by_gdb)
-	  continue;
+	  QUIT;
 
-	if (MSYMBOL_TYPE (msymbol) == ourtype
-	    || MSYMBOL_TYPE (msymbol) == ourtype2
-	    || MSYMBOL_TYPE (msymbol) == ourtype3
-	    || MSYMBOL_TYPE (msymbol) == ourtype4)
-	  {
-	    if (!datum.preg_p
-		|| regexec (&datum.preg, MSYMBOL_NATURAL_NAME (msymbol), 0,
-			    NULL, 0) == 0)
-	      {
-		/* Note: An important side-effect of these lookup functions
-		   is to expand the symbol table if msymbol is found, for the
-		   benefit of the next loop on ALL_COMPUNITS.  */
-		if (kind == FUNCTIONS_DOMAIN
-		    ? (find_pc_compunit_symtab
-		       (MSYMBOL_VALUE_ADDRESS (objfile, msymbol)) == NULL)
-		    : (lookup_symbol_in_objfile_from_linkage_name
-		       (objfile, MSYMBOL_LINKAGE_NAME (msymbol), VAR_DOMAIN)
-		       .symbol == NULL))
-		  found_misc = 1;
-	      }
-	  }
-      }
+	  /* Note: An important side-effect of these lookup functions
+	     is to expand the symbol table if msymbol is found, for the
+	     benefit of the next loop on ALL_COMPUNITS.  */
+	  if (kind == FUNCTIONS_DOMAIN
+	      ? (find_pc_compunit_symtab
+		 (MSYMBOL_VALUE_ADDRESS (bmsym.objfile, msymbol)) == NULL)
+	      : (lookup_symbol_in_objfile_from_linkage_name
+		 (bmsym.objfile, MSYMBOL_LINKAGE_NAME (msymbol), VAR_DOMAIN)
+		 .symbol == NULL))
+	    found_misc = 1;
+	}
     }
 
   found = NULL;
@@ -4494,61 +4733,101 @@ search_symbols (const char *regexp, enum search_domain kind,
   nfound = 0;
   retval_chain = make_cleanup_free_search_symbols (&found);
 
+  /* Now that every symtab that can contain a match is expanded, scan
+     their global and static blocks.  The file name filter is applied
+     to each symtab here, in the main thread, because
+     symtab_to_fullname caches its result in the symtab.  */
+
+  std::vector<struct compunit_symtab *> compunits;
+  std::unordered_set<struct symtab *> matching_symtabs;
+
   ALL_COMPUNITS (objfile, cust)
   {
-    bv = COMPUNIT_BLOCKVECTOR (cust);
-    for (i = GLOBAL_BLOCK; i <= STATIC_BLOCK; i++)
+    compunits.push_back (cust);
+
+    if (nfiles != 0)
       {
-	b = BLOCKVECTOR_BLOCK (bv, i);
-	ALL_BLOCK_SYMBOLS (b, iter, sym)
-	  {
-	    struct symtab *real_symtab = symbol_symtab (sym);
+	struct symtab *real_symtab;
 
+	ALL_COMPUNIT_FILETABS (cust, real_symtab)
+	  {
 	    QUIT;
 
-	    /* Check first sole REAL_SYMTAB->FILENAME.  It does not need to be
-	       a substring of symtab_to_fullname as it may contain "./" etc.  */
-	    if ((file_matches (real_symtab->filename, files, nfiles, 0)
-		 || ((basenames_may_differ
-		      || file_matches (lbasename (real_symtab->filename),
-				       files, nfiles, 1))
-		     && file_matches (symtab_to_fullname (real_symtab),
-				      files, nfiles, 0)))
-		&& ((!datum.preg_p
-		     || regexec (&datum.preg, SYMBOL_NATURAL_NAME (sym), 0,
-				 NULL, 0) == 0)
-		    && ((kind == VARIABLES_DOMAIN
-			 && SYMBOL_CLASS (sym) != LOC_TYPEDEF
-			 && SYMBOL_CLASS (sym) != LOC_UNRESOLVED
-			 && SYMBOL_CLASS (sym) != LOC_BLOCK
-			 /* LOC_CONST can be used for more than just enums,
-			    e.g., c++ static const members.
-			    We only want to skip enums here.  */
-			 && !(SYMBOL_CLASS (sym) == LOC_CONST
-			      && (TYPE_CODE (SYMBOL_TYPE (sym))
-				  == TYPE_CODE_ENUM)))
-			|| (kind == FUNCTIONS_DOMAIN 
-			    && SYMBOL_CLASS (sym) == LOC_BLOCK)
-			|| (kind == TYPES_DOMAIN
-			    && SYMBOL_CLASS (sym) == LOC_TYPEDEF))))
-	      {
-		/* match */
-		struct symbol_search *psr = XCNEW (struct symbol_search);
-
-		psr->block = i;
-		psr->symbol = sym;
-		psr->next = NULL;
-		if (tail == NULL)
-		  found = psr;
-		else
-		  tail->next = psr;
-		tail = psr;
-		nfound ++;
-	      }
+	    /* Check first sole REAL_SYMTAB->FILENAME.  It does not need
+	       to be a substring of symtab_to_fullname as it may contain
+	       "./" etc.  */
+	    if (file_matches (real_symtab->filename, files, nfiles, 0)
+		|| ((basenames_may_differ
+		     || file_matches (lbasename (real_symtab->filename),
+				      files, nfiles, 1))
+		    && file_matches (symtab_to_fullname (real_symtab),
+				     files, nfiles, 0)))
+	      matching_symtabs.insert (real_symtab);
 	  }
       }
   }
 
+  /* The matches of each compunit, in block and dictionary order, as
+     pairs of block index and symbol.  */
+  typedef std::vector<std::pair<int, struct symbol *>> cu_matches;
+  typedef std::vector<struct compunit_symtab *>::iterator cu_iter;
+  std::vector<cu_matches> matches_by_cu (compunits.size ());
+
+  /* Without a regexp the threads need no pattern buffer of their
+     own; otherwise use as many threads as we have buffers for.  */
+  unsigned int n_threads = (datum.preg_p
+			    ? datum.worker_preg.size ()
+			    : worker_thread_count ());
+
+  if (datum.preg_p)
+    search_symbols_prepare_names (compunits);
+
+  datum.next_worker_preg = 0;
+  gdb::parallel_for_each (n_threads, compunits.begin (), compunits.end (),
+			  [&] (cu_iter first, cu_iter last)
+    {
+      regex_t *preg = search_symbols_claim_preg (&datum);
+
+      for (cu_iter it = first; it != last; ++it)
+	{
+	  const struct blockvector *bv = COMPUNIT_BLOCKVECTOR (*it);
+	  cu_matches &result = matches_by_cu[it - compunits.begin ()];
+
+	  for (int i = GLOBAL_BLOCK; i <= STATIC_BLOCK; i++)
+	    {
+	      struct block *b = BLOCKVECTOR_BLOCK (bv, i);
+	      struct block_iterator iter;
+	      struct symbol *sym;
+
+	      ALL_BLOCK_SYMBOLS (b, iter, sym)
+		{
+		  if (search_symbols_symbol_matches (&datum, preg,
+						     matching_symtabs,
+						     kind, sym))
+		    result.push_back (std::make_pair (i, sym));
+		}
+	    }
+	}
+    });
+
+  QUIT;
+
+  for (const cu_matches &cu_result : matches_by_cu)
+    for (const std::pair<int, struct symbol *> &match : cu_result)
+      {
+	struct symbol_search *psr = XCNEW (struct symbol_search);
+
+	psr->block = match.first;
+	psr->symbol = match.second;
+	psr->next = NULL;
+	if (tail == NULL)
+	  found = psr;
+	else
+	  tail->next = psr;
+	tail = psr;
+	nfound ++;
+      }
+
   if (found != NULL)
     {
       sort_search_symbols_remove_dups (found, nfound, &found, &tail);
@@ -4560,49 +4839,36 @@ search_symbols (const char *regexp, enum search_domain kind,
 
   if (found_misc || (nfiles == 0 && kind != FUNCTIONS_DOMAIN))
     {
-      ALL_MSYMBOLS (objfile, msymbol)
-      {
-        QUIT;
+      for (const struct bound_minimal_symbol &bmsym : minsym_matches)
+	{
+	  struct minimal_symbol *msymbol = bmsym.minsym;
 
-	if (msymbol->created_by_gdb)
-	  continue;
+	  QUIT;
 
-	if (MSYMBOL_TYPE (msymbol) == ourtype
-	    || MSYMBOL_TYPE (msymbol) == ourtype2
-	    || MSYMBOL_TYPE (msymbol) == ourtype3
-	    || MSYMBOL_TYPE (msymbol) == ourtype4)
-	  {
-	    if (!datum.preg_p
-		|| regexec (&datum.preg, MSYMBOL_NATURAL_NAME (msymbol), 0,
-			    NULL, 0) == 0)
-	      {
-		/* For functions we can do a quick check of whether the
-		   symbol might be found via find_pc_symtab.  */
-		if (kind != FUNCTIONS_DOMAIN
-		    || (find_pc_compunit_symtab
-			(MSYMBOL_VALUE_ADDRESS (objfile, msymbol)) == NULL))
-		  {
-		    if (lookup_symbol_in_objfile_from_linkage_name
-			(objfile, MSYMBOL_LINKAGE_NAME (msymbol), VAR_DOMAIN)
-			.symbol == NULL)
-		      {
-			/* match */
-			struct symbol_search *psr = XNEW (struct symbol_search);
-			psr->block = i;
-			psr->msymbol.minsym = msymbol;
-			psr->msymbol.objfile = objfile;
-			psr->symbol = NULL;
-			psr->next = NULL;
-			if (tail == NULL)
-			  found = psr;
-			else
-			  tail->next = psr;
-			tail = psr;
-		      }
-		  }
-	      }
-	  }
-      }
+	  /* For functions we can do a quick check of whether the
+	     symbol might be found via find_pc_symtab.  */
+	  if (kind != FUNCTIONS_DOMAIN
+	      || (find_pc_compunit_symtab
+		  (MSYMBOL_VALUE_ADDRESS (bmsym.objfile, msymbol)) == NULL))
+	    {
+	      if (lookup_symbol_in_objfile_from_linkage_name
+		  (bmsym.objfile, MSYMBOL_LINKAGE_NAME (msymbol), VAR_DOMAIN)
+		  .symbol == NULL)
+		{
+		  /* match */
+		  struct symbol_search *psr = XNEW (struct symbol_search);
+		  psr->block = GLOBAL_BLOCK;
+		  psr->msymbol = bmsym;
+		  psr->symbol = NULL;
+		  psr->next = NULL;
+		  if (tail == NULL)
+		    found = psr;
+		  else
+		    tail->next = psr;
+		  tail = psr;
+		}
+	    }
+	}
     }
 
   discard_cleanups (retval_chain);
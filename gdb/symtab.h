@@ -214,6 +214,32 @@ extern void symbol_set_names (struct general_symbol_info *symbol,
 			      const char *linkage_name, int len, int copy_name,
 			      struct objfile *objfile);
 
+/* Like symbol_set_names, but DEMANGLED is what an earlier call to
+   symbol_find_demangled_name returned for LINKAGE_NAME, so the name
+   is not demangled again.  This takes ownership of DEMANGLED.  */
+extern void symbol_set_names_demangled (struct general_symbol_info *symbol,
+					const char *linkage_name, int len,
+					int copy_name,
+					struct objfile *objfile,
+					char *demangled);
+
+/* Try to determine the demangled name for a symbol, based on the
+   language of that symbol.  If the language is set to language_auto,
+   it will attempt to find any demangling algorithm that works and
+   then set the language appropriately.  The returned name is allocated
+   by the demangler and should be xfree'd.
+
+   This only reads global state, so it may be called from worker
+   threads for distinct symbols.  */
+extern char *symbol_find_demangled_name (struct general_symbol_info *gsymbol,
+					 const char *mangled);
+
+/* Return non-zero if OBJFILE's BFD already has a demangled name
+   recorded for LINKAGE_NAME, so that setting it as a symbol's name
+   would not demangle it again.  */
+extern int symbol_demangled_name_cached_p (struct objfile *objfile,
+					   const char *linkage_name);
+
 /* Now come lots of name accessor macros.  Short version as to when to
    use which: Use SYMBOL_NATURAL_NAME to refer to the name of the
    symbol in the original source code.  Use SYMBOL_LINKAGE_NAME if you
@@ -363,6 +389,14 @@ struct minimal_symbol
      the object file format may not carry that piece of information.  */
   unsigned int has_size : 1;
 
+  /* Nonzero once the name has been entered into the objfile's
+     demangled name hash by symbol_set_names.  Until then, the name is
+     only the linkage name as recorded, and NAME_COPY says whether it
+     must be copied when it is entered; see
+     minimal_symbol_reader::record_full.  */
+  unsigned int name_set : 1;
+  unsigned int name_copy : 1;
+
   /* Minimal symbols with the same hash key are kept on a linked
      list.  This is the link.  */
 
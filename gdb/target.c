@@ -1144,8 +1144,7 @@ raw_memory_xfer_partial (struct target_ops *ops, gdb_byte *readbuf,
      that never made it to the target.  */
   if (writebuf != NULL
       && !ptid_equal (inferior_ptid, null_ptid)
-      && target_dcache_init_p ()
-      && (stack_cache_enabled_p () || code_cache_enabled_p ()))
+      && target_dcache_init_p ())
     {
       DCACHE *dcache = target_dcache_get ();
 
@@ -1223,6 +1222,24 @@ memory_xfer_partial_1 (struct target_ops *ops, enum target_object object,
   else
     inf = NULL;
 
+  /* Memory prefetched into the dcache is used for any kind of read,
+     except of raw memory which bypasses the dcache.  */
+  if (inf != NULL
+      && readbuf != NULL
+      && object != TARGET_OBJECT_RAW_MEMORY
+      && get_traceframe_number () == -1
+      && target_dcache_init_p ())
+    {
+      ULONGEST done = dcache_read_prefetched (target_dcache_get (), memaddr,
+					      readbuf, reg_len);
+
+      if (done > 0)
+	{
+	  *xfered_len = done;
+	  return TARGET_XFER_OK;
+	}
+    }
+
   if (inf != NULL
       && readbuf != NULL
       /* The dcache reads whole cache lines; that doesn't play well
@@ -1468,6 +1485,19 @@ target_read_uint32 (CORE_ADDR memaddr, uint32_t *result)
   return 0;
 }
 
+/* See target.h.  */
+
+ULONGEST
+target_prefetch_memory (CORE_ADDR memaddr, ULONGEST len)
+{
+  if (ptid_equal (inferior_ptid, null_ptid)
+      || get_traceframe_number () != -1
+      || len == 0)
+    return 0;
+
+  return dcache_prefetch (target_dcache_get_or_init (), memaddr, len);
+}
+
 /* Like target_read_memory, but specify explicitly that this is a read
    from the target's raw memory.  That is, this read bypasses the
    dcache, breakpoint shadowing, etc.  */
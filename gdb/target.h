@@ -1437,6 +1437,15 @@ extern int target_read_string (CORE_ADDR, char **, int, int *);
 extern int target_read_raw_memory (CORE_ADDR memaddr, gdb_byte *myaddr,
 				   ssize_t len);
 
+/* Read the LEN bytes at MEMADDR into the target data cache, in as few
+   target accesses as possible, so that reading any part of them later
+   does not access the target until the inferior runs or the cache is
+   otherwise flushed.  This is only a hint: errors are ignored, and
+   less may be read.  Return the number of bytes from MEMADDR that are
+   in the cache.  */
+
+extern ULONGEST target_prefetch_memory (CORE_ADDR memaddr, ULONGEST len);
+
 extern int target_read_stack (CORE_ADDR memaddr, gdb_byte *myaddr, ssize_t len);
 
 extern int target_read_code (CORE_ADDR memaddr, gdb_byte *myaddr, ssize_t len);
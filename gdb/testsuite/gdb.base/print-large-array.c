@@ -0,0 +1,47 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright (C) 2017 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#define LARGE_SIZE (256 * 1024)
+
+int large_int_array[LARGE_SIZE / sizeof (int)];
+char large_char_array[LARGE_SIZE];
+int large_uniform_array[LARGE_SIZE / sizeof (int)];
+char large_uniform_char_array[LARGE_SIZE];
+
+void
+change_arrays (void)
+{
+  large_int_array[50000] = -1;
+}
+
+int
+main (void)
+{
+  int i;
+
+  for (i = 0; i < LARGE_SIZE / sizeof (int); i++)
+    large_int_array[i] = i;
+  for (i = 0; i < LARGE_SIZE - 1; i++)
+    large_char_array[i] = 'a' + i % 26;
+  large_uniform_array[LARGE_SIZE / sizeof (int) - 1] = 1;
+  for (i = 0; i < LARGE_SIZE - 1; i++)
+    large_uniform_char_array[i] = 'x';
+
+  change_arrays (); /* break here */
+
+  return 0; /* break after change */
+}
@@ -0,0 +1,43 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2017 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* Enough overloaded functions, compiled without debug info, that
+   their minimal symbols are demangled by several worker threads.  */
+
+#define F1(n) \
+  int func_##n (int x) { return x + n; } \
+  long func_##n (long x) { return x - n; }
+#define F10(n) \
+  F1 (n##0) F1 (n##1) F1 (n##2) F1 (n##3) F1 (n##4) \
+  F1 (n##5) F1 (n##6) F1 (n##7) F1 (n##8) F1 (n##9)
+#define F100(n) \
+  F10 (n##0) F10 (n##1) F10 (n##2) F10 (n##3) F10 (n##4) \
+  F10 (n##5) F10 (n##6) F10 (n##7) F10 (n##8) F10 (n##9)
+#define F1000(n) \
+  F100 (n##0) F100 (n##1) F100 (n##2) F100 (n##3) F100 (n##4) \
+  F100 (n##5) F100 (n##6) F100 (n##7) F100 (n##8) F100 (n##9)
+
+namespace ns
+{
+  F1000 (1)
+}
+
+int
+main ()
+{
+  return ns::func_1234 (0) + ns::func_1234 (0L) != 0;
+}
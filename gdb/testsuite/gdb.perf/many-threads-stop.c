@@ -0,0 +1,68 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright (C) 2017 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+#include <pthread.h>
+#include <unistd.h>
+
+#ifndef NUM_THREADS
+#define NUM_THREADS 1000
+#endif
+
+static pthread_barrier_t barrier;
+
+static void *
+thread_function (void *arg)
+{
+  pthread_barrier_wait (&barrier);
+  /* Keep the thread running, so that it has to be stopped.  */
+  while (1)
+    usleep (1000);
+  return NULL;
+}
+
+void
+all_started (void)
+{
+}
+
+void
+marker (void)
+{
+}
+
+int
+main (void)
+{
+  static pthread_t threads[NUM_THREADS];
+  pthread_attr_t attr;
+  int i;
+
+  pthread_attr_init (&attr);
+  pthread_attr_setstacksize (&attr, 64 * 1024);
+  pthread_barrier_init (&barrier, NULL, NUM_THREADS + 1);
+
+  for (i = 0; i < NUM_THREADS; i++)
+    pthread_create (&threads[i], &attr, thread_function, NULL);
+  pthread_barrier_wait (&barrier);
+
+  all_started ();
+
+  /* Each call stops every thread of the process.  */
+  while (1)
+    marker ();
+
+  return 0;
+}
@@ -0,0 +1,53 @@
+# Copyright (C) 2017 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# This file is part of the GDB testsuite.  It tests the caching of
+# pretty-printer lookups.
+
+import gdb
+
+class PointPrinter (object):
+    def __init__ (self, val):
+        self.val = val
+
+    def to_string (self):
+        return "pt(%d,%d)" % (int (self.val['x']), int (self.val['y']))
+
+class CountingLookup (object):
+    """A lookup function which counts how often it is called, and
+    recognizes struct point while RECOGNIZE is true."""
+
+    def __init__ (self, name, cacheable, recognize):
+        self.name = name
+        self.enabled = True
+        if cacheable:
+            self.cacheable = True
+        self.recognize = recognize
+        self.calls = 0
+
+    def __call__ (self, val):
+        self.calls += 1
+        if (self.recognize
+            and str (val.type.strip_typedefs ()) == 'struct point'):
+            return PointPrinter (val)
+        return None
+
+plain_lookup = CountingLookup ('plain-lookup', False, False)
+skip_lookup = CountingLookup ('skip-lookup', True, False)
+point_lookup = CountingLookup ('point-lookup', True, True)
+
+gdb.pretty_printers.append (plain_lookup)
+gdb.pretty_printers.append (skip_lookup)
+gdb.pretty_printers.append (point_lookup)
@@ -1982,6 +1982,84 @@ maybe_print_array_index (struct type *index_type, LONGEST index,
   LA_PRINT_ARRAY_INDEX (index_value, stream, options);
 }
 
+/* Return how many of the LEN elements, each ELTLEN addressable memory
+   units long, of the array at EMBEDDED_OFFSET in VAL were read, if
+   only the start of VAL was read by value_fetch_lazy_limited.  */
+
+static unsigned int
+fetched_array_length (struct value *val, LONGEST embedded_offset,
+		      ULONGEST eltlen, unsigned int len)
+{
+  LONGEST limit = value_limited_length (val);
+
+  if (limit == 0 || eltlen == 0)
+    return len;
+
+  limit -= embedded_offset;
+  if (limit < 0)
+    return 0;
+  if (limit / eltlen < len)
+    return limit / eltlen;
+  return len;
+}
+
+/* See valprint.h.  */
+
+unsigned int
+val_print_fetch_elements (struct value *val, LONGEST embedded_offset,
+			  ULONGEST eltlen, unsigned int start,
+			  unsigned int print_max, unsigned int len)
+{
+  unsigned int fetched_len
+    = fetched_array_length (val, embedded_offset, eltlen, len);
+
+  if (fetched_len < len
+      && (fetched_len <= start || fetched_len - start < print_max))
+    {
+      ULONGEST want = (ULONGEST) start + print_max;
+
+      if (want > len)
+	want = len;
+      value_fetch_limited_more (val, embedded_offset + want * eltlen);
+      fetched_len = fetched_array_length (val, embedded_offset, eltlen, len);
+    }
+
+  return fetched_len;
+}
+
+/* See valprint.h.  */
+
+unsigned int
+val_print_fetch_repeats (struct value *val, LONGEST embedded_offset,
+			 ULONGEST eltlen, unsigned int start,
+			 unsigned int fetched_len, unsigned int len)
+{
+  while (fetched_len < len)
+    {
+      unsigned int want, new_len, i;
+
+      /* Read twice as much as before each time.  */
+      want = fetched_len < len / 2 ? 2 * fetched_len : len;
+      if (want == 0)
+	want = 1;
+      value_fetch_limited_more (val, (embedded_offset
+				      + (LONGEST) want * eltlen));
+      new_len = fetched_array_length (val, embedded_offset, eltlen, len);
+      if (new_len <= fetched_len)
+	break;
+
+      for (i = fetched_len; i < new_len; i++)
+	if (!value_contents_eq (val, embedded_offset + start * eltlen,
+				val, embedded_offset + i * eltlen,
+				eltlen))
+	  return new_len;
+
+      fetched_len = new_len;
+    }
+
+  return fetched_len;
+}
+
 /*  Called by various <lang>_val_print routines to print elements of an
    array in the form "<elem1>, <elem2>, <elem3>, ...".
 
@@ -2001,6 +2079,8 @@ val_print_array_elements (struct type *type,
 {
   unsigned int things_printed = 0;
   unsigned len;
+  /* Number of leading elements whose contents were read.  */
+  unsigned int fetched_len;
   struct type *elttype, *index_type, *base_index_type;
   unsigned eltlen;
   /* Position of the array element we are examining to see
@@ -2052,10 +2132,29 @@ val_print_array_elements (struct type *type,
       len = 0;
     }
 
+  /* If only the start of VAL was read (see value_fetch_lazy_limited),
+     read on if "print elements" was raised since, and treat the
+     elements that were not read like those beyond the limit.  */
+  fetched_len = val_print_fetch_elements (val, embedded_offset, eltlen, i,
+					  options->print_max, len);
+
   annotate_array_section_begin (i, elttype);
 
   for (; i < len && things_printed < options->print_max; i++)
     {
+      /* A repeat block may have taken us past the part that was
+	 read.  */
+      if (i >= fetched_len)
+	{
+	  fetched_len = val_print_fetch_elements (val, embedded_offset,
+						  eltlen, i,
+						  (options->print_max
+						   - things_printed),
+						  len);
+	  if (i >= fetched_len)
+	    break;
+	}
+
       if (i != 0)
 	{
 	  if (options->prettyformat_arrays)
@@ -2078,7 +2177,7 @@ val_print_array_elements (struct type *type,
 	 UINT_MAX (unlimited).  */
       if (options->repeat_count_threshold < UINT_MAX)
 	{
-	  while (rep1 < len
+	  while (rep1 < fetched_len
 		 && value_contents_eq (val,
 				       embedded_offset + i * eltlen,
 				       val,
@@ -2089,6 +2188,26 @@ val_print_array_elements (struct type *type,
 	      ++reps;
 	      ++rep1;
 	    }
+
+	  /* If the repeats go on to the end of the part of VAL that was
+	     read, read on until they stop, so that the count is right.  */
+	  if (rep1 == fetched_len && fetched_len < len)
+	    {
+	      fetched_len = val_print_fetch_repeats (val, embedded_offset,
+						     eltlen, i, fetched_len,
+						     len);
+	      while (rep1 < fetched_len
+		     && value_contents_eq (val,
+					   embedded_offset + i * eltlen,
+					   val,
+					   (embedded_offset
+					    + rep1 * eltlen),
+					   eltlen))
+		{
+		  ++reps;
+		  ++rep1;
+		}
+	    }
 	}
 
       if (reps > options->repeat_count_threshold)
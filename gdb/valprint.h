@@ -121,6 +121,34 @@ extern void val_print_array_elements (struct type *, LONGEST,
 				      const struct value_print_options *,
 				      unsigned int);
 
+/* Of the array of LEN elements, each ELTLEN addressable memory units
+   long, at EMBEDDED_OFFSET in VAL, make sure that elements START to
+   START + PRINT_MAX - 1 have been read, if only the start of VAL was
+   read by value_fetch_lazy_limited with a smaller "print elements"
+   limit.  Return the number of leading elements read.  */
+
+extern unsigned int val_print_fetch_elements (struct value *val,
+					      LONGEST embedded_offset,
+					      ULONGEST eltlen,
+					      unsigned int start,
+					      unsigned int print_max,
+					      unsigned int len);
+
+/* Elements START to FETCHED_LEN - 1 of the array of LEN elements, each
+   ELTLEN addressable memory units long, at EMBEDDED_OFFSET in VAL are
+   all equal, and VAL was only read up to element FETCHED_LEN by
+   value_fetch_lazy_limited.  Read more of VAL, until the run of equal
+   elements ends or all of the array has been read, so that the run
+   can be printed with its real repeat count.  Return the number of
+   elements now read.  */
+
+extern unsigned int val_print_fetch_repeats (struct value *val,
+					     LONGEST embedded_offset,
+					     ULONGEST eltlen,
+					     unsigned int start,
+					     unsigned int fetched_len,
+					     unsigned int len);
+
 extern void val_print_type_code_int (struct type *, const gdb_byte *,
 				     struct ui_file *);
 
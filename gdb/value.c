@@ -40,6 +40,8 @@
 #include "tracepoint.h"
 #include "cp-abi.h"
 #include "user-regs.h"
+#include "inferior.h"
+#include "observer.h"
 #include <algorithm>
 
 /* Prototypes for exported functions.  */
@@ -339,8 +341,26 @@ struct value
      treated pretty much the same, except not-saved registers have a
      different string representation and related error strings.  */
   VEC(range_s) *optimized_out;
+
+  /* If non-zero, this is a large array value of which only the first
+     LIMITED_LENGTH addressable memory units were read from the
+     target, by value_fetch_lazy_limited.  The rest of the contents is
+     marked unavailable until value_fetch_limited_more or
+     value_fetch_limited_rest reads it.  */
+  LONGEST limited_length;
+
+  /* The values of limited_fetch_epoch and of the number of the
+     current inferior when LIMITED_LENGTH was set.  The rest of the
+     contents is only read if they are unchanged, so that it is what
+     the memory held when the start was read.  The values in the value
+     history and in convenience variables are read in full before the
+     memory may change, by limited_fetch_saved_values.  */
+  unsigned long limited_epoch;
+  int limited_inferior;
 };
 
+static void value_fetch_limited_rest (struct value *val);
+
 /* See value.h.  */
 
 struct gdbarch *
@@ -1276,6 +1296,7 @@ const gdb_byte *
 value_contents_all (struct value *value)
 {
   const gdb_byte *result = value_contents_for_printing (value);
+  value_fetch_limited_rest (value);
   require_not_optimized_out (value);
   require_available (value);
   return result;
@@ -1355,6 +1376,11 @@ value_contents_copy_raw (struct value *dst, LONGEST dst_offset,
 					     TARGET_CHAR_BIT * dst_offset,
 					     TARGET_CHAR_BIT * length));
 
+  /* If SRC was only read in part, read the rest before copying any of
+     it.  */
+  if (src->limited_length > 0 && src_offset + length > src->limited_length)
+    value_fetch_limited_rest (src);
+
   /* Copy the data.  */
   memcpy (value_contents_all_raw (dst) + dst_offset * unit_size,
 	  value_contents_all_raw (src) + src_offset * unit_size,
@@ -1428,6 +1454,7 @@ value_contents_writeable (struct value *value)
 {
   if (value->lazy)
     value_fetch_lazy (value);
+  value_fetch_limited_rest (value);
   return value_contents_raw (value);
 }
 
@@ -1792,6 +1819,9 @@ value_copy (struct value *arg)
     }
   val->unavailable = VEC_copy (range_s, arg->unavailable);
   val->optimized_out = VEC_copy (range_s, arg->optimized_out);
+  val->limited_length = arg->limited_length;
+  val->limited_epoch = arg->limited_epoch;
+  val->limited_inferior = arg->limited_inferior;
   set_value_parent (val, arg->parent);
   if (VALUE_LVAL (val) == lval_computed)
     {
@@ -4111,6 +4141,307 @@ value_fetch_lazy (struct value *val)
   set_value_lazy (val, 0);
 }
 
+/* Incremented whenever the memory of the inferior may change: when
+   it resumes or exits, and when GDB writes to it.  */
+
+static unsigned long limited_fetch_epoch;
+
+/* If only the start of VAL was read by value_fetch_lazy_limited, and
+   the rest is still what the memory holds, read the rest now.  If LEN
+   is not -1, only do so if the rest overlaps the LEN addressable
+   memory units at ADDR.  */
+
+static void
+limited_fetch_saved_value (struct value *val, CORE_ADDR addr, LONGEST len)
+{
+  CORE_ADDR start, end;
+
+  if (val == NULL
+      || val->limited_length == 0
+      || val->limited_epoch != limited_fetch_epoch
+      || val->limited_inferior != current_inferior ()->num)
+    return;
+
+  start = value_address (val) + val->limited_length;
+  end = (value_address (val)
+	 + type_length_units (check_typedef (value_enclosing_type (val))));
+  if (len != -1 && (addr + len <= start || addr >= end))
+    return;
+
+  /* Failing to read just leaves the rest unavailable.  */
+  TRY
+    {
+      value_fetch_limited_rest (val);
+    }
+  CATCH (ex, RETURN_MASK_ERROR)
+    {
+    }
+  END_CATCH
+}
+
+/* Read the rest of the partially read values in the value history
+   and in convenience variables, before the memory they came from may
+   change, since those values must not change.  LEN and ADDR are as
+   for limited_fetch_saved_value.  The rest of values which are just
+   being printed stays unread; it becomes unavailable instead.  */
+
+static void
+limited_fetch_saved_values (CORE_ADDR addr, LONGEST len)
+{
+  struct value_history_chunk *cur;
+  struct internalvar *var;
+  int i;
+
+  for (cur = value_history_chain; cur; cur = cur->next)
+    for (i = 0; i < VALUE_HISTORY_CHUNK; i++)
+      limited_fetch_saved_value (cur->values[i], addr, len);
+
+  for (var = internalvars; var; var = var->next)
+    if (var->kind == INTERNALVAR_VALUE)
+      limited_fetch_saved_value (var->u.value, addr, len);
+}
+
+static void
+limited_fetch_about_to_proceed (void)
+{
+  limited_fetch_saved_values (0, -1);
+}
+
+static void
+limited_fetch_memory_about_to_change (struct inferior *inferior,
+				      CORE_ADDR addr, ssize_t len)
+{
+  if (inferior == current_inferior ())
+    limited_fetch_saved_values (addr, len);
+}
+
+static void
+limited_fetch_target_resumed (ptid_t ptid)
+{
+  ++limited_fetch_epoch;
+}
+
+static void
+limited_fetch_memory_changed (struct inferior *inferior, CORE_ADDR addr,
+			      ssize_t len, const bfd_byte *data)
+{
+  ++limited_fetch_epoch;
+}
+
+static void
+limited_fetch_inferior_exit (struct inferior *inf)
+{
+  ++limited_fetch_epoch;
+}
+
+/* Arrays whose contents are at most this many bytes long are always
+   read in full by value_fetch_lazy_limited, and larger ones are read
+   at least this far.  This keeps the printed form of small arrays,
+   and in particular their "<repeats N times>" counts, exact.  */
+
+#define LIMITED_FETCH_MIN_LENGTH 65536
+
+/* See value.h.  */
+
+void
+value_fetch_lazy_limited (struct value *val, unsigned int elements)
+{
+  struct type *type = check_typedef (value_enclosing_type (val));
+
+  gdb_assert (value_lazy (val));
+
+  if (VALUE_LVAL (val) == lval_memory
+      && value_bitsize (val) == 0
+      && elements != UINT_MAX
+      && TYPE_CODE (type) == TYPE_CODE_ARRAY
+      && !TYPE_VECTOR (type)
+      && TYPE_LENGTH (type) > LIMITED_FETCH_MIN_LENGTH)
+    {
+      struct type *elttype = check_typedef (TYPE_TARGET_TYPE (type));
+      int unit_size
+	= gdbarch_addressable_memory_unit_size (get_type_arch (type));
+      ULONGEST length = type_length_units (type);
+      ULONGEST eltlen = type_length_units (elttype);
+      ULONGEST limit;
+
+      if (eltlen != 0)
+	{
+	  limit = std::max ((ULONGEST) elements * eltlen,
+			    (ULONGEST) LIMITED_FETCH_MIN_LENGTH / unit_size);
+	  limit -= limit % eltlen;
+
+	  if (limit < length)
+	    {
+	      read_value_memory (val, 0, value_stack (val),
+				 value_address (val),
+				 value_contents_all_raw (val), limit);
+	      mark_value_bytes_unavailable (val, limit, length - limit);
+	      val->limited_length = limit;
+	      val->limited_epoch = limited_fetch_epoch;
+	      val->limited_inferior = current_inferior ()->num;
+	      set_value_lazy (val, 0);
+	      return;
+	    }
+	}
+    }
+
+  value_fetch_lazy (val);
+}
+
+/* See value.h.  */
+
+LONGEST
+value_limited_length (const struct value *val)
+{
+  return val->limited_length;
+}
+
+/* See value.h.  */
+
+void
+value_fetch_limited_more (struct value *val, LONGEST length)
+{
+  LONGEST limit = val->limited_length;
+  LONGEST total;
+  range_s *r;
+
+  if (limit == 0 || length <= limit)
+    return;
+
+  if (val->limited_epoch != limited_fetch_epoch
+      || val->limited_inferior != current_inferior ()->num)
+    {
+      val->limited_length = 0;
+      return;
+    }
+
+  total = type_length_units (check_typedef (value_enclosing_type (val)));
+  if (length > total)
+    length = total;
+
+  /* Forget the range value_fetch_lazy_limited marked unavailable.  It
+     is the last one, though it may have been merged with bytes that
+     were unavailable in the part that was read.  */
+  r = VEC_last (range_s, val->unavailable);
+  gdb_assert (r->offset + r->length == total * TARGET_CHAR_BIT);
+  if (r->offset >= limit * TARGET_CHAR_BIT)
+    VEC_pop (range_s, val->unavailable);
+  else
+    r->length = limit * TARGET_CHAR_BIT - r->offset;
+
+  TRY
+    {
+      read_value_memory (val, limit, value_stack (val),
+			 value_address (val) + limit,
+			 value_contents_all_raw (val)
+			 + limit * gdbarch_addressable_memory_unit_size
+				     (get_value_arch (val)),
+			 length - limit);
+    }
+  CATCH (ex, RETURN_MASK_ERROR)
+    {
+      /* Leave the rest unavailable, as it was.  */
+      mark_value_bytes_unavailable (val, limit, total - limit);
+      throw_exception (ex);
+    }
+  END_CATCH
+
+  if (length < total)
+    {
+      mark_value_bytes_unavailable (val, length, total - length);
+      val->limited_length = length;
+    }
+  else
+    val->limited_length = 0;
+}
+
+/* If only the start of VAL was read by value_fetch_lazy_limited, read
+   the rest of it from the target now.  This is how the elements of a
+   partially read array in the value history that were not printed
+   become available when they are used.  If the memory may have
+   changed since the start was read, the rest stays unavailable
+   instead, since values, in particular those in the value history,
+   never change.  */
+
+static void
+value_fetch_limited_rest (struct value *val)
+{
+  if (val->limited_length > 0)
+    value_fetch_limited_more
+      (val, type_length_units (check_typedef (value_enclosing_type (val))));
+}
+
+/* The most value_prefetch reads at once.  */
+
+#define MAX_PREFETCH_LENGTH 65536
+
+/* See value.h.  */
+
+ULONGEST
+value_prefetch (struct value *val, LONGEST count)
+{
+  struct type *type = check_typedef (value_type (val));
+  int unit_size;
+  ULONGEST length;
+
+  if (VALUE_LVAL (val) != lval_memory
+      || value_bitsize (val) != 0
+      || count <= 0)
+    return 0;
+
+  unit_size = gdbarch_addressable_memory_unit_size (get_type_arch (type));
+  length = TYPE_LENGTH (type);
+  if (length == 0)
+    return 0;
+
+  if (count > MAX_PREFETCH_LENGTH / length)
+    count = std::max ((ULONGEST) 1, MAX_PREFETCH_LENGTH / length);
+
+  return target_prefetch_memory (value_address (val),
+				 count * length / unit_size) * unit_size;
+}
+
+/* See value.h.  */
+
+void
+value_readahead (struct value_readahead *ra, struct value *val,
+		 LONGEST remaining)
+{
+  struct type *type = check_typedef (value_type (val));
+  CORE_ADDR addr;
+  ULONGEST length;
+  int unit_size;
+
+  if (VALUE_LVAL (val) != lval_memory
+      || !value_lazy (val)
+      || value_bitsize (val) != 0)
+    {
+      ra->length = 0;
+      return;
+    }
+
+  unit_size = gdbarch_addressable_memory_unit_size (get_type_arch (type));
+  addr = value_address (val);
+  length = TYPE_LENGTH (type) / unit_size;
+
+  /* Prefetch once two values in a row are adjacent, and again when
+     the values get past what was prefetched.  */
+  if (length != 0
+      && length == ra->length
+      && addr == ra->next
+      && (addr < ra->start || addr + length > ra->end))
+    {
+      ULONGEST done = value_prefetch (val, remaining) / unit_size;
+
+      /* Do not try again if that failed.  */
+      ra->start = addr;
+      ra->end = done != 0 ? addr + done : (CORE_ADDR) -1;
+    }
+
+  ra->next = addr + length;
+  ra->length = length;
+}
+
 /* Implementation of the convenience function $_isvoid.  */
 
 static struct value *
@@ -4179,4 +4510,11 @@ prevents future values, larger than this size, from being allocated."),
 			    set_max_value_size,
 			    show_max_value_size,
 			    &setlist, &showlist);
+
+  observer_attach_about_to_proceed (limited_fetch_about_to_proceed);
+  observer_attach_memory_about_to_change
+    (limited_fetch_memory_about_to_change);
+  observer_attach_target_resumed (limited_fetch_target_resumed);
+  observer_attach_memory_changed (limited_fetch_memory_changed);
+  observer_attach_inferior_exit (limited_fetch_inferior_exit);
 }
@@ -367,6 +367,62 @@ extern const gdb_byte *
 
 extern void value_fetch_lazy (struct value *val);
 
+/* Like value_fetch_lazy, but if VAL is a large array in memory, only
+   read as much of it as is needed to print its first ELEMENTS
+   elements, instead of all of it.  The rest of the contents is marked
+   unavailable until it is used, e.g. by value_contents or by taking
+   an element of VAL that was not read, which reads it, provided the
+   inferior's memory can not have changed since.  Otherwise the rest
+   stays unavailable.  ELEMENTS is typically the "print elements"
+   limit; UINT_MAX means no limit.  */
+extern void value_fetch_lazy_limited (struct value *val,
+				      unsigned int elements);
+
+/* If VAL was read by value_fetch_lazy_limited and only partially
+   fetched, return the number of addressable memory units of its
+   contents that were read.  Return zero otherwise, including once
+   the rest has been read.  */
+extern LONGEST value_limited_length (const struct value *val);
+
+/* If only the start of VAL was read by value_fetch_lazy_limited, read
+   more of it, so that at least its first LENGTH addressable memory
+   units are available, or all of it if it is shorter.  If the memory
+   may have changed since the start was read, nothing is read and the
+   rest of VAL stays unavailable for good.  */
+extern void value_fetch_limited_more (struct value *val, LONGEST length);
+
+/* If VAL is a value in memory, read the memory of COUNT objects of
+   its type starting at its address, up to an internal limit, into the
+   target data cache at once, so that fetching VAL and the objects
+   after it does not access the target once for each.  Return the
+   number of bytes prefetched.  */
+extern ULONGEST value_prefetch (struct value *val, LONGEST count);
+
+/* The state of value_readahead.  Zero-initialize it before the first
+   call.  */
+
+struct value_readahead
+{
+  /* The address following the last value seen.  */
+  CORE_ADDR next;
+
+  /* The length of the last value seen, in addressable units, or zero
+     if it was not a lazy value in memory.  */
+  ULONGEST length;
+
+  /* The range last prefetched.  */
+  CORE_ADDR start;
+  CORE_ADDR end;
+};
+
+/* Called for each value VAL of a sequence, such as the elements of a
+   container, with REMAINING the number of values in the sequence
+   that are still to come, VAL included.  When the values are
+   adjacent in memory, prefetch as many of them as possible with
+   value_prefetch.  */
+extern void value_readahead (struct value_readahead *ra, struct value *val,
+			     LONGEST remaining);
+
 /* If nonzero, this is the value of a variable which does not actually
    exist in the program, at least partially.  If the value is lazy,
    this may fetch it now.  */
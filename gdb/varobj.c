@@ -749,6 +749,7 @@ update_dynamic_varobj_children (struct varobj *var,
 				int to)
 {
   int i;
+  struct value_readahead readahead = { 0 };
 
   *cchanged = 0;
 
@@ -785,7 +786,11 @@ update_dynamic_varobj_children (struct varobj *var,
 	  /* Release vitem->value so its lifetime is not bound to the
 	     execution of a command.  */
 	  if (item != NULL && item->value != NULL)
-	    release_value_or_incref (item->value);
+	    {
+	      release_value_or_incref (item->value);
+	      value_readahead (&readahead, item->value,
+			       to < 0 ? INT_MAX : to + 1 - i);
+	    }
 	}
 
       if (item == NULL)
@@ -839,6 +844,17 @@ update_dynamic_varobj_children (struct varobj *var,
   return 1;
 }
 
+/* If the value of VAR has not been read, read its memory at once, so
+   that creating or updating its children, which are read one by one,
+   does not access the target for each of them.  */
+
+static void
+varobj_prefetch_children (struct varobj *var)
+{
+  if (var->value != NULL && value_lazy (var->value))
+    value_prefetch (var->value, 1);
+}
+
 int
 varobj_get_num_children (struct varobj *var)
 {
@@ -890,6 +906,8 @@ varobj_list_children (struct varobj *var, int *from, int *to)
 
   /* If we're called when the list of children is not yet initialized,
      allocate enough elements in it.  */
+  if (VEC_length (varobj_p, var->children) < var->num_children)
+    varobj_prefetch_children (var);
   while (VEC_length (varobj_p, var->children) < var->num_children)
     VEC_safe_push (varobj_p, var->children, NULL);
 
@@ -1775,6 +1793,8 @@ varobj_update (struct varobj **varp, int is_explicit)
 	 child is popped from the work stack first, and so
 	 will be added to result first.  This does not
 	 affect correctness, just "nicer".  */
+      if (!VEC_empty (varobj_p, v->children))
+	varobj_prefetch_children (v);
       for (i = VEC_length (varobj_p, v->children)-1; i >= 0; --i)
 	{
 	  varobj_p c = VEC_index (varobj_p, v->children, i);
@@ -47,6 +47,10 @@ zlib_compress(int header_size,
 {
   *compressed_size = uncompressed_size + uncompressed_size / 1000 + 128;
   *compressed_data = new unsigned char[*compressed_size + header_size];
+  // Clear the header, so that fields the caller does not set, such
+  // as ch_reserved in a 64-bit ELF compression header, are zero
+  // rather than whatever the memory held.
+  memset(*compressed_data, 0, header_size);
 
   int compress_level;
   if (parameters->options().optimize() >= 1)
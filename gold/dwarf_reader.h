@@ -966,6 +966,14 @@ class Dwarf_line_info
             std::vector<std::string>* other_lines)
   { return this->do_addr2line(shndx, offset, other_lines); }
 
+  // Create a Dwarf_line_info object of the right size and endianness
+  // for OBJECT.  If SHNDX is not -1U, only the line information for
+  // that section is read.  The caller must lock OBJECT and delete the
+  // result.  Unlike one_addr2line, this does not touch a shared cache,
+  // so different objects may be read in different threads.
+  static Dwarf_line_info*
+  create(Object* object, unsigned int shndx = -1U);
+
   // A helper function for a single addr2line lookup.  It also keeps a
   // cache of the last CACHE_SIZE Dwarf_line_info objects it created;
   // set to 0 not to cache at all.  The larger CACHE_SIZE is, the more
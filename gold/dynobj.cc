@@ -26,6 +26,7 @@
 #include <cstring>
 
 #include "elfcpp.h"
+#include "gold-threads.h"
 #include "parameters.h"
 #include "script.h"
 #include "symtab.h"
@@ -914,6 +915,49 @@ Dynobj::elf_hash(const char* name)
   return h;
 }
 
+// The minimum number of symbols worth handing to a thread when
+// building the hash tables.
+
+static const size_t hash_table_min_piece = 32768;
+
+// Compute the hash codes of the names of a vector of symbols, in
+// parallel pieces.
+
+class Symbol_hash_codes : public Parallel_pieces
+{
+ public:
+  Symbol_hash_codes(const std::vector<Symbol*>& syms,
+		    uint32_t (*hash)(const char*),
+		    std::vector<uint32_t>* codes)
+    : syms_(syms), hash_(hash), codes_(codes)
+  { }
+
+  // Compute all the hash codes.
+  void
+  compute()
+  {
+    this->codes_->resize(this->syms_.size());
+    this->run(Parallel_pieces::piece_count(this->syms_.size(),
+					   hash_table_min_piece));
+  }
+
+ protected:
+  void
+  do_run_piece(int piece, int count)
+  {
+    size_t start, end;
+    Parallel_pieces::piece_range(this->syms_.size(), piece, count,
+				 &start, &end);
+    for (size_t i = start; i < end; ++i)
+      (*this->codes_)[i] = this->hash_(this->syms_[i]->name());
+  }
+
+ private:
+  const std::vector<Symbol*>& syms_;
+  uint32_t (*hash_)(const char*);
+  std::vector<uint32_t>* codes_;
+};
+
 // Create a standard ELF hash table, setting *PPHASH and *PHASHLEN.
 // DYNSYMS is a vector with all the global dynamic symbols.
 // LOCAL_DYNSYM_COUNT is the number of local symbols in the dynamic
@@ -928,9 +972,8 @@ Dynobj::create_elf_hash_table(const std::vector<Symbol*>& dynsyms,
   unsigned int dynsym_count = dynsyms.size();
 
   // Get the hash values for all the symbols.
-  std::vector<uint32_t> dynsym_hashvals(dynsym_count);
-  for (unsigned int i = 0; i < dynsym_count; ++i)
-    dynsym_hashvals[i] = Dynobj::elf_hash(dynsyms[i]->name());
+  std::vector<uint32_t> dynsym_hashvals;
+  Symbol_hash_codes(dynsyms, Dynobj::elf_hash, &dynsym_hashvals).compute();
 
   const unsigned int bucketcount =
     Dynobj::compute_bucket_count(dynsym_hashvals, false);
@@ -1080,9 +1123,6 @@ Dynobj::create_gnu_hash_table(const std::vector<Symbol*>& dynsyms,
   std::vector<Symbol*> hashed_dynsyms;
   hashed_dynsyms.reserve(count);
 
-  std::vector<uint32_t> dynsym_hashvals;
-  dynsym_hashvals.reserve(count);
-  
   for (unsigned int i = 0; i < count; ++i)
     {
       Symbol* sym = dynsyms[i];
@@ -1093,12 +1133,13 @@ Dynobj::create_gnu_hash_table(const std::vector<Symbol*>& dynsyms,
 	      || sym->is_forced_local()))
 	unhashed_dynsyms.push_back(sym);
       else
-	{
-	  hashed_dynsyms.push_back(sym);
-	  dynsym_hashvals.push_back(Dynobj::gnu_hash(sym->name()));
-	}
+	hashed_dynsyms.push_back(sym);
     }
 
+  std::vector<uint32_t> dynsym_hashvals;
+  Symbol_hash_codes(hashed_dynsyms, Dynobj::gnu_hash,
+		    &dynsym_hashvals).compute();
+
   // Put the unhashed symbols at the start of the global portion of
   // the dynamic symbol table.
   const unsigned int unhashed_count = unhashed_dynsyms.size();
@@ -1171,6 +1212,173 @@ Dynobj::create_gnu_hash_table(const std::vector<Symbol*>& dynsyms,
     gold_unreachable();
 }
 
+// Fill in the chains and the bloom filter of a GNU hash table, in
+// parallel pieces.  Each piece of the symbols sets its own bloom
+// filter, and stores its symbols in each bucket after those of the
+// previous pieces, so that the result is the same as doing it in one
+// pass.
+
+template<int size, bool big_endian>
+class Gnu_hash_chains : public Parallel_pieces
+{
+ public:
+  typedef typename elfcpp::Elf_types<size>::Elf_WXword Word;
+
+  Gnu_hash_chains(const std::vector<Symbol*>& hashed_dynsyms,
+		  const std::vector<uint32_t>& dynsym_hashvals,
+		  unsigned int bucketcount, uint32_t shift1, uint32_t shift2,
+		  uint32_t maskbits, uint32_t maskwords)
+    : hashed_dynsyms_(hashed_dynsyms), dynsym_hashvals_(dynsym_hashvals),
+      bucketcount_(bucketcount), shift1_(shift1), shift2_(shift2),
+      maskbits_(maskbits), maskwords_(maskwords), pieces_(), last_(NULL),
+      chains_(NULL), symindx_(0), counting_(true)
+  { }
+
+  // Count the symbols in each bucket, setting COUNTS, and or the bloom
+  // filters of the pieces into BITMASK.
+  void
+  count(int pieces, std::vector<uint32_t>* counts,
+	std::vector<Word>* bitmask);
+
+  // Store the chains at CHAINS, and set the dynamic symbol indexes,
+  // given the INDX of the first symbol of each bucket, the LAST
+  // symbol index of each bucket, and the index SYMINDX of the first
+  // hashed symbol.  This must be called after count.
+  void
+  store(const std::vector<uint32_t>& indx,
+	const std::vector<uint32_t>& last, uint32_t symindx,
+	unsigned char* chains);
+
+ protected:
+  void
+  do_run_piece(int piece, int count);
+
+ private:
+  // The state of one piece.
+  struct Piece
+  {
+    // The number of symbols of the piece in each bucket, and then the
+    // next symbol index of the piece in each bucket.
+    std::vector<uint32_t> next;
+    // The bloom filter of the piece.
+    std::vector<Word> bitmask;
+  };
+
+  const std::vector<Symbol*>& hashed_dynsyms_;
+  const std::vector<uint32_t>& dynsym_hashvals_;
+  unsigned int bucketcount_;
+  uint32_t shift1_;
+  uint32_t shift2_;
+  uint32_t maskbits_;
+  uint32_t maskwords_;
+  std::vector<Piece> pieces_;
+  const std::vector<uint32_t>* last_;
+  unsigned char* chains_;
+  uint32_t symindx_;
+  bool counting_;
+};
+
+template<int size, bool big_endian>
+void
+Gnu_hash_chains<size, big_endian>::count(int pieces,
+					 std::vector<uint32_t>* counts,
+					 std::vector<Word>* bitmask)
+{
+  this->pieces_.resize(pieces);
+  this->counting_ = true;
+  this->run(pieces);
+
+  // The next symbol index of each piece in each bucket is after those
+  // of the previous pieces; store the counts for now.
+  counts->assign(this->bucketcount_, 0);
+  bitmask->assign(this->maskwords_, 0);
+  for (int i = 0; i < pieces; ++i)
+    {
+      Piece* piece = &this->pieces_[i];
+      for (unsigned int b = 0; b < this->bucketcount_; ++b)
+	{
+	  uint32_t c = piece->next[b];
+	  piece->next[b] = (*counts)[b];
+	  (*counts)[b] += c;
+	}
+      for (uint32_t w = 0; w < this->maskwords_; ++w)
+	(*bitmask)[w] |= piece->bitmask[w];
+      std::vector<Word>().swap(piece->bitmask);
+    }
+}
+
+template<int size, bool big_endian>
+void
+Gnu_hash_chains<size, big_endian>::store(const std::vector<uint32_t>& indx,
+					 const std::vector<uint32_t>& last,
+					 uint32_t symindx,
+					 unsigned char* chains)
+{
+  for (size_t i = 0; i < this->pieces_.size(); ++i)
+    {
+      Piece* piece = &this->pieces_[i];
+      for (unsigned int b = 0; b < this->bucketcount_; ++b)
+	piece->next[b] += indx[b];
+    }
+
+  this->last_ = &last;
+  this->chains_ = chains;
+  this->symindx_ = symindx;
+  this->counting_ = false;
+  this->run(this->pieces_.size());
+}
+
+template<int size, bool big_endian>
+void
+Gnu_hash_chains<size, big_endian>::do_run_piece(int piece, int count)
+{
+  size_t start, end;
+  Parallel_pieces::piece_range(this->hashed_dynsyms_.size(), piece, count,
+			       &start, &end);
+  Piece* p = &this->pieces_[piece];
+  const uint32_t mask = (1U << this->shift1_) - 1U;
+
+  if (this->counting_)
+    {
+      p->next.assign(this->bucketcount_, 0);
+      p->bitmask.assign(this->maskwords_, 0);
+      for (size_t i = start; i < end; ++i)
+	{
+	  uint32_t hashval = this->dynsym_hashvals_[i];
+	  ++p->next[hashval % this->bucketcount_];
+
+	  unsigned int val = ((hashval >> this->shift1_)
+			      & ((this->maskbits_ >> this->shift1_) - 1));
+	  p->bitmask[val] |= (static_cast<Word>(1U)) << (hashval & mask);
+	  p->bitmask[val] |= ((static_cast<Word>(1U))
+			      << ((hashval >> this->shift2_) & mask));
+	}
+      return;
+    }
+
+  const std::vector<uint32_t>& last(*this->last_);
+  for (size_t i = start; i < end; ++i)
+    {
+      Symbol* sym = this->hashed_dynsyms_[i];
+      uint32_t hashval = this->dynsym_hashvals_[i];
+
+      unsigned int bucket = hashval % this->bucketcount_;
+      uint32_t dynsym_index = p->next[bucket];
+      uint32_t val = hashval & ~ 1U;
+      if (dynsym_index == last[bucket])
+	{
+	  // Last element terminates the chain.
+	  val |= 1;
+	}
+      unsigned char* pchain =
+	this->chains_ + (dynsym_index - this->symindx_) * 4;
+      elfcpp::Swap<32, big_endian>::writeval(pchain, val);
+
+      sym->set_dynsym_index(dynsym_index);
+      ++p->next[bucket];
+    }
+}
+
 // Create the actual data for a GNU hash table.  This is just a copy
 // of the code from the old GNU linker.
 
@@ -1235,26 +1443,31 @@ Dynobj::sized_create_gnu_hash_table(
 	maskbitslog2 = 6;
       shift1 = 6;
     }
-  uint32_t mask = (1U << shift1) - 1U;
   uint32_t shift2 = maskbitslog2;
   uint32_t maskbits = 1U << maskbitslog2;
   uint32_t maskwords = 1U << (maskbitslog2 - shift1);
 
   typedef typename elfcpp::Elf_types<size>::Elf_WXword Word;
-  std::vector<Word> bitmask(maskwords);
-  std::vector<uint32_t> counts(bucketcount);
+  std::vector<Word> bitmask;
+  std::vector<uint32_t> counts;
   std::vector<uint32_t> indx(bucketcount);
+  std::vector<uint32_t> last(bucketcount);
   uint32_t symindx = unhashed_dynsym_count;
 
-  // Count the number of times each hash bucket is used.
-  for (unsigned int i = 0; i < nsyms; ++i)
-    ++counts[dynsym_hashvals[i] % bucketcount];
+  // Count the number of times each hash bucket is used, and build the
+  // bloom filter.
+  Gnu_hash_chains<size, big_endian> chains(hashed_dynsyms, dynsym_hashvals,
+					   bucketcount, shift1, shift2,
+					   maskbits, maskwords);
+  chains.count(Parallel_pieces::piece_count(nsyms, hash_table_min_piece),
+	       &counts, &bitmask);
 
   unsigned int cnt = symindx;
   for (unsigned int i = 0; i < bucketcount; ++i)
     {
       indx[i] = cnt;
       cnt += counts[i];
+      last[i] = cnt - 1;
     }
 
   unsigned int hashlen = (4 + bucketcount + nsyms) * 4;
@@ -1276,29 +1489,8 @@ Dynobj::sized_create_gnu_hash_table(
       p += 4;
     }
 
-  for (unsigned int i = 0; i < nsyms; ++i)
-    {
-      Symbol* sym = hashed_dynsyms[i];
-      uint32_t hashval = dynsym_hashvals[i];
-
-      unsigned int bucket = hashval % bucketcount;
-      unsigned int val = ((hashval >> shift1)
-			  & ((maskbits >> shift1) - 1));
-      bitmask[val] |= (static_cast<Word>(1U)) << (hashval & mask);
-      bitmask[val] |= (static_cast<Word>(1U)) << ((hashval >> shift2) & mask);
-      val = hashval & ~ 1U;
-      if (counts[bucket] == 1)
-	{
-	  // Last element terminates the chain.
-	  val |= 1;
-	}
-      elfcpp::Swap<32, big_endian>::writeval(p + (indx[bucket] - symindx) * 4,
-					     val);
-      --counts[bucket];
-
-      sym->set_dynsym_index(indx[bucket]);
-      ++indx[bucket];
-    }
+  // Store the chains, which sets the final dynamic symbol indexes.
+  chains.store(indx, last, symindx, p);
 
   p = phash + 16;
   for (unsigned int i = 0; i < maskwords; ++i)
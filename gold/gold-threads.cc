@@ -23,9 +23,11 @@
 #include "gold.h"
 
 #include <cstring>
+#include <vector>
 
 #ifdef ENABLE_THREADS
 #include <pthread.h>
+#include <unistd.h>
 #endif
 
 #include "options.h"
@@ -447,4 +449,105 @@ Initialize_lock::do_run_once(void*)
   *this->pplock_ = new Lock();
 }
 
+// Class Parallel_pieces.
+
+// Return the number of pieces to split WORK into.  The pieces are
+// run while laying out the output, so this uses the thread count of
+// the middle of the link, as queue_middle_tasks does.
+
+int
+Parallel_pieces::piece_count(size_t work, size_t min_work)
+{
+  if (!parameters->options().threads() || work < 2 * min_work)
+    return 1;
+
+#ifndef ENABLE_THREADS
+  gold_unreachable();
+#else
+  int threads = parameters->options().thread_count_middle();
+  if (threads == 0)
+    {
+#ifdef _SC_NPROCESSORS_ONLN
+      long online = sysconf(_SC_NPROCESSORS_ONLN);
+      threads = online > 0 ? online : 1;
+#else
+      threads = 1;
+#endif
+    }
+
+  size_t count = work / min_work;
+  if (count > static_cast<size_t>(threads))
+    count = threads;
+  return count;
+#endif
+}
+
+#ifdef ENABLE_THREADS
+
+// The argument passed to a thread running a piece.
+
+struct Parallel_piece_arg
+{
+  Parallel_pieces* pieces;
+  int piece;
+  int count;
+};
+
+// A routine passed to pthread_create which runs a piece.
+
+extern "C"
+{
+
+static void*
+c_run_piece(void* arg)
+{
+  Parallel_piece_arg* ppa = static_cast<Parallel_piece_arg*>(arg);
+  ppa->pieces->internal_run(ppa->piece, ppa->count);
+  return NULL;
+}
+
+}
+
+#endif // defined(ENABLE_THREADS)
+
+// Run the pieces.
+
+void
+Parallel_pieces::run(int count)
+{
+  gold_assert(count > 0);
+
+#ifdef ENABLE_THREADS
+  if (count > 1)
+    {
+      gold_assert(parameters->options().threads());
+
+      std::vector<pthread_t> tids(count);
+      std::vector<Parallel_piece_arg> args(count);
+      for (int i = 1; i < count; ++i)
+	{
+	  args[i].pieces = this;
+	  args[i].piece = i;
+	  args[i].count = count;
+	  int err = pthread_create(&tids[i], NULL, c_run_piece, &args[i]);
+	  if (err != 0)
+	    gold_fatal(_("pthread_create failed: %s"), strerror(err));
+	}
+
+      this->do_run_piece(0, count);
+
+      for (int i = 1; i < count; ++i)
+	{
+	  int err = pthread_join(tids[i], NULL);
+	  if (err != 0)
+	    gold_fatal(_("pthread_join failed: %s"), strerror(err));
+	}
+      return;
+    }
+#endif
+
+  for (int i = 0; i < count; ++i)
+    this->do_run_piece(i, count);
+}
+
 } // End namespace gold.
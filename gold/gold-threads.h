@@ -262,6 +262,56 @@ class Initialize_lock : public Once
   Lock** const pplock_;
 };
 
+// A class used to split a job into pieces which run in parallel when
+// we are using threads, and return when they are all done.  This is
+// for loops over large arrays inside a single task.  This is an
+// abstract parent class; any actual use will involve a child of this.
+
+class Parallel_pieces
+{
+ public:
+  Parallel_pieces()
+  { }
+
+  virtual
+  ~Parallel_pieces()
+  { }
+
+  // Return the number of pieces to split WORK units of work into, so
+  // that each piece has at least MIN_WORK units, and there are no
+  // more pieces than --thread-count-middle.  This is 1 if we are not
+  // using threads.
+  static int
+  piece_count(size_t work, size_t min_work);
+
+  // Set *START and *END to the range of piece PIECE of COUNT pieces
+  // of an array of SIZE elements.
+  static void
+  piece_range(size_t size, int piece, int count, size_t* start,
+	      size_t* end)
+  {
+    *start = static_cast<uint64_t>(size) * piece / count;
+    *end = static_cast<uint64_t>(size) * (piece + 1) / count;
+  }
+
+  // Run the COUNT pieces, and wait for all of them to finish.  The
+  // first piece runs in the calling thread.
+  void
+  run(int count);
+
+  // This is an internal function, which must be public because it is
+  // run by an extern "C" function called via pthread_create.
+  void
+  internal_run(int piece, int count)
+  { this->do_run_piece(piece, count); }
+
+ protected:
+  // This must be implemented by the child class.  It must only touch
+  // data which no other piece touches.
+  virtual void
+  do_run_piece(int piece, int count) = 0;
+};
+
 } // End namespace gold.
 
 #endif // !defined(GOLD_THREADS_H)
@@ -368,8 +368,9 @@ void
 Layout_task_runner::run(Workqueue* workqueue, const Task* task)
 {
   // See if any of the input definitions violate the One Definition Rule.
-  // TODO: if this is too slow, do this as a task, rather than inline.
-  this->symtab_->detect_odr_violations(task, this->options_.output_file_name());
+  // This is done by tasks which run in parallel with the rest of the link.
+  this->symtab_->detect_odr_violations(workqueue,
+				       this->options_.output_file_name());
 
   Layout* layout = this->layout_;
   off_t file_size = layout->finalize(this->input_objects_,
@@ -702,6 +702,10 @@ class General_options
 	      N_("Ignored"), N_("[ignored]"),
 	      {"definitions", "nodefinitions", "nosymbolic", "pure-text"});
 
+  DEFINE_bool(async_output_write, options::TWO_DASHES, '\0', false,
+	      N_("Write finished parts of the output file in the background"),
+	      N_("Write the output file through a file mapping (default)"));
+
   // b
 
   // This should really be an "enum", but it's too easy for folks to
@@ -1076,6 +1080,11 @@ class General_options
 	      N_("Orphan section handling"), N_("[place,discard,warn,error]"),
 	      {"place", "discard", "warn", "error"});
 
+  DEFINE_enum(output_map_advice, options::TWO_DASHES, '\0', "none",
+	      N_("Prefault the memory of the output file, or use huge pages"),
+	      N_("[none,prefault,hugepage]"),
+	      {"none", "prefault", "hugepage"});
+
   // p
 
   DEFINE_bool(p, options::ONE_DASH, 'p', false,
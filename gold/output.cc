@@ -29,11 +29,17 @@
 #include <unistd.h>
 #include <sys/stat.h>
 #include <algorithm>
+#include <deque>
+#include <map>
 
 #ifdef HAVE_SYS_MMAN_H
 #include <sys/mman.h>
 #endif
 
+#ifdef ENABLE_THREADS
+#include <pthread.h>
+#endif
+
 #include "libiberty.h"
 
 #include "dwarf.h"
@@ -44,6 +50,7 @@
 #include "merge.h"
 #include "descriptors.h"
 #include "layout.h"
+#include "timer.h"
 #include "output.h"
 
 // For systems without mmap support.
@@ -4963,6 +4970,348 @@ Output_segment::print_section_list_to_mapfile(Mapfile* mapfile,
     (*p)->print_to_mapfile(mapfile);
 }
 
+// Class Output_file_writer.  This writes the parts of the output file
+// queued by Output_file::queue_write from a thread of its own, so that
+// the writes overlap with the rest of the link instead of all
+// happening when the file is closed.  The parts are written in the
+// order in which they were queued.  A part may still be changing
+// while it is written, and a view may be changed without being queued
+// again, or be queued at the wrong offset, so every part handed out as
+// an output view is written once more when the file is finished.  The
+// background writes get most of the data to the file early; the last
+// ones make sure that every byte has its final value.
+
+class Output_file_writer
+{
+ public:
+  Output_file_writer(const char* name, int o, const unsigned char* base);
+
+  ~Output_file_writer();
+
+  // Queue the SIZE bytes at START to be written.
+  void
+  queue(off_t start, size_t size);
+
+  // Record that the SIZE bytes at START were handed out as an output
+  // view, to be written again by finish.
+  void
+  hand_out(off_t start, size_t size);
+
+  // Wait for the queued writes, and stop the thread, so that the
+  // contents of the file may move.
+  void
+  stop();
+
+  // Start writing again, from the contents of the file at BASE.
+  void
+  restart(const unsigned char* base);
+
+  // Wait for the queued writes, then write the parts of the FILE_SIZE
+  // bytes which were handed out as output views or never queued, and
+  // report any error.
+  void
+  finish(off_t file_size);
+
+  // The body of the thread.
+  void
+  run();
+
+ private:
+  // A part of the file.
+  typedef std::pair<off_t, size_t> Range;
+
+  // A set of parts of the file, as a map from the start to the end of
+  // each part.  The parts are merged when they overlap or touch.
+  typedef std::map<off_t, off_t> Range_set;
+
+  // Add the part from START to END to RANGES.
+  static void
+  add_range(Range_set* ranges, off_t start, off_t end);
+
+  // Write RANGE to the file.
+  void
+  write_range(const Range& range);
+
+  // The file name, for errors.
+  const char* name_;
+  // The file descriptor.
+  int o_;
+  // The contents of the file.
+  const unsigned char* base_;
+  // The parts waiting to be written.
+  std::deque<Range> queue_;
+  // The parts ever queued.
+  Range_set queued_;
+  // The parts ever handed out as output views.
+  Range_set handed_out_;
+  // The first error, or 0.  This and the statistics below are only
+  // used by the thread, or after it is done.
+  int errno_;
+  // The number of bytes and calls to pwrite.
+  unsigned long long bytes_;
+  unsigned long long writes_;
+  // Wall time spent in pwrite, in milliseconds.
+  long write_time_;
+#ifdef ENABLE_THREADS
+  // Protects queue_, queued_ and handed_out_ while the thread is
+  // running.
+  pthread_mutex_t lock_;
+  // Signaled when there is something in queue_, or when done_ is set.
+  pthread_cond_t cond_;
+  // Set by stop.
+  bool done_;
+  pthread_t tid_;
+#endif
+};
+
+#ifdef ENABLE_THREADS
+
+// Passed to pthread_create.
+
+extern "C"
+{
+
+static void*
+output_file_writer_body(void* arg)
+{
+  static_cast<Output_file_writer*>(arg)->run();
+  return NULL;
+}
+
+}
+
+#endif // defined(ENABLE_THREADS)
+
+Output_file_writer::Output_file_writer(const char* name, int o,
+				       const unsigned char* base)
+  : name_(name), o_(o), base_(base), queue_(), queued_(), handed_out_(),
+    errno_(0), bytes_(0), writes_(0), write_time_(0)
+{
+#ifdef ENABLE_THREADS
+  this->done_ = false;
+  int err = pthread_mutex_init(&this->lock_, NULL);
+  if (err != 0)
+    gold_fatal(_("pthread_mutex_init failed: %s"), strerror(err));
+  err = pthread_cond_init(&this->cond_, NULL);
+  if (err != 0)
+    gold_fatal(_("pthread_cond_init failed: %s"), strerror(err));
+#endif
+  this->restart(base);
+}
+
+Output_file_writer::~Output_file_writer()
+{
+#ifdef ENABLE_THREADS
+  pthread_cond_destroy(&this->cond_);
+  pthread_mutex_destroy(&this->lock_);
+#endif
+}
+
+// Add a part to a set, merging it with the parts it overlaps.
+
+void
+Output_file_writer::add_range(Range_set* ranges, off_t start, off_t end)
+{
+  Range_set::iterator p = ranges->upper_bound(start);
+  if (p != ranges->begin())
+    {
+      Range_set::iterator prev = p;
+      --prev;
+      if (prev->second >= start)
+	p = prev;
+    }
+  off_t merged_start = start;
+  off_t merged_end = end;
+  while (p != ranges->end() && p->first <= end)
+    {
+      merged_start = std::min(merged_start, p->first);
+      merged_end = std::max(merged_end, p->second);
+      ranges->erase(p++);
+    }
+  (*ranges)[merged_start] = merged_end;
+}
+
+// Queue a part of the file.  Without threads, just write it now.
+
+void
+Output_file_writer::queue(off_t start, size_t size)
+{
+  if (size == 0)
+    return;
+
+  Range range(start, size);
+
+#ifdef ENABLE_THREADS
+  pthread_mutex_lock(&this->lock_);
+#endif
+
+  add_range(&this->queued_, start, start + size);
+
+#ifdef ENABLE_THREADS
+  // Extend the last part still waiting if this one follows it.
+  if (!this->queue_.empty()
+      && (this->queue_.back().first
+	  + static_cast<off_t>(this->queue_.back().second)) == start)
+    this->queue_.back().second += size;
+  else
+    this->queue_.push_back(range);
+  pthread_cond_signal(&this->cond_);
+  pthread_mutex_unlock(&this->lock_);
+#else
+  this->write_range(range);
+#endif
+}
+
+// Record a part handed out as an output view.
+
+void
+Output_file_writer::hand_out(off_t start, size_t size)
+{
+  if (size == 0)
+    return;
+
+#ifdef ENABLE_THREADS
+  pthread_mutex_lock(&this->lock_);
+#endif
+  add_range(&this->handed_out_, start, start + size);
+#ifdef ENABLE_THREADS
+  pthread_mutex_unlock(&this->lock_);
+#endif
+}
+
+// Write a part of the file.
+
+void
+Output_file_writer::write_range(const Range& range)
+{
+  Timer timer;
+  timer.start();
+
+  const unsigned char* p = this->base_ + range.first;
+  off_t offset = range.first;
+  size_t bytes_to_write = range.second;
+  unsigned long long writes = 0;
+  int err = 0;
+  while (bytes_to_write > 0)
+    {
+      ssize_t bytes_written = ::pwrite(this->o_, p, bytes_to_write, offset);
+      ++writes;
+      if (bytes_written < 0 && errno == EINTR)
+	continue;
+      if (bytes_written <= 0)
+	{
+	  err = bytes_written < 0 ? errno : EIO;
+	  break;
+	}
+      p += bytes_written;
+      offset += bytes_written;
+      bytes_to_write -= bytes_written;
+    }
+
+  long wall = timer.get_elapsed_time().wall;
+
+  this->bytes_ += range.second - bytes_to_write;
+  this->writes_ += writes;
+  this->write_time_ += wall;
+  if (err != 0 && this->errno_ == 0)
+    this->errno_ = err;
+}
+
+// The body of the thread: write parts until finish is called and
+// nothing is left.
+
+void
+Output_file_writer::run()
+{
+#ifdef ENABLE_THREADS
+  pthread_mutex_lock(&this->lock_);
+  while (true)
+    {
+      while (this->queue_.empty() && !this->done_)
+	pthread_cond_wait(&this->cond_, &this->lock_);
+      if (this->queue_.empty())
+	break;
+      Range range = this->queue_.front();
+      this->queue_.pop_front();
+      pthread_mutex_unlock(&this->lock_);
+      this->write_range(range);
+      pthread_mutex_lock(&this->lock_);
+    }
+  pthread_mutex_unlock(&this->lock_);
+#endif
+}
+
+// Stop the thread once it has written everything queued.
+
+void
+Output_file_writer::stop()
+{
+#ifdef ENABLE_THREADS
+  pthread_mutex_lock(&this->lock_);
+  this->done_ = true;
+  pthread_cond_signal(&this->cond_);
+  pthread_mutex_unlock(&this->lock_);
+  int err = pthread_join(this->tid_, NULL);
+  if (err != 0)
+    gold_fatal(_("pthread_join failed: %s"), strerror(err));
+#endif
+}
+
+// Start the thread, writing from BASE.
+
+void
+Output_file_writer::restart(const unsigned char* base)
+{
+  this->base_ = base;
+#ifdef ENABLE_THREADS
+  this->done_ = false;
+  int err = pthread_create(&this->tid_, NULL, output_file_writer_body, this);
+  if (err != 0)
+    gold_fatal(_("pthread_create failed: %s"), strerror(err));
+#endif
+}
+
+// Finish writing the file.
+
+void
+Output_file_writer::finish(off_t file_size)
+{
+  this->stop();
+
+  // Write every part handed out as an output view again, since it may
+  // have changed after it was last queued.  Also write whatever was
+  // never queued, in case something changed the file without going
+  // through the views.  This is normally just the padding between
+  // sections.
+  Range_set rest(this->handed_out_);
+  off_t pos = 0;
+  for (Range_set::const_iterator p = this->queued_.begin();
+       p != this->queued_.end();
+       ++p)
+    {
+      if (p->first > pos)
+	add_range(&rest, pos, p->first);
+      pos = std::max(pos, p->second);
+    }
+  if (pos < file_size)
+    add_range(&rest, pos, file_size);
+
+  for (Range_set::const_iterator p = rest.begin(); p != rest.end(); ++p)
+    this->write_range(Range(p->first, p->second - p->first));
+
+  if (this->errno_ != 0)
+    gold_error(_("%s: write: %s"), this->name_, strerror(this->errno_));
+
+  if (parameters->options().stats())
+    {
+      fprintf(stderr, _("%s: output file writes: %llu bytes in %llu calls\n"),
+	      program_name, this->bytes_, this->writes_);
+      fprintf(stderr, _("%s: output file write time: (wall: %ld.%06ld)\n"),
+	      program_name, this->write_time_ / 1000,
+	      (this->write_time_ % 1000) * 1000);
+    }
+}
+
 // Output_file methods.
 
 Output_file::Output_file(const char* name)
@@ -4972,7 +5321,8 @@ Output_file::Output_file(const char* name)
     base_(NULL),
     map_is_anonymous_(false),
     map_is_allocated_(false),
-    is_temporary_(false)
+    is_temporary_(false),
+    writer_(NULL)
 {
 }
 
@@ -5135,6 +5485,16 @@ Output_file::resize(off_t file_size)
   // to unmap to flush to the file, then remap after growing the file.
   if (this->map_is_anonymous_)
     {
+      // The writer reads from the map, which may move, so stop it
+      // until the map is in place.
+      if (this->writer_ != NULL)
+	{
+	  this->writer_->stop();
+	  int err = gold_fallocate(this->o_, 0, file_size);
+	  if (err != 0)
+	    gold_fatal(_("%s: %s"), this->name_, strerror(err));
+	}
+
       void* base;
       if (!this->map_is_allocated_)
 	{
@@ -5154,6 +5514,9 @@ Output_file::resize(off_t file_size)
 	}
       this->base_ = static_cast<unsigned char*>(base);
       this->file_size_ = file_size;
+
+      if (this->writer_ != NULL)
+	this->writer_->restart(this->base_);
     }
   else
     {
@@ -5182,6 +5545,7 @@ Output_file::map_anonymous()
     }
   this->base_ = static_cast<unsigned char*>(base);
   this->map_is_anonymous_ = true;
+  this->advise_map();
   return true;
 }
 
@@ -5232,14 +5596,103 @@ Output_file::map_no_anonymous(bool writable)
 
   this->map_is_anonymous_ = false;
   this->base_ = static_cast<unsigned char*>(base);
+  if (writable)
+    this->advise_map();
   return true;
 }
 
+// Allocate anonymous memory for the file, and start a writer which
+// writes the parts of it that are done while the link goes on.
+// Return false if the file is not a regular file, which the writer
+// can not write at random offsets.
+
+bool
+Output_file::map_async()
+{
+  const int o = this->o_;
+  struct stat statbuf;
+  if (o == STDOUT_FILENO || o == STDERR_FILENO
+      || ::fstat(o, &statbuf) != 0
+      || !S_ISREG(statbuf.st_mode)
+      || this->is_temporary_)
+    return false;
+
+  // Reserve the space now, as map_no_anonymous does; this also sets
+  // the size of the file, so that parts which are never written read
+  // as zeroes.
+  int err = gold_fallocate(o, 0, this->file_size_);
+  if (err != 0)
+    gold_fatal(_("%s: %s"), this->name_, strerror(err));
+
+  if (!this->map_anonymous())
+    return false;
+
+  this->writer_ = new Output_file_writer(this->name_, o, this->base_);
+  return true;
+}
+
+// Apply --output-map-advice to a new map.  Prefaulting the map up
+// front avoids taking page faults, which are serialized, in all the
+// threads writing the file.  Huge pages have the same effect for
+// anonymous maps.
+
+void
+Output_file::advise_map()
+{
+  if (this->map_is_allocated_ || this->file_size_ == 0)
+    return;
+
+  const char* advice = parameters->options().output_map_advice();
+  if (strcmp(advice, "prefault") == 0)
+    {
+#if defined(HAVE_MMAP) && defined(MADV_POPULATE_WRITE)
+      if (::madvise(this->base_, this->file_size_, MADV_POPULATE_WRITE) == 0)
+	return;
+#endif
+      // Touch each page by writing back what it holds.
+      long pagesize = ::sysconf(_SC_PAGESIZE);
+      if (pagesize <= 0)
+	pagesize = 4096;
+      volatile unsigned char* p = this->base_;
+      for (off_t i = 0; i < this->file_size_; i += pagesize)
+	p[i] = p[i];
+    }
+  else if (strcmp(advice, "hugepage") == 0)
+    {
+#if defined(HAVE_MMAP) && defined(MADV_HUGEPAGE)
+      // This is only advice; ignore any failure.
+      ::madvise(this->base_, this->file_size_, MADV_HUGEPAGE);
+#endif
+    }
+}
+
+// Record that part of the file was handed out as an output view.
+
+void
+Output_file::hand_out_view(off_t start, size_t size)
+{
+  this->writer_->hand_out(start, size);
+}
+
+// Queue part of the file to be written by the writer.
+
+void
+Output_file::queue_write(off_t start, size_t size)
+{
+  gold_assert(start >= 0
+	      && start + static_cast<off_t>(size) <= this->file_size_);
+  this->writer_->queue(start, size);
+}
+
 // Map the file into memory.
 
 void
 Output_file::map()
 {
+  if (parameters->options().async_output_write()
+      && this->map_async())
+    return;
+
   if (parameters->options().mmap_output_file()
       && this->map_no_anonymous(true))
     return;
@@ -5280,8 +5733,18 @@ Output_file::unmap()
 void
 Output_file::close()
 {
+  Timer timer;
+  timer.start();
+
+  if (this->writer_ != NULL)
+    {
+      // Wait for the background writes to finish.
+      this->writer_->finish(this->file_size_);
+      delete this->writer_;
+      this->writer_ = NULL;
+    }
   // If the map isn't file-backed, we need to write it now.
-  if (this->map_is_anonymous_ && !this->is_temporary_)
+  else if (this->map_is_anonymous_ && !this->is_temporary_)
     {
       size_t bytes_to_write = this->file_size_;
       size_t offset = 0;
@@ -5309,6 +5772,18 @@ Output_file::close()
     if (::close(this->o_) < 0)
       gold_error(_("%s: close: %s"), this->name_, strerror(errno));
   this->o_ = -1;
+
+  if (parameters->options().stats())
+    {
+      Timer::TimeStats elapsed = timer.get_elapsed_time();
+      fprintf(stderr,
+	      _("%s: output file writeback at close: "
+		"(user: %ld.%06ld sys: %ld.%06ld wall: %ld.%06ld)\n"),
+	      program_name,
+	      elapsed.user / 1000, (elapsed.user % 1000) * 1000,
+	      elapsed.sys / 1000, (elapsed.sys % 1000) * 1000,
+	      elapsed.wall / 1000, (elapsed.wall % 1000) * 1000);
+    }
 }
 
 // Instantiate the templates we need.  We could use the configure
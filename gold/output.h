@@ -40,6 +40,7 @@ class Object;
 class Symbol;
 class Output_merge_base;
 class Output_section;
+class Output_file_writer;
 class Relocatable_relocs;
 class Target;
 template<int size, bool big_endian>
@@ -95,12 +96,20 @@ class Output_file
   { return this->name_; }
 
   // We currently always use mmap which makes the view handling quite
-  // simple.  In the future we may support other approaches.
+  // simple.  With --async-output-write, the views are in an anonymous
+  // map, and each part written back through write_output_view is
+  // queued to be written to the file in the background.  The output
+  // views are all written again when the file is closed, so that a
+  // view changed after it was written back still reaches the file.
 
   // Write data to the output file.
   void
   write(off_t offset, const void* data, size_t len)
-  { memcpy(this->base_ + offset, data, len); }
+  {
+    memcpy(this->base_ + offset, data, len);
+    if (this->writer_ != NULL)
+      this->queue_write(offset, len);
+  }
 
   // Get a buffer to use to write to the file, given the offset into
   // the file and the size.
@@ -109,14 +118,19 @@ class Output_file
   {
     gold_assert(start >= 0
 		&& start + static_cast<off_t>(size) <= this->file_size_);
+    if (this->writer_ != NULL)
+      this->hand_out_view(start, size);
     return this->base_ + start;
   }
 
   // VIEW must have been returned by get_output_view.  Write the
   // buffer to the file, passing in the offset and the size.
   void
-  write_output_view(off_t, size_t, unsigned char*)
-  { }
+  write_output_view(off_t start, size_t size, unsigned char*)
+  {
+    if (this->writer_ != NULL)
+      this->queue_write(start, size);
+  }
 
   // Get a read/write buffer.  This is used when we want to write part
   // of the file, read it in, and write it again.
@@ -126,14 +140,21 @@ class Output_file
 
   // Write a read/write buffer back to the file.
   void
-  write_input_output_view(off_t, size_t, unsigned char*)
-  { }
+  write_input_output_view(off_t start, size_t size, unsigned char*)
+  {
+    if (this->writer_ != NULL)
+      this->queue_write(start, size);
+  }
 
   // Get a read buffer.  This is used when we just want to read part
   // of the file back it in.
   const unsigned char*
   get_input_view(off_t start, size_t size)
-  { return this->get_output_view(start, size); }
+  {
+    gold_assert(start >= 0
+		&& start + static_cast<off_t>(size) <= this->file_size_);
+    return this->base_ + start;
+  }
 
   // Release a read bfufer.
   void
@@ -154,6 +175,23 @@ class Output_file
   bool
   map_no_anonymous(bool);
 
+  // Allocate anonymous memory for the file and start writing it in
+  // the background.
+  bool
+  map_async();
+
+  // Apply --output-map-advice to the map.
+  void
+  advise_map();
+
+  // Record that part of the file was handed out as an output view.
+  void
+  hand_out_view(off_t start, size_t size);
+
+  // Queue part of the file to be written in the background.
+  void
+  queue_write(off_t start, size_t size);
+
   // Unmap the file from memory (and flush to disk buffers).
   void
   unmap();
@@ -172,6 +210,8 @@ class Output_file
   bool map_is_allocated_;
   // True if this is a temporary file which should not be output.
   bool is_temporary_;
+  // If not NULL, writes the file in the background.
+  Output_file_writer* writer_;
 };
 
 // An abtract class for data which has to go into the output file.
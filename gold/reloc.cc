@@ -1157,7 +1157,8 @@ Sized_relobj_file<size, big_endian>::incremental_relocs_write_reltype(
       elfcpp::Swap<32, big_endian>::writeval(pov + 4, out_shndx);
       elfcpp::Swap<size, big_endian>::writeval(pov + 8, offset);
       elfcpp::Swap<size, big_endian>::writeval(pov + 8 + sizeof_addr, addend);
-      of->write_output_view(pov - view, incr_reloc_size, view);
+      of->write_output_view(relocs_off + (pov - view), incr_reloc_size,
+			    view);
     }
 }
 
@@ -24,8 +24,11 @@
 
 #include <cstdio>
 #include <cstdlib>
+#include <cctype>
+#include <climits>
 #include <cstring>
 #include <fnmatch.h>
+#include <map>
 #include <string>
 #include <vector>
 #include "filenames.h"
@@ -487,6 +490,13 @@ Lex::can_continue_name(const char* c)
           // separator. But a single colon is not part of a name.
           return c + 2;
         }
+      else if ((this->mode_ == VERSION_SCRIPT || this->mode_ == DYNAMIC_LIST)
+               && (c[-1] == '[' || c[1] == ']'))
+        {
+          // Except in a character class such as [:digit:] in a glob
+          // bracket expression.
+          return c + 1;
+        }
       return NULL;
 
     default:
@@ -1947,18 +1957,19 @@ struct Version_tree
   const struct Version_dependency_list* dependencies;
 };
 
-// Helper class that calls cplus_demangle when needed and takes care of freeing
-// the result.
+// Helper class that calls cplus_demangle when needed.  The result is
+// kept in a cache shared by all lookups, which owns it.  Lookups run
+// in parallel tasks, so the cache is protected by LOCK, if not NULL.
 
 class Lazy_demangler
 {
  public:
-  Lazy_demangler(const char* symbol, int options)
-    : symbol_(symbol), options_(options), demangled_(NULL), did_demangle_(false)
-  { }
+  typedef Unordered_map<std::string, char*> Cache;
 
-  ~Lazy_demangler()
-  { free(this->demangled_); }
+  Lazy_demangler(const char* symbol, int options, Cache* cache, Lock* lock)
+    : symbol_(symbol), options_(options), cache_(cache), lock_(lock),
+      demangled_(NULL), did_demangle_(false)
+  { }
 
   // Return the demangled name. The actual demangling happens on the first call,
   // and the result is later cached.
@@ -1970,6 +1981,10 @@ class Lazy_demangler
   const char* symbol_;
   // Option flags to pass to cplus_demagle.
   const int options_;
+  // The demangled names of the symbols seen so far.
+  Cache* cache_;
+  // The lock protecting CACHE_.
+  Lock* lock_;
   // The cached demangled value, or NULL if demangling didn't happen yet or
   // failed.
   char* demangled_;
@@ -1977,33 +1992,610 @@ class Lazy_demangler
   bool did_demangle_;
 };
 
-// Return the demangled name. The actual demangling happens on the first call,
-// and the result is later cached. Returns NULL if the symbol cannot be
-// demangled.
+// Return the demangled name. The actual demangling happens on the first
+// call for SYMBOL_, and the result is later cached. Returns NULL if the
+// symbol cannot be demangled.
 
 inline char*
 Lazy_demangler::get()
 {
   if (!this->did_demangle_)
     {
-      this->demangled_ = cplus_demangle(this->symbol_, this->options_);
+      std::string key(this->symbol_);
+      {
+	Hold_optional_lock hl(this->lock_);
+	Cache::const_iterator p = this->cache_->find(key);
+	if (p != this->cache_->end())
+	  {
+	    this->demangled_ = p->second;
+	    this->did_demangle_ = true;
+	    return this->demangled_;
+	  }
+      }
+
+      // Demangle without holding the lock.  If another thread got
+      // there first, use its result.
+      char* demangled = cplus_demangle(this->symbol_, this->options_);
+      {
+	Hold_optional_lock hl(this->lock_);
+	std::pair<Cache::iterator, bool> ins =
+	  this->cache_->insert(std::make_pair(key, demangled));
+	if (!ins.second)
+	  free(demangled);
+	this->demangled_ = ins.first->second;
+      }
       this->did_demangle_ = true;
     }
   return this->demangled_;
 }
 
+// A set of glob patterns compiled into a single matcher, which finds
+// the last pattern matching a name in one pass over the name.  Each
+// pattern is compiled into a sequence of elements, and the matcher
+// simulates all the patterns at once as a nondeterministic automaton
+// whose states are positions in the patterns.  The deterministic
+// automaton is built lazily from the sets of positions that the names
+// actually reach, over classes of the bytes which no pattern tells
+// apart.  Lookups run in parallel tasks, so new states are built
+// while holding a lock, and the transitions to them are published
+// atomically for the threads which follow them without the lock.
+// This follows fnmatch with FNM_NOESCAPE for single byte characters;
+// patterns using anything else are left to fnmatch.
+
+class Version_glob_matcher
+{
+ public:
+  Version_glob_matcher()
+    : patterns_(), sets_(), position_patterns_(), class_count_(0),
+      states_(NULL), state_count_(0), state_map_(), is_full_(false),
+      lock_(NULL),
+      initialize_lock_(&this->lock_)
+  { }
+
+  ~Version_glob_matcher();
+
+  // Add PATTERN, which wins over all patterns with a smaller INDEX.
+  // Return false if PATTERN can not be compiled.
+  bool
+  add(const std::string& pattern, int index);
+
+  // Prepare for matching, once all the patterns have been added.
+  void
+  finalize();
+
+  // Return the largest index of a pattern matching NAME, or -1 if
+  // there is none.  This may only be used if name_is_simple(NAME),
+  // after finalize.  Several threads may call this at once.
+  int
+  match(const char* name);
+
+  // Return whether NAME can be matched by a matcher.  In a multibyte
+  // locale, fnmatch matches characters rather than bytes.
+  static bool
+  name_is_simple(const char* name);
+
+ private:
+  // The maximum number of states we build.  Once there are this many,
+  // a name which reaches a state not yet built is matched by
+  // simulating the nondeterministic automaton for the rest of it.
+  static const size_t max_states = 16384;
+
+  // One element of a compiled pattern: a '*', or a set of bytes.
+  struct Element
+  {
+    Element(bool s, unsigned int cs)
+      : is_star(s), charset(cs)
+    { }
+
+    bool is_star;
+    // The index in sets_ of the bytes this element matches.
+    unsigned int charset;
+  };
+
+  struct Pattern
+  {
+    std::vector<Element> elements;
+    // The first position of this pattern.  Position FIRST + I means
+    // that the first I elements have been matched.  The positions of
+    // all the patterns are numbered together.
+    unsigned int first;
+    int index;
+  };
+
+  // A set of bytes.
+  struct Charset
+  {
+    unsigned char bits[(UCHAR_MAX + 1) / CHAR_BIT];
+
+    bool
+    test(unsigned char c) const
+    { return (this->bits[c / CHAR_BIT] & (1U << (c % CHAR_BIT))) != 0; }
+
+    void
+    set(unsigned char c)
+    { this->bits[c / CHAR_BIT] |= 1U << (c % CHAR_BIT); }
+  };
+
+  typedef std::vector<unsigned int> Positions;
+
+  // A state of the deterministic automaton.  Only NEXT changes once
+  // the state is built.
+  struct State
+  {
+    // The positions in the patterns, sorted.
+    Positions positions;
+    // The largest index of a pattern fully matched, or -1.
+    int accept;
+    // The next state for each byte class, or -1 if not yet built.
+    int* next;
+  };
+
+  typedef std::map<Positions, int> State_map;
+
+  // Read an entry of State::next, which may be set by another thread.
+  static int
+  load_next(const int* p)
+  {
+#if !defined(ENABLE_THREADS)
+    return *p;
+#elif defined(__ATOMIC_ACQUIRE)
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+#else
+    int ret = *const_cast<const volatile int*>(p);
+    __sync_synchronize();
+    return ret;
+#endif
+  }
+
+  // Set an entry of State::next, once the state it refers to is built.
+  static void
+  store_next(int* p, int v)
+  {
+#if !defined(ENABLE_THREADS)
+    *p = v;
+#elif defined(__ATOMIC_RELEASE)
+    __atomic_store_n(p, v, __ATOMIC_RELEASE);
+#else
+    __sync_synchronize();
+    *const_cast<volatile int*>(p) = v;
+#endif
+  }
+
+  unsigned int
+  add_charset(const Charset&);
+
+  bool
+  parse_bracket(const char**, Charset*);
+
+  void
+  add_closure(const Pattern*, unsigned int, Positions*) const;
+
+  void
+  step(const Positions&, unsigned char, Positions*) const;
+
+  int
+  accept(const Positions&) const;
+
+  int
+  find_state(Positions*);
+
+  int
+  transition(int, unsigned char);
+
+  int
+  match_positions(const Positions&, const unsigned char*) const;
+
+  // The compiled patterns.
+  std::vector<Pattern> patterns_;
+  // The sets of bytes used by the elements.
+  std::vector<Charset> sets_;
+  // Map from positions to the index in patterns_ of their pattern.
+  std::vector<unsigned int> position_patterns_;
+  // Map from bytes to their class.  The bytes of a class are in the
+  // same sets_, so they have the same transitions.
+  unsigned short byte_classes_[UCHAR_MAX + 1];
+  // The number of byte classes.
+  unsigned int class_count_;
+  // The states built so far; the first one is the start state.  This
+  // is an array of max_states entries allocated by finalize, which
+  // never moves, so that threads can follow the transitions to a
+  // state without the lock.  Only the first STATE_COUNT_ are set.
+  State** states_;
+  // The number of states built, which only changes with the lock held.
+  size_t state_count_;
+  // Map from sets of positions to states_.
+  State_map state_map_;
+  // Whether there are max_states states.
+  bool is_full_;
+  // The lock held while building states.
+  Lock* lock_;
+  // The helper to initialize lock_ once the options are known.
+  Initialize_lock initialize_lock_;
+};
+
+Version_glob_matcher::~Version_glob_matcher()
+{
+  for (size_t i = 0; i < this->state_count_; ++i)
+    {
+      delete[] this->states_[i]->next;
+      delete this->states_[i];
+    }
+  delete[] this->states_;
+  delete this->lock_;
+}
+
+// Add a set of bytes and return its index.
+
+unsigned int
+Version_glob_matcher::add_charset(const Charset& cs)
+{
+  for (size_t i = 0; i < this->sets_.size(); ++i)
+    if (memcmp(this->sets_[i].bits, cs.bits, sizeof cs.bits) == 0)
+      return i;
+  this->sets_.push_back(cs);
+  return this->sets_.size() - 1;
+}
+
+// Parse the bracket expression at *PP, which points after the '['.
+// On success, set *CS to the bytes it matches, advance *PP after the
+// closing ']', and return true.  Return false for the forms we leave
+// to fnmatch, including an unterminated bracket.
+
+bool
+Version_glob_matcher::parse_bracket(const char** pp, Charset* cs)
+{
+  static const struct
+  {
+    const char* name;
+    int (*fn)(int);
+  } classes[] =
+  {
+    { "alnum", isalnum }, { "alpha", isalpha }, { "blank", isblank },
+    { "cntrl", iscntrl }, { "digit", isdigit }, { "graph", isgraph },
+    { "lower", islower }, { "print", isprint }, { "punct", ispunct },
+    { "space", isspace }, { "upper", isupper }, { "xdigit", isxdigit }
+  };
+
+  const char* p = *pp;
+  memset(cs->bits, 0, sizeof cs->bits);
+
+  bool negate = *p == '!' || *p == '^';
+  if (negate)
+    ++p;
+
+  bool first = true;
+  while (first || *p != ']')
+    {
+      first = false;
+      unsigned char c = *p;
+      if (c == '\0')
+	return false;
+
+      if (c == '[' && (p[1] == '=' || p[1] == '.'))
+	return false;
+
+      if (c == '[' && p[1] == ':')
+	{
+	  const char* end = strstr(p + 2, ":]");
+	  if (end == NULL)
+	    return false;
+	  std::string name(p + 2, end - (p + 2));
+	  size_t i;
+	  for (i = 0; i < sizeof classes / sizeof classes[0]; ++i)
+	    if (name == classes[i].name)
+	      break;
+	  if (i >= sizeof classes / sizeof classes[0])
+	    return false;
+	  for (unsigned int b = 1; b <= UCHAR_MAX; ++b)
+	    if (classes[i].fn(b))
+	      cs->set(b);
+	  p = end + 2;
+	  // A class can not start a range.
+	  if (*p == '-' && p[1] != ']')
+	    return false;
+	  continue;
+	}
+
+      ++p;
+      unsigned char last = c;
+      if (*p == '-' && p[1] != ']' && p[1] != '\0')
+	{
+	  if (p[1] == '[')
+	    return false;
+	  last = p[1];
+	  if (last < c)
+	    return false;
+	  p += 2;
+	}
+      for (unsigned int b = c; b <= last; ++b)
+	cs->set(b);
+    }
+
+  if (negate)
+    {
+      for (size_t i = 0; i < sizeof cs->bits; ++i)
+	cs->bits[i] = ~cs->bits[i];
+    }
+  // A name never contains a null byte.
+  cs->bits[0] &= ~1U;
+
+  *pp = p + 1;
+  return true;
+}
+
+// Compile PATTERN.
+
+bool
+Version_glob_matcher::add(const std::string& pattern, int index)
+{
+  Pattern pat;
+  const char* p = pattern.c_str();
+  while (*p != '\0')
+    {
+      unsigned char c = *p;
+      Charset cs;
+      memset(cs.bits, 0, sizeof cs.bits);
+      if (c > 0x7f)
+	return false;
+      else if (c == '*')
+	{
+	  if (pat.elements.empty() || !pat.elements.back().is_star)
+	    pat.elements.push_back(Element(true, 0));
+	  ++p;
+	  continue;
+	}
+      else if (c == '?')
+	{
+	  memset(cs.bits, 0xff, sizeof cs.bits);
+	  cs.bits[0] &= ~1U;
+	  ++p;
+	}
+      else if (c == '[')
+	{
+	  ++p;
+	  if (!this->parse_bracket(&p, &cs))
+	    return false;
+	}
+      else
+	{
+	  cs.set(c);
+	  ++p;
+	}
+      pat.elements.push_back(Element(false, this->add_charset(cs)));
+    }
+
+  pat.first = this->position_patterns_.size();
+  pat.index = index;
+  this->position_patterns_.resize(pat.first + pat.elements.size() + 1,
+				  this->patterns_.size());
+  this->patterns_.push_back(pat);
+  return true;
+}
+
+// Add position I of PAT to *POSITIONS, along with the positions
+// reached from it by letting '*' match nothing.
+
+void
+Version_glob_matcher::add_closure(const Pattern* pat, unsigned int i,
+				  Positions* positions) const
+{
+  positions->push_back(pat->first + i);
+  while (i < pat->elements.size() && pat->elements[i].is_star)
+    {
+      ++i;
+      positions->push_back(pat->first + i);
+    }
+}
+
+// Set *TO to the positions reached from the positions FROM by byte C.
+
+void
+Version_glob_matcher::step(const Positions& from, unsigned char c,
+			   Positions* to) const
+{
+  for (Positions::const_iterator p = from.begin(); p != from.end(); ++p)
+    {
+      const Pattern* pat = &this->patterns_[this->position_patterns_[*p]];
+      unsigned int i = *p - pat->first;
+      if (i >= pat->elements.size())
+	continue;
+      const Element& e(pat->elements[i]);
+      if (e.is_star)
+	this->add_closure(pat, i, to);
+      else if (this->sets_[e.charset].test(c))
+	this->add_closure(pat, i + 1, to);
+    }
+  std::sort(to->begin(), to->end());
+  to->erase(std::unique(to->begin(), to->end()), to->end());
+}
+
+// Return the largest index of a pattern fully matched at POSITIONS,
+// or -1.
+
+int
+Version_glob_matcher::accept(const Positions& positions) const
+{
+  int ret = -1;
+  for (Positions::const_iterator p = positions.begin();
+       p != positions.end();
+       ++p)
+    {
+      const Pattern* pat = &this->patterns_[this->position_patterns_[*p]];
+      if (*p == pat->first + pat->elements.size() && pat->index > ret)
+	ret = pat->index;
+    }
+  return ret;
+}
+
+// Return the index of the state for the sorted *POSITIONS, building
+// it if needed.  Return -1 if there are already max_states states.
+// This must be called with the lock held.
+
+int
+Version_glob_matcher::find_state(Positions* positions)
+{
+  State_map::const_iterator p = this->state_map_.find(*positions);
+  if (p != this->state_map_.end())
+    return p->second;
+
+  if (this->state_count_ >= max_states)
+    return -1;
+
+  State* state = new State;
+  state->positions.swap(*positions);
+  state->accept = this->accept(state->positions);
+  state->next = new int[this->class_count_];
+  for (unsigned int c = 0; c < this->class_count_; ++c)
+    state->next[c] = -1;
+
+  // Other threads only see the new state once transition publishes
+  // a transition to it.
+  int ret = this->state_count_;
+  this->states_[ret] = state;
+  ++this->state_count_;
+  this->state_map_[state->positions] = ret;
+  return ret;
+}
+
+// Compute the byte classes and build the start state.
+
+void
+Version_glob_matcher::finalize()
+{
+  // Give the same class to the bytes which are in the same sets.
+  typedef std::map<std::vector<bool>, unsigned int> Class_map;
+  Class_map classes;
+  for (unsigned int c = 0; c <= UCHAR_MAX; ++c)
+    {
+      std::vector<bool> in_sets(this->sets_.size());
+      for (size_t i = 0; i < this->sets_.size(); ++i)
+	in_sets[i] = this->sets_[i].test(c);
+      unsigned int count = classes.size();
+      std::pair<Class_map::iterator, bool> ins =
+	classes.insert(std::make_pair(in_sets, count));
+      this->byte_classes_[c] = ins.first->second;
+    }
+  this->class_count_ = classes.size();
+
+  this->states_ = new State*[max_states];
+  Positions start;
+  for (std::vector<Pattern>::const_iterator p = this->patterns_.begin();
+       p != this->patterns_.end();
+       ++p)
+    this->add_closure(&*p, 0, &start);
+  std::sort(start.begin(), start.end());
+  start.erase(std::unique(start.begin(), start.end()), start.end());
+  this->find_state(&start);
+
+  this->initialize_lock_.initialize();
+}
+
+// Return the state reached from state FROM by byte C, building it if
+// needed, or -1 if there are too many states to build it.
+
+int
+Version_glob_matcher::transition(int from, unsigned char c)
+{
+  Hold_optional_lock hl(this->lock_);
+
+  // Another thread may have built the state since our caller looked.
+  State* state = this->states_[from];
+  int* pnext = &state->next[this->byte_classes_[c]];
+  if (*pnext >= 0)
+    return *pnext;
+
+  Positions positions;
+  this->step(state->positions, c, &positions);
+  int to = this->find_state(&positions);
+  if (to < 0)
+    {
+      if (!this->is_full_ && parameters->options().stats())
+	fprintf(stderr,
+		_("%s: version script glob matcher reached %lu states\n"),
+		program_name, static_cast<unsigned long>(max_states));
+      this->is_full_ = true;
+      return -1;
+    }
+
+  store_next(pnext, to);
+  return to;
+}
+
+// Return the largest index of a pattern matching the name P, starting
+// at POSITIONS, by simulating the nondeterministic automaton.
+
+int
+Version_glob_matcher::match_positions(const Positions& positions,
+				      const unsigned char* p) const
+{
+  Positions from(positions);
+  for (; *p != '\0'; ++p)
+    {
+      Positions to;
+      this->step(from, *p, &to);
+      if (to.empty())
+	return -1;
+      from.swap(to);
+    }
+  return this->accept(from);
+}
+
+// Return the largest index of a pattern matching NAME.
+
+int
+Version_glob_matcher::match(const char* name)
+{
+  int state = 0;
+  for (const unsigned char* p = reinterpret_cast<const unsigned char*>(name);
+       *p != '\0';
+       ++p)
+    {
+      const State* from = this->states_[state];
+      int to = load_next(&from->next[this->byte_classes_[*p]]);
+      if (to < 0)
+	{
+	  to = this->transition(state, *p);
+	  if (to < 0)
+	    return this->match_positions(from->positions, p);
+	}
+      state = to;
+      // Nothing can match once no pattern is left.
+      if (this->states_[state]->positions.empty())
+	return -1;
+    }
+  return this->states_[state]->accept;
+}
+
+// Return whether the bytes of NAME are its characters.
+
+bool
+Version_glob_matcher::name_is_simple(const char* name)
+{
+  if (MB_CUR_MAX == 1)
+    return true;
+  for (const char* p = name; *p != '\0'; ++p)
+    if (static_cast<unsigned char>(*p) > 0x7f)
+      return false;
+  return true;
+}
+
 // Class Version_script_info.
 
 Version_script_info::Version_script_info()
   : dependency_lists_(), expression_lists_(), version_trees_(), globs_(),
+    demangle_lock_(NULL), demangle_initialize_lock_(&this->demangle_lock_),
     default_version_(NULL), default_is_global_(false), is_finalized_(false)
 {
   for (int i = 0; i < LANGUAGE_COUNT; ++i)
-    this->exact_[i] = NULL;
+    {
+      this->exact_[i] = NULL;
+      this->glob_matchers_[i] = NULL;
+    }
 }
 
 Version_script_info::~Version_script_info()
 {
+  delete this->demangle_lock_;
 }
 
 // Forget all the known version script information.
@@ -2020,6 +2612,17 @@ Version_script_info::clear()
   for (size_t k = 0; k < this->expression_lists_.size(); ++k)
     delete this->expression_lists_[k];
   this->expression_lists_.clear();
+  for (int i = 0; i < LANGUAGE_COUNT; ++i)
+    {
+      delete this->glob_matchers_[i];
+      this->glob_matchers_[i] = NULL;
+      for (Demangled_names::iterator p = this->demangled_names_[i].begin();
+	   p != this->demangled_names_[i].end();
+	   ++p)
+	free(p->second);
+      this->demangled_names_[i].clear();
+    }
+  this->fnmatch_globs_.clear();
 }
 
 // Finalize the version script information.
@@ -2155,6 +2758,7 @@ Version_script_info::build_lookup_tables()
       this->build_expression_list_lookup(v->local, v, false);
       this->build_expression_list_lookup(v->global, v, true);
     }
+  this->build_glob_matchers();
 }
 
 // If a pattern has backlashes but no unquoted wildcard characters,
@@ -2283,6 +2887,27 @@ Version_script_info::build_expression_list_lookup(
     }
 }
 
+// Compile the glob patterns into a matcher for each language, so
+// that a symbol name is matched against all of them in one pass.
+
+void
+Version_script_info::build_glob_matchers()
+{
+  for (size_t i = 0; i < this->globs_.size(); ++i)
+    {
+      const Version_expression* e = this->globs_[i].expression;
+      Version_glob_matcher*& matcher(this->glob_matchers_[e->language]);
+      if (matcher == NULL)
+	matcher = new Version_glob_matcher();
+      if (!matcher->add(e->pattern, i))
+	this->fnmatch_globs_.push_back(i);
+    }
+
+  for (int i = 0; i < LANGUAGE_COUNT; ++i)
+    if (this->glob_matchers_[i] != NULL)
+      this->glob_matchers_[i]->finalize();
+}
+
 // Return the name to match given a name, a language code, and two
 // lazy demanglers.
 
@@ -2305,6 +2930,78 @@ Version_script_info::get_name_to_match(const char* name,
     }
 }
 
+// Find the last glob pattern in globs_ which matches SYMBOL_NAME.
+// Return true and set *PGLOB if there is one.
+
+bool
+Version_script_info::match_globs(const char* symbol_name,
+				 Lazy_demangler* cpp_demangler,
+				 Lazy_demangler* java_demangler,
+				 const Glob** pglob) const
+{
+  const char* names[LANGUAGE_COUNT];
+  bool use_matchers = true;
+  for (int i = 0; i < LANGUAGE_COUNT; ++i)
+    {
+      names[i] = NULL;
+      if (this->glob_matchers_[i] == NULL)
+	continue;
+      names[i] = this->get_name_to_match(symbol_name, i, cpp_demangler,
+					 java_demangler);
+      if (names[i] != NULL && !Version_glob_matcher::name_is_simple(names[i]))
+	use_matchers = false;
+    }
+
+  if (!use_matchers)
+    {
+      // Look through all the glob patterns in reverse order.
+      for (size_t i = this->globs_.size(); i > 0; --i)
+	{
+	  const Glob* p = &this->globs_[i - 1];
+	  const char* name_to_match = names[p->expression->language];
+	  if (name_to_match != NULL
+	      && fnmatch(p->expression->pattern.c_str(), name_to_match,
+			 FNM_NOESCAPE) == 0)
+	    {
+	      *pglob = p;
+	      return true;
+	    }
+	}
+      return false;
+    }
+
+  int best = -1;
+  for (int i = 0; i < LANGUAGE_COUNT; ++i)
+    {
+      if (names[i] == NULL)
+	continue;
+      int index = this->glob_matchers_[i]->match(names[i]);
+      if (index > best)
+	best = index;
+    }
+
+  // Only the patterns after BEST can override it.
+  for (size_t i = this->fnmatch_globs_.size(); i > 0; --i)
+    {
+      size_t index = this->fnmatch_globs_[i - 1];
+      if (static_cast<int>(index) <= best)
+	break;
+      const Version_expression* e = this->globs_[index].expression;
+      const char* name_to_match = names[e->language];
+      if (name_to_match != NULL
+	  && fnmatch(e->pattern.c_str(), name_to_match, FNM_NOESCAPE) == 0)
+	{
+	  best = index;
+	  break;
+	}
+    }
+
+  if (best < 0)
+    return false;
+  *pglob = &this->globs_[best];
+  return true;
+}
+
 // Look up SYMBOL_NAME in the list of versions.  Return true if the
 // symbol is found, false if not.  If the symbol is found, then if
 // PVERSION is not NULL, set *PVERSION to the version tag, and if
@@ -2316,9 +3013,15 @@ Version_script_info::get_symbol_version(const char* symbol_name,
 					std::string* pversion,
 					bool* p_is_global) const
 {
-  Lazy_demangler cpp_demangled_name(symbol_name, DMGL_ANSI | DMGL_PARAMS);
+  // This is called from the parallel relocation tasks.
+  this->demangle_initialize_lock_.initialize();
+  Lazy_demangler cpp_demangled_name(symbol_name, DMGL_ANSI | DMGL_PARAMS,
+				    &this->demangled_names_[LANGUAGE_CXX],
+				    this->demangle_lock_);
   Lazy_demangler java_demangled_name(symbol_name,
-				     DMGL_ANSI | DMGL_PARAMS | DMGL_JAVA);
+				     DMGL_ANSI | DMGL_PARAMS | DMGL_JAVA,
+				     &this->demangled_names_[LANGUAGE_JAVA],
+				     this->demangle_lock_);
 
   gold_assert(this->is_finalized_);
   for (int i = 0; i < LANGUAGE_COUNT; ++i)
@@ -2366,29 +3069,17 @@ Version_script_info::get_symbol_version(const char* symbol_name,
 	}
     }
 
-  // Look through the glob patterns in reverse order.
+  // Look through the glob patterns.
 
-  for (Globs::const_reverse_iterator p = this->globs_.rbegin();
-       p != this->globs_.rend();
-       ++p)
+  const Glob* p;
+  if (this->match_globs(symbol_name, &cpp_demangled_name,
+			&java_demangled_name, &p))
     {
-      int language = p->expression->language;
-      const char* name_to_match = this->get_name_to_match(symbol_name,
-							  language,
-							  &cpp_demangled_name,
-							  &java_demangled_name);
-      if (name_to_match == NULL)
-	continue;
-
-      if (fnmatch(p->expression->pattern.c_str(), name_to_match,
-		  FNM_NOESCAPE) == 0)
-	{
-	  if (pversion != NULL)
-	    *pversion = p->version->tag;
-	  if (p_is_global != NULL)
-	    *p_is_global = p->is_global;
-	  return true;
-	}
+      if (pversion != NULL)
+	*pversion = p->version->tag;
+      if (p_is_global != NULL)
+	*p_is_global = p->is_global;
+      return true;
     }
 
   // Finally, there may be a wildcard.
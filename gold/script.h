@@ -35,6 +35,7 @@
 #include <vector>
 
 #include "elfcpp.h"
+#include "gold-threads.h"
 #include "script-sections.h"
 
 namespace gold
@@ -58,6 +59,7 @@ struct Version_expression_list;
 struct Version_tree;
 struct Version_expression;
 class Lazy_demangler;
+class Version_glob_matcher;
 class Incremental_script_entry;
 
 // This class represents an expression in a linker script.
@@ -287,6 +289,11 @@ class Version_script_info
 
   typedef std::vector<Glob> Globs;
 
+  // Map from a symbol name to its demangled name, or NULL if it can
+  // not be demangled.  The demangled names are allocated by
+  // cplus_demangle.
+  typedef Unordered_map<std::string, char*> Demangled_names;
+
   bool
   unquote(std::string*) const;
 
@@ -298,10 +305,17 @@ class Version_script_info
   build_expression_list_lookup(const Version_expression_list*,
 			       const Version_tree*, bool);
 
+  void
+  build_glob_matchers();
+
   const char*
   get_name_to_match(const char*, int,
 		    Lazy_demangler*, Lazy_demangler*) const;
 
+  bool
+  match_globs(const char*, Lazy_demangler*, Lazy_demangler*,
+	      const Glob**) const;
+
   // All the version dependencies we allocate.
   std::vector<Version_dependency_list*> dependency_lists_;
   // All the version expressions we allocate.
@@ -312,6 +326,19 @@ class Version_script_info
   Exact* exact_[LANGUAGE_COUNT];
   // A vector of glob patterns mapping to Version_trees.
   Globs globs_;
+  // The glob patterns compiled into a single matcher, by language.
+  Version_glob_matcher* glob_matchers_[LANGUAGE_COUNT];
+  // The indexes in globs_ of the patterns which the matchers can not
+  // handle, in increasing order.  These are matched with fnmatch.
+  std::vector<size_t> fnmatch_globs_;
+  // Demangled symbol names, by language, since the same name is
+  // often looked up many times.  Protected by demangle_lock_, since
+  // lookups are done by the parallel relocation tasks.
+  mutable Demangled_names demangled_names_[LANGUAGE_COUNT];
+  // The lock for demangled_names_.
+  mutable Lock* demangle_lock_;
+  // The helper to initialize demangle_lock_ once the options are known.
+  mutable Initialize_lock demangle_initialize_lock_;
   // The default version to use, if there is one.  This is from a
   // pattern of "*".
   const Version_tree* default_version_;
@@ -25,6 +25,7 @@
 #include <cstring>
 #include <stdint.h>
 #include <algorithm>
+#include <map>
 #include <set>
 #include <string>
 #include <utility>
@@ -3447,32 +3448,6 @@ struct Odr_violation_compare
   }
 };
 
-// Returns all of the lines attached to LOC, not just the one the
-// instruction actually came from.
-std::vector<std::string>
-Symbol_table::linenos_from_loc(const Task* task,
-                               const Symbol_location& loc)
-{
-  // We need to lock the object in order to read it.  This
-  // means that we have to run in a singleton Task.  If we
-  // want to run this in a general Task for better
-  // performance, we will need one Task for object, plus
-  // appropriate locking to ensure that we don't conflict with
-  // other uses of the object.  Also note, one_addr2line is not
-  // currently thread-safe.
-  Task_lock_obj<Object> tl(task, loc.object);
-
-  std::vector<std::string> result;
-  Symbol_location code_loc = loc;
-  parameters->target().function_location(&code_loc);
-  // 16 is the size of the object-cache that one_addr2line should use.
-  std::string canonical_result = Dwarf_line_info::one_addr2line(
-      code_loc.object, code_loc.shndx, code_loc.offset, 16, &result);
-  if (!canonical_result.empty())
-    result.push_back(canonical_result);
-  return result;
-}
-
 // OutputIterator that records if it was ever assigned to.  This
 // allows it to be used with std::set_intersection() to check for
 // intersection rather than computing the intersection.
@@ -3502,37 +3477,213 @@ struct Check_intersection
   bool value_;
 };
 
-// Check candidate_odr_violations_ to find symbols with the same name
-// but apparently different definitions (different source-file/line-no
-// for each line assigned to the first instruction).
+// The state of an ODR violation check, shared by its tasks.  The
+// line numbers of every definition of the candidate symbols are
+// looked up by one Odr_lineno_task per defining object, which reads
+// the line table of the object only once for all its definitions.
+// Odr_report_runner then compares them in a fixed order, so that the
+// warnings do not depend on the order of the tasks or on addresses.
+
+class Odr_check
+{
+ public:
+  // A definition of a candidate symbol.
+  struct Definition
+  {
+    Symbol_location loc;
+    // Where the code of the definition is, as returned by
+    // Target::function_location; this may be in another object than
+    // LOC, and is the object whose line table is read.
+    Symbol_location code_loc;
+    // All of the lines attached to LOC, not just the one the
+    // instruction actually came from; the canonical one is last.
+    // This helps the ODR checker avoid false positives.  Empty if we
+    // couldn't parse the debug info.
+    std::vector<std::string> linenos;
+  };
+
+  // A candidate symbol and its definitions.
+  struct Candidate
+  {
+    const char* name;
+    std::vector<Definition> definitions;
+  };
+
+  // The definitions in an object.
+  typedef std::vector<Definition*> Definition_list;
+
+  // Map from the objects holding the code of definitions to those
+  // definitions.
+  typedef std::map<Object*, Definition_list> Object_map;
+
+  Odr_check(const char* output_file_name)
+    : output_file_name_(output_file_name), candidates_(), objects_()
+  { }
+
+  std::vector<Candidate>&
+  candidates()
+  { return this->candidates_; }
+
+  Object_map&
+  objects()
+  { return this->objects_; }
+
+  // Report the candidates whose definitions share no line.
+  void
+  report() const;
+
+ private:
+  const char* output_file_name_;
+  std::vector<Candidate> candidates_;
+  Object_map objects_;
+};
+
+// Sort candidates by name.
+
+struct Odr_candidate_compare
+{
+  bool
+  operator()(const Odr_check::Candidate& c1,
+	     const Odr_check::Candidate& c2) const
+  { return strcmp(c1.name, c2.name) < 0; }
+};
+
+// Sort definitions by object name, then location.
+
+struct Odr_definition_compare
+{
+  bool
+  operator()(const Odr_check::Definition& d1,
+	     const Odr_check::Definition& d2) const
+  {
+    if (d1.loc.object != d2.loc.object)
+      {
+	int cmp = d1.loc.object->name().compare(d2.loc.object->name());
+	if (cmp != 0)
+	  return cmp < 0;
+      }
+    if (d1.loc.shndx != d2.loc.shndx)
+      return d1.loc.shndx < d2.loc.shndx;
+    return d1.loc.offset < d2.loc.offset;
+  }
+};
+
+// A task which looks up the line numbers of the definitions of
+// candidate symbols whose code is in one object.
+
+class Odr_lineno_task : public Task
+{
+ public:
+  Odr_lineno_task(Object* object, Odr_check::Definition_list* definitions,
+		  Task_token* blocker)
+    : object_(object), definitions_(definitions), blocker_(blocker)
+  { }
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable()
+  {
+    if (this->object_->is_locked())
+      return this->object_->token();
+    return NULL;
+  }
+
+  // Lock the object, and unblock BLOCKER_ when done.
+  void
+  locks(Task_locker* tl)
+  {
+    Task_token* token = this->object_->token();
+    if (token != NULL)
+      tl->add(this, token);
+    tl->add(this, this->blocker_);
+  }
+
+  void
+  run(Workqueue*);
+
+  std::string
+  get_name() const
+  { return "Odr_lineno_task " + this->object_->name(); }
+
+ private:
+  Object* object_;
+  Odr_check::Definition_list* definitions_;
+  Task_token* blocker_;
+};
 
 void
-Symbol_table::detect_odr_violations(const Task* task,
-				    const char* output_file_name) const
+Odr_lineno_task::run(Workqueue*)
+{
+  Dwarf_line_info* lineinfo = Dwarf_line_info::create(this->object_);
+
+  for (Odr_check::Definition_list::iterator p = this->definitions_->begin();
+       p != this->definitions_->end();
+       ++p)
+    {
+      const Symbol_location& code_loc = (*p)->code_loc;
+      gold_assert(code_loc.object == this->object_);
+
+      std::vector<std::string>* result = &(*p)->linenos;
+      std::string canonical_result =
+	lineinfo->addr2line(code_loc.shndx, code_loc.offset, result);
+      if (!canonical_result.empty())
+	result->push_back(canonical_result);
+    }
+
+  delete lineinfo;
+  this->object_->release();
+}
+
+// A Task_function_runner which reports the violations once all the
+// line numbers have been looked up.
+
+class Odr_report_runner : public Task_function_runner
 {
-  for (Odr_map::const_iterator it = candidate_odr_violations_.begin();
-       it != candidate_odr_violations_.end();
+ public:
+  Odr_report_runner(Odr_check* check)
+    : check_(check)
+  { }
+
+  ~Odr_report_runner()
+  { delete this->check_; }
+
+  void
+  run(Workqueue*, const Task*)
+  { this->check_->report(); }
+
+ private:
+  Odr_check* check_;
+};
+
+// Find candidates with the same name but apparently different
+// definitions (different source-file/line-no for each line assigned
+// to the first instruction).
+
+void
+Odr_check::report() const
+{
+  for (std::vector<Candidate>::const_iterator it = this->candidates_.begin();
+       it != this->candidates_.end();
        ++it)
     {
-      const char* const symbol_name = it->first;
+      const char* const symbol_name = it->name;
 
       std::string first_object_name;
       std::vector<std::string> first_object_linenos;
 
-      Unordered_set<Symbol_location, Symbol_location_hash>::const_iterator
-          locs = it->second.begin();
-      const Unordered_set<Symbol_location, Symbol_location_hash>::const_iterator
-          locs_end = it->second.end();
+      std::vector<Definition>::const_iterator locs = it->definitions.begin();
+      const std::vector<Definition>::const_iterator locs_end =
+	  it->definitions.end();
       for (; locs != locs_end && first_object_linenos.empty(); ++locs)
         {
           // Save the line numbers from the first definition to
           // compare to the other definitions.  Ideally, we'd compare
           // every definition to every other, but we don't want to
           // take O(N^2) time to do this.  This shortcut may cause
-          // false negatives that appear or disappear depending on the
-          // link order, but it won't cause false positives.
-          first_object_name = locs->object->name();
-          first_object_linenos = this->linenos_from_loc(task, *locs);
+          // false negatives, but it won't cause false positives.
+          first_object_name = locs->loc.object->name();
+          first_object_linenos = locs->linenos;
         }
       if (first_object_linenos.empty())
 	continue;
@@ -3544,13 +3695,11 @@ Symbol_table::detect_odr_violations(const Task* task,
 
       for (; locs != locs_end; ++locs)
         {
-          std::vector<std::string> linenos =
-              this->linenos_from_loc(task, *locs);
+          std::vector<std::string> linenos = locs->linenos;
           // linenos will be empty if we couldn't parse the debug info.
           if (linenos.empty())
             continue;
           // Sort by Odr_violation_compare to make std::set_intersection work.
-          gold_assert(!linenos.empty());
           std::string second_object_canonical_result = linenos.back();
           std::sort(linenos.begin(), linenos.end(), Odr_violation_compare());
 
@@ -3565,7 +3714,8 @@ Symbol_table::detect_odr_violations(const Task* task,
             {
               gold_warning(_("while linking %s: symbol '%s' defined in "
                              "multiple places (possible ODR violation):"),
-                           output_file_name, demangle(symbol_name).c_str());
+                           this->output_file_name_,
+			   demangle(symbol_name).c_str());
               // This only prints one location from each definition,
               // which may not be the location we expect to intersect
               // with another definition.  We could print the whole
@@ -3575,7 +3725,7 @@ Symbol_table::detect_odr_violations(const Task* task,
                       first_object_name.c_str());
               fprintf(stderr, _("  %s from %s\n"),
                       second_object_canonical_result.c_str(),
-                      locs->object->name().c_str());
+                      locs->loc.object->name().c_str());
               // Only print one broken pair, to avoid needing to
               // compare against a list of the disjoint definition
               // locations we've found so far.  (If we kept comparing
@@ -3586,8 +3736,67 @@ Symbol_table::detect_odr_violations(const Task* task,
             }
         }
     }
-  // We only call one_addr2line() in this function, so we can clear its cache.
-  Dwarf_line_info::clear_addr2line_cache();
+}
+
+// Check candidate_odr_violations_ to find symbols with the same name
+// but apparently different definitions.  This queues the tasks which
+// do the work.
+
+void
+Symbol_table::detect_odr_violations(Workqueue* workqueue,
+				    const char* output_file_name) const
+{
+  if (this->candidate_odr_violations_.empty())
+    return;
+
+  Odr_check* check = new Odr_check(output_file_name);
+  std::vector<Odr_check::Candidate>& candidates = check->candidates();
+  candidates.resize(this->candidate_odr_violations_.size());
+
+  std::vector<Odr_check::Candidate>::iterator pc = candidates.begin();
+  for (Odr_map::const_iterator it = this->candidate_odr_violations_.begin();
+       it != this->candidate_odr_violations_.end();
+       ++it, ++pc)
+    {
+      pc->name = it->first;
+      for (Unordered_set<Symbol_location, Symbol_location_hash>::const_iterator
+	     locs = it->second.begin();
+	   locs != it->second.end();
+	   ++locs)
+	{
+	  Odr_check::Definition def;
+	  def.loc = *locs;
+	  def.code_loc = *locs;
+	  pc->definitions.push_back(def);
+	}
+      std::sort(pc->definitions.begin(), pc->definitions.end(),
+		Odr_definition_compare());
+    }
+  std::sort(candidates.begin(), candidates.end(), Odr_candidate_compare());
+
+  // Group the definitions by the object holding their code, now that
+  // they no longer move.
+  Odr_check::Object_map& objects = check->objects();
+  for (pc = candidates.begin(); pc != candidates.end(); ++pc)
+    for (std::vector<Odr_check::Definition>::iterator pd =
+	   pc->definitions.begin();
+	 pd != pc->definitions.end();
+	 ++pd)
+      {
+	parameters->target().function_location(&pd->code_loc);
+	objects[pd->code_loc.object].push_back(&*pd);
+      }
+
+  Task_token* blocker = new Task_token(true);
+  blocker->add_blockers(objects.size());
+  for (Odr_check::Object_map::iterator po = objects.begin();
+       po != objects.end();
+       ++po)
+    workqueue->queue(new Odr_lineno_task(po->first, &po->second, blocker));
+
+  workqueue->queue(new Task_function(new Odr_report_runner(check),
+				     blocker,
+				     "Task_function Odr_report_runner"));
 }
 
 // Warnings functions.
@@ -1560,8 +1560,10 @@ class Symbol_table
 
   // Check candidate_odr_violations_ to find symbols with the same name
   // but apparently different definitions (different source-file/line-no).
+  // This queues tasks on WORKQUEUE which read the line tables of the
+  // defining objects in parallel.
   void
-  detect_odr_violations(const Task*, const char* output_file_name) const;
+  detect_odr_violations(Workqueue*, const char* output_file_name) const;
 
   // Add any undefined symbols named on the command line to the symbol
   // table.
@@ -1858,12 +1860,6 @@ class Symbol_table
   do_allocate_commons_list(Layout*, Commons_section_type, Commons_type*,
 			   Mapfile*, Sort_commons_order);
 
-  // Returns all of the lines attached to LOC, not just the one the
-  // instruction actually came from.  This helps the ODR checker avoid
-  // false positives.
-  static std::vector<std::string>
-  linenos_from_loc(const Task* task, const Symbol_location& loc);
-
   // Implement detect_odr_violations.
   template<int size, bool big_endian>
   void
@@ -117,6 +117,22 @@ then
   check debug_msg_cdebug.err "odr_violation2.cc:2[7-9]"
 fi
 
+# Check for the same ODR violations when the checks run in threads.
+if test -r debug_msg_threads.err
+then
+  check debug_msg_threads.err ": symbol 'Ordering::operator()(int, int)' defined in multiple places (possible ODR violation):"
+  check debug_msg_threads.err "odr_violation1.cc:6"
+  check debug_msg_threads.err "odr_violation2.cc:1[256]"
+  check_missing debug_msg_threads.err "OdrDerived::~OdrDerived()"
+  check_missing debug_msg_threads.err "__adjust_heap"
+  check_missing debug_msg_threads.err ": symbol 'OverriddenCFunction' defined in multiple places (possible ODR violation):"
+  check_missing debug_msg_threads.err "odr_violation1.cc:1[6-8]"
+  check_missing debug_msg_threads.err "odr_violation2.cc:2[3-5]"
+  check debug_msg_threads.err ": symbol 'SometimesInlineFunction(int)' defined in multiple places (possible ODR violation):"
+  check debug_msg_threads.err "debug_msg.cc:6[89]"
+  check debug_msg_threads.err "odr_violation2.cc:2[7-9]"
+fi
+
 # When linking together .so's, we don't catch the line numbers, but we
 # still find all the undefined variables, and the ODR violation.
 check debug_msg_so.err "debug_msg.so: error: undefined reference to 'undef_fn1()'"
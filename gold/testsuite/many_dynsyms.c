@@ -0,0 +1,27 @@
+// many_dynsyms.c -- a shared library with more than 64k dynamic symbols
+
+// Copyright (C) 2017 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+// This is linked into a shared library, with and without --threads,
+// by many_dynsyms_test.sh.  The generated .h file defines 70,000
+// variables, which is enough for gold to build the dynamic hash
+// tables in several pieces when using threads.
+
+#include "many_sections_define.h"
@@ -0,0 +1,57 @@
+#!/bin/sh
+
+# many_dynsyms_test.sh -- test the hash tables for many dynamic symbols
+
+# Copyright (C) 2017 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# With more than 64k dynamic symbols, gold builds the .hash and
+# .gnu.hash sections in pieces when using threads.  Check that the
+# library linked with --threads has both sections and all the
+# symbols, and that it is the same as the library linked without
+# threads.
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check many_dynsyms.stdout " \.hash "
+check many_dynsyms.stdout " \.gnu\.hash "
+
+count=`grep -c " var_[0-9]*$" many_dynsyms.stdout`
+if test "$count" -ne 70000; then
+    echo "Expected 70000 dynamic symbols in many_dynsyms_2.so, found $count"
+    exit 1
+fi
+
+if ! cmp -s many_dynsyms_1.so many_dynsyms_2.so; then
+    echo "many_dynsyms_1.so and many_dynsyms_2.so differ"
+    exit 1
+fi
+
+exit 0
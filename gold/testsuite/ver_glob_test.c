@@ -0,0 +1,36 @@
+// ver_glob_test.c -- test glob matching in ver_glob_test.map
+
+// Copyright (C) 2017 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+// This is linked into a shared library with the generated
+// ver_glob_long.c, with and without --threads, and
+// ver_glob_test.sh checks the version of each symbol.  The comments
+// give the version each symbol should get.
+
+void glob_a_one (void) { }	// V1, from a range
+void glob_c_one (void) { }	// V1, from a range
+void glob_d_one (void) { }	// local
+void glob_5_one (void) { }	// V1, from [[:digit:]]
+void glob_Q_one (void) { }	// V2, from a negated bracket of classes
+void glob_x_one (void) { }	// V1
+void glob_x_two (void) { }	// V2, from a later pattern left to fnmatch
+void glob_y_one (void) { }	// V1, from a pattern left to fnmatch
+void glob_y_two (void) { }	// V2, from a later pattern
+void glob_b_three (void) { }	// V3, from a later pattern
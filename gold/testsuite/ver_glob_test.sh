@@ -0,0 +1,79 @@
+#!/bin/sh
+
+# ver_glob_test.sh -- test glob matching in version scripts
+
+# Copyright (C) 2017 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# This file goes with ver_glob_test.c and ver_glob_test.map.  We check
+# that each symbol in the shared libraries linked with and without
+# --threads gets the version given in ver_glob_test.c, and that the
+# glob matcher ran out of states for the long symbols and fell back
+# to matching them by simulation.
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected symbol in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check_missing()
+{
+    if grep -q "$2" "$1"
+    then
+	echo "Found unexpected symbol in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+for f in ver_glob_test_1.stdout ver_glob_test_2.stdout
+do
+    check $f "V1  *glob_a_one$"
+    check $f "V1  *glob_c_one$"
+    check_missing $f "glob_d_one$"
+    check $f "V1  *glob_5_one$"
+    check $f "V2  *glob_Q_one$"
+    check $f "V1  *glob_x_one$"
+    check $f "V2  *glob_x_two$"
+    check $f "V1  *glob_y_one$"
+    check $f "V2  *glob_y_two$"
+    check $f "V3  *glob_b_three$"
+    check $f "V3  *glob_long_[ab]*abbbbbbbbbbbbbbbbb$"
+    check_missing $f "glob_long_[ab]*bbbbbbbbbbbbbbbbbb$"
+done
+
+if ! grep -q "glob matcher reached" ver_glob_test_1.err
+then
+    echo "The glob matcher did not run out of states:"
+    cat ver_glob_test_1.err
+    exit 1
+fi
+
+exit 0
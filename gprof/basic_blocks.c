@@ -35,7 +35,6 @@
 
 static int cmp_bb (const PTR, const PTR);
 static int cmp_ncalls (const PTR, const PTR);
-static void fskip_string (FILE *);
 static void annotate_with_count (char *, unsigned int, int, PTR);
 
 /* Default option values:  */
@@ -100,30 +99,17 @@ cmp_ncalls (const PTR lp, const PTR rp)
   return left->line_num - right->line_num;
 }
 
-/* Skip over variable length string.  */
-static void
-fskip_string (FILE *fp)
-{
-  int ch;
-
-  while ((ch = fgetc (fp)) != EOF)
-    {
-      if (ch == '\0')
-	break;
-    }
-}
-
-/* Read a basic-block record from file IFP.  FILENAME is the name
-   of file IFP and is provided for formatting error-messages only.  */
+/* Read a basic-block record from file IN.  FILENAME is the name
+   of file IN and is provided for formatting error-messages only.  */
 
 void
-bb_read_rec (FILE *ifp, const char *filename)
+bb_read_rec (Gmon_In *in, const char *filename)
 {
   unsigned int nblocks, b;
   bfd_vma addr, ncalls;
   Sym *sym;
 
-  if (gmon_io_read_32 (ifp, &nblocks))
+  if (gmon_io_read_32 (in, &nblocks))
     {
       fprintf (stderr, _("%s: %s: unexpected end of file\n"),
 	       whoami, filename);
@@ -132,7 +118,7 @@ bb_read_rec (FILE *ifp, const char *filename)
 
   nblocks = bfd_get_32 (core_bfd, (bfd_byte *) & nblocks);
   if (gmon_file_version == 0)
-    fskip_string (ifp);
+    gmon_io_skip_string (in);
 
   for (b = 0; b < nblocks; ++b)
     {
@@ -142,18 +128,18 @@ bb_read_rec (FILE *ifp, const char *filename)
 
 	  /* Version 0 had lots of extra stuff that we don't
 	     care about anymore.  */
-	  if ((fread (&ncalls, sizeof (ncalls), 1, ifp) != 1)
-	      || (fread (&addr, sizeof (addr), 1, ifp) != 1)
-	      || (fskip_string (ifp), FALSE)
-	      || (fskip_string (ifp), FALSE)
-	      || (fread (&line_num, sizeof (line_num), 1, ifp) != 1))
+	  if (gmon_io_read (in, (char *) &ncalls, sizeof (ncalls))
+	      || gmon_io_read (in, (char *) &addr, sizeof (addr))
+	      || (gmon_io_skip_string (in), FALSE)
+	      || (gmon_io_skip_string (in), FALSE)
+	      || gmon_io_read (in, (char *) &line_num, sizeof (line_num)))
 	    {
 	      perror (filename);
 	      done (1);
 	    }
 	}
-      else if (gmon_io_read_vma (ifp, &addr)
-	       || gmon_io_read_vma (ifp, &ncalls))
+      else if (gmon_io_read_vma (in, &addr)
+	       || gmon_io_read_vma (in, &ncalls))
 	{
 	  perror (filename);
 	  done (1);
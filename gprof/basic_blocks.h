@@ -26,7 +26,9 @@ extern bfd_boolean bb_annotate_all_lines; /* Force annotation of all lines?  */
 extern int bb_table_length;		/* Length of most-used bb table.  */
 extern unsigned long bb_min_calls;	/* Minimum execution count.  */
 
-extern void bb_read_rec             (FILE *, const char *);
+struct gmon_in;
+
+extern void bb_read_rec             (struct gmon_in *, const char *);
 extern void bb_write_blocks         (FILE *, const char *);
 extern void bb_create_syms          (void);
 extern void print_annotated_source  (void);
@@ -30,17 +30,31 @@
 #include "gmon_out.h"
 #include "sym_ids.h"
 
-void
-cg_tally (bfd_vma from_pc, bfd_vma self_pc, unsigned long count)
+/* Look up the symbols of the arc from FROM_PC to SELF_PC, the caller's
+   in *PARENT and the called function's in *CHILD.  *LAST_PARENT is the
+   parent found by the previous call, which is tried first.  Return
+   zero if either of them is unknown.  This only reads the symbol
+   table, so several threads may look up arcs at once.  */
+
+int
+cg_lookup_arc (bfd_vma from_pc, bfd_vma self_pc, Sym **last_parent,
+	       Sym **parent, Sym **child)
 {
-  Sym *parent;
-  Sym *child;
-
-  parent = sym_lookup (&symtab, from_pc);
-  child = sym_lookup (&symtab, self_pc);
-
-  if (child == NULL || parent == NULL)
-    return;
+  /* gmon.out files list the arcs grouped by caller address, so the
+     parent is very often the same as last time.  */
+  if (*last_parent != NULL
+      && *last_parent >= symtab.base && *last_parent < symtab.limit
+      && from_pc >= (*last_parent)->addr
+      && from_pc <= (*last_parent)->end_addr
+      && (*last_parent + 1 == symtab.limit
+	  || from_pc < (*last_parent)[1].addr))
+    *parent = *last_parent;
+  else
+    *parent = *last_parent = sym_lookup (&symtab, from_pc);
+  *child = sym_lookup (&symtab, self_pc);
+
+  if (*child == NULL || *parent == NULL)
+    return 0;
 
   /* If we're doing line-by-line profiling, both the parent and the
      child will probably point to line symbols instead of function
@@ -51,12 +65,18 @@ cg_tally (bfd_vma from_pc, bfd_vma self_pc, unsigned long count)
 
      For normal profiling, is_func will be set on all symbols, so this
      code will do nothing.  */
-  while (child >= symtab.base && ! child->is_func)
-    --child;
+  while (*child >= symtab.base && ! (*child)->is_func)
+    --*child;
+
+  return *child >= symtab.base;
+}
 
-  if (child < symtab.base)
-    return;
+/* Add COUNT calls from PARENT to CHILD, as found by cg_lookup_arc, to
+   the call graph.  */
 
+void
+cg_tally_arc (Sym *parent, Sym *child, unsigned long count)
+{
   /* Keep arc if it is on INCL_ARCS table or if the INCL_ARCS table
      is empty and it is not in the EXCL_ARCS table.  */
   if (sym_id_arc_is_present (&syms[INCL_ARCS], parent, child)
@@ -71,20 +91,29 @@ cg_tally (bfd_vma from_pc, bfd_vma self_pc, unsigned long count)
     }
 }
 
-/* Read a record from file IFP describing an arc in the function
+void
+cg_tally (bfd_vma from_pc, bfd_vma self_pc, unsigned long count)
+{
+  static Sym *last_parent;
+  Sym *parent;
+  Sym *child;
+
+  if (cg_lookup_arc (from_pc, self_pc, &last_parent, &parent, &child))
+    cg_tally_arc (parent, child, count);
+}
+
+/* Read a record from file IN describing an arc in the function
    call-graph and the count of how many times the arc has been
-   traversed.  FILENAME is the name of file IFP and is provided
+   traversed.  FILENAME is the name of file IN and is provided
    for formatting error-messages only.  */
 
 void
-cg_read_rec (FILE *ifp, const char *filename)
+cg_read_rec (Gmon_In *in, const char *filename)
 {
   bfd_vma from_pc, self_pc;
   unsigned int count;
 
-  if (gmon_io_read_vma (ifp, &from_pc)
-      || gmon_io_read_vma (ifp, &self_pc)
-      || gmon_io_read_32 (ifp, &count))
+  if (gmon_io_read_arc (in, &from_pc, &self_pc, &count))
     {
       fprintf (stderr, _("%s: %s: unexpected end of file\n"),
 	       whoami, filename);
@@ -113,10 +142,8 @@ cg_write_arcs (FILE *ofp, const char *filename)
     {
       for (arc = sym->cg.children; arc; arc = arc->next_child)
 	{
-	  if (gmon_io_write_8 (ofp, GMON_TAG_CG_ARC)
-	      || gmon_io_write_vma (ofp, arc->parent->addr)
-	      || gmon_io_write_vma (ofp, arc->child->addr)
-	      || gmon_io_write_32 (ofp, arc->count))
+	  if (gmon_io_write_arc (ofp, arc->parent->addr, arc->child->addr,
+				 arc->count))
 	    {
 	      perror (filename);
 	      done (1);
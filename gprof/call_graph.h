@@ -22,8 +22,12 @@
 #ifndef call_graph_h
 #define call_graph_h
 
+struct gmon_in;
+
+extern int  cg_lookup_arc (bfd_vma, bfd_vma, Sym **, Sym **, Sym **);
+extern void cg_tally_arc  (Sym *, Sym *, unsigned long);
 extern void cg_tally      (bfd_vma, bfd_vma, unsigned long);
-extern void cg_read_rec   (FILE *, const char *);
+extern void cg_read_rec   (struct gmon_in *, const char *);
 extern void cg_write_arcs (FILE *, const char *);
 
 #endif /* call_graph_h */
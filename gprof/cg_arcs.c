@@ -28,6 +28,7 @@
  */
 #include "gprof.h"
 #include "libiberty.h"
+#include "hashtab.h"
 #include "search_list.h"
 #include "source.h"
 #include "symtab.h"
@@ -51,6 +52,27 @@ unsigned int num_cycles;
 Arc **arcs;
 unsigned int numarcs;
 
+/* All arcs, hashed by their parent and child symbols.  */
+static htab_t arc_table;
+
+static hashval_t
+arc_hash (const void *p)
+{
+  const Arc *arc = (const Arc *) p;
+
+  return (*htab_hash_pointer) (arc->parent) * 31
+    + (*htab_hash_pointer) (arc->child);
+}
+
+static int
+arc_eq (const void *p1, const void *p2)
+{
+  const Arc *left = (const Arc *) p1;
+  const Arc *right = (const Arc *) p2;
+
+  return left->parent == right->parent && left->child == right->child;
+}
+
 /*
  * Return TRUE iff PARENT has an arc to covers the address
  * range covered by CHILD.
@@ -58,7 +80,7 @@ unsigned int numarcs;
 Arc *
 arc_lookup (Sym *parent, Sym *child)
 {
-  Arc *arc;
+  Arc *arc, key;
 
   if (!parent || !child)
     {
@@ -67,6 +89,27 @@ arc_lookup (Sym *parent, Sym *child)
     }
   DBG (LOOKUPDEBUG, printf ("[arc_lookup] parent %s child %s\n",
 			    parent->name, child->name));
+
+  if (arc_table != NULL)
+    {
+      key.parent = parent;
+      key.child = child;
+      arc = (Arc *) htab_find (arc_table, &key);
+      if (arc)
+	return arc;
+    }
+
+  /*
+   * The arcs from a symbol in the core symbol table all go to
+   * symbols of that table, which cover disjoint address ranges, so
+   * the only arc that can cover CHILD is the one to CHILD itself.
+   * The symbols of the sym_ids.c tables need the search through all
+   * of PARENT's children, even when CHILD is a core symbol, as for
+   * sym_id_arc_is_present.
+   */
+  if (parent >= symtab.base && parent < symtab.limit)
+    return 0;
+
   for (arc = parent->cg.children; arc; arc = arc->next_child)
     {
       DBG (LOOKUPDEBUG, printf ("[arc_lookup]\t parent %s child %s\n",
@@ -89,6 +132,7 @@ arc_add (Sym *parent, Sym *child, unsigned long count)
 {
   static unsigned int maxarcs = 0;
   Arc *arc, **newarcs;
+  void **slot;
 
   DBG (TALLYDEBUG, printf ("[arc_add] %lu arcs from %s to %s\n",
 			   count, parent->name, child->name));
@@ -109,6 +153,11 @@ arc_add (Sym *parent, Sym *child, unsigned long count)
   arc->child = child;
   arc->count = count;
 
+  if (arc_table == NULL)
+    arc_table = htab_create (1024, arc_hash, arc_eq, NULL);
+  slot = htab_find_slot (arc_table, arc, INSERT);
+  *slot = arc;
+
   /* If this isn't an arc for a recursive call to parent, then add it
      to the array of arcs.  */
   if (parent != child)
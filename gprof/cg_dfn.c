@@ -37,16 +37,20 @@
 
 #define	DFN_INCR_DEPTH (128)
 
+/*
+ * The cycles of the call-graph are its strongly connected components,
+ * found with Tarjan's algorithm.  DFN_STACK holds the functions being
+ * visited, each with the next of its arcs to follow.  CYCLE_STACK holds
+ * the functions which have been visited but whose cycle is not yet
+ * complete; they are still marked DFN_BUSY.
+ */
 typedef struct
   {
     Sym *sym;
-    int cycle_top;
+    Arc *next_arc;
   }
 DFN_Stack;
 
-static bfd_boolean is_numbered (Sym *);
-static bfd_boolean is_busy (Sym *);
-static void find_cycle (Sym *);
 static void pre_visit (Sym *);
 static void post_visit (Sym *);
 
@@ -55,159 +59,15 @@ int dfn_maxdepth = 0;
 int dfn_depth = 0;
 int dfn_counter = DFN_NAN;
 
-
-/*
- * Is CHILD already numbered?
- */
-static bfd_boolean
-is_numbered (Sym *child)
-{
-  return child->cg.top_order != DFN_NAN && child->cg.top_order != DFN_BUSY;
-}
-
-
-/*
- * Is CHILD already busy?
- */
-static bfd_boolean
-is_busy (Sym *child)
-{
-  if (child->cg.top_order == DFN_NAN)
-    {
-      return FALSE;
-    }
-  return TRUE;
-}
-
-
-/*
- * CHILD is part of a cycle.  Find the top caller into this cycle
- * that is not part of the cycle and make all functions in cycle
- * members of that cycle (top caller == caller with smallest
- * depth-first number).
- */
-static void
-find_cycle (Sym *child)
-{
-  Sym *head = 0;
-  Sym *tail;
-  int cycle_top;
-  int cycle_index;
-
-  for (cycle_top = dfn_depth; cycle_top > 0; --cycle_top)
-    {
-      head = dfn_stack[cycle_top].sym;
-      if (child == head)
-	{
-	  break;
-	}
-      if (child->cg.cyc.head != child && child->cg.cyc.head == head)
-	{
-	  break;
-	}
-    }
-  if (cycle_top <= 0)
-    {
-      fprintf (stderr, "[find_cycle] couldn't find head of cycle\n");
-      done (1);
-    }
-#ifdef DEBUG
-  if (debug_level & DFNDEBUG)
-    {
-      printf ("[find_cycle] dfn_depth %d cycle_top %d ",
-	      dfn_depth, cycle_top);
-      if (head)
-	{
-	  print_name (head);
-	}
-      else
-	{
-	  printf ("<unknown>");
-	}
-      printf ("\n");
-    }
-#endif
-  if (cycle_top == dfn_depth)
-    {
-      /*
-       * This is previous function, e.g. this calls itself.  Sort of
-       * boring.
-       *
-       * Since we are taking out self-cycles elsewhere no need for
-       * the special case, here.
-       */
-      DBG (DFNDEBUG,
-	   printf ("[find_cycle] ");
-	   print_name (child);
-	   printf ("\n"));
-    }
-  else
-    {
-      /*
-       * Glom intervening functions that aren't already glommed into
-       * this cycle.  Things have been glommed when their cyclehead
-       * field points to the head of the cycle they are glommed
-       * into.
-       */
-      for (tail = head; tail->cg.cyc.next; tail = tail->cg.cyc.next)
-	{
-	  /* void: chase down to tail of things already glommed */
-	  DBG (DFNDEBUG,
-	       printf ("[find_cycle] tail ");
-	       print_name (tail);
-	       printf ("\n"));
-	}
-      /*
-       * If what we think is the top of the cycle has a cyclehead
-       * field, then it's not really the head of the cycle, which is
-       * really what we want.
-       */
-      if (head->cg.cyc.head != head)
-	{
-	  head = head->cg.cyc.head;
-	  DBG (DFNDEBUG, printf ("[find_cycle] new cyclehead ");
-	       print_name (head);
-	       printf ("\n"));
-	}
-      for (cycle_index = cycle_top + 1; cycle_index <= dfn_depth; ++cycle_index)
-	{
-	  child = dfn_stack[cycle_index].sym;
-	  if (child->cg.cyc.head == child)
-	    {
-	      /*
-	       * Not yet glommed anywhere, glom it and fix any
-	       * children it has glommed.
-	       */
-	      tail->cg.cyc.next = child;
-	      child->cg.cyc.head = head;
-	      DBG (DFNDEBUG, printf ("[find_cycle] glomming ");
-		   print_name (child);
-		   printf (" onto ");
-		   print_name (head);
-		   printf ("\n"));
-	      for (tail = child; tail->cg.cyc.next; tail = tail->cg.cyc.next)
-		{
-		  tail->cg.cyc.next->cg.cyc.head = head;
-		  DBG (DFNDEBUG, printf ("[find_cycle] and its tail ");
-		       print_name (tail->cg.cyc.next);
-		       printf (" onto ");
-		       print_name (head);
-		       printf ("\n"));
-		}
-	    }
-	  else if (child->cg.cyc.head != head /* firewall */ )
-	    {
-	      fprintf (stderr, "[find_cycle] glommed, but not to head\n");
-	      done (1);
-	    }
-	}
-    }
-}
+static Sym **cycle_stack = NULL;
+static int cycle_maxdepth = 0;
+static int cycle_depth = 0;
+static int dfn_visited = 0;
 
 
 /*
  * Prepare for visiting the children of PARENT.  Push a parent onto
- * the stack and mark it busy.
+ * the stacks and mark it busy.
  */
 static void
 pre_visit (Sym *parent)
@@ -222,8 +82,18 @@ pre_visit (Sym *parent)
     }
 
   dfn_stack[dfn_depth].sym = parent;
-  dfn_stack[dfn_depth].cycle_top = dfn_depth;
+  dfn_stack[dfn_depth].next_arc = parent->cg.children;
+
+  if (cycle_depth >= cycle_maxdepth)
+    {
+      cycle_maxdepth += DFN_INCR_DEPTH;
+      cycle_stack = (Sym **) xrealloc (cycle_stack,
+				       cycle_maxdepth * sizeof *cycle_stack);
+    }
+  cycle_stack[cycle_depth++] = parent;
+
   parent->cg.top_order = DFN_BUSY;
+  parent->cg.dfn_index = parent->cg.low_link = ++dfn_visited;
   DBG (DFNDEBUG, printf ("[pre_visit]\t\t%d:", dfn_depth);
        print_name (parent);
        printf ("\n"));
@@ -231,37 +101,57 @@ pre_visit (Sym *parent)
 
 
 /*
- * Done with visiting node PARENT.  Pop PARENT off dfn_stack
- * and number functions if PARENT is head of a cycle.
+ * Done with visiting node PARENT.  Pop PARENT off dfn_stack.  If
+ * nothing PARENT reaches leads back to a function visited before
+ * PARENT, PARENT is the head of a cycle made of itself and everything
+ * above it on CYCLE_STACK: link those together and number them.
  */
 static void
 post_visit (Sym *parent)
 {
-  Sym *member;
+  Sym *member, *tail;
 
   DBG (DFNDEBUG, printf ("[post_visit]\t%d: ", dfn_depth);
        print_name (parent);
        printf ("\n"));
+  --dfn_depth;
+
+  if (parent->cg.low_link != parent->cg.dfn_index)
+    {
+      /* Part of a cycle headed further down the stack.  */
+      DBG (DFNDEBUG, printf ("[post_visit]\t\tis part of a cycle\n"));
+      member = dfn_stack[dfn_depth].sym;
+      if (parent->cg.low_link < member->cg.low_link)
+	member->cg.low_link = parent->cg.low_link;
+      return;
+    }
+
   /*
-   * Number functions and things in their cycles unless the function
-   * is itself part of a cycle:
+   * Number functions and things in their cycles.  The members are
+   * everything above PARENT on CYCLE_STACK.
    */
-  if (parent->cg.cyc.head == parent)
+  ++dfn_counter;
+  tail = parent;
+  do
     {
-      ++dfn_counter;
-      for (member = parent; member; member = member->cg.cyc.next)
+      member = cycle_stack[--cycle_depth];
+      member->cg.top_order = dfn_counter;
+      DBG (DFNDEBUG, printf ("[post_visit]\t\tmember ");
+	   print_name (member);
+	   printf ("-> cg.top_order = %d\n", dfn_counter));
+      if (member != parent)
 	{
-	  member->cg.top_order = dfn_counter;
-	  DBG (DFNDEBUG, printf ("[post_visit]\t\tmember ");
+	  DBG (DFNDEBUG, printf ("[post_visit] glomming ");
 	       print_name (member);
-	       printf ("-> cg.top_order = %d\n", dfn_counter));
+	       printf (" onto ");
+	       print_name (parent);
+	       printf ("\n"));
+	  member->cg.cyc.head = parent;
+	  member->cg.cyc.next = tail->cg.cyc.next;
+	  tail->cg.cyc.next = member;
 	}
     }
-  else
-    {
-      DBG (DFNDEBUG, printf ("[post_visit]\t\tis part of a cycle\n"));
-    }
-  --dfn_depth;
+  while (member != parent);
 }
 
 
@@ -271,33 +161,45 @@ post_visit (Sym *parent)
 void
 cg_dfn (Sym *parent)
 {
-  Arc *arc;
-
   DBG (DFNDEBUG, printf ("[dfn] dfn( ");
        print_name (parent);
        printf (")\n"));
   /*
    * If we're already numbered, no need to look any further:
    */
-  if (is_numbered (parent))
+  if (parent->cg.top_order != DFN_NAN)
     {
       return;
     }
+
   /*
-   * If we're already busy, must be a cycle:
+   * Visit the children without recursion, so that deep call chains
+   * cannot overflow the stack.
    */
-  if (is_busy (parent))
-    {
-      find_cycle (parent);
-      return;
-    }
   pre_visit (parent);
-  /*
-   * Recursively visit children:
-   */
-  for (arc = parent->cg.children; arc; arc = arc->next_child)
+  while (dfn_depth > 0)
     {
-      cg_dfn (arc->child);
+      DFN_Stack *top = &dfn_stack[dfn_depth];
+      Arc *arc = top->next_arc;
+      Sym *child;
+
+      if (arc == NULL)
+	{
+	  post_visit (top->sym);
+	  continue;
+	}
+
+      top->next_arc = arc->next_child;
+      child = arc->child;
+      if (child->cg.top_order == DFN_NAN)
+	pre_visit (child);
+      else if (child->cg.top_order == DFN_BUSY)
+	{
+	  /*
+	   * If we're already busy, must be a cycle:
+	   */
+	  if (child->cg.dfn_index < top->sym->cg.low_link)
+	    top->sym->cg.low_link = child->cg.dfn_index;
+	}
     }
-  post_visit (parent);
 }
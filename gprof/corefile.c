@@ -756,6 +756,210 @@ core_create_function_syms (void)
   symtab_finalize (&symtab);
 }
 
+/* The text-space addresses at which the source line information may
+   change, with the file, line and function that start there.  When
+   ROWS is NULL, every address is a candidate, and its line is looked
+   up.  */
+
+struct line_row
+{
+  bfd_vma vma;
+  /* NULL if there is no line information from VMA on.  */
+  Source_File *file;
+  int line;
+  /* The function, or NULL if it has to be looked up.  */
+  const char *name;
+};
+
+struct line_rows
+{
+  struct line_row *rows;
+  unsigned int len;
+  unsigned int size;
+  bfd_vma low;
+  bfd_vma high;
+  /* The function names the rows point to.  */
+  char **names;
+  unsigned int names_len;
+  unsigned int names_size;
+};
+
+static void
+line_rows_add (struct line_rows *lr, bfd_vma vma, Source_File *file,
+	       int line, const char *func_name)
+{
+  struct line_row *row;
+
+  /* Of several rows at one address, the last one applies.  */
+  if (lr->len != 0 && lr->rows[lr->len - 1].vma == vma)
+    row = &lr->rows[lr->len - 1];
+  else
+    {
+      if (lr->len == lr->size)
+	{
+	  lr->size = lr->size ? lr->size * 2 : 1024;
+	  lr->rows = (struct line_row *)
+	    xrealloc (lr->rows, lr->size * sizeof (struct line_row));
+	}
+      row = &lr->rows[lr->len++];
+    }
+  row->vma = vma;
+  row->file = file;
+  row->line = line;
+  row->name = func_name;
+}
+
+/* Callback for bfd_dwarf2_enumerate_lines, which passes the rows in
+   order of increasing address.  The strings it passes need not outlive
+   the call, so consecutive rows share a copy.  */
+
+static bfd_boolean
+line_rows_add_dwarf (bfd_vma vma, const char *filename, unsigned int line,
+		     const char *funcname, bfd_boolean end_sequence,
+		     void *data)
+{
+  struct line_rows *lr = (struct line_rows *) data;
+  struct line_row *prev = lr->len != 0 ? &lr->rows[lr->len - 1] : NULL;
+  Source_File *file = NULL;
+  const char *func_name = NULL;
+
+  if (vma < lr->low || vma >= lr->high)
+    return TRUE;
+
+  if (!end_sequence && filename != NULL && line != 0)
+    {
+      if (prev != NULL && prev->file != NULL
+	  && filename_cmp (prev->file->name, filename) == 0)
+	file = prev->file;
+      else
+	file = source_file_lookup_path (filename);
+
+      if (funcname == NULL)
+	;
+      else if (prev != NULL && prev->name != NULL
+	       && strcmp (prev->name, funcname) == 0)
+	func_name = prev->name;
+      else
+	{
+	  if (lr->names_len == lr->names_size)
+	    {
+	      lr->names_size = lr->names_size ? lr->names_size * 2 : 256;
+	      lr->names = (char **)
+		xrealloc (lr->names, lr->names_size * sizeof (char *));
+	    }
+	  func_name = lr->names[lr->names_len++] = xstrdup (funcname);
+	}
+    }
+  line_rows_add (lr, vma, file, file != NULL ? (int) line : 0, func_name);
+  return TRUE;
+}
+
+/* Collect the rows of the DWARF line tables that fall in the text
+   section.  A function symbol that starts between two rows gets a row
+   of its own, whose line is looked up.  If there are no DWARF line
+   tables, leave LR->ROWS NULL so that every address gets looked at.  */
+
+static void
+line_rows_init (struct line_rows *lr)
+{
+  struct line_rows dwarf;
+  unsigned int i, j;
+
+  memset (lr, 0, sizeof (*lr));
+  lr->low = core_text_sect->vma;
+  lr->high = core_text_sect->vma + bfd_get_section_size (core_text_sect);
+
+  dwarf = *lr;
+  if (!bfd_dwarf2_enumerate_lines (core_bfd, core_syms, line_rows_add_dwarf,
+				   &dwarf)
+      || dwarf.len == 0)
+    {
+      free (dwarf.rows);
+      for (i = 0; i < dwarf.names_len; i++)
+	free (dwarf.names[i]);
+      free (dwarf.names);
+      return;
+    }
+
+  /* Merge in the function starts; the symbol table is sorted.  */
+  for (i = j = 0; i < dwarf.len || j < symtab.len;)
+    {
+      if (j >= symtab.len
+	  || (i < dwarf.len && dwarf.rows[i].vma <= symtab.base[j].addr))
+	{
+	  line_rows_add (lr, dwarf.rows[i].vma, dwarf.rows[i].file,
+			 dwarf.rows[i].line, dwarf.rows[i].name);
+	  i++;
+	}
+      else
+	{
+	  bfd_vma vma = symtab.base[j++].addr;
+
+	  if (vma >= lr->low && vma < lr->high
+	      && lr->len != 0 && lr->rows[lr->len - 1].vma != vma
+	      && lr->rows[lr->len - 1].file != NULL)
+	    line_rows_add (lr, vma, lr->rows[lr->len - 1].file, 0, NULL);
+	}
+    }
+  free (dwarf.rows);
+  lr->names = dwarf.names;
+  lr->names_len = dwarf.names_len;
+
+  DBG (AOUTDEBUG, printf ("[line_rows_init] %u candidate addresses\n",
+			  lr->len));
+}
+
+static void
+line_rows_free (struct line_rows *lr)
+{
+  unsigned int i;
+
+  free (lr->rows);
+  for (i = 0; i < lr->names_len; i++)
+    free (lr->names[i]);
+  free (lr->names);
+}
+
+/* Store the next candidate address from LR in *VMA, using *INDEX to
+   keep track of the position.  Return FALSE when there are no more.
+   Set *HAVE_INFO to whether there is line information for *VMA, and
+   if so store it in *FILENAME, *FUNCNAME and *LINE_NUM.  */
+
+static bfd_boolean
+line_rows_next (struct line_rows *lr, unsigned int *index, bfd_vma *vma,
+		bfd_boolean *have_info, const char **filename,
+		const char **funcname, int *line_num)
+{
+  if (lr->rows != NULL)
+    {
+      struct line_row *row;
+
+      if (*index >= lr->len)
+	return FALSE;
+      row = &lr->rows[(*index)++];
+      *vma = row->vma;
+      if (row->file == NULL)
+	*have_info = FALSE;
+      else if (row->name == NULL)
+	*have_info = get_src_info (*vma, filename, funcname, line_num);
+      else
+	{
+	  *filename = row->file->name;
+	  *funcname = row->name;
+	  *line_num = row->line;
+	  *have_info = TRUE;
+	}
+      return TRUE;
+    }
+
+  *vma = lr->low + (bfd_vma) *index * min_insn_size;
+  if (*vma >= lr->high)
+    return FALSE;
+  ++*index;
+  *have_info = get_src_info (*vma, filename, funcname, line_num);
+  return TRUE;
+}
+
 /* Read in symbol table from core.
    One symbol per line of source code is entered.  */
 
@@ -769,7 +973,9 @@ core_create_line_syms (void)
   const char *filename;
   int prev_line_num;
   Sym_Table ltab;
-  bfd_vma vma_high;
+  struct line_rows lr;
+  bfd_boolean have_info;
+  unsigned int idx;
 
   /* Create symbols for functions as usual.  This is necessary in
      cases where parts of a program were not compiled with -g.  For
@@ -778,13 +984,17 @@ core_create_line_syms (void)
 
   /* Pass 1: count the number of symbols.  */
 
-  /* To find all line information, walk through all possible
-     text-space addresses (one by one!) and get the debugging
-     info for each address.  When the debugging info changes,
-     it is time to create a new symbol.
+  /* To find all line information, walk through the text-space
+     addresses where the debugging info may change and get the
+     debugging info for each address.  When the debugging info
+     changes, it is time to create a new symbol.
+
+     With DWARF line tables those addresses are just the rows of the
+     tables, which give the line and function, and the function
+     starts.  Otherwise we have to look at every possible address (one by
+     one!).  */
+  line_rows_init (&lr);
 
-     Of course, this is rather slow and it would be better if
-     BFD would provide an iterator for enumerating all line infos.  */
   prev_name_len = PATH_MAX;
   prev_filename_len = PATH_MAX;
   prev_name = (char *) xmalloc (prev_name_len);
@@ -792,12 +1002,12 @@ core_create_line_syms (void)
   ltab.len = 0;
   prev_line_num = 0;
 
-  vma_high = core_text_sect->vma + bfd_get_section_size (core_text_sect);
-  for (vma = core_text_sect->vma; vma < vma_high; vma += min_insn_size)
+  for (idx = 0; line_rows_next (&lr, &idx, &vma, &have_info, &filename,
+			       &dummy.name, &dummy.line_num);)
     {
       unsigned int len;
 
-      if (!get_src_info (vma, &filename, &dummy.name, &dummy.line_num)
+      if (!have_info
 	  || (prev_line_num == dummy.line_num
 	      && prev_name != NULL
 	      && strcmp (prev_name, dummy.name) == 0
@@ -859,18 +1069,20 @@ core_create_line_syms (void)
      lot cleaner now.  */
   prev = 0;
 
-  for (vma = core_text_sect->vma; vma < vma_high; vma += min_insn_size)
+  for (idx = 0; line_rows_next (&lr, &idx, &vma, &have_info, &filename,
+			       &dummy.name, &dummy.line_num);)
     {
-      sym_init (ltab.limit);
-
-      if (!get_src_info (vma, &filename, &ltab.limit->name, &ltab.limit->line_num)
-	  || (prev && prev->line_num == ltab.limit->line_num
-	      && strcmp (prev->name, ltab.limit->name) == 0
+      if (!have_info
+	  || (prev && prev->line_num == dummy.line_num
+	      && strcmp (prev->name, dummy.name) == 0
 	      && filename_cmp (prev->file->name, filename) == 0))
 	continue;
 
+      sym_init (ltab.limit);
+
       /* Make name pointer a malloc'ed string.  */
-      ltab.limit->name = xstrdup (ltab.limit->name);
+      ltab.limit->name = xstrdup (dummy.name);
+      ltab.limit->line_num = dummy.line_num;
       ltab.limit->file = source_file_lookup_path (filename);
 
       ltab.limit->addr = vma;
@@ -899,6 +1111,8 @@ core_create_line_syms (void)
       ++ltab.limit;
     }
 
+  line_rows_free (&lr);
+
   /* Copy in function symbols.  */
   memcpy (ltab.limit, symtab.base, symtab.len * sizeof (Sym));
   ltab.limit += symtab.len;
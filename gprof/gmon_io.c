@@ -34,6 +34,18 @@
 #include "hertz.h"
 #include "hist.h"
 #include "libiberty.h"
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
+#if defined (HAVE_MMAP) && defined (HAVE_PTHREAD_H) \
+    && defined (HAVE_PTHREAD_CREATE)
+#include <pthread.h>
+#define GMON_IO_THREADS 1
+#endif
+
+#if defined (HAVE_MMAP) && !defined (MAP_FAILED)
+#define MAP_FAILED ((void *) -1)
+#endif
 
 enum gmon_ptr_size {
   ptr_32bit,
@@ -49,22 +61,32 @@ static enum gmon_ptr_size gmon_get_ptr_size (void);
 static enum gmon_ptr_signedness gmon_get_ptr_signedness (void);
 
 #ifdef BFD_HOST_U_64_BIT
-static int gmon_io_read_64 (FILE *, BFD_HOST_U_64_BIT *);
+static int gmon_io_read_64 (Gmon_In *, BFD_HOST_U_64_BIT *);
 static int gmon_io_write_64 (FILE *, BFD_HOST_U_64_BIT);
 #endif
 static int gmon_read_raw_arc
-  (FILE *, bfd_vma *, bfd_vma *, unsigned long *);
+  (Gmon_In *, bfd_vma *, bfd_vma *, unsigned long *);
 static int gmon_write_raw_arc
   (FILE *, bfd_vma, bfd_vma, unsigned long);
 
+/* Size of the stdio buffers used for gmon files.  */
+#define GMON_IO_BUFSIZE (256 * 1024)
+
 int gmon_input = 0;
 int gmon_file_version = 0;	/* 0 == old (non-versioned) file format.  */
 
 static enum gmon_ptr_size
 gmon_get_ptr_size (void)
 {
+  static bfd *cached_bfd;
+  static enum gmon_ptr_size cached_size;
   int size;
 
+  /* This is asked for every address read or written, so remember the
+     answer for CORE_BFD.  */
+  if (cached_bfd == core_bfd)
+    return cached_size;
+
   /* Pick best size for pointers.  Start with the ELF size, and if not
      elf go with the architecture's address size.  */
   size = bfd_get_arch_size (core_bfd);
@@ -74,9 +96,13 @@ gmon_get_ptr_size (void)
   switch (size)
     {
     case 32:
+      cached_size = ptr_32bit;
+      cached_bfd = core_bfd;
       return ptr_32bit;
 
     case 64:
+      cached_size = ptr_64bit;
+      cached_bfd = core_bfd;
       return ptr_64bit;
 
     default:
@@ -89,41 +115,233 @@ gmon_get_ptr_size (void)
 static enum gmon_ptr_signedness
 gmon_get_ptr_signedness (void)
 {
+  static bfd *cached_bfd;
+  static enum gmon_ptr_signedness cached_signedness;
   int sext;
 
+  if (cached_bfd == core_bfd)
+    return cached_signedness;
+
   /* Figure out whether to sign extend.  If BFD doesn't know, assume no.  */
   sext = bfd_get_sign_extend_vma (core_bfd);
   if (sext == -1)
-    return ptr_unsigned;
-  return (sext ? ptr_signed : ptr_unsigned);
+    cached_signedness = ptr_unsigned;
+  else
+    cached_signedness = sext ? ptr_signed : ptr_unsigned;
+  cached_bfd = core_bfd;
+  return cached_signedness;
+}
+
+/* Return the size in bytes of an address in a gmon.out file.  */
+
+static unsigned int
+gmon_vma_size (void)
+{
+  return gmon_get_ptr_size () == ptr_32bit ? 4 : 8;
+}
+
+/* Decode the address at BUF.  */
+
+static bfd_vma
+gmon_io_get_vma (const char *buf)
+{
+  unsigned int val32;
+
+  switch (gmon_get_ptr_size ())
+    {
+    case ptr_32bit:
+      val32 = bfd_get_32 (core_bfd, buf);
+      if (gmon_get_ptr_signedness () == ptr_signed)
+	return (int) val32;
+      return val32;
+
+#ifdef BFD_HOST_U_64_BIT
+    case ptr_64bit:
+#ifdef BFD_HOST_64_BIT
+      if (gmon_get_ptr_signedness () == ptr_signed)
+	return (BFD_HOST_64_BIT) bfd_get_64 (core_bfd, buf);
+#endif
+      return bfd_get_64 (core_bfd, buf);
+#endif
+    }
+  return 0;
+}
+
+/* Encode VAL as an address at BUF.  */
+
+static void
+gmon_io_put_vma (char *buf, bfd_vma val)
+{
+  switch (gmon_get_ptr_size ())
+    {
+    case ptr_32bit:
+      bfd_put_32 (core_bfd, val, buf);
+      break;
+
+#ifdef BFD_HOST_U_64_BIT
+    case ptr_64bit:
+      bfd_put_64 (core_bfd, val, buf);
+      break;
+#endif
+    }
+}
+
+#ifdef HAVE_MMAP
+/* Map FILENAME into memory for reading into *IN.  Return zero if it
+   is not a regular file or cannot be mapped, and should be read
+   through stdio instead.  */
+
+static int
+gmon_io_map (Gmon_In *in, const char *filename)
+{
+  struct stat st;
+  void *addr;
+  int fd;
+
+  fd = open (filename, O_RDONLY | O_BINARY);
+  if (fd < 0)
+    return 0;
+
+  if (fstat (fd, &st) != 0
+      || !S_ISREG (st.st_mode)
+      || st.st_size <= 0
+      || (off_t) (size_t) st.st_size != st.st_size)
+    {
+      close (fd);
+      return 0;
+    }
+
+  addr = mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close (fd);
+  if (addr == MAP_FAILED)
+    return 0;
+
+  in->fp = NULL;
+  in->base = in->ptr = (const char *) addr;
+  in->end = in->base + st.st_size;
+  return 1;
+}
+#endif
+
+/* Open FILENAME, or the standard input if it is "-", for reading into
+   *IN.  */
+
+static void
+gmon_io_open (Gmon_In *in, const char *filename)
+{
+  memset (in, 0, sizeof (*in));
+
+  if (strcmp (filename, "-") == 0)
+    {
+      in->fp = stdin;
+      SET_BINARY (fileno (stdin));
+      return;
+    }
+
+#ifdef HAVE_MMAP
+  /* The records are small and decoded field by field, so read them
+     straight from the mapped file if we can.  */
+  if (gmon_io_map (in, filename))
+    return;
+#endif
+
+  in->fp = fopen (filename, FOPEN_RB);
+  if (!in->fp)
+    {
+      perror (filename);
+      done (1);
+    }
+
+  /* Otherwise read the file in large chunks.  */
+  setvbuf (in->fp, NULL, _IOFBF, GMON_IO_BUFSIZE);
+}
+
+static void
+gmon_io_close (Gmon_In *in)
+{
+  if (in->fp == NULL)
+    {
+#ifdef HAVE_MMAP
+      munmap ((void *) in->base, in->end - in->base);
+#endif
+    }
+  else if (in->fp != stdin)
+    fclose (in->fp);
+}
+
+/* Position IN at OFFSET from the start of the file.  Like fseek, this
+   may go past the end of the file.  */
+
+static int
+gmon_io_seek (Gmon_In *in, long offset)
+{
+  if (in->fp != NULL)
+    return fseek (in->fp, offset, SEEK_SET);
+
+  if (offset < 0)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+  if (offset < in->end - in->base)
+    in->ptr = in->base + offset;
+  else
+    in->ptr = in->end;
+  return 0;
+}
+
+/* Return the next N bytes of IN, or NULL if the file ends before them.
+   Bytes read through stdio are copied to BUF, which must have room for
+   N of them; mapped bytes are returned where they are.  */
+
+static const char *
+gmon_io_next (Gmon_In *in, char *buf, size_t n)
+{
+  const char *p;
+
+  if (in->fp != NULL)
+    return fread (buf, 1, n, in->fp) == n ? buf : NULL;
+
+  if ((size_t) (in->end - in->ptr) < n)
+    {
+      in->ptr = in->end;
+      return NULL;
+    }
+  p = in->ptr;
+  in->ptr += n;
+  return p;
 }
 
 int
-gmon_io_read_32 (FILE *ifp, unsigned int *valp)
+gmon_io_read_32 (Gmon_In *in, unsigned int *valp)
 {
   char buf[4];
+  const char *p;
 
-  if (fread (buf, 1, 4, ifp) != 4)
+  p = gmon_io_next (in, buf, 4);
+  if (p == NULL)
     return 1;
-  *valp = bfd_get_32 (core_bfd, buf);
+  *valp = bfd_get_32 (core_bfd, p);
   return 0;
 }
 
 #ifdef BFD_HOST_U_64_BIT
 static int
-gmon_io_read_64 (FILE *ifp, BFD_HOST_U_64_BIT *valp)
+gmon_io_read_64 (Gmon_In *in, BFD_HOST_U_64_BIT *valp)
 {
   char buf[8];
+  const char *p;
 
-  if (fread (buf, 1, 8, ifp) != 8)
+  p = gmon_io_next (in, buf, 8);
+  if (p == NULL)
     return 1;
-  *valp = bfd_get_64 (core_bfd, buf);
+  *valp = bfd_get_64 (core_bfd, p);
   return 0;
 }
 #endif
 
 int
-gmon_io_read_vma (FILE *ifp, bfd_vma *valp)
+gmon_io_read_vma (Gmon_In *in, bfd_vma *valp)
 {
   unsigned int val32;
 #ifdef BFD_HOST_U_64_BIT
@@ -133,7 +351,7 @@ gmon_io_read_vma (FILE *ifp, bfd_vma *valp)
   switch (gmon_get_ptr_size ())
     {
     case ptr_32bit:
-      if (gmon_io_read_32 (ifp, &val32))
+      if (gmon_io_read_32 (in, &val32))
 	return 1;
       if (gmon_get_ptr_signedness () == ptr_signed)
         *valp = (int) val32;
@@ -143,7 +361,7 @@ gmon_io_read_vma (FILE *ifp, bfd_vma *valp)
 
 #ifdef BFD_HOST_U_64_BIT
     case ptr_64bit:
-      if (gmon_io_read_64 (ifp, &val64))
+      if (gmon_io_read_64 (in, &val64))
 	return 1;
 #ifdef BFD_HOST_64_BIT
       if (gmon_get_ptr_signedness () == ptr_signed)
@@ -158,13 +376,59 @@ gmon_io_read_vma (FILE *ifp, bfd_vma *valp)
 }
 
 int
-gmon_io_read (FILE *ifp, char *buf, size_t n)
+gmon_io_read (Gmon_In *in, char *buf, size_t n)
 {
-  if (fread (buf, 1, n, ifp) != n)
+  const char *p;
+
+  p = gmon_io_next (in, buf, n);
+  if (p == NULL)
     return 1;
+  if (p != buf)
+    memcpy (buf, p, n);
   return 0;
 }
 
+/* Read up to N items of SIZE bytes from IN into BUF, like fread.
+   Return the number of items read.  */
+
+size_t
+gmon_io_read_items (Gmon_In *in, void *buf, size_t size, size_t n)
+{
+  size_t avail;
+
+  if (in->fp != NULL)
+    return fread (buf, size, n, in->fp);
+
+  avail = (in->end - in->ptr) / size;
+  if (n > avail)
+    n = avail;
+  memcpy (buf, in->ptr, n * size);
+  in->ptr += n * size;
+  return n;
+}
+
+/* Skip over a variable length string in IN.  */
+
+void
+gmon_io_skip_string (Gmon_In *in)
+{
+  const char *nul;
+  int ch;
+
+  if (in->fp != NULL)
+    {
+      while ((ch = fgetc (in->fp)) != EOF)
+	{
+	  if (ch == '\0')
+	    break;
+	}
+      return;
+    }
+
+  nul = (const char *) memchr (in->ptr, '\0', in->end - in->ptr);
+  in->ptr = nul != NULL ? nul + 1 : in->end;
+}
+
 int
 gmon_io_write_32 (FILE *ofp, unsigned int val)
 {
@@ -229,29 +493,70 @@ gmon_io_write (FILE *ofp, char *buf, size_t n)
   return 0;
 }
 
+/* Read the body of a GMON_TAG_CG_ARC record, the caller's address,
+   the callee's address and the call count, from IN in one go.
+   Return 0 on success.  */
+
+int
+gmon_io_read_arc (Gmon_In *in, bfd_vma *from_pc, bfd_vma *self_pc,
+		  unsigned int *count)
+{
+  char buf[8 + 8 + 4];
+  unsigned int vma_size = gmon_vma_size ();
+  const char *p;
+
+  p = gmon_io_next (in, buf, 2 * vma_size + 4);
+  if (p == NULL)
+    return 1;
+  *from_pc = gmon_io_get_vma (p);
+  *self_pc = gmon_io_get_vma (p + vma_size);
+  *count = bfd_get_32 (core_bfd, p + 2 * vma_size);
+  return 0;
+}
+
+/* Write a complete GMON_TAG_CG_ARC record to OFP with one fwrite.
+   Return 0 on success.  */
+
+int
+gmon_io_write_arc (FILE *ofp, bfd_vma from_pc, bfd_vma self_pc,
+		   unsigned int count)
+{
+  char buf[1 + 8 + 8 + 4];
+  unsigned int vma_size = gmon_vma_size ();
+
+  bfd_put_8 (core_bfd, GMON_TAG_CG_ARC, buf);
+  gmon_io_put_vma (buf + 1, from_pc);
+  gmon_io_put_vma (buf + 1 + vma_size, self_pc);
+  bfd_put_32 (core_bfd, (bfd_vma) count, buf + 1 + 2 * vma_size);
+  if (fwrite (buf, 1, 1 + 2 * vma_size + 4, ofp) != 1 + 2 * vma_size + 4)
+    return 1;
+  return 0;
+}
+
 static int
-gmon_read_raw_arc (FILE *ifp, bfd_vma *fpc, bfd_vma *spc, unsigned long *cnt)
+gmon_read_raw_arc (Gmon_In *in, bfd_vma *fpc, bfd_vma *spc,
+		   unsigned long *cnt)
 {
 #ifdef BFD_HOST_U_64_BIT
   BFD_HOST_U_64_BIT cnt64;
 #endif
   unsigned int cnt32;
 
-  if (gmon_io_read_vma (ifp, fpc)
-      || gmon_io_read_vma (ifp, spc))
+  if (gmon_io_read_vma (in, fpc)
+      || gmon_io_read_vma (in, spc))
     return 1;
 
   switch (gmon_get_ptr_size ())
     {
     case ptr_32bit:
-      if (gmon_io_read_32 (ifp, &cnt32))
+      if (gmon_io_read_32 (in, &cnt32))
 	return 1;
       *cnt = cnt32;
       break;
 
 #ifdef BFD_HOST_U_64_BIT
     case ptr_64bit:
-      if (gmon_io_read_64 (ifp, &cnt64))
+      if (gmon_io_read_64 (in, &cnt64))
 	return 1;
       *cnt = cnt64;
       break;
@@ -288,32 +593,40 @@ gmon_write_raw_arc (FILE *ofp, bfd_vma fpc, bfd_vma spc, unsigned long cnt)
   return 0;
 }
 
+/* Tell the user what FILENAME contained, if they asked.  */
+
+static void
+gmon_print_info (const char *filename, int nhist, int narcs, int nbbs)
+{
+  if (output_style & STYLE_GMON_INFO)
+    {
+      printf (_("File `%s' (version %d) contains:\n"),
+	      filename, gmon_file_version);
+      printf (nhist == 1 ?
+	      _("\t%d histogram record\n") :
+	      _("\t%d histogram records\n"), nhist);
+      printf (narcs == 1 ?
+	      _("\t%d call-graph record\n") :
+	      _("\t%d call-graph records\n"), narcs);
+      printf (nbbs == 1 ?
+	      _("\t%d basic-block count record\n") :
+	      _("\t%d basic-block count records\n"), nbbs);
+      first_output = FALSE;
+    }
+}
+
 void
 gmon_out_read (const char *filename)
 {
-  FILE *ifp;
+  Gmon_In in;
   struct gmon_hdr ghdr;
   unsigned char tag;
   int nhist = 0, narcs = 0, nbbs = 0;
 
   /* Open gmon.out file.  */
-  if (strcmp (filename, "-") == 0)
-    {
-      ifp = stdin;
-      SET_BINARY (fileno (stdin));
-    }
-  else
-    {
-      ifp = fopen (filename, FOPEN_RB);
+  gmon_io_open (&in, filename);
 
-      if (!ifp)
-	{
-	  perror (filename);
-	  done (1);
-	}
-    }
-
-  if (fread (&ghdr, sizeof (struct gmon_hdr), 1, ifp) != 1)
+  if (gmon_io_read (&in, (char *) &ghdr, sizeof (struct gmon_hdr)))
     {
       fprintf (stderr, _("%s: file too short to be a gmon file\n"),
 	       filename);
@@ -342,26 +655,26 @@ gmon_out_read (const char *filename)
 	}
 
       /* Read in all the records.  */
-      while (fread (&tag, sizeof (tag), 1, ifp) == 1)
+      while (gmon_io_read (&in, (char *) &tag, sizeof (tag)) == 0)
 	{
 	  switch (tag)
 	    {
 	    case GMON_TAG_TIME_HIST:
 	      ++nhist;
 	      gmon_input |= INPUT_HISTOGRAM;
-	      hist_read_rec (ifp, filename);
+	      hist_read_rec (&in, filename);
 	      break;
 
 	    case GMON_TAG_CG_ARC:
 	      ++narcs;
 	      gmon_input |= INPUT_CALL_GRAPH;
-	      cg_read_rec (ifp, filename);
+	      cg_read_rec (&in, filename);
 	      break;
 
 	    case GMON_TAG_BB_COUNT:
 	      ++nbbs;
 	      gmon_input |= INPUT_BB_COUNTS;
-	      bb_read_rec (ifp, filename);
+	      bb_read_rec (&in, filename);
 	      break;
 
 	    default:
@@ -398,7 +711,7 @@ gmon_out_read (const char *filename)
       /* This fseek() ought to work even on stdin as long as it's
 	 not an interactive device (heck, is there anybody who would
 	 want to type in a gmon.out at the terminal?).  */
-      if (fseek (ifp, 0, SEEK_SET) < 0)
+      if (gmon_io_seek (&in, 0) < 0)
 	{
 	  perror (filename);
 	  done (1);
@@ -406,9 +719,9 @@ gmon_out_read (const char *filename)
 
       /* The beginning of the old BSD header and the 4.4BSD header
 	 are the same: lowpc, highpc, ncnt  */
-      if (gmon_io_read_vma (ifp, &tmp.low_pc)
-          || gmon_io_read_vma (ifp, &tmp.high_pc)
-          || gmon_io_read_32 (ifp, &tmp.ncnt))
+      if (gmon_io_read_vma (&in, &tmp.low_pc)
+          || gmon_io_read_vma (&in, &tmp.high_pc)
+          || gmon_io_read_32 (&in, &tmp.ncnt))
 	{
  bad_gmon_file:
           fprintf (stderr, _("%s: file too short to be a gmon file\n"),
@@ -417,7 +730,7 @@ gmon_out_read (const char *filename)
 	}
 
       /* Check to see if this a 4.4BSD-style header.  */
-      if (gmon_io_read_32 (ifp, &version))
+      if (gmon_io_read_32 (&in, &version))
 	goto bad_gmon_file;
 
       if (version == GMONVERSION)
@@ -425,7 +738,7 @@ gmon_out_read (const char *filename)
 	  unsigned int profrate;
 
 	  /* 4.4BSD format header.  */
-          if (gmon_io_read_32 (ifp, &profrate))
+          if (gmon_io_read_32 (&in, &profrate))
 	    goto bad_gmon_file;
 
 	  if (!histograms)
@@ -472,7 +785,7 @@ gmon_out_read (const char *filename)
 	}
 
       /* Position the file to after the header.  */
-      if (fseek (ifp, header_size, SEEK_SET) < 0)
+      if (gmon_io_seek (&in, header_size) < 0)
 	{
 	  perror (filename);
 	  done (1);
@@ -524,7 +837,8 @@ gmon_out_read (const char *filename)
 
       for (i = 0; i < hist_num_bins; ++i)
 	{
-	  if (fread (raw_bin_count, sizeof (raw_bin_count), 1, ifp) != 1)
+	  if (gmon_io_read (&in, (char *) raw_bin_count,
+			    sizeof (raw_bin_count)))
 	    {
 	      fprintf (stderr,
 		       _("%s: unexpected EOF after reading %d/%d bins\n"),
@@ -538,7 +852,7 @@ gmon_out_read (const char *filename)
 
       /* The rest of the file consists of a bunch of
 	 <from,self,count> tuples.  */
-      while (gmon_read_raw_arc (ifp, &from_pc, &self_pc, &count) == 0)
+      while (gmon_read_raw_arc (&in, &from_pc, &self_pc, &count) == 0)
 	{
 	  ++narcs;
 
@@ -570,24 +884,340 @@ gmon_out_read (const char *filename)
       done (1);
     }
 
-  if (ifp != stdin)
-    fclose (ifp);
+  gmon_io_close (&in);
 
-  if (output_style & STYLE_GMON_INFO)
+  gmon_print_info (filename, nhist, narcs, nbbs);
+}
+
+#ifdef GMON_IO_THREADS
+
+/* The most threads to read gmon files with.  */
+#define GMON_IO_MAX_THREADS 16
+
+/* An arc read by a worker thread, with the symbols cg_lookup_arc
+   found for it.  */
+
+struct gmon_arc
+{
+  Sym *parent;
+  Sym *child;
+  unsigned int count;
+};
+
+/* A gmon file read by a worker thread, for the main thread to add to
+   the profile.  */
+
+struct gmon_file
+{
+  const char *filename;
+  int done;			/* Has its worker finished with it?  */
+  int ok;			/* Was it read without surprises?  */
+  Gmon_In in;			/* Its mapped contents.  */
+  const char **recs;		/* Its histogram and basic-block records.  */
+  unsigned int nrecs;
+  struct gmon_arc *arcs;	/* Its arcs between known symbols.  */
+  size_t nknown_arcs;
+  int nhist, narcs, nbbs;
+};
+
+/* The files being read, shared with the worker threads under LOCK.  */
+
+static struct
+{
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+  struct gmon_file *files;
+  int nfiles;
+  int next;			/* The next file for a worker to read.  */
+  int limit;			/* Workers wait before reading this one.  */
+} gmon_read;
+
+/* Read FILE, which should be in the current gmon.out format, without
+   changing any global state, so that worker threads can do this for
+   several files at once.  Anything unusual leaves FILE->ok clear, and
+   the main thread then reads the file with gmon_out_read, which
+   reports the problem.  */
+
+static void
+gmon_scan_file (struct gmon_file *file)
+{
+  unsigned int vma_size = gmon_vma_size ();
+  const struct gmon_hdr *ghdr;
+  Sym *last_parent = NULL;
+  Sym *parent, *child;
+  size_t recs_size = 0, arcs_size = 0;
+  const char *p, *end;
+
+  if (strcmp (file->filename, "-") == 0
+      || !gmon_io_map (&file->in, file->filename))
+    return;
+
+  p = file->in.base;
+  end = file->in.end;
+  ghdr = (const struct gmon_hdr *) p;
+  if ((size_t) (end - p) < sizeof (struct gmon_hdr)
+      || strncmp (&ghdr->cookie[0], GMON_MAGIC, 4) != 0
+      || bfd_get_32 (core_bfd, ghdr->version) != GMON_VERSION)
+    return;
+  p += sizeof (struct gmon_hdr);
+
+  while (p < end)
     {
-      printf (_("File `%s' (version %d) contains:\n"),
-	      filename, gmon_file_version);
-      printf (nhist == 1 ?
-	      _("\t%d histogram record\n") :
-	      _("\t%d histogram records\n"), nhist);
-      printf (narcs == 1 ?
-	      _("\t%d call-graph record\n") :
-	      _("\t%d call-graph records\n"), narcs);
-      printf (nbbs == 1 ?
-	      _("\t%d basic-block count record\n") :
-	      _("\t%d basic-block count records\n"), nbbs);
-      first_output = FALSE;
+      const char *rec = p++;
+      bfd_vma from_pc, self_pc;
+      unsigned int n;
+
+      switch (*(const unsigned char *) rec)
+	{
+	case GMON_TAG_TIME_HIST:
+	  /* The address range, the number of bins, the profiling rate
+	     and the dimension, then the bins.  */
+	  if ((size_t) (end - p) < 2 * vma_size + 4 + 4 + 15 + 1)
+	    return;
+	  n = bfd_get_32 (core_bfd, p + 2 * vma_size);
+	  p += 2 * vma_size + 4 + 4 + 15 + 1;
+	  if ((size_t) (end - p) / sizeof (UNIT) < n)
+	    return;
+	  p += n * sizeof (UNIT);
+	  ++file->nhist;
+	  break;
+
+	case GMON_TAG_CG_ARC:
+	  if ((size_t) (end - p) < 2 * vma_size + 4)
+	    return;
+	  from_pc = gmon_io_get_vma (p);
+	  self_pc = gmon_io_get_vma (p + vma_size);
+	  n = bfd_get_32 (core_bfd, p + 2 * vma_size);
+	  p += 2 * vma_size + 4;
+	  ++file->narcs;
+
+	  if (cg_lookup_arc (from_pc, self_pc, &last_parent, &parent, &child))
+	    {
+	      if (file->nknown_arcs == arcs_size)
+		{
+		  arcs_size = arcs_size ? 2 * arcs_size : 1024;
+		  file->arcs = (struct gmon_arc *)
+		    xrealloc (file->arcs, arcs_size * sizeof (struct gmon_arc));
+		}
+	      file->arcs[file->nknown_arcs].parent = parent;
+	      file->arcs[file->nknown_arcs].child = child;
+	      file->arcs[file->nknown_arcs].count = n;
+	      ++file->nknown_arcs;
+	    }
+	  continue;
+
+	case GMON_TAG_BB_COUNT:
+	  /* The number of blocks, then an address and count for each.  */
+	  if ((size_t) (end - p) < 4)
+	    return;
+	  n = bfd_get_32 (core_bfd, p);
+	  p += 4;
+	  if ((size_t) (end - p) / (2 * vma_size) < n)
+	    return;
+	  p += (size_t) n * 2 * vma_size;
+	  ++file->nbbs;
+	  break;
+
+	default:
+	  return;
+	}
+
+      if (file->nrecs == recs_size)
+	{
+	  recs_size = recs_size ? 2 * recs_size : 16;
+	  file->recs = (const char **)
+	    xrealloc (file->recs, recs_size * sizeof (const char *));
+	}
+      file->recs[file->nrecs++] = rec;
+    }
+
+  file->ok = 1;
+}
+
+/* Add FILE, read by a worker thread, to the profile just as
+   gmon_out_read would have.  */
+
+static void
+gmon_add_file (struct gmon_file *file)
+{
+  unsigned int i;
+  size_t j;
+
+  if (!file->ok)
+    {
+      gmon_out_read (file->filename);
+      return;
+    }
+
+  gmon_file_version = GMON_VERSION;
+
+  for (i = 0; i < file->nrecs; ++i)
+    {
+      Gmon_In in = file->in;
+
+      in.ptr = file->recs[i] + 1;
+      switch (*(const unsigned char *) file->recs[i])
+	{
+	case GMON_TAG_TIME_HIST:
+	  gmon_input |= INPUT_HISTOGRAM;
+	  hist_read_rec (&in, file->filename);
+	  break;
+
+	case GMON_TAG_BB_COUNT:
+	  gmon_input |= INPUT_BB_COUNTS;
+	  bb_read_rec (&in, file->filename);
+	  break;
+	}
     }
+
+  if (file->narcs != 0)
+    gmon_input |= INPUT_CALL_GRAPH;
+  for (j = 0; j < file->nknown_arcs; ++j)
+    cg_tally_arc (file->arcs[j].parent, file->arcs[j].child,
+		  file->arcs[j].count);
+
+  gmon_print_info (file->filename, file->nhist, file->narcs, file->nbbs);
+}
+
+static void
+gmon_free_file (struct gmon_file *file)
+{
+  if (file->in.base != NULL)
+    gmon_io_close (&file->in);
+  free (file->recs);
+  free (file->arcs);
+  file->recs = NULL;
+  file->arcs = NULL;
+}
+
+static void *
+gmon_read_worker (void *arg ATTRIBUTE_UNUSED)
+{
+  int i;
+
+  pthread_mutex_lock (&gmon_read.lock);
+  for (;;)
+    {
+      while (gmon_read.next < gmon_read.nfiles
+	     && gmon_read.next >= gmon_read.limit)
+	pthread_cond_wait (&gmon_read.cond, &gmon_read.lock);
+      if (gmon_read.next >= gmon_read.nfiles)
+	break;
+      i = gmon_read.next++;
+      pthread_mutex_unlock (&gmon_read.lock);
+
+      gmon_scan_file (&gmon_read.files[i]);
+
+      pthread_mutex_lock (&gmon_read.lock);
+      gmon_read.files[i].done = 1;
+      pthread_cond_broadcast (&gmon_read.cond);
+    }
+  pthread_mutex_unlock (&gmon_read.lock);
+  return NULL;
+}
+
+/* Read the NFILES gmon files FILENAMES with worker threads.  Return
+   zero, having read none of them, if threads are of no use here.  */
+
+static int
+gmon_read_files_in_threads (const char **filenames, int nfiles)
+{
+  pthread_t threads[GMON_IO_MAX_THREADS];
+  long nthreads = 1;
+  int ahead, started, i;
+
+  /* Debugging output is printed as the records are read, and the BSD
+     formats are rarely used; read those files one by one.  */
+  if (nfiles < 2
+      || debug_level != 0
+      || (file_format != FF_AUTO && file_format != FF_MAGIC))
+    return 0;
+
+#ifdef _SC_NPROCESSORS_ONLN
+  nthreads = sysconf (_SC_NPROCESSORS_ONLN);
+#endif
+  if (nthreads > nfiles)
+    nthreads = nfiles;
+  if (nthreads > GMON_IO_MAX_THREADS)
+    nthreads = GMON_IO_MAX_THREADS;
+  if (nthreads < 2)
+    return 0;
+
+  /* The workers use these caches, so fill them now.  */
+  gmon_get_ptr_size ();
+  gmon_get_ptr_signedness ();
+
+  /* Keep the number of files read but not yet added bounded, as their
+     arcs take memory.  */
+  ahead = 2 * nthreads;
+
+  gmon_read.files = (struct gmon_file *)
+    xcalloc (nfiles, sizeof (struct gmon_file));
+  for (i = 0; i < nfiles; ++i)
+    gmon_read.files[i].filename = filenames[i];
+  gmon_read.nfiles = nfiles;
+  gmon_read.next = 0;
+  gmon_read.limit = ahead;
+  pthread_mutex_init (&gmon_read.lock, NULL);
+  pthread_cond_init (&gmon_read.cond, NULL);
+
+  for (started = 0; started < nthreads; ++started)
+    if (pthread_create (&threads[started], NULL, gmon_read_worker, NULL) != 0)
+      break;
+
+  if (started != 0)
+    {
+      /* Add the files to the profile in order, as the workers finish
+	 reading them.  */
+      for (i = 0; i < nfiles; ++i)
+	{
+	  struct gmon_file *file = &gmon_read.files[i];
+
+	  pthread_mutex_lock (&gmon_read.lock);
+	  while (!file->done)
+	    pthread_cond_wait (&gmon_read.cond, &gmon_read.lock);
+	  pthread_mutex_unlock (&gmon_read.lock);
+
+	  gmon_add_file (file);
+	  gmon_free_file (file);
+
+	  pthread_mutex_lock (&gmon_read.lock);
+	  gmon_read.limit = i + 1 + ahead;
+	  pthread_cond_broadcast (&gmon_read.cond);
+	  pthread_mutex_unlock (&gmon_read.lock);
+	}
+
+      while (started > 0)
+	pthread_join (threads[--started], NULL);
+      i = 1;
+    }
+  else
+    i = 0;
+
+  pthread_cond_destroy (&gmon_read.cond);
+  pthread_mutex_destroy (&gmon_read.lock);
+  free (gmon_read.files);
+  gmon_read.files = NULL;
+  return i;
+}
+
+#endif /* GMON_IO_THREADS */
+
+/* Read the NFILES gmon files FILENAMES and sum them, in order.  When
+   threads are available, several files are read at once.  */
+
+void
+gmon_out_read_files (const char **filenames, int nfiles)
+{
+  int i;
+
+#ifdef GMON_IO_THREADS
+  if (gmon_read_files_in_threads (filenames, nfiles))
+    return;
+#endif
+
+  for (i = 0; i < nfiles; ++i)
+    gmon_out_read (filenames[i]);
 }
 
 
@@ -603,11 +1233,13 @@ gmon_out_write (const char *filename)
       perror (filename);
       done (1);
     }
+  setvbuf (ofp, NULL, _IOFBF, GMON_IO_BUFSIZE);
 
   if (file_format == FF_AUTO || file_format == FF_MAGIC)
     {
       /* Write gmon header.  */
 
+      memset (&ghdr, 0, sizeof (ghdr));
       memcpy (&ghdr.cookie[0], GMON_MAGIC, 4);
       bfd_put_32 (core_bfd, (bfd_vma) GMON_VERSION, (bfd_byte *) ghdr.version);
 
@@ -29,15 +29,35 @@
 extern int gmon_input;		/* What input did we see?  */
 extern int gmon_file_version;	/* File version are we dealing with.  */
 
-extern int gmon_io_read_vma (FILE *ifp, bfd_vma *valp);
-extern int gmon_io_read_32 (FILE *ifp, unsigned int *valp);
-extern int gmon_io_read (FILE *ifp, char *buf, size_t n);
+/* A gmon file being read.  Its contents are either mapped into memory,
+   from BASE to END with PTR pointing to the next byte to read, or read
+   through the stdio stream FP.  */
+typedef struct gmon_in
+  {
+    FILE *fp;			/* stream, or NULL if mapped */
+    const char *base;		/* start of the mapped contents */
+    const char *ptr;		/* next byte to read */
+    const char *end;		/* end of the mapped contents */
+  }
+Gmon_In;
+
+extern int gmon_io_read_vma (Gmon_In *in, bfd_vma *valp);
+extern int gmon_io_read_32 (Gmon_In *in, unsigned int *valp);
+extern int gmon_io_read (Gmon_In *in, char *buf, size_t n);
+extern size_t gmon_io_read_items (Gmon_In *in, void *buf, size_t size,
+				  size_t n);
+extern void gmon_io_skip_string (Gmon_In *in);
 extern int gmon_io_write_vma (FILE *ifp, bfd_vma val);
 extern int gmon_io_write_32 (FILE *ifp, unsigned int val);
 extern int gmon_io_write_8 (FILE *ifp, unsigned int val);
 extern int gmon_io_write (FILE *ifp, char *buf, size_t n);
+extern int gmon_io_read_arc (Gmon_In *in, bfd_vma *from_pc,
+			     bfd_vma *self_pc, unsigned int *count);
+extern int gmon_io_write_arc (FILE *ofp, bfd_vma from_pc, bfd_vma self_pc,
+			      unsigned int count);
 
 extern void gmon_out_read   (const char *);
+extern void gmon_out_read_files (const char **, int);
 extern void gmon_out_write  (const char *);
 
 #endif /* gmon_io_h */
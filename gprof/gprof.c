@@ -545,14 +545,17 @@ This program is free software.  This program has absolutely no warranty.\n"));
     }
   else
     {
+      const char **gmon_names;
+      int num_gmon_names = 0;
+
       /* Get information about gmon.out file(s).  */
-      do
-	{
-	  gmon_out_read (gmon_name);
-	  if (optind < argc)
-	    gmon_name = argv[optind];
-	}
-      while (optind++ < argc);
+      gmon_names = (const char **) xmalloc ((argc - optind + 1)
+					    * sizeof (const char *));
+      gmon_names[num_gmon_names++] = gmon_name;
+      while (optind < argc)
+	gmon_names[num_gmon_names++] = argv[optind++];
+      gmon_out_read_files (gmon_names, num_gmon_names);
+      free (gmon_names);
     }
 
   /* If user did not specify output style, try to guess something
@@ -577,6 +580,11 @@ This program is free software.  This program has absolutely no warranty.\n"));
   if (output_style & STYLE_SUMMARY_FILE)
     {
       gmon_out_write (GMONSUM);
+
+      /* When only summing profiles, there is no need to assign the
+	 samples to symbols or to put the call graph together.  */
+      if (output_style == STYLE_SUMMARY_FILE)
+	return 0;
     }
 
   if (gmon_input & INPUT_HISTOGRAM)
@@ -79,7 +79,7 @@ SItab[] =
 };
 
 /* Reads just the header part of histogram record into
-   *RECORD from IFP.  FILENAME is the name of IFP and
+   *RECORD from IN.  FILENAME is the name of IN and
    is provided for formatting error messages only.
 
    If FIRST is non-zero, sets global variables HZ, HIST_DIMENSION,
@@ -88,7 +88,7 @@ SItab[] =
    of those variables and emits an error if that's not so.  */
 static void
 read_histogram_header (histogram *record,
-		       FILE *ifp, const char *filename,
+		       Gmon_In *in, const char *filename,
 		       int first)
 {
   unsigned int profrate;
@@ -96,12 +96,12 @@ read_histogram_header (histogram *record,
   char n_hist_dimension_abbrev;
   double n_hist_scale;
 
-  if (gmon_io_read_vma (ifp, &record->lowpc)
-      || gmon_io_read_vma (ifp, &record->highpc)
-      || gmon_io_read_32 (ifp, &record->num_bins)
-      || gmon_io_read_32 (ifp, &profrate)
-      || gmon_io_read (ifp, n_hist_dimension, 15)
-      || gmon_io_read (ifp, &n_hist_dimension_abbrev, 1))
+  if (gmon_io_read_vma (in, &record->lowpc)
+      || gmon_io_read_vma (in, &record->highpc)
+      || gmon_io_read_32 (in, &record->num_bins)
+      || gmon_io_read_32 (in, &profrate)
+      || gmon_io_read (in, n_hist_dimension, 15)
+      || gmon_io_read (in, &n_hist_dimension_abbrev, 1))
     {
       fprintf (stderr, _("%s: %s: unexpected end of file\n"),
 	       whoami, filename);
@@ -162,11 +162,11 @@ read_histogram_header (histogram *record,
     }
 }
 
-/* Read the histogram from file IFP.  FILENAME is the name of IFP and
+/* Read the histogram from file IN.  FILENAME is the name of IN and
    is provided for formatting error messages only.  */
 
 void
-hist_read_rec (FILE * ifp, const char *filename)
+hist_read_rec (Gmon_In *in, const char *filename)
 {
   bfd_vma lowpc, highpc;
   histogram n_record;
@@ -175,7 +175,7 @@ hist_read_rec (FILE * ifp, const char *filename)
 
   /* 1. Read the header and see if there's existing record for the
      same address range and that there are no overlapping records.  */
-  read_histogram_header (&n_record, ifp, filename, num_histograms == 0);
+  read_histogram_header (&n_record, in, filename, num_histograms == 0);
 
   existing_record = find_histogram (n_record.lowpc, n_record.highpc);
   if (existing_record)
@@ -220,23 +220,35 @@ hist_read_rec (FILE * ifp, const char *filename)
 	       (unsigned long) record->lowpc, (unsigned long) record->highpc,
                record->num_bins));
 
-  for (i = 0; i < record->num_bins; ++i)
+  for (i = 0; i < record->num_bins;)
     {
-      UNIT count;
-      if (fread (&count[0], sizeof (count), 1, ifp) != 1)
+      UNIT counts[1024];
+      size_t n, got, j;
+
+      /* Read the samples a block at a time.  */
+      n = record->num_bins - i;
+      if (n > ARRAY_SIZE (counts))
+	n = ARRAY_SIZE (counts);
+      got = gmon_io_read_items (in, counts, sizeof (counts[0]), n);
+
+      for (j = 0; j < got; ++j, ++i)
+	{
+	  record->sample[i] += bfd_get_16 (core_bfd, (bfd_byte *) counts[j]);
+	  DBG (SAMPLEDEBUG,
+	       printf ("[hist_read_rec] 0x%lx: %u\n",
+		       (unsigned long) (record->lowpc
+					+ i * (record->highpc - record->lowpc)
+					/ record->num_bins),
+		       record->sample[i]));
+	}
+
+      if (got != n)
 	{
 	  fprintf (stderr,
 		  _("%s: %s: unexpected EOF after reading %u of %u samples\n"),
 		   whoami, filename, i, record->num_bins);
 	  done (1);
 	}
-      record->sample[i] += bfd_get_16 (core_bfd, (bfd_byte *) & count[0]);
-      DBG (SAMPLEDEBUG,
-	   printf ("[hist_read_rec] 0x%lx: %u\n",
-		   (unsigned long) (record->lowpc
-                                    + i * (record->highpc - record->lowpc)
-                                    / record->num_bins),
-		   record->sample[i]));
     }
 }
 
@@ -37,7 +37,9 @@ extern unsigned    num_histograms;
    each sample covers HIST_SCALE bytes.  */
 extern double hist_scale;
 
-extern void hist_read_rec        (FILE *, const char *);
+struct gmon_in;
+
+extern void hist_read_rec        (struct gmon_in *, const char *);
 extern void hist_write_hist      (FILE *, const char *);
 extern void hist_assign_samples  (void);
 extern void hist_print           (void);
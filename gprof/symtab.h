@@ -78,6 +78,8 @@ typedef struct sym
 	double child_time;	/* Cumulative ticks in children.  */
 	int index;		/* Index in the graph list.  */
 	int top_order;		/* Graph call chain top-sort order.  */
+	int dfn_index;		/* Depth-first visiting order.  */
+	int low_link;		/* Lowest dfn_index reachable.  */
 	bfd_boolean print_flag;	/* Should this be printed?  */
 	struct
 	  {
@@ -0,0 +1,127 @@
+#!/bin/sh
+# Check the call graph gprof prints, the removal of arcs with -k, the
+# summing of profiles, and the source lines gprof -l attributes to
+# functions.
+# Copyright (C) 2017 Free Software Foundation, Inc.
+#
+# This file is part of GNU Binutils.
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# Usage: tst-gmon-gprof.sh CC GPROF SRCDIR
+#
+# The program is built with CC -pg and run here, so the test is only
+# meaningful for a native gprof.  It passes as UNSUPPORTED if CC can
+# not build or run a profiled program.
+
+CC=$1
+GPROF=$2
+srcdir=$3
+
+status=0
+
+rm -f tst-gmon gmon.out tst-gmon.out
+if ! $CC -pg -O0 -o tst-gmon $srcdir/tst-gmon.c > /dev/null 2>&1 \
+   || ! ./tst-gmon || ! test -f gmon.out; then
+  echo "UNSUPPORTED: tst-gmon-gprof.sh"
+  exit 0
+fi
+
+# Print the children listed in the call graph entry of CALLER.
+children ()
+{
+  $GPROF -b -q "$@" tst-gmon gmon.out > tst-gmon.out || return 1
+  sed -n '/^\[[0-9]*\].* caller \[[0-9]*\]$/,/^---/p' tst-gmon.out \
+    | sed -n '2,$s/^.* \([a-z_]*\) \[[0-9]*\]$/\1/p' | LC_ALL=C sort \
+    | tr '\n' ' '
+}
+
+check ()
+{
+  name=$1
+  expected=$2
+  shift 2
+  actual=`children "$@"`
+  if test "$actual" = "$expected"; then
+    echo "PASS: $name"
+  else
+    echo "FAIL: $name: expected \"$expected\", got \"$actual\""
+    status=1
+  fi
+}
+
+check "gprof call graph" "callee_a callee_b "
+check "gprof -k caller/callee_a" "callee_b " -kcaller/callee_a
+check "gprof -k caller/callee_b" "callee_a " -k caller/callee_b
+check "gprof -k callee_a/caller" "callee_a callee_b " -kcallee_a/caller
+
+# Print the number of calls of callee_a in the flat profile of the
+# given profile data files.
+calls ()
+{
+  $GPROF -b -p tst-gmon "$@" > tst-gmon.out || return 1
+  awk '$NF == "callee_a" { print $4 }' tst-gmon.out
+}
+
+check_calls ()
+{
+  name=$1
+  expected=$2
+  shift 2
+  actual=`calls "$@"`
+  if test "$actual" = "$expected"; then
+    echo "PASS: $name"
+  else
+    echo "FAIL: $name: expected $expected calls, got \"$actual\""
+    status=1
+  fi
+}
+
+rm -f gmon.sum
+check_calls "gprof two files" 200 gmon.out gmon.out
+if $GPROF -s tst-gmon gmon.out gmon.out > tst-gmon.out \
+   && test -f gmon.sum && ! test -s tst-gmon.out; then
+  echo "PASS: gprof -s"
+else
+  echo "FAIL: gprof -s"
+  status=1
+fi
+check_calls "gprof gmon.sum" 200 gmon.sum
+check_calls "gprof gmon.sum gmon.out" 300 gmon.sum gmon.out
+
+# With -l, each function is named with the line of its opening brace,
+# which follows the line of its name.  DWARF 2 line tables are used as
+# they can be read by any version of BFD and written by any compiler.
+rm -f gmon.out
+if ! $CC -pg -O0 -gdwarf-2 -o tst-gmon $srcdir/tst-gmon.c > /dev/null 2>&1 \
+   || ! ./tst-gmon || ! test -f gmon.out; then
+  echo "UNSUPPORTED: gprof -l"
+else
+  $GPROF -b -l -q tst-gmon gmon.out > tst-gmon.out
+  for func in callee_a callee_b caller; do
+    line=`sed -n "/^$func (void)$/=" $srcdir/tst-gmon.c`
+    line=`expr $line + 1`
+    if grep " $func (tst-gmon.c:$line @ " tst-gmon.out > /dev/null; then
+      echo "PASS: gprof -l $func"
+    else
+      echo "FAIL: gprof -l $func: expected line $line"
+      status=1
+    fi
+  done
+fi
+
+rm -f tst-gmon gmon.out gmon.sum tst-gmon.out
+exit $status
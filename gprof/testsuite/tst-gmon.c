@@ -0,0 +1,56 @@
+/* tst-gmon.c -- a program to profile for tst-gmon-gprof.sh.
+
+   Copyright (C) 2017 Free Software Foundation, Inc.
+
+   This file is part of GNU Binutils.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.  */
+
+/* CALLER calls both CALLEE_A and CALLEE_B, so that the arc to one of
+   them can be removed with -k while the other one stays.  */
+
+int calls;
+
+void __attribute__ ((noinline))
+callee_a (void)
+{
+  calls++;
+}
+
+void __attribute__ ((noinline))
+callee_b (void)
+{
+  calls += 2;
+}
+
+void __attribute__ ((noinline))
+caller (void)
+{
+  int i;
+
+  for (i = 0; i < 100; i++)
+    {
+      callee_a ();
+      callee_b ();
+    }
+}
+
+int
+main (void)
+{
+  caller ();
+  return calls != 300;
+}
@@ -136,6 +136,12 @@ extern const struct demangler_engine
 extern char *
 cplus_demangle (const char *mangled, int options);
 
+/* Like cplus_demangle, but allocate the result on OB instead of with
+   malloc.  */
+struct obstack;
+extern char *
+cplus_demangle_obstack (const char *mangled, int options, struct obstack *ob);
+
 extern int
 cplus_demangle_opname (const char *opname, char *result, int options);
 
@@ -552,6 +552,7 @@
 #define ELFCOMPRESS_ZLIB   1		/* Compressed with zlib.  */
 #define ELFCOMPRESS_LOOS   0x60000000	/* OS-specific semantics, lo */
 #define ELFCOMPRESS_HIOS   0x6FFFFFFF	/* OS-specific semantics, hi */
+#define ELFCOMPRESS_ZLIB_CHUNKED 0x60000001 /* zlib with restart points.  */
 #define ELFCOMPRESS_LOPROC 0x70000000	/* Processor-specific semantics, lo */
 #define ELFCOMPRESS_HIPROC 0x7FFFFFFF	/* Processor-specific semantics, hi */
 
@@ -160,6 +160,12 @@ struct host_callback_struct
     char *buffer;
   } pipe_buffer[MAX_CALLBACK_FDS];
 
+  /* The file name and host open flags each target fd was opened with,
+     so that a simulator checkpoint can open it again.  NULL for fds
+     that were not opened by name (stdin/stdout/stderr and pipes).  */
+  char *fd_name[MAX_CALLBACK_FDS];
+  int fd_flags[MAX_CALLBACK_FDS];
+
   /* System call numbers.  */
   CB_TARGET_DEFS_MAP *syscall_map;
   /* Errno values.  */
@@ -338,6 +344,16 @@ int cb_is_stdin (host_callback *, int);
 int cb_is_stdout (host_callback *, int);
 int cb_is_stderr (host_callback *, int);
 
+/* Describe target fd FD for a checkpoint: set *NAME, *FLAGS and
+   *OFFSET and return 1 if it can be opened again by name, return 0 if
+   it is closed or is one of the standard fds, which are always open,
+   and -1 if it is open but cannot be recreated.  */
+int cb_save_fd (host_callback *, int, const char **, int *, long *);
+
+/* Reopen target fd FD as described by cb_save_fd.  Return 0 on
+   success, -1 on error.  */
+int cb_restore_fd (host_callback *, int, const char *, int, long);
+
 /* Read a string out of the target.  */
 int cb_get_string (host_callback *, CB_SYSCALL *, char *, int, unsigned long);
 
@@ -238,6 +238,49 @@ void sim_info (SIM_DESC sd, int verbose);
 void sim_resume (SIM_DESC sd, int step, int siggnal);
 
 
+/* Resume the simulated program and keep it running while the program
+   counter stays within [START, END), as when stepping over a source
+   line.  The simulation stops with SIGTRAP at the first instruction
+   outside the range, or earlier for any of the reasons sim_resume
+   stops.  SIGGNAL is as for sim_resume.
+
+   Return zero, without resuming, if the simulator cannot step a range;
+   the caller should then single step with sim_resume.  */
+
+int sim_resume_range (SIM_DESC sd, SIM_ADDR start, SIM_ADDR end,
+		      int siggnal);
+
+
+/* Return nonzero if the simulator implements sim_insert_breakpoint,
+   sim_remove_breakpoint and sim_resume_range.  This has no other
+   effect.  */
+
+int sim_breakpoints_supported (SIM_DESC sd);
+
+
+/* Set a breakpoint at ADDR without writing to the simulated program's
+   memory, replacing any breakpoint already set there.  If NR_CONDITIONS
+   is zero the simulation stops with SIGTRAP every time ADDR is about
+   to execute.  Otherwise CONDITIONS[I] is an agent expression (see
+   gdb/common/ax.def) of LENGTHS[I] bytes, in which register numbers are
+   the simulator's, and the simulation only stops if one of them
+   evaluates to non-zero or cannot be evaluated.  The expressions are
+   copied.
+
+   Return zero if the simulator does not support such breakpoints.  */
+
+int sim_insert_breakpoint (SIM_DESC sd, SIM_ADDR addr, int nr_conditions,
+			   const unsigned char * const *conditions,
+			   const int *lengths);
+
+
+/* Remove the breakpoint set at ADDR by sim_insert_breakpoint, if any.
+
+   Return zero if the simulator does not support such breakpoints.  */
+
+int sim_remove_breakpoint (SIM_DESC sd, SIM_ADDR addr);
+
+
 /* Asynchronous request to stop the simulation.
    A nonzero return indicates that the simulator is able to handle
    the request */
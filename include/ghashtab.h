@@ -0,0 +1,134 @@
+/* An expandable hash table probing control bytes in groups.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston, MA 02110-1301, USA.  */
+
+/* This package provides the same operations as hashtab.h, with the
+   same callbacks and the same meaning for every function: a table
+   built with htab_create_alloc can be switched to ghtab_create_alloc
+   by renaming the htab_ calls to ghtab_.
+
+   The difference is in the layout.  Next to the array of entries the
+   table keeps one control byte per slot, recording whether the slot is
+   empty, deleted, or full, and for a full slot seven bits of the
+   element's hash.  A lookup scans the control bytes of 16 slots at a
+   time and only calls the equality function on the entries whose hash
+   bits match, so that a search usually touches one cache line of
+   control bytes and one entry, instead of one entry per probe.
+
+   Unlike hashtab.h, a slot returned by ghtab_find_slot with INSERT for
+   an element not in the table is already counted as full: the caller
+   must store a non-NULL entry there.  */
+
+#ifndef __GHASHTAB_H__
+#define __GHASHTAB_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#include "hashtab.h"
+
+/* Hash tables are of the following type.  The structure
+   (implementation) of this type is not needed for using the hash
+   tables.  All work with hash table should be executed only through
+   functions mentioned below.  The size of this structure is subject to
+   change.  */
+
+struct ghtab {
+  /* Pointer to hash function.  */
+  htab_hash hash_f;
+
+  /* Pointer to comparison function.  */
+  htab_eq eq_f;
+
+  /* Pointer to cleanup function.  */
+  htab_del del_f;
+
+  /* Table itself, SIZE entries.  */
+  void **entries;
+
+  /* One control byte per entry.  */
+  unsigned char *ctrl;
+
+  /* Current size (in entries) of the hash table.  Always a power of
+     two, and a multiple of the group size.  */
+  size_t size;
+
+  /* Current number of elements.  */
+  size_t n_elements;
+
+  /* Current number of deleted elements in the table.  */
+  size_t n_deleted;
+
+  /* The following member is used for debugging.  Its value is number
+     of all calls of `ghtab_find_slot' for the hash table.  */
+  unsigned int searches;
+
+  /* The following member is used for debugging.  Its value is number
+     of groups visited past the first one.  */
+  unsigned int collisions;
+
+  /* Pointers to allocate/free functions.  */
+  htab_alloc alloc_f;
+  htab_free free_f;
+
+  /* Alternate allocate/free functions, which take an extra argument.  */
+  void *alloc_arg;
+  htab_alloc_with_arg alloc_with_arg_f;
+  htab_free_with_arg free_with_arg_f;
+};
+
+typedef struct ghtab *ghtab_t;
+
+/* The prototypes of the package functions, matching their htab_
+   counterparts.  */
+
+extern ghtab_t	ghtab_create_alloc  (size_t, htab_hash,
+                                     htab_eq, htab_del,
+                                     htab_alloc, htab_free);
+
+extern ghtab_t	ghtab_create_alloc_ex (size_t, htab_hash,
+                                       htab_eq, htab_del,
+                                       void *, htab_alloc_with_arg,
+                                       htab_free_with_arg);
+
+extern ghtab_t ghtab_create (size_t, htab_hash, htab_eq, htab_del);
+extern ghtab_t ghtab_try_create (size_t, htab_hash, htab_eq, htab_del);
+
+extern void	ghtab_delete (ghtab_t);
+extern void	ghtab_empty (ghtab_t);
+
+extern void *	ghtab_find (ghtab_t, const void *);
+extern void **	ghtab_find_slot (ghtab_t, const void *, enum insert_option);
+extern void *	ghtab_find_with_hash (ghtab_t, const void *, hashval_t);
+extern void **	ghtab_find_slot_with_hash (ghtab_t, const void *,
+					   hashval_t, enum insert_option);
+extern void	ghtab_clear_slot	(ghtab_t, void **);
+extern void	ghtab_remove_elt	(ghtab_t, void *);
+extern void	ghtab_remove_elt_with_hash (ghtab_t, void *, hashval_t);
+
+extern void	ghtab_traverse	(ghtab_t, htab_trav, void *);
+extern void	ghtab_traverse_noresize	(ghtab_t, htab_trav, void *);
+
+extern size_t	ghtab_size	(ghtab_t);
+extern size_t	ghtab_elements	(ghtab_t);
+extern double	ghtab_collisions	(ghtab_t);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __GHASHTAB_H__ */
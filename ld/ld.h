@@ -172,6 +172,9 @@ typedef struct
   /* If set, display the target memory usage (per memory region).  */
   bfd_boolean print_memory_usage;
 
+  /* If set, read input files through a mapping of their contents.  */
+  bfd_boolean mmap_inputs;
+
   /* Big or little endian as set on command line.  */
   enum endian_enum endian;
 
@@ -142,6 +142,11 @@ ldfile_try_open_bfd (const char *attempt,
   /* Linker needs to decompress sections.  */
   entry->the_bfd->flags |= BFD_DECOMPRESS;
 
+  /* If asked, map the inputs, so that symbols and relocs are swapped
+     in straight from the file.  */
+  if (command_line.mmap_inputs)
+    entry->the_bfd->flags |= BFD_MMAP;
+
   /* This is a linker input BFD.  */
   entry->the_bfd->is_linker_input = 1;
 
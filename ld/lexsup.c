@@ -353,6 +353,9 @@ static const struct ld_option ld_options[] =
     '\0', NULL, N_("Do not demangle symbol names"), TWO_DASHES },
   { {"no-keep-memory", no_argument, NULL, OPTION_NO_KEEP_MEMORY},
     '\0', NULL, N_("Use less memory and more disk I/O"), TWO_DASHES },
+  { {"mmap-inputs", no_argument, NULL, OPTION_MMAP_INPUTS},
+    '\0', NULL, N_("Read input files through a mapping of their contents"),
+    TWO_DASHES },
   { {"no-undefined", no_argument, NULL, OPTION_NO_UNDEFINED},
     '\0', NULL, N_("Do not allow unresolved references in object files"),
     TWO_DASHES },
@@ -916,6 +919,9 @@ parse_args (unsigned argc, char **argv)
 	case OPTION_NO_KEEP_MEMORY:
 	  link_info.keep_memory = FALSE;
 	  break;
+	case OPTION_MMAP_INPUTS:
+	  command_line.mmap_inputs = TRUE;
+	  break;
 	case OPTION_NO_UNDEFINED:
 	  link_info.unresolved_syms_in_objects
 	    = how_to_report_unresolved_symbols;
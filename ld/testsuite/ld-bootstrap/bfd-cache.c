@@ -0,0 +1,161 @@
+/* Read files through the BFD file cache, serially and from several
+   threads at once, and check that both read the same.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+
+   This file is part of the GNU Binutils.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.  */
+
+/* The arguments are objects and archives, and each archive member
+   is read as well.  Run with a low limit on open files, the cache
+   has to close files to make room for others while they are being
+   read, and reopen them later.  */
+
+#define PACKAGE "bfd-cache"
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "bfd.h"
+
+#define NTHREADS 4
+#define ROUNDS 3
+
+static bfd **bfds;
+static unsigned long *sums;
+static int nbfds;
+
+/* Return a checksum of the contents of the sections of ABFD, or zero
+   if they can not be read.  */
+
+static unsigned long
+checksum (bfd *abfd)
+{
+  unsigned long sum = 1;
+  asection *sec;
+
+  for (sec = abfd->sections; sec != NULL; sec = sec->next)
+    {
+      bfd_byte *contents;
+      bfd_size_type i;
+
+      if ((sec->flags & SEC_HAS_CONTENTS) == 0 || sec->size == 0)
+	continue;
+      if (!bfd_malloc_and_get_section (abfd, sec, &contents))
+	return 0;
+      for (i = 0; i < sec->size; i++)
+	sum = sum * 31 + contents[i];
+      free (contents);
+      sum |= 1;
+    }
+  return sum;
+}
+
+static void
+add_bfd (bfd *abfd)
+{
+  bfds = realloc (bfds, (nbfds + 1) * sizeof (*bfds));
+  bfds[nbfds++] = abfd;
+}
+
+/* Check the BFDs whose index is THREAD modulo NTHREADS.  Each BFD is
+   read by one thread only, but the members of an archive share the
+   archive's file.  */
+
+static void *
+check_bfds (void *thread)
+{
+  long t = (long) thread;
+  long failures = 0;
+  int round;
+  int i;
+
+  for (round = 0; round < ROUNDS; round++)
+    for (i = t; i < nbfds; i += NTHREADS)
+      if (checksum (bfds[i]) != sums[i])
+	{
+	  fprintf (stderr, "%s: contents differ\n", bfd_get_filename (bfds[i]));
+	  failures++;
+	}
+  return (void *) failures;
+}
+
+int
+main (int argc, char **argv)
+{
+  pthread_t threads[NTHREADS];
+  long failures = 0;
+  long t;
+  int i;
+
+  bfd_init ();
+
+  /* Opening files is not thread safe, so open them all first.  */
+  for (i = 1; i < argc; i++)
+    {
+      bfd *abfd = bfd_openr (argv[i], NULL);
+
+      if (abfd == NULL)
+	{
+	  bfd_perror (argv[i]);
+	  return 1;
+	}
+      if (bfd_check_format (abfd, bfd_archive))
+	{
+	  bfd *elt = NULL;
+
+	  while ((elt = bfd_openr_next_archived_file (abfd, elt)) != NULL)
+	    if (bfd_check_format (elt, bfd_object))
+	      add_bfd (elt);
+	}
+      else if (bfd_check_format (abfd, bfd_object))
+	add_bfd (abfd);
+      else
+	{
+	  bfd_perror (argv[i]);
+	  return 1;
+	}
+    }
+
+  sums = malloc (nbfds * sizeof (*sums));
+  for (i = 0; i < nbfds; i++)
+    {
+      sums[i] = checksum (bfds[i]);
+      if (sums[i] == 0)
+	{
+	  bfd_perror (bfd_get_filename (bfds[i]));
+	  return 1;
+	}
+    }
+
+  for (t = 0; t < NTHREADS; t++)
+    if (pthread_create (&threads[t], NULL, check_bfds, (void *) t) != 0)
+      {
+	perror ("pthread_create");
+	return 1;
+      }
+  for (t = 0; t < NTHREADS; t++)
+    {
+      void *ret;
+
+      pthread_join (threads[t], &ret);
+      failures += (long) ret;
+    }
+
+  if (failures != 0)
+    return 1;
+  printf ("read %d files\n", nbfds);
+  return 0;
+}
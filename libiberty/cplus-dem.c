@@ -68,6 +68,7 @@ void * realloc ();
 #define CURRENT_DEMANGLING_STYLE work->options
 
 #include "libiberty.h"
+#include "obstack.h"
 
 #define min(X,Y) (((X) < (Y)) ? (X) : (Y))
 
@@ -362,6 +363,9 @@ static int
 demangle_method_args (struct work_stuff *, const char **, string *);
 #endif
 
+static char *
+cplus_demangle_1 (const char *, int, struct obstack *);
+
 static char *
 internal_cplus_demangle (struct work_stuff *, const char *);
 
@@ -867,12 +871,63 @@ cplus_demangle_name_to_style (const char *name)
 
 char *
 cplus_demangle (const char *mangled, int options)
+{
+  return cplus_demangle_1 (mangled, options, NULL);
+}
+
+/* char *cplus_demangle_obstack (const char *mangled, int options,
+				 struct obstack *ob)
+
+   Like cplus_demangle, but the result is allocated on OB, which must
+   not have an object under construction.  Nothing is left on OB when
+   NULL is returned.  G++ v3 and Rust names, the usual
+   case, are demangled straight onto OB without any other memory
+   allocation, which makes this the cheaper interface when many names
+   are demangled and the results are kept together.  */
+
+char *
+cplus_demangle_obstack (const char *mangled, int options, struct obstack *ob)
+{
+  return cplus_demangle_1 (mangled, options, ob);
+}
+
+/* Demangling callback that appends to the obstack OPAQUE.  */
+
+static void
+demangle_obstack_callback (const char *s, size_t len, void *opaque)
+{
+  obstack_grow ((struct obstack *) opaque, s, len);
+}
+
+/* Move RET, allocated by malloc, onto OB if OB is not NULL.  */
+
+static char *
+demangle_result_to_obstack (char *ret, struct obstack *ob)
+{
+  char *copy;
+
+  if (ob == NULL || ret == NULL)
+    return ret;
+  copy = (char *) obstack_copy0 (ob, ret, strlen (ret));
+  free (ret);
+  return copy;
+}
+
+/* Worker for cplus_demangle and cplus_demangle_obstack.  The result
+   is allocated on OB, or with malloc if OB is NULL.  */
+
+static char *
+cplus_demangle_1 (const char *mangled, int options, struct obstack *ob)
 {
   char *ret;
   struct work_stuff work[1];
 
   if (current_demangling_style == no_demangling)
-    return xstrdup (mangled);
+    {
+      if (ob != NULL)
+	return (char *) obstack_copy0 (ob, mangled, strlen (mangled));
+      return xstrdup (mangled);
+    }
 
   memset ((char *) work, 0, sizeof (work));
   work->options = options;
@@ -882,7 +937,20 @@ cplus_demangle (const char *mangled, int options)
   /* The V3 ABI demangling is implemented elsewhere.  */
   if (GNU_V3_DEMANGLING || RUST_DEMANGLING || AUTO_DEMANGLING)
     {
-      ret = cplus_demangle_v3 (mangled, work->options);
+      if (ob == NULL)
+	ret = cplus_demangle_v3 (mangled, work->options);
+      else if (cplus_demangle_v3_callback (mangled, work->options,
+					   demangle_obstack_callback, ob))
+	{
+	  obstack_1grow (ob, '\0');
+	  ret = (char *) obstack_finish (ob);
+	}
+      else
+	{
+	  /* Drop whatever was printed before the error.  */
+	  obstack_free (ob, obstack_finish (ob));
+	  ret = NULL;
+	}
       if (GNU_V3_DEMANGLING)
 	return ret;
 
@@ -894,7 +962,10 @@ cplus_demangle (const char *mangled, int options)
 	    rust_demangle_sym (ret);
 	  else if (RUST_DEMANGLING)
 	    {
-	      free (ret);
+	      if (ob != NULL)
+		obstack_free (ob, ret);
+	      else
+		free (ret);
 	      ret = NULL;
 	    }
 	}
@@ -907,22 +978,22 @@ cplus_demangle (const char *mangled, int options)
     {
       ret = java_demangle_v3 (mangled);
       if (ret)
-        return ret;
+        return demangle_result_to_obstack (ret, ob);
     }
 
   if (GNAT_DEMANGLING)
-    return ada_demangle (mangled, options);
+    return demangle_result_to_obstack (ada_demangle (mangled, options), ob);
 
   if (DLANG_DEMANGLING)
     {
       ret = dlang_demangle (mangled, options);
       if (ret)
-	return ret;
+	return demangle_result_to_obstack (ret, ob);
     }
 
   ret = internal_cplus_demangle (work, mangled);
   squangle_mop_up (work);
-  return (ret);
+  return demangle_result_to_obstack (ret, ob);
 }
 
 char *
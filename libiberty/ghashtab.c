@@ -0,0 +1,630 @@
+/* An expandable hash table probing control bytes in groups.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+
+This file is part of the libiberty library.
+Libiberty is free software; you can redistribute it and/or
+modify it under the terms of the GNU Library General Public
+License as published by the Free Software Foundation; either
+version 2 of the License, or (at your option) any later version.
+
+Libiberty is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Library General Public License for more details.
+
+You should have received a copy of the GNU Library General Public
+License along with libiberty; see the file COPYING.LIB.  If
+not, write to the Free Software Foundation, Inc., 51 Franklin Street - Fifth Floor,
+Boston, MA 02110-1301, USA.  */
+
+/* The table is an array of entries whose size is a power of two,
+   split into groups of GROUP_SIZE consecutive slots, with a parallel
+   array of control bytes.  A control byte is CTRL_EMPTY, CTRL_DELETED,
+   or for a full slot the high bit plus seven bits taken from the
+   element's hash (its tag).
+
+   The rest of the hash selects the group where the search starts.
+   Within a group, every slot whose control byte equals the tag is a
+   candidate and is checked with the equality function.  If the group
+   has an empty slot, the element cannot be further along; otherwise
+   the search goes on to the next group of a triangular sequence, which
+   visits every group of the table once.
+
+   Removing an element leaves a CTRL_DELETED tombstone only when its
+   group has no empty slot, since only then might a search have gone
+   past the group.  Tombstones count against the load factor and are
+   dropped when the table is rebuilt.  */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <sys/types.h>
+
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+
+#include <stdio.h>
+
+#include "libiberty.h"
+#include "ansidecl.h"
+#include "ghashtab.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define GROUP_SIZE 16
+
+#define CTRL_EMPTY 0
+#define CTRL_DELETED 1
+#define CTRL_FULL 0x80
+
+/* Grow or rebuild the table once it is this full, counting
+   tombstones, expressed as a fraction of eighths.  */
+#define MAX_LOAD_EIGHTHS 7
+
+static int ghtab_expand (ghtab_t);
+
+/* Return a bit mask of the slots of the group at CTRL whose control
+   byte is C.  */
+
+static inline unsigned int
+group_match (const unsigned char *ctrl, unsigned char c)
+{
+#ifdef __SSE2__
+  __m128i group = _mm_loadu_si128 ((const __m128i *) ctrl);
+  return _mm_movemask_epi8 (_mm_cmpeq_epi8 (group, _mm_set1_epi8 (c)));
+#else
+  unsigned int mask = 0;
+  int i;
+
+  for (i = 0; i < GROUP_SIZE; i++)
+    if (ctrl[i] == c)
+      mask |= 1u << i;
+  return mask;
+#endif
+}
+
+/* Return a bit mask of the slots of the group at CTRL that are empty
+   or deleted.  */
+
+static inline unsigned int
+group_match_free (const unsigned char *ctrl)
+{
+#ifdef __SSE2__
+  __m128i group = _mm_loadu_si128 ((const __m128i *) ctrl);
+  return ~_mm_movemask_epi8 (group) & 0xffff;
+#else
+  unsigned int mask = 0;
+  int i;
+
+  for (i = 0; i < GROUP_SIZE; i++)
+    if ((ctrl[i] & CTRL_FULL) == 0)
+      mask |= 1u << i;
+  return mask;
+#endif
+}
+
+/* Return the index of the lowest set bit of the non-zero MASK.  */
+
+static inline unsigned int
+lowest_bit (unsigned int mask)
+{
+#if GCC_VERSION >= 3004
+  return __builtin_ctz (mask);
+#else
+  unsigned int i = 0;
+
+  while ((mask & 1) == 0)
+    {
+      mask >>= 1;
+      i++;
+    }
+  return i;
+#endif
+}
+
+/* Scramble HASH so that both the tag and the group index depend on
+   all of its bits; hash functions like htab_hash_pointer leave the low
+   bits constant.  */
+
+static inline hashval_t
+mix_hash (hashval_t hash)
+{
+  hash *= 0x9e3779b1;
+  return hash ^ (hash >> 15);
+}
+
+static inline unsigned char
+hash_tag (hashval_t mixed)
+{
+  return CTRL_FULL | ((mixed >> 25) & 0x7f);
+}
+
+/* Return the index of the first group to probe for MIXED in a table of
+   N_GROUPS groups.  */
+
+static inline size_t
+hash_group (hashval_t mixed, size_t n_groups)
+{
+  return mixed & (n_groups - 1);
+}
+
+/* Return the smallest valid table size holding at least N slots.  */
+
+static size_t
+table_size (size_t n)
+{
+  size_t size = GROUP_SIZE;
+
+  while (size < n)
+    size *= 2;
+  return size;
+}
+
+static void *
+ghtab_alloc_array (ghtab_t htab, size_t nmemb, size_t size)
+{
+  if (htab->alloc_with_arg_f != NULL)
+    return (*htab->alloc_with_arg_f) (htab->alloc_arg, nmemb, size);
+  return (*htab->alloc_f) (nmemb, size);
+}
+
+static void
+ghtab_free_array (ghtab_t htab, void *p)
+{
+  if (htab->free_f != NULL)
+    (*htab->free_f) (p);
+  else if (htab->free_with_arg_f != NULL)
+    (*htab->free_with_arg_f) (htab->alloc_arg, p);
+}
+
+/* Allocate zeroed entries and control bytes for SIZE slots and install
+   them in HTAB.  Return zero if the memory cannot be allocated, leaving
+   HTAB unchanged.  */
+
+static int
+ghtab_alloc_table (ghtab_t htab, size_t size)
+{
+  void **entries;
+  unsigned char *ctrl;
+
+  entries = (void **) ghtab_alloc_array (htab, size, sizeof (void *));
+  if (entries == NULL)
+    return 0;
+  ctrl = (unsigned char *) ghtab_alloc_array (htab, size, 1);
+  if (ctrl == NULL)
+    {
+      ghtab_free_array (htab, entries);
+      return 0;
+    }
+  htab->entries = entries;
+  htab->ctrl = ctrl;
+  htab->size = size;
+  return 1;
+}
+
+/* Create a hash table with room for at least SIZE elements, as
+   htab_create_alloc does.  */
+
+ghtab_t
+ghtab_create_alloc (size_t size, htab_hash hash_f, htab_eq eq_f,
+		    htab_del del_f, htab_alloc alloc_f, htab_free free_f)
+{
+  ghtab_t result;
+
+  result = (ghtab_t) (*alloc_f) (1, sizeof (struct ghtab));
+  if (result == NULL)
+    return NULL;
+  result->hash_f = hash_f;
+  result->eq_f = eq_f;
+  result->del_f = del_f;
+  result->alloc_f = alloc_f;
+  result->free_f = free_f;
+  if (!ghtab_alloc_table (result, table_size (size + size / 4)))
+    {
+      if (free_f != NULL)
+	(*free_f) (result);
+      return NULL;
+    }
+  return result;
+}
+
+/* As above, but use the variants of ALLOC_F and FREE_F which accept
+   an extra argument.  */
+
+ghtab_t
+ghtab_create_alloc_ex (size_t size, htab_hash hash_f, htab_eq eq_f,
+		       htab_del del_f, void *alloc_arg,
+		       htab_alloc_with_arg alloc_f,
+		       htab_free_with_arg free_f)
+{
+  ghtab_t result;
+
+  result = (ghtab_t) (*alloc_f) (alloc_arg, 1, sizeof (struct ghtab));
+  if (result == NULL)
+    return NULL;
+  result->hash_f = hash_f;
+  result->eq_f = eq_f;
+  result->del_f = del_f;
+  result->alloc_arg = alloc_arg;
+  result->alloc_with_arg_f = alloc_f;
+  result->free_with_arg_f = free_f;
+  if (!ghtab_alloc_table (result, table_size (size + size / 4)))
+    {
+      if (free_f != NULL)
+	(*free_f) (alloc_arg, result);
+      return NULL;
+    }
+  return result;
+}
+
+ghtab_t
+ghtab_create (size_t size, htab_hash hash_f, htab_eq eq_f, htab_del del_f)
+{
+  return ghtab_create_alloc (size, hash_f, eq_f, del_f, xcalloc, free);
+}
+
+ghtab_t
+ghtab_try_create (size_t size, htab_hash hash_f, htab_eq eq_f,
+		  htab_del del_f)
+{
+  return ghtab_create_alloc (size, hash_f, eq_f, del_f, calloc, free);
+}
+
+/* Call the cleanup function, if any, on every element of HTAB.  */
+
+static void
+ghtab_delete_elements (ghtab_t htab)
+{
+  size_t i;
+
+  if (htab->del_f == NULL)
+    return;
+  for (i = 0; i < htab->size; i++)
+    if (htab->ctrl[i] & CTRL_FULL)
+      (*htab->del_f) (htab->entries[i]);
+}
+
+/* Free the memory of HTAB after calling the cleanup function on its
+   elements.  */
+
+void
+ghtab_delete (ghtab_t htab)
+{
+  ghtab_delete_elements (htab);
+  ghtab_free_array (htab, htab->entries);
+  ghtab_free_array (htab, htab->ctrl);
+  ghtab_free_array (htab, htab);
+}
+
+/* Remove all elements from HTAB.  */
+
+void
+ghtab_empty (ghtab_t htab)
+{
+  ghtab_delete_elements (htab);
+
+  /* Instead of clearing megabyte, downsize the table.  */
+  if (htab->size > 1024 * 1024 / sizeof (void *))
+    {
+      void **entries = htab->entries;
+      unsigned char *ctrl = htab->ctrl;
+
+      if (ghtab_alloc_table (htab, 1024 / sizeof (void *)))
+	{
+	  ghtab_free_array (htab, entries);
+	  ghtab_free_array (htab, ctrl);
+	  htab->n_elements = 0;
+	  htab->n_deleted = 0;
+	  return;
+	}
+    }
+
+  memset (htab->entries, 0, htab->size * sizeof (void *));
+  memset (htab->ctrl, CTRL_EMPTY, htab->size);
+  htab->n_elements = 0;
+  htab->n_deleted = 0;
+}
+
+/* Return the index of a free slot for an element with MIXED hash in a
+   table known to hold no equal element and no tombstones.  */
+
+static size_t
+find_free_slot (ghtab_t htab, hashval_t mixed)
+{
+  size_t group_mask = htab->size / GROUP_SIZE - 1;
+  size_t group = hash_group (mixed, group_mask + 1);
+  size_t step = 0;
+
+  for (;;)
+    {
+      const unsigned char *ctrl = htab->ctrl + group * GROUP_SIZE;
+      unsigned int mask = group_match_free (ctrl);
+
+      if (mask != 0)
+	return group * GROUP_SIZE + lowest_bit (mask);
+      group = (group + ++step) & group_mask;
+    }
+}
+
+/* Rebuild HTAB at a size suited to its element count, dropping the
+   tombstones.  Return zero if memory cannot be allocated, leaving HTAB
+   unchanged.  */
+
+static int
+ghtab_expand (ghtab_t htab)
+{
+  void **oentries = htab->entries;
+  unsigned char *octrl = htab->ctrl;
+  size_t osize = htab->size;
+  size_t elts = htab->n_elements;
+  size_t nsize, i;
+
+  /* Resize only when table after removal of unused elements is either
+     too full or too empty.  */
+  if (elts * 2 > osize)
+    nsize = table_size (elts * 4);
+  else if (elts * 8 < osize && osize > 32)
+    nsize = table_size (elts * 2);
+  else
+    nsize = osize;
+
+  if (!ghtab_alloc_table (htab, nsize))
+    return 0;
+
+  for (i = 0; i < osize; i++)
+    if (octrl[i] & CTRL_FULL)
+      {
+	hashval_t mixed = mix_hash ((*htab->hash_f) (oentries[i]));
+	size_t slot = find_free_slot (htab, mixed);
+
+	htab->ctrl[slot] = hash_tag (mixed);
+	htab->entries[slot] = oentries[i];
+      }
+  htab->n_deleted = 0;
+
+  ghtab_free_array (htab, oentries);
+  ghtab_free_array (htab, octrl);
+  return 1;
+}
+
+/* Look up an element equal to ELEMENT, whose hash is HASH.  Return it,
+   or NULL if there is none.  */
+
+void *
+ghtab_find_with_hash (ghtab_t htab, const void *element, hashval_t hash)
+{
+  hashval_t mixed = mix_hash (hash);
+  unsigned char tag = hash_tag (mixed);
+  size_t group_mask = htab->size / GROUP_SIZE - 1;
+  size_t group = hash_group (mixed, group_mask + 1);
+  size_t step = 0;
+
+  htab->searches++;
+  for (;;)
+    {
+      const unsigned char *ctrl = htab->ctrl + group * GROUP_SIZE;
+      unsigned int mask;
+
+      for (mask = group_match (ctrl, tag); mask != 0; mask &= mask - 1)
+	{
+	  void *entry = htab->entries[group * GROUP_SIZE + lowest_bit (mask)];
+
+	  if ((*htab->eq_f) (entry, element))
+	    return entry;
+	}
+      if (group_match (ctrl, CTRL_EMPTY) != 0)
+	return NULL;
+
+      htab->collisions++;
+      group = (group + ++step) & group_mask;
+    }
+}
+
+/* Like ghtab_find_with_hash, but compute the hash value from the
+   element.  */
+
+void *
+ghtab_find (ghtab_t htab, const void *element)
+{
+  return ghtab_find_with_hash (htab, element, (*htab->hash_f) (element));
+}
+
+/* Return a pointer to the slot of the element equal to ELEMENT, whose
+   hash is HASH.  If there is none, return NULL if INSERT is NO_INSERT;
+   otherwise reserve a slot for it and return a pointer to the slot,
+   which the caller must fill.  Return NULL as well when the table
+   needs to grow and memory cannot be allocated.  */
+
+void **
+ghtab_find_slot_with_hash (ghtab_t htab, const void *element,
+			   hashval_t hash, enum insert_option insert)
+{
+  hashval_t mixed;
+  unsigned char tag;
+  size_t group_mask, group, step = 0;
+  size_t first_free = (size_t) -1;
+
+  if (insert == INSERT
+      && ((htab->n_elements + htab->n_deleted + 1) * 8
+	  > htab->size * MAX_LOAD_EIGHTHS))
+    {
+      if (ghtab_expand (htab) == 0)
+	return NULL;
+    }
+
+  mixed = mix_hash (hash);
+  tag = hash_tag (mixed);
+  group_mask = htab->size / GROUP_SIZE - 1;
+  group = hash_group (mixed, group_mask + 1);
+
+  htab->searches++;
+  for (;;)
+    {
+      const unsigned char *ctrl = htab->ctrl + group * GROUP_SIZE;
+      unsigned int mask;
+
+      for (mask = group_match (ctrl, tag); mask != 0; mask &= mask - 1)
+	{
+	  size_t slot = group * GROUP_SIZE + lowest_bit (mask);
+
+	  if ((*htab->eq_f) (htab->entries[slot], element))
+	    return &htab->entries[slot];
+	}
+
+      if (insert == INSERT && first_free == (size_t) -1)
+	{
+	  mask = group_match_free (ctrl);
+	  if (mask != 0)
+	    first_free = group * GROUP_SIZE + lowest_bit (mask);
+	}
+
+      if (group_match (ctrl, CTRL_EMPTY) != 0)
+	break;
+
+      htab->collisions++;
+      group = (group + ++step) & group_mask;
+    }
+
+  if (insert == NO_INSERT)
+    return NULL;
+
+  if (htab->ctrl[first_free] == CTRL_DELETED)
+    htab->n_deleted--;
+  htab->ctrl[first_free] = tag;
+  htab->entries[first_free] = NULL;
+  htab->n_elements++;
+  return &htab->entries[first_free];
+}
+
+/* Like ghtab_find_slot_with_hash, but compute the hash value from the
+   element.  */
+
+void **
+ghtab_find_slot (ghtab_t htab, const void *element,
+		 enum insert_option insert)
+{
+  return ghtab_find_slot_with_hash (htab, element,
+				    (*htab->hash_f) (element), insert);
+}
+
+/* Mark slot INDEX of HTAB free, without calling the cleanup
+   function.  */
+
+static void
+ghtab_release_slot (ghtab_t htab, size_t index)
+{
+  const unsigned char *group = htab->ctrl + index / GROUP_SIZE * GROUP_SIZE;
+
+  if (group_match (group, CTRL_EMPTY) != 0)
+    htab->ctrl[index] = CTRL_EMPTY;
+  else
+    {
+      htab->ctrl[index] = CTRL_DELETED;
+      htab->n_deleted++;
+    }
+  htab->entries[index] = NULL;
+  htab->n_elements--;
+}
+
+/* Remove the element equal to ELEMENT, whose hash is HASH, if there
+   is one, calling the cleanup function on it.  */
+
+void
+ghtab_remove_elt_with_hash (ghtab_t htab, void *element, hashval_t hash)
+{
+  void **slot;
+
+  slot = ghtab_find_slot_with_hash (htab, element, hash, NO_INSERT);
+  if (slot == NULL)
+    return;
+
+  if (htab->del_f)
+    (*htab->del_f) (*slot);
+
+  ghtab_release_slot (htab, slot - htab->entries);
+}
+
+void
+ghtab_remove_elt (ghtab_t htab, void *element)
+{
+  ghtab_remove_elt_with_hash (htab, element, (*htab->hash_f) (element));
+}
+
+/* Remove the element in SLOT, which must have been returned by
+   ghtab_find_slot for HTAB, calling the cleanup function on it.  */
+
+void
+ghtab_clear_slot (ghtab_t htab, void **slot)
+{
+  size_t index = slot - htab->entries;
+
+  if (slot < htab->entries || index >= htab->size
+      || (htab->ctrl[index] & CTRL_FULL) == 0)
+    abort ();
+
+  if (htab->del_f)
+    (*htab->del_f) (*slot);
+
+  ghtab_release_slot (htab, index);
+}
+
+/* Call CALLBACK with each slot of HTAB holding an element and with
+   INFO, until CALLBACK returns zero.  */
+
+void
+ghtab_traverse_noresize (ghtab_t htab, htab_trav callback, void *info)
+{
+  size_t i;
+
+  for (i = 0; i < htab->size; i++)
+    if (htab->ctrl[i] & CTRL_FULL)
+      if (!(*callback) (&htab->entries[i], info))
+	break;
+}
+
+/* Like ghtab_traverse_noresize, but shrink the table first if it is
+   mostly empty.  */
+
+void
+ghtab_traverse (ghtab_t htab, htab_trav callback, void *info)
+{
+  if (htab->n_elements * 8 < htab->size && htab->size > 32)
+    ghtab_expand (htab);
+
+  ghtab_traverse_noresize (htab, callback, info);
+}
+
+/* Return the current size of HTAB, in slots.  */
+
+size_t
+ghtab_size (ghtab_t htab)
+{
+  return htab->size;
+}
+
+/* Return the current number of elements in HTAB.  */
+
+size_t
+ghtab_elements (ghtab_t htab)
+{
+  return htab->n_elements;
+}
+
+/* Return the average number of groups visited past the first one per
+   search.  */
+
+double
+ghtab_collisions (ghtab_t htab)
+{
+  if (htab->searches == 0)
+    return 0.0;
+
+  return (double) htab->collisions / (double) htab->searches;
+}
@@ -26,6 +26,10 @@
 #include <stdio.h>
 #include "libiberty.h"
 #include "demangle.h"
+#include "obstack.h"
+
+#define obstack_chunk_alloc xmalloc
+#define obstack_chunk_free free
 #ifdef HAVE_STRING_H
 #include <string.h>
 #endif
@@ -183,6 +187,7 @@ main(argc, argv)
   struct line input;
   struct line expect;
   char *result;
+  struct obstack ob;
   int failures = 0;
   int tests = 0;
 
@@ -195,6 +200,7 @@ main(argc, argv)
   format.data = 0;
   input.data = 0;
   expect.data = 0;
+  obstack_init (&ob);
 
   for (;;)
     {
@@ -327,6 +333,22 @@ main(argc, argv)
 	}
       free (result);
 
+      /* The obstack interface must give the same answer.  */
+      result = cplus_demangle_obstack (inp,
+				       (DMGL_PARAMS | DMGL_ANSI | DMGL_TYPES
+					| (ret_postfix ? DMGL_RET_POSTFIX : 0)
+					| (ret_drop ? DMGL_RET_DROP : 0)),
+				       &ob);
+      if (result
+	  ? strcmp (result, expect.data)
+	  : strcmp (input.data, expect.data))
+	{
+	  fail (lineno, format.data, input.data, result, expect.data);
+	  failures++;
+	}
+      if (result)
+	obstack_free (&ob, result);
+
       if (no_params)
 	{
 	  get_line (&expect);
@@ -346,6 +368,7 @@ main(argc, argv)
   free (format.data);
   free (input.data);
   free (expect.data);
+  obstack_free (&ob, NULL);
 
   printf ("%s: %d tests, %d failures\n", argv[0], tests, failures);
   return failures ? 1 : 0;
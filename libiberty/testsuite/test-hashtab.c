@@ -0,0 +1,373 @@
+/* Tests and benchmarks for the hash table packages.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+
+   This file is part of the libiberty library, which is part of GCC.
+
+   This file is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   In addition to the permissions in the GNU General Public License, the
+   Free Software Foundation gives you unlimited permission to link the
+   compiled version of this file into combinations with other programs,
+   and to distribute those combinations without any restriction coming
+   from the use of this file.  (The General Public License restrictions
+   do apply in other respects; for example, they cover modification of
+   the file, and distribution when not linked into a combined
+   executable.)
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/* Without arguments, check ghashtab.h against hashtab.h on a random
+   sequence of operations.  With --bench, time both on insertions and
+   on successful and failing lookups, for tables of pointers and of
+   strings at a range of sizes.  */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include "libiberty.h"
+#include "hashtab.h"
+#include "ghashtab.h"
+#include <stdio.h>
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+
+#ifndef EXIT_SUCCESS
+#define EXIT_SUCCESS 0
+#endif
+
+#ifndef EXIT_FAILURE
+#define EXIT_FAILURE 1
+#endif
+
+static int fails;
+
+#define CHECK(COND)							\
+  do									\
+    {									\
+      if (!(COND))							\
+	{								\
+	  fprintf (stderr, "FAIL: %s:%d: %s\n", __FILE__, __LINE__, #COND); \
+	  fails++;							\
+	}								\
+    }									\
+  while (0)
+
+/* A small deterministic generator, so that runs are repeatable.  */
+
+static unsigned long rand_state = 1;
+
+static unsigned long
+next_rand (void)
+{
+  rand_state = (rand_state * 1103515245 + 12345) & 0xffffffff;
+  return rand_state >> 1;
+}
+
+static char **
+make_strings (size_t n, const char *prefix)
+{
+  char **strs = XNEWVEC (char *, n);
+  size_t i;
+
+  for (i = 0; i < n; i++)
+    {
+      char buf[64];
+
+      sprintf (buf, "%s%lu_%lx", prefix, (unsigned long) i, next_rand ());
+      strs[i] = xstrdup (buf);
+    }
+  return strs;
+}
+
+static void
+free_strings (char **strs, size_t n)
+{
+  size_t i;
+
+  for (i = 0; i < n; i++)
+    free (strs[i]);
+  free (strs);
+}
+
+static int
+eq_string (const void *a, const void *b)
+{
+  return strcmp ((const char *) a, (const char *) b) == 0;
+}
+
+static int deleted;
+
+static void
+count_del (void *p ATTRIBUTE_UNUSED)
+{
+  deleted++;
+}
+
+static int
+count_trav (void **slot ATTRIBUTE_UNUSED, void *info)
+{
+  (*(size_t *) info)++;
+  return 1;
+}
+
+/* Apply the same random insertions and removals to an htab and a
+   ghtab of strings, checking that they agree all along.  */
+
+static void
+check_random (size_t n, size_t ops)
+{
+  char **strs = make_strings (n, "key");
+  htab_t ref = htab_create (16, htab_hash_string, eq_string, NULL);
+  ghtab_t tab = ghtab_create (16, htab_hash_string, eq_string,
+			      count_del);
+  size_t i, count;
+
+  deleted = 0;
+  for (i = 0; i < ops; i++)
+    {
+      char *s = strs[next_rand () % n];
+      char copy[64];
+      int in_ref;
+      void **slot;
+
+      /* Look up a copy, so that equality is by content.  */
+      strcpy (copy, s);
+      in_ref = htab_find (ref, copy) != NULL;
+      CHECK ((ghtab_find (tab, copy) != NULL) == in_ref);
+
+      switch (next_rand () % 4)
+	{
+	case 0:
+	case 1:
+	  *htab_find_slot (ref, s, INSERT) = s;
+	  slot = ghtab_find_slot (tab, copy, INSERT);
+	  CHECK (slot != NULL);
+	  CHECK (in_ref ? *slot == s : *slot == NULL);
+	  *slot = s;
+	  break;
+
+	case 2:
+	  /* htab_remove_elt requires the element to be present.  */
+	  if (in_ref)
+	    htab_remove_elt (ref, s);
+	  ghtab_remove_elt (tab, copy);
+	  break;
+
+	case 3:
+	  slot = ghtab_find_slot (tab, copy, NO_INSERT);
+	  CHECK ((slot != NULL) == in_ref);
+	  if (slot != NULL)
+	    {
+	      CHECK (*slot == s);
+	      htab_remove_elt (ref, s);
+	      ghtab_clear_slot (tab, slot);
+	    }
+	  break;
+	}
+
+      CHECK (ghtab_elements (tab) == htab_elements (ref));
+    }
+
+  for (i = 0; i < n; i++)
+    CHECK ((ghtab_find (tab, strs[i]) != NULL)
+	   == (htab_find (ref, strs[i]) != NULL));
+
+  count = 0;
+  ghtab_traverse (tab, count_trav, &count);
+  CHECK (count == htab_elements (ref));
+
+  count = ghtab_elements (tab);
+  deleted = 0;
+  ghtab_empty (tab);
+  CHECK (deleted == (int) count);
+  CHECK (ghtab_elements (tab) == 0);
+  CHECK (ghtab_find (tab, strs[0]) == NULL);
+
+  htab_delete (ref);
+  ghtab_delete (tab);
+  free_strings (strs, n);
+}
+
+/* Fill a table past several expansions and remove everything, with
+   pointer keys whose low bits are all equal.  */
+
+static void
+check_pointers (size_t n)
+{
+  char *base = XNEWVEC (char, n * 64);
+  ghtab_t tab = ghtab_create (0, htab_hash_pointer, htab_eq_pointer, NULL);
+  size_t i;
+
+  for (i = 0; i < n; i++)
+    {
+      void **slot = ghtab_find_slot (tab, base + i * 64, INSERT);
+      CHECK (*slot == NULL);
+      *slot = base + i * 64;
+    }
+  CHECK (ghtab_elements (tab) == n);
+  CHECK (ghtab_size (tab) >= n);
+
+  for (i = 0; i < n; i++)
+    {
+      CHECK (ghtab_find (tab, base + i * 64) == base + i * 64);
+      CHECK (ghtab_find (tab, base + i * 64 + 1) == NULL);
+    }
+
+  for (i = 0; i < n; i += 2)
+    ghtab_remove_elt (tab, base + i * 64);
+  CHECK (ghtab_elements (tab) == n / 2);
+  for (i = 0; i < n; i++)
+    CHECK ((ghtab_find (tab, base + i * 64) != NULL) == (i % 2 == 1));
+
+  ghtab_delete (tab);
+  free (base);
+}
+
+/* Benchmarks.  */
+
+static void
+report (const char *what, const char *kind, size_t n, long htab_time,
+	long ghtab_time, size_t ops)
+{
+  printf ("%-8s %-7s %8lu   htab %7.1f ns/op   ghtab %7.1f ns/op\n",
+	  what, kind, (unsigned long) n,
+	  htab_time * 1000.0 / ops, ghtab_time * 1000.0 / ops);
+}
+
+/* Time the tables on the N keys KEYS, and on the N keys MISSING which
+   are not in the table.  */
+
+static void
+bench (const char *what, void **keys, void **missing, size_t n,
+       htab_hash hash_f, htab_eq eq_f)
+{
+  size_t rounds = 1 + 4000000 / n;
+  size_t ops = rounds * n;
+  size_t r, i, found = 0;
+  long start, t_ins_h, t_ins_g, t_hit_h, t_hit_g, t_miss_h, t_miss_g;
+  htab_t h = NULL;
+  ghtab_t g = NULL;
+
+  start = get_run_time ();
+  for (r = 0; r < rounds; r++)
+    {
+      if (h != NULL)
+	htab_delete (h);
+      h = htab_create (16, hash_f, eq_f, NULL);
+      for (i = 0; i < n; i++)
+	*htab_find_slot (h, keys[i], INSERT) = keys[i];
+    }
+  t_ins_h = get_run_time () - start;
+
+  start = get_run_time ();
+  for (r = 0; r < rounds; r++)
+    {
+      if (g != NULL)
+	ghtab_delete (g);
+      g = ghtab_create (16, hash_f, eq_f, NULL);
+      for (i = 0; i < n; i++)
+	*ghtab_find_slot (g, keys[i], INSERT) = keys[i];
+    }
+  t_ins_g = get_run_time () - start;
+
+  start = get_run_time ();
+  for (r = 0; r < rounds; r++)
+    for (i = 0; i < n; i++)
+      found += htab_find (h, keys[i]) != NULL;
+  t_hit_h = get_run_time () - start;
+
+  start = get_run_time ();
+  for (r = 0; r < rounds; r++)
+    for (i = 0; i < n; i++)
+      found += ghtab_find (g, keys[i]) != NULL;
+  t_hit_g = get_run_time () - start;
+
+  start = get_run_time ();
+  for (r = 0; r < rounds; r++)
+    for (i = 0; i < n; i++)
+      found += htab_find (h, missing[i]) != NULL;
+  t_miss_h = get_run_time () - start;
+
+  start = get_run_time ();
+  for (r = 0; r < rounds; r++)
+    for (i = 0; i < n; i++)
+      found += ghtab_find (g, missing[i]) != NULL;
+  t_miss_g = get_run_time () - start;
+
+  if (found != 2 * ops)
+    abort ();
+
+  report (what, "insert", n, t_ins_h, t_ins_g, ops);
+  report (what, "hit", n, t_hit_h, t_hit_g, ops);
+  report (what, "miss", n, t_miss_h, t_miss_g, ops);
+
+  htab_delete (h);
+  ghtab_delete (g);
+}
+
+static void
+run_benchmarks (void)
+{
+  size_t n;
+
+  for (n = 1000; n <= 1000000; n *= 10)
+    {
+      char **strs = make_strings (n, "_ZN4gdb6symbolE");
+      char **other = make_strings (n, "_ZN4gdb7missingE");
+      char *base = XNEWVEC (char, 2 * n * 16);
+      void **ptrs = XNEWVEC (void *, n);
+      void **ptrs_missing = XNEWVEC (void *, n);
+      size_t i;
+
+      for (i = 0; i < n; i++)
+	{
+	  ptrs[i] = base + 2 * i * 16;
+	  ptrs_missing[i] = base + (2 * i + 1) * 16;
+	}
+
+      bench ("pointer", ptrs, ptrs_missing, n,
+	     htab_hash_pointer, htab_eq_pointer);
+      bench ("string", (void **) strs, (void **) other, n,
+	     htab_hash_string, eq_string);
+
+      free (ptrs_missing);
+      free (ptrs);
+      free (base);
+      free_strings (other, n);
+      free_strings (strs, n);
+    }
+}
+
+int
+main (int argc, char **argv)
+{
+  if (argc > 1 && strcmp (argv[1], "--bench") == 0)
+    {
+      run_benchmarks ();
+      return EXIT_SUCCESS;
+    }
+
+  check_random (50, 2000);
+  check_random (5000, 200000);
+  check_pointers (100000);
+
+  if (fails)
+    exit (EXIT_FAILURE);
+
+  return EXIT_SUCCESS;
+}
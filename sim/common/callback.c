@@ -156,6 +156,8 @@ os_close (host_callback *p, int fd)
       result = wrap (p, close (fdmap (p, fd)));
     }
   p->fd_buddy[fd] = -1;
+  free (p->fd_name[fd]);
+  p->fd_name[fd] = NULL;
 
   return result;
 }
@@ -242,7 +244,8 @@ os_open (host_callback *p, const char *name, int flags)
     {
       if (p->fd_buddy[i] < 0)
 	{
-	  int f = open (name, cb_target_to_host_open (p, flags), 0644);
+	  int host_flags = cb_target_to_host_open (p, flags);
+	  int f = open (name, host_flags, 0644);
 	  if (f < 0)
 	    {
 	      p->last_errno = errno;
@@ -250,6 +253,9 @@ os_open (host_callback *p, const char *name, int flags)
 	    }
 	  p->fd_buddy[i] = i;
 	  p->fdmap[i] = f;
+	  free (p->fd_name[i]);
+	  p->fd_name[i] = xstrdup (name);
+	  p->fd_flags[i] = host_flags;
 	  return i;
 	}
     }
@@ -599,6 +605,8 @@ os_shutdown (host_callback *p)
       p->ispipe[i] = 0;
       p->pipe_buffer[i].size = 0;
       p->pipe_buffer[i].buffer = NULL;
+      free (p->fd_name[i]);
+      p->fd_name[i] = NULL;
 
       next = p->fd_buddy[i];
       if (next < 0)
@@ -737,6 +745,8 @@ host_callback default_callback =
   { -1, },	/* fd_buddy */
   { 0, },	/* ispipe */
   { { 0, 0 }, }, /* pipe_buffer */
+  { 0, },	/* fd_name */
+  { 0, },	/* fd_flags */
 
   0, /* syscall_map */
   0, /* errno_map */
@@ -1064,6 +1074,52 @@ cb_is_stderr (host_callback *cb, int fd)
   return fdbad (cb, fd) ? 0 : fdmap (cb, fd) == 2;
 }
 
+int
+cb_save_fd (host_callback *cb, int fd, const char **name, int *flags,
+	    long *offset)
+{
+  if (fdbad (cb, fd) || cb_is_stdin (cb, fd)
+      || cb_is_stdout (cb, fd) || cb_is_stderr (cb, fd))
+    return 0;
+  if (cb->fd_name[fd] == NULL || cb->ispipe[fd])
+    return -1;
+  *offset = lseek (fdmap (cb, fd), 0, SEEK_CUR);
+  if (*offset < 0)
+    return -1;
+  *name = cb->fd_name[fd];
+  *flags = cb->fd_flags[fd];
+  return 1;
+}
+
+int
+cb_restore_fd (host_callback *cb, int fd, const char *name, int flags,
+	       long offset)
+{
+  int f;
+
+  if (fd < 0 || fd >= MAX_CALLBACK_FDS)
+    return -1;
+  if (cb->fd_buddy[fd] >= 0)
+    cb->close (cb, fd);
+
+  /* The file already exists in the state being restored; creating or
+     truncating it again would lose what the program wrote to it.  */
+  flags &= ~(O_CREAT | O_EXCL | O_TRUNC);
+  f = open (name, flags, 0644);
+  if (f < 0)
+    return -1;
+  if (lseek (f, offset, SEEK_SET) != offset)
+    {
+      close (f);
+      return -1;
+    }
+  cb->fd_buddy[fd] = fd;
+  cb->fdmap[fd] = f;
+  cb->fd_name[fd] = xstrdup (name);
+  cb->fd_flags[fd] = flags;
+  return 0;
+}
+
 const char *
 cb_host_str_syscall (host_callback *cb, int host_val)
 {
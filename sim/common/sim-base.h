@@ -87,6 +87,8 @@ typedef struct _sim_cpu sim_cpu;
 #include "sim-engine.h"
 #include "sim-watch.h"
 #include "sim-memopt.h"
+#include "sim-checkpoint.h"
+#include "sim-break.h"
 #include "sim-cpu.h"
 
 
@@ -202,6 +204,14 @@ typedef struct {
   sim_watchpoints watchpoints;
 #define STATE_WATCHPOINTS(sd) (&(sd)->base.watchpoints)
 
+  /* Checkpoint options.  */
+  struct sim_checkpoint_state *checkpoint;
+#define STATE_CHECKPOINT(sd) ((sd)->base.checkpoint)
+
+  /* Breakpoints and range stepping for the debugger.  */
+  struct sim_break_state breakpoints;
+#define STATE_BREAKPOINTS(sd) (&(sd)->base.breakpoints)
+
 #if WITH_HW
   struct sim_hw *hw;
 #define STATE_HW(sd) ((sd)->base.hw)
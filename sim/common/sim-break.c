@@ -0,0 +1,533 @@
+/* Simulator breakpoint and range stepping support.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+
+This file is part of GDB, the GNU debugger.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "config.h"
+
+#include "sim-main.h"
+#include "sim-assert.h"
+#include "gdb/remote-sim.h"
+
+#ifdef HAVE_STRING_H
+#include <string.h>
+#else
+#ifdef HAVE_STRINGS_H
+#include <strings.h>
+#endif
+#endif
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+
+struct sim_breakpoint {
+  address_word addr;
+  int nr_conditions;
+  unsigned char **conditions;
+  int *lengths;
+  struct sim_breakpoint *next;
+};
+
+static struct sim_breakpoint **
+bucket (SIM_DESC sd, address_word addr)
+{
+  /* Instructions are at least two bytes apart on most targets.  */
+  return &STATE_BREAKPOINTS (sd)->buckets[(addr >> 1)
+					  % SIM_BREAK_NR_BUCKETS];
+}
+
+static struct sim_breakpoint *
+find_breakpoint (SIM_DESC sd, address_word addr)
+{
+  struct sim_breakpoint *bp;
+
+  for (bp = *bucket (sd, addr); bp != NULL; bp = bp->next)
+    if (bp->addr == addr)
+      return bp;
+  return NULL;
+}
+
+static void
+free_breakpoint (struct sim_breakpoint *bp)
+{
+  int i;
+
+  for (i = 0; i < bp->nr_conditions; i++)
+    free (bp->conditions[i]);
+  free (bp->conditions);
+  free (bp->lengths);
+  free (bp);
+}
+
+static void
+update_active (SIM_DESC sd)
+{
+  struct sim_break_state *state = STATE_BREAKPOINTS (sd);
+
+  state->active = state->stepping || state->nr_breakpoints > 0;
+}
+
+
+/* Evaluation of the agent expressions, following gdbserver/ax.c.  The
+   opcode values are those of gdb/common/ax.def.  */
+
+enum {
+  ax_add = 0x02, ax_sub = 0x03, ax_mul = 0x04,
+  ax_div_signed = 0x05, ax_div_unsigned = 0x06,
+  ax_rem_signed = 0x07, ax_rem_unsigned = 0x08,
+  ax_lsh = 0x09, ax_rsh_signed = 0x0a, ax_rsh_unsigned = 0x0b,
+  ax_log_not = 0x0e, ax_bit_and = 0x0f, ax_bit_or = 0x10,
+  ax_bit_xor = 0x11, ax_bit_not = 0x12, ax_equal = 0x13,
+  ax_less_signed = 0x14, ax_less_unsigned = 0x15, ax_ext = 0x16,
+  ax_ref8 = 0x17, ax_ref16 = 0x18, ax_ref32 = 0x19, ax_ref64 = 0x1a,
+  ax_if_goto = 0x20, ax_goto = 0x21,
+  ax_const8 = 0x22, ax_const16 = 0x23, ax_const32 = 0x24,
+  ax_const64 = 0x25, ax_reg = 0x26, ax_end = 0x27,
+  ax_dup = 0x28, ax_pop = 0x29, ax_zero_ext = 0x2a, ax_swap = 0x2b,
+  ax_pick = 0x32, ax_rot = 0x33
+};
+
+#define AX_STACK_SIZE 100
+
+/* Give up on expressions that loop.  */
+#define AX_MAX_STEPS 10000
+
+/* Return the LEN byte target order number at BUF.  */
+
+static unsigned64
+extract_target (const unsigned char *buf, int len)
+{
+  unsigned64 val = 0;
+  int i;
+
+  if (CURRENT_TARGET_BYTE_ORDER == BFD_ENDIAN_BIG)
+    for (i = 0; i < len; i++)
+      val = (val << 8) | buf[i];
+  else
+    for (i = len - 1; i >= 0; i--)
+      val = (val << 8) | buf[i];
+  return val;
+}
+
+/* Evaluate the LEN byte expression EXPR for CPU.  Return the value it
+   leaves on the stack, or nonzero if it cannot be evaluated, so that
+   a condition in doubt stops the program.  */
+
+static int
+eval_condition (SIM_DESC sd, sim_cpu *cpu, const unsigned char *expr,
+		int len)
+{
+  signed64 stack[AX_STACK_SIZE];
+  int sp = 0;
+  int pc = 0;
+  int steps;
+
+#define NEED(N) do { if (sp < (N)) return 1; } while (0)
+#define PUSH(V) \
+  do \
+    { \
+      signed64 val_ = (V); \
+      if (sp >= AX_STACK_SIZE) \
+	return 1; \
+      stack[sp] = val_; \
+      sp++; \
+    } \
+  while (0)
+#define TOP (stack[sp - 1])
+#define BINARY(EXPR) \
+  do { NEED (2); sp--; stack[sp - 1] = (EXPR); } while (0)
+#define A (stack[sp - 1])
+#define B (stack[sp])
+#define UA ((unsigned64) stack[sp - 1])
+#define UB ((unsigned64) stack[sp])
+
+  for (steps = 0; steps < AX_MAX_STEPS; steps++)
+    {
+      int op, arg, i;
+      unsigned char buf[8];
+
+      if (pc >= len)
+	return 1;
+      op = expr[pc++];
+
+      switch (op)
+	{
+	case ax_add:
+	  BINARY (A + B);
+	  break;
+	case ax_sub:
+	  BINARY (A - B);
+	  break;
+	case ax_mul:
+	  BINARY (A * B);
+	  break;
+	case ax_div_signed:
+	  NEED (2);
+	  if (TOP == 0)
+	    return 1;
+	  BINARY (A / B);
+	  break;
+	case ax_div_unsigned:
+	  NEED (2);
+	  if (TOP == 0)
+	    return 1;
+	  BINARY (UA / UB);
+	  break;
+	case ax_rem_signed:
+	  NEED (2);
+	  if (TOP == 0)
+	    return 1;
+	  BINARY (A % B);
+	  break;
+	case ax_rem_unsigned:
+	  NEED (2);
+	  if (TOP == 0)
+	    return 1;
+	  BINARY (UA % UB);
+	  break;
+	case ax_lsh:
+	  BINARY (UA << (UB & 63));
+	  break;
+	case ax_rsh_signed:
+	  BINARY (A >> (UB & 63));
+	  break;
+	case ax_rsh_unsigned:
+	  BINARY (UA >> (UB & 63));
+	  break;
+	case ax_log_not:
+	  NEED (1);
+	  TOP = !TOP;
+	  break;
+	case ax_bit_and:
+	  BINARY (A & B);
+	  break;
+	case ax_bit_or:
+	  BINARY (A | B);
+	  break;
+	case ax_bit_xor:
+	  BINARY (A ^ B);
+	  break;
+	case ax_bit_not:
+	  NEED (1);
+	  TOP = ~TOP;
+	  break;
+	case ax_equal:
+	  BINARY (A == B);
+	  break;
+	case ax_less_signed:
+	  BINARY (A < B);
+	  break;
+	case ax_less_unsigned:
+	  BINARY (UA < UB);
+	  break;
+
+	case ax_ext:
+	case ax_zero_ext:
+	  if (pc >= len)
+	    return 1;
+	  arg = expr[pc++];
+	  NEED (1);
+	  if (arg > 0 && arg < 64)
+	    {
+	      unsigned64 mask = ((unsigned64) 1 << arg) - 1;
+	      unsigned64 sign = (unsigned64) 1 << (arg - 1);
+
+	      TOP &= mask;
+	      if (op == ax_ext)
+		TOP = ((unsigned64) TOP ^ sign) - sign;
+	    }
+	  break;
+
+	case ax_ref8:
+	case ax_ref16:
+	case ax_ref32:
+	case ax_ref64:
+	  {
+	    int size = 1 << (op - ax_ref8);
+
+	    NEED (1);
+	    if (sim_core_read_buffer (sd, cpu, read_map, buf,
+				      (address_word) TOP, size) != size)
+	      return 1;
+	    TOP = extract_target (buf, size);
+	  }
+	  break;
+
+	case ax_if_goto:
+	case ax_goto:
+	  if (pc + 2 > len)
+	    return 1;
+	  arg = (expr[pc] << 8) | expr[pc + 1];
+	  pc += 2;
+	  if (op == ax_goto)
+	    pc = arg;
+	  else
+	    {
+	      NEED (1);
+	      if (stack[--sp])
+		pc = arg;
+	    }
+	  break;
+
+	case ax_const8:
+	case ax_const16:
+	case ax_const32:
+	case ax_const64:
+	  {
+	    int size = 1 << (op - ax_const8);
+	    unsigned64 val = 0;
+
+	    if (pc + size > len)
+	      return 1;
+	    for (i = 0; i < size; i++)
+	      val = (val << 8) | expr[pc++];
+	    PUSH (val);
+	  }
+	  break;
+
+	case ax_reg:
+	  {
+	    int size = sizeof (unsigned_word);
+
+	    if (pc + 2 > len)
+	      return 1;
+	    arg = (expr[pc] << 8) | expr[pc + 1];
+	    pc += 2;
+	    if (CPU_REG_FETCH (cpu) == NULL
+		|| (*CPU_REG_FETCH (cpu)) (cpu, arg, buf, size) != size)
+	      return 1;
+	    PUSH (extract_target (buf, size));
+	  }
+	  break;
+
+	case ax_end:
+	  NEED (1);
+	  return TOP != 0;
+
+	case ax_dup:
+	  NEED (1);
+	  PUSH (TOP);
+	  break;
+	case ax_pop:
+	  NEED (1);
+	  sp--;
+	  break;
+	case ax_swap:
+	  {
+	    signed64 tem;
+
+	    NEED (2);
+	    tem = stack[sp - 1];
+	    stack[sp - 1] = stack[sp - 2];
+	    stack[sp - 2] = tem;
+	  }
+	  break;
+	case ax_pick:
+	  if (pc >= len)
+	    return 1;
+	  arg = expr[pc++];
+	  NEED (arg + 1);
+	  PUSH (stack[sp - 1 - arg]);
+	  break;
+	case ax_rot:
+	  {
+	    signed64 tem;
+
+	    /* a b c => c a b */
+	    NEED (3);
+	    tem = stack[sp - 1];
+	    stack[sp - 1] = stack[sp - 2];
+	    stack[sp - 2] = stack[sp - 3];
+	    stack[sp - 3] = tem;
+	  }
+	  break;
+
+	default:
+	  /* Floating point, tracing, state variables and printf have no
+	     place in a condition.  */
+	  return 1;
+	}
+    }
+
+#undef NEED
+#undef PUSH
+#undef TOP
+#undef BINARY
+#undef A
+#undef B
+#undef UA
+#undef UB
+
+  return 1;
+}
+
+
+void
+sim_break_check (SIM_DESC sd, sim_cpu *cpu, address_word pc)
+{
+  struct sim_break_state *state = STATE_BREAKPOINTS (sd);
+  struct sim_breakpoint *bp;
+  int i;
+
+  if (state->stepping
+      && (pc < state->step_start || pc >= state->step_end))
+    sim_engine_halt (sd, cpu, NULL, pc, sim_stopped, SIM_SIGTRAP);
+
+  if (state->nr_breakpoints == 0)
+    return;
+  bp = find_breakpoint (sd, pc);
+  if (bp == NULL)
+    return;
+
+  if (bp->nr_conditions == 0)
+    sim_engine_halt (sd, cpu, NULL, pc, sim_stopped, SIM_SIGTRAP);
+  for (i = 0; i < bp->nr_conditions; i++)
+    if (eval_condition (sd, cpu, bp->conditions[i], bp->lengths[i]))
+      sim_engine_halt (sd, cpu, NULL, pc, sim_stopped, SIM_SIGTRAP);
+}
+
+
+/* The debugger interface.  */
+
+int
+sim_breakpoints_supported (SIM_DESC sd)
+{
+  SIM_ASSERT (STATE_MAGIC (sd) == SIM_MAGIC_NUMBER);
+
+  return STATE_BREAKPOINTS (sd)->supported;
+}
+
+int
+sim_resume_range (SIM_DESC sd, SIM_ADDR start, SIM_ADDR end, int siggnal)
+{
+  struct sim_break_state *state = STATE_BREAKPOINTS (sd);
+  address_word pc;
+
+  SIM_ASSERT (STATE_MAGIC (sd) == SIM_MAGIC_NUMBER);
+
+  if (!state->supported)
+    return 0;
+
+  pc = CPU_PC_GET (STATE_CPU (sd, 0));
+  if (start >= end || pc < start || pc >= end)
+    {
+      sim_resume (sd, 1, siggnal);
+      return 1;
+    }
+
+  state->stepping = 1;
+  state->step_start = start;
+  state->step_end = end;
+  update_active (sd);
+
+  sim_resume (sd, 0, siggnal);
+
+  state->stepping = 0;
+  update_active (sd);
+  return 1;
+}
+
+int
+sim_insert_breakpoint (SIM_DESC sd, SIM_ADDR addr, int nr_conditions,
+		       const unsigned char * const *conditions,
+		       const int *lengths)
+{
+  struct sim_break_state *state = STATE_BREAKPOINTS (sd);
+  struct sim_breakpoint *bp;
+  int i;
+
+  SIM_ASSERT (STATE_MAGIC (sd) == SIM_MAGIC_NUMBER);
+
+  if (!state->supported)
+    return 0;
+
+  sim_remove_breakpoint (sd, addr);
+
+  bp = ZALLOC (struct sim_breakpoint);
+  bp->addr = addr;
+  bp->nr_conditions = nr_conditions;
+  if (nr_conditions > 0)
+    {
+      bp->conditions = NZALLOC (unsigned char *, nr_conditions);
+      bp->lengths = NZALLOC (int, nr_conditions);
+      for (i = 0; i < nr_conditions; i++)
+	{
+	  bp->conditions[i] = (unsigned char *) xmalloc (lengths[i]);
+	  memcpy (bp->conditions[i], conditions[i], lengths[i]);
+	  bp->lengths[i] = lengths[i];
+	}
+    }
+
+  bp->next = *bucket (sd, addr);
+  *bucket (sd, addr) = bp;
+  state->nr_breakpoints++;
+  update_active (sd);
+  return 1;
+}
+
+int
+sim_remove_breakpoint (SIM_DESC sd, SIM_ADDR addr)
+{
+  struct sim_break_state *state = STATE_BREAKPOINTS (sd);
+  struct sim_breakpoint **bpp;
+
+  SIM_ASSERT (STATE_MAGIC (sd) == SIM_MAGIC_NUMBER);
+
+  if (!state->supported)
+    return 0;
+
+  for (bpp = bucket (sd, addr); *bpp != NULL; bpp = &(*bpp)->next)
+    if ((*bpp)->addr == addr)
+      {
+	struct sim_breakpoint *bp = *bpp;
+
+	*bpp = bp->next;
+	free_breakpoint (bp);
+	state->nr_breakpoints--;
+	break;
+      }
+
+  update_active (sd);
+  return 1;
+}
+
+
+static void
+sim_break_uninstall (SIM_DESC sd)
+{
+  struct sim_break_state *state = STATE_BREAKPOINTS (sd);
+  int i;
+
+  for (i = 0; i < SIM_BREAK_NR_BUCKETS; i++)
+    while (state->buckets[i] != NULL)
+      {
+	struct sim_breakpoint *bp = state->buckets[i];
+
+	state->buckets[i] = bp->next;
+	free_breakpoint (bp);
+      }
+  state->nr_breakpoints = 0;
+  state->stepping = 0;
+  state->active = 0;
+}
+
+SIM_RC
+sim_break_install (SIM_DESC sd)
+{
+  SIM_ASSERT (STATE_MAGIC (sd) == SIM_MAGIC_NUMBER);
+  sim_module_add_uninstall_fn (sd, sim_break_uninstall);
+  return SIM_RC_OK;
+}
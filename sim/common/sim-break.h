@@ -0,0 +1,64 @@
+/* Simulator breakpoint and range stepping support.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+
+This file is part of GDB, the GNU debugger.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef SIM_BREAK_H
+#define SIM_BREAK_H
+
+/* This module implements sim_insert_breakpoint, sim_remove_breakpoint
+   and sim_resume_range (see gdb/remote-sim.h), so that a debugger can
+   leave breakpoint conditions and the stepping of a source line to the
+   simulator instead of stopping it at every hit or instruction.
+
+   It needs the help of the engine: a simulator that supports it sets
+   SIM_BREAK_SUPPORTED once its modules are installed, and its engine
+   calls sim_break_check before each instruction while SIM_BREAK_ACTIVE
+   is nonzero.  Other simulators report that they cannot do either, and
+   the debugger falls back to memory breakpoints and single steps.  */
+
+/* Breakpoints are kept in a small hash table on their address.  */
+#define SIM_BREAK_NR_BUCKETS 64
+
+struct sim_break_state {
+  /* Set by the simulator when its engine calls sim_break_check.  */
+  int supported;
+
+  /* Nonzero while there are breakpoints or a range is being
+     stepped.  */
+  int active;
+
+  /* The range being stepped, if STEPPING.  */
+  int stepping;
+  address_word step_start;
+  address_word step_end;
+
+  int nr_breakpoints;
+  struct sim_breakpoint *buckets[SIM_BREAK_NR_BUCKETS];
+};
+
+#define SIM_BREAK_SUPPORTED(sd) (STATE_BREAKPOINTS (sd)->supported)
+#define SIM_BREAK_ACTIVE(sd) (STATE_BREAKPOINTS (sd)->active)
+
+/* Halt the simulation with SIGTRAP if the instruction of CPU at PC is
+   outside the range being stepped, or if a breakpoint is set at PC and
+   one of its conditions holds.  Otherwise return.  */
+extern void sim_break_check (SIM_DESC sd, sim_cpu *cpu, address_word pc);
+
+/* Install the "break" module.  */
+MODULE_INSTALL_FN sim_break_install;
+
+#endif /* SIM_BREAK_H */
@@ -0,0 +1,783 @@
+/* Simulator checkpoint/restore support.
+   Copyright (C) 2016 Free Software Foundation, Inc.
+
+This file is part of GDB, the GNU debugger.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "config.h"
+
+#include "sim-main.h"
+#include "sim-options.h"
+#include "sim-assert.h"
+
+#include <stdio.h>
+
+#ifdef HAVE_STRING_H
+#include <string.h>
+#else
+#ifdef HAVE_STRINGS_H
+#include <strings.h>
+#endif
+#endif
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+
+/* A checkpoint file is the magic string and a version byte followed
+   by a sequence of ULEB128 numbers and raw bytes:
+
+     number of cpus, then each cpu as written by CPU_CHECKPOINT_SAVE
+     the event clock
+     number of memory buffers, then for each: the access maps it is
+       attached to, level, space, address, size and modulo, then runs
+       of nonzero pages as (length, offset, bytes), ending with a
+       zero length
+     number of open files, then for each: target fd, host open flags,
+       offset, name length and name
+
+   Pages of zeros are left out, so a checkpoint of a mostly empty
+   memory is small.
+
+   Pending events are not saved.  Their handlers are host functions
+   owned by the module that scheduled them, and the restoring run
+   schedules its own from its options.  Only the clock is carried
+   over, and the restoring run's events keep their distance from it.  */
+
+#define CHECKPOINT_MAGIC "SIMCKPT"
+#define CHECKPOINT_MAGIC_SIZE 8
+#define CHECKPOINT_VERSION 1
+
+#define CHECKPOINT_PAGE_SIZE 4096
+
+struct _sim_checkpoint_file {
+  SIM_DESC sd;
+  FILE *file;
+  /* The first thing that went wrong, or NULL.  */
+  const char *error;
+};
+
+/* What the options asked for.  */
+
+struct sim_checkpoint_state {
+  char *save_file;
+  int save_after_p;
+  unsigned long save_after;
+  int save_at_pc_p;
+  unsigned_word save_at_pc;
+  sim_event *save_event;
+  char *restore_file;
+  /* Nonzero once the modules have been initialized, so that options
+     given as commands act straight away.  */
+  int initialized;
+};
+
+void
+sim_checkpoint_write_word (sim_checkpoint_file *f, unsigned64 val)
+{
+  do
+    {
+      int byte = val & 0x7f;
+
+      val >>= 7;
+      if (val != 0)
+	byte |= 0x80;
+      if (putc (byte, f->file) == EOF && f->error == NULL)
+	f->error = "write error";
+    }
+  while (val != 0);
+}
+
+void
+sim_checkpoint_write_bytes (sim_checkpoint_file *f, const void *buf,
+			    unsigned long length)
+{
+  if (length != 0 && fwrite (buf, length, 1, f->file) != 1
+      && f->error == NULL)
+    f->error = "write error";
+}
+
+unsigned64
+sim_checkpoint_read_word (sim_checkpoint_file *f)
+{
+  unsigned64 val = 0;
+  unsigned shift = 0;
+  int byte;
+
+  do
+    {
+      if (f->error != NULL)
+	return 0;
+      byte = getc (f->file);
+      if (byte == EOF)
+	{
+	  f->error = "truncated checkpoint";
+	  return 0;
+	}
+      if (shift < 64)
+	val |= (unsigned64) (byte & 0x7f) << shift;
+      shift += 7;
+    }
+  while (byte & 0x80);
+  return val;
+}
+
+void
+sim_checkpoint_read_bytes (sim_checkpoint_file *f, void *buf,
+			   unsigned long length)
+{
+  if (f->error != NULL)
+    {
+      memset (buf, 0, length);
+      return;
+    }
+  if (length != 0 && fread (buf, length, 1, f->file) != 1)
+    {
+      f->error = "truncated checkpoint";
+      memset (buf, 0, length);
+    }
+}
+
+void
+sim_checkpoint_mismatch (sim_checkpoint_file *f, const char *why)
+{
+  if (f->error == NULL)
+    f->error = why;
+}
+
+/* Return the modulo MAPPING was attached with; sim_core_map_attach
+   stores it less one, so no modulo leaves all bits set.  */
+
+static unsigned
+mapping_modulo (sim_core_mapping *mapping)
+{
+  return mapping->mask + 1;
+}
+
+/* Return the size of the host buffer behind MAPPING.  */
+
+static unsigned long
+mapping_buffer_size (sim_core_mapping *mapping)
+{
+  return (mapping_modulo (mapping) != 0
+	  ? mapping_modulo (mapping) : mapping->nr_bytes);
+}
+
+/* Return the access maps in which a mapping just like MAPPING
+   appears.  */
+
+static unsigned
+mapping_map_mask (SIM_DESC sd, sim_core_mapping *mapping)
+{
+  sim_core *core = STATE_CORE (sd);
+  unsigned mask = 0;
+  unsigned map;
+
+  for (map = 0; map < nr_maps; map++)
+    {
+      sim_core_mapping *m;
+
+      for (m = core->common.map[map].first; m != NULL; m = m->next)
+	if (m->buffer == mapping->buffer && m->base == mapping->base
+	    && m->bound == mapping->bound)
+	  mask |= 1 << map;
+    }
+  return mask;
+}
+
+/* Call FN, if not NULL, on the first mapping of each distinct memory
+   buffer, in a stable order, and return how many there were.  */
+
+static int
+for_each_memory_buffer (SIM_DESC sd,
+			void (*fn) (SIM_DESC, sim_core_mapping *, void *),
+			void *data)
+{
+  sim_core *core = STATE_CORE (sd);
+  unsigned map;
+  int count = 0;
+
+  for (map = 0; map < nr_maps; map++)
+    {
+      sim_core_mapping *mapping;
+
+      for (mapping = core->common.map[map].first;
+	   mapping != NULL;
+	   mapping = mapping->next)
+	{
+	  unsigned earlier;
+	  int seen = 0;
+
+	  /* Devices are skipped; sim_checkpoint_save refuses them.  */
+	  if (mapping->buffer == NULL)
+	    continue;
+
+	  /* The same buffer can be attached to several maps, or at
+	     several addresses by --memory-alias; its contents only
+	     need saving once.  */
+	  for (earlier = 0; earlier <= map && !seen; earlier++)
+	    {
+	      sim_core_mapping *m;
+
+	      for (m = core->common.map[earlier].first;
+		   m != NULL && !(earlier == map && m == mapping);
+		   m = m->next)
+		if (m->buffer == mapping->buffer)
+		  {
+		    seen = 1;
+		    break;
+		  }
+	    }
+	  if (seen)
+	    continue;
+
+	  count++;
+	  if (fn != NULL)
+	    fn (sd, mapping, data);
+	}
+    }
+  return count;
+}
+
+/* Return a mapping of a device rather than memory, or NULL.  */
+
+static sim_core_mapping *
+find_device_mapping (SIM_DESC sd)
+{
+  sim_core *core = STATE_CORE (sd);
+  unsigned map;
+
+  for (map = 0; map < nr_maps; map++)
+    {
+      sim_core_mapping *mapping;
+
+      for (mapping = core->common.map[map].first;
+	   mapping != NULL;
+	   mapping = mapping->next)
+	if (mapping->buffer == NULL)
+	  return mapping;
+    }
+  return NULL;
+}
+
+static void
+save_memory_run (sim_checkpoint_file *f, const unsigned8 *buffer,
+		 unsigned long start, unsigned long end)
+{
+  sim_checkpoint_write_word (f, end - start);
+  sim_checkpoint_write_word (f, start);
+  sim_checkpoint_write_bytes (f, buffer + start, end - start);
+}
+
+static void
+save_memory_buffer (SIM_DESC sd, sim_core_mapping *mapping, void *data)
+{
+  static const unsigned8 zeros[CHECKPOINT_PAGE_SIZE];
+  sim_checkpoint_file *f = (sim_checkpoint_file *) data;
+  const unsigned8 *buffer = (const unsigned8 *) mapping->buffer;
+  unsigned long size = mapping_buffer_size (mapping);
+  unsigned long offset, length, run_start = 0;
+  int in_run = 0;
+
+  sim_checkpoint_write_word (f, mapping_map_mask (sd, mapping));
+  sim_checkpoint_write_word (f, (unsigned64) (signed64) mapping->level);
+  sim_checkpoint_write_word (f, mapping->space);
+  sim_checkpoint_write_word (f, mapping->base);
+  sim_checkpoint_write_word (f, mapping->nr_bytes);
+  sim_checkpoint_write_word (f, mapping_modulo (mapping));
+
+  /* Write each run of pages that are not all zero.  */
+  for (offset = 0; offset < size; offset += length)
+    {
+      length = size - offset;
+      if (length > CHECKPOINT_PAGE_SIZE)
+	length = CHECKPOINT_PAGE_SIZE;
+      if (memcmp (buffer + offset, zeros, length) != 0)
+	{
+	  if (!in_run)
+	    run_start = offset;
+	  in_run = 1;
+	}
+      else if (in_run)
+	{
+	  save_memory_run (f, buffer, run_start, offset);
+	  in_run = 0;
+	}
+    }
+  if (in_run)
+    save_memory_run (f, buffer, run_start, size);
+  sim_checkpoint_write_word (f, 0);
+}
+
+/* Return the mapping in one of the maps in MAP_MASK that matches the
+   other arguments, or NULL.  */
+
+static sim_core_mapping *
+find_memory_mapping (SIM_DESC sd, unsigned map_mask, int level, int space,
+		     address_word base, address_word nr_bytes)
+{
+  sim_core *core = STATE_CORE (sd);
+  unsigned map;
+
+  for (map = 0; map < nr_maps; map++)
+    {
+      sim_core_mapping *mapping;
+
+      if ((map_mask & (1 << map)) == 0)
+	continue;
+      for (mapping = core->common.map[map].first;
+	   mapping != NULL;
+	   mapping = mapping->next)
+	if (mapping->level == level && mapping->space == space
+	    && mapping->base == base && mapping->nr_bytes == nr_bytes
+	    && mapping->buffer != NULL)
+	  return mapping;
+    }
+  return NULL;
+}
+
+static void
+restore_memory_buffer (SIM_DESC sd, sim_checkpoint_file *f)
+{
+  unsigned map_mask = sim_checkpoint_read_word (f);
+  int level = (int) (signed64) sim_checkpoint_read_word (f);
+  int space = sim_checkpoint_read_word (f);
+  address_word base = sim_checkpoint_read_word (f);
+  address_word nr_bytes = sim_checkpoint_read_word (f);
+  unsigned modulo = sim_checkpoint_read_word (f);
+  sim_core_mapping *mapping;
+  unsigned8 *buffer;
+  unsigned long size = modulo != 0 ? modulo : nr_bytes;
+
+  if (f->error != NULL)
+    return;
+  if (map_mask == 0)
+    {
+      f->error = "bad memory map mask";
+      return;
+    }
+
+  /* Normally the restoring run was configured like the one that saved
+     the checkpoint and already has this memory.  Anything it lacks is
+     attached here.  */
+  mapping = find_memory_mapping (sd, map_mask, level, space, base, nr_bytes);
+  if (mapping == NULL)
+    {
+      sim_core_attach (sd, NULL, level, map_mask, space, base, nr_bytes,
+		       modulo, NULL, NULL);
+      mapping = find_memory_mapping (sd, map_mask, level, space, base,
+				     nr_bytes);
+      SIM_ASSERT (mapping != NULL);
+    }
+  if (mapping_buffer_size (mapping) != size)
+    {
+      f->error = "memory layout differs from the checkpoint";
+      return;
+    }
+
+  buffer = (unsigned8 *) mapping->buffer;
+  memset (buffer, 0, size);
+  while (f->error == NULL)
+    {
+      unsigned long length = sim_checkpoint_read_word (f);
+      unsigned long offset;
+
+      if (length == 0)
+	break;
+      offset = sim_checkpoint_read_word (f);
+      if (offset > size || length > size - offset)
+	{
+	  f->error = "memory contents out of range";
+	  break;
+	}
+      sim_checkpoint_read_bytes (f, buffer + offset, length);
+    }
+}
+
+static void
+save_files (SIM_DESC sd, sim_checkpoint_file *f)
+{
+  host_callback *cb = STATE_CALLBACK (sd);
+  const char *name;
+  int flags;
+  long offset;
+  int fd, count = 0;
+
+  for (fd = 0; fd < MAX_CALLBACK_FDS; fd++)
+    if (cb_save_fd (cb, fd, &name, &flags, &offset) > 0)
+      count++;
+  sim_checkpoint_write_word (f, count);
+
+  for (fd = 0; fd < MAX_CALLBACK_FDS; fd++)
+    if (cb_save_fd (cb, fd, &name, &flags, &offset) > 0)
+      {
+	sim_checkpoint_write_word (f, fd);
+	sim_checkpoint_write_word (f, flags);
+	sim_checkpoint_write_word (f, offset);
+	sim_checkpoint_write_word (f, strlen (name));
+	sim_checkpoint_write_bytes (f, name, strlen (name));
+      }
+}
+
+static void
+restore_files (SIM_DESC sd, sim_checkpoint_file *f, const char *file_name)
+{
+  host_callback *cb = STATE_CALLBACK (sd);
+  const char *name;
+  int flags;
+  long offset;
+  unsigned long count, i;
+  int fd;
+
+  count = sim_checkpoint_read_word (f);
+  if (f->error != NULL)
+    return;
+
+  /* Close whatever the restoring run has open so far.  */
+  for (fd = 0; fd < MAX_CALLBACK_FDS; fd++)
+    if (cb_save_fd (cb, fd, &name, &flags, &offset) != 0)
+      cb->close (cb, fd);
+
+  for (i = 0; i < count && f->error == NULL; i++)
+    {
+      unsigned long length;
+      char *path;
+
+      fd = sim_checkpoint_read_word (f);
+      flags = sim_checkpoint_read_word (f);
+      offset = sim_checkpoint_read_word (f);
+      length = sim_checkpoint_read_word (f);
+      if (f->error != NULL)
+	break;
+      path = (char *) xmalloc (length + 1);
+      sim_checkpoint_read_bytes (f, path, length);
+      path[length] = '\0';
+      if (f->error == NULL
+	  && cb_restore_fd (cb, fd, path, flags, offset) != 0)
+	{
+	  sim_io_eprintf (sd, "%s: cannot reopen `%s' as target fd %d\n",
+			  file_name, path, fd);
+	  f->error = "cannot reopen a file";
+	}
+      free (path);
+    }
+}
+
+SIM_RC
+sim_checkpoint_save (SIM_DESC sd, const char *file_name)
+{
+  host_callback *cb = STATE_CALLBACK (sd);
+  sim_checkpoint_file f;
+  const char *name;
+  int flags;
+  long offset;
+  sim_core_mapping *device;
+  int i, fd, nr_buffers;
+
+  /* Refuse before writing anything if some state cannot be saved.  */
+  for (i = 0; i < MAX_NR_PROCESSORS; ++i)
+    if (CPU_CHECKPOINT_SAVE (STATE_CPU (sd, i)) == NULL)
+      {
+	sim_io_eprintf (sd, "%s: this simulator does not support "
+			"checkpoints\n", file_name);
+	return SIM_RC_FAIL;
+      }
+  for (fd = 0; fd < MAX_CALLBACK_FDS; fd++)
+    if (cb_save_fd (cb, fd, &name, &flags, &offset) < 0)
+      {
+	sim_io_eprintf (sd, "%s: target fd %d cannot be checkpointed\n",
+			file_name, fd);
+	return SIM_RC_FAIL;
+      }
+  device = find_device_mapping (sd);
+  if (device != NULL)
+    {
+      sim_io_eprintf (sd, "%s: memory mapped device at 0x%lx cannot be "
+		      "checkpointed\n", file_name, (unsigned long) device->base);
+      return SIM_RC_FAIL;
+    }
+
+  f.sd = sd;
+  f.error = NULL;
+  f.file = fopen (file_name, "wb");
+  if (f.file == NULL)
+    {
+      sim_io_eprintf (sd, "%s: cannot create checkpoint\n", file_name);
+      return SIM_RC_FAIL;
+    }
+
+  sim_checkpoint_write_bytes (&f, CHECKPOINT_MAGIC, CHECKPOINT_MAGIC_SIZE);
+  sim_checkpoint_write_word (&f, CHECKPOINT_VERSION);
+
+  sim_checkpoint_write_word (&f, MAX_NR_PROCESSORS);
+  for (i = 0; i < MAX_NR_PROCESSORS; ++i)
+    {
+      sim_cpu *cpu = STATE_CPU (sd, i);
+
+      CPU_CHECKPOINT_SAVE (cpu) (cpu, &f);
+    }
+
+  sim_checkpoint_write_word (&f, sim_events_time (sd));
+
+  nr_buffers = for_each_memory_buffer (sd, NULL, NULL);
+  sim_checkpoint_write_word (&f, nr_buffers);
+  for_each_memory_buffer (sd, save_memory_buffer, &f);
+
+  save_files (sd, &f);
+
+  if (fclose (f.file) != 0 && f.error == NULL)
+    f.error = "write error";
+  if (f.error != NULL)
+    {
+      sim_io_eprintf (sd, "%s: %s\n", file_name, f.error);
+      return SIM_RC_FAIL;
+    }
+  return SIM_RC_OK;
+}
+
+SIM_RC
+sim_checkpoint_restore (SIM_DESC sd, const char *file_name)
+{
+  sim_checkpoint_file f;
+  char magic[CHECKPOINT_MAGIC_SIZE];
+  unsigned long count, i;
+
+  f.sd = sd;
+  f.error = NULL;
+  f.file = fopen (file_name, "rb");
+  if (f.file == NULL)
+    {
+      sim_io_eprintf (sd, "%s: cannot open checkpoint\n", file_name);
+      return SIM_RC_FAIL;
+    }
+
+  sim_checkpoint_read_bytes (&f, magic, sizeof (magic));
+  if (f.error == NULL
+      && (memcmp (magic, CHECKPOINT_MAGIC, sizeof (magic)) != 0
+	  || sim_checkpoint_read_word (&f) != CHECKPOINT_VERSION))
+    f.error = "not a simulator checkpoint";
+
+  count = sim_checkpoint_read_word (&f);
+  if (f.error == NULL && count != MAX_NR_PROCESSORS)
+    f.error = "checkpoint has a different number of cpus";
+  for (i = 0; i < MAX_NR_PROCESSORS && f.error == NULL; ++i)
+    {
+      sim_cpu *cpu = STATE_CPU (sd, i);
+
+      if (CPU_CHECKPOINT_RESTORE (cpu) == NULL)
+	f.error = "this simulator does not support checkpoints";
+      else
+	CPU_CHECKPOINT_RESTORE (cpu) (cpu, &f);
+    }
+
+  if (f.error == NULL)
+    sim_events_set_time (sd, sim_checkpoint_read_word (&f));
+
+  count = sim_checkpoint_read_word (&f);
+  for (i = 0; i < count && f.error == NULL; i++)
+    restore_memory_buffer (sd, &f);
+
+  restore_files (sd, &f, file_name);
+
+  fclose (f.file);
+  if (f.error != NULL)
+    {
+      sim_io_eprintf (sd, "%s: %s\n", file_name, f.error);
+      return SIM_RC_FAIL;
+    }
+  return SIM_RC_OK;
+}
+
+static void
+checkpoint_save_event (SIM_DESC sd, void *data)
+{
+  struct sim_checkpoint_state *state = STATE_CHECKPOINT (sd);
+
+  state->save_event = NULL;
+  sim_checkpoint_save (sd, state->save_file);
+}
+
+/* Arrange for the checkpoint asked for by the options to be saved.  */
+
+static SIM_RC
+schedule_checkpoint_save (SIM_DESC sd)
+{
+  struct sim_checkpoint_state *state = STATE_CHECKPOINT (sd);
+
+  if (state->save_event != NULL)
+    {
+      sim_events_deschedule (sd, state->save_event);
+      state->save_event = NULL;
+    }
+
+  if (state->save_after_p || state->save_at_pc_p)
+    {
+      if (state->save_file == NULL)
+	{
+	  sim_io_eprintf (sd, "Missing --checkpoint-save option\n");
+	  return SIM_RC_FAIL;
+	}
+    }
+  else
+    return SIM_RC_OK;
+
+  if (state->save_after_p)
+    {
+      signed64 delta = state->save_after - sim_events_time (sd);
+
+      state->save_event = sim_events_schedule (sd, delta > 0 ? delta : 0,
+					       checkpoint_save_event, NULL);
+    }
+  else
+    {
+      sim_watchpoints *watch = STATE_WATCHPOINTS (sd);
+
+      if (watch->pc == NULL)
+	{
+	  sim_io_eprintf (sd, "--checkpoint-at-pc is not supported by "
+			  "this simulator\n");
+	  return SIM_RC_FAIL;
+	}
+      state->save_event = sim_events_watch_sim (sd, watch->pc,
+						watch->sizeof_pc,
+						BFD_ENDIAN_UNKNOWN,
+						1, state->save_at_pc,
+						state->save_at_pc,
+						checkpoint_save_event, NULL);
+    }
+  return SIM_RC_OK;
+}
+
+enum {
+  OPTION_CHECKPOINT_SAVE = OPTION_START,
+  OPTION_CHECKPOINT_AFTER,
+  OPTION_CHECKPOINT_AT_PC,
+  OPTION_CHECKPOINT_RESTORE
+};
+
+static DECLARE_OPTION_HANDLER (checkpoint_option_handler);
+
+static const OPTION checkpoint_options[] =
+{
+  { {"checkpoint-save", required_argument, NULL, OPTION_CHECKPOINT_SAVE },
+      '\0', "FILE", "Save a checkpoint to FILE (now, if given as a command)",
+      checkpoint_option_handler },
+
+  { {"checkpoint-after", required_argument, NULL, OPTION_CHECKPOINT_AFTER },
+      '\0', "TICKS", "Save the checkpoint once TICKS ticks have passed",
+      checkpoint_option_handler },
+
+  { {"checkpoint-at-pc", required_argument, NULL, OPTION_CHECKPOINT_AT_PC },
+      '\0', "ADDRESS", "Save the checkpoint when the PC first reaches ADDRESS",
+      checkpoint_option_handler },
+
+  { {"checkpoint-restore", required_argument, NULL,
+     OPTION_CHECKPOINT_RESTORE },
+      '\0', "FILE", "Restore the checkpoint in FILE before running",
+      checkpoint_option_handler },
+
+  { {NULL, no_argument, NULL, 0}, '\0', NULL, NULL, NULL }
+};
+
+static SIM_RC
+checkpoint_option_handler (SIM_DESC sd, sim_cpu *cpu, int opt,
+			   char *arg, int is_command)
+{
+  struct sim_checkpoint_state *state = STATE_CHECKPOINT (sd);
+
+  switch (opt)
+    {
+    case OPTION_CHECKPOINT_SAVE:
+      free (state->save_file);
+      state->save_file = xstrdup (arg);
+      if (!state->initialized)
+	return SIM_RC_OK;
+      if (!state->save_after_p && !state->save_at_pc_p)
+	return sim_checkpoint_save (sd, arg);
+      return schedule_checkpoint_save (sd);
+
+    case OPTION_CHECKPOINT_AFTER:
+      state->save_after = strtoul (arg, NULL, 0);
+      state->save_after_p = 1;
+      state->save_at_pc_p = 0;
+      return state->initialized ? schedule_checkpoint_save (sd) : SIM_RC_OK;
+
+    case OPTION_CHECKPOINT_AT_PC:
+      state->save_at_pc = strtoul (arg, NULL, 0);
+      state->save_at_pc_p = 1;
+      state->save_after_p = 0;
+      return state->initialized ? schedule_checkpoint_save (sd) : SIM_RC_OK;
+
+    case OPTION_CHECKPOINT_RESTORE:
+      if (state->initialized)
+	return sim_checkpoint_restore (sd, arg);
+      /* The program is not loaded yet; restore on the first resume.  */
+      free (state->restore_file);
+      state->restore_file = xstrdup (arg);
+      return SIM_RC_OK;
+
+    default:
+      sim_io_eprintf (sd, "Unknown checkpoint option %d\n", opt);
+      return SIM_RC_FAIL;
+    }
+}
+
+static SIM_RC
+sim_checkpoint_init (SIM_DESC sd)
+{
+  struct sim_checkpoint_state *state = STATE_CHECKPOINT (sd);
+
+  state->initialized = 1;
+  /* The event queue has just been emptied.  */
+  state->save_event = NULL;
+  return schedule_checkpoint_save (sd);
+}
+
+static SIM_RC
+sim_checkpoint_resume (SIM_DESC sd)
+{
+  struct sim_checkpoint_state *state = STATE_CHECKPOINT (sd);
+  char *file_name = state->restore_file;
+
+  if (file_name == NULL)
+    return SIM_RC_OK;
+  state->restore_file = NULL;
+  if (sim_checkpoint_restore (sd, file_name) != SIM_RC_OK)
+    sim_io_error (sd, "%s: checkpoint restore failed", file_name);
+  free (file_name);
+  return SIM_RC_OK;
+}
+
+static void
+sim_checkpoint_uninstall (SIM_DESC sd)
+{
+  struct sim_checkpoint_state *state = STATE_CHECKPOINT (sd);
+
+  free (state->save_file);
+  free (state->restore_file);
+  free (state);
+  STATE_CHECKPOINT (sd) = NULL;
+}
+
+SIM_RC
+sim_checkpoint_install (SIM_DESC sd)
+{
+  SIM_ASSERT (STATE_MAGIC (sd) == SIM_MAGIC_NUMBER);
+  STATE_CHECKPOINT (sd) = ZALLOC (struct sim_checkpoint_state);
+  sim_add_option_table (sd, NULL, checkpoint_options);
+  sim_module_add_uninstall_fn (sd, sim_checkpoint_uninstall);
+  sim_module_add_init_fn (sd, sim_checkpoint_init);
+  sim_module_add_resume_fn (sd, sim_checkpoint_resume);
+  return SIM_RC_OK;
+}
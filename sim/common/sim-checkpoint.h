@@ -0,0 +1,62 @@
+/* Simulator checkpoint/restore support.
+   Copyright (C) 2016 Free Software Foundation, Inc.
+
+This file is part of GDB, the GNU debugger.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef SIM_CHECKPOINT_H
+#define SIM_CHECKPOINT_H
+
+/* A checkpoint holds the machine state of a stopped simulation: the
+   cpus, the contents of memory, the event clock and the files opened
+   through the syscall layer.  A later run of the same program with the
+   same memory configuration can restore it and carry on from there
+   instead of repeating the work that led up to it.
+
+   The common code saves everything but the cpus.  A simulator that
+   supports checkpoints sets CPU_CHECKPOINT_SAVE and
+   CPU_CHECKPOINT_RESTORE, which write and read the cpu state with the
+   functions below.  */
+
+typedef struct _sim_checkpoint_file sim_checkpoint_file;
+
+/* Write an unsigned number, or LENGTH bytes at BUF.  */
+extern void sim_checkpoint_write_word (sim_checkpoint_file *, unsigned64);
+extern void sim_checkpoint_write_bytes (sim_checkpoint_file *,
+					const void *buf,
+					unsigned long length);
+
+/* Read what the above wrote.  After an error, reads return zeros and
+   the restore fails once the cpu routine returns.  */
+extern unsigned64 sim_checkpoint_read_word (sim_checkpoint_file *);
+extern void sim_checkpoint_read_bytes (sim_checkpoint_file *, void *buf,
+				       unsigned long length);
+
+/* Report that the data being read does not describe this cpu.  */
+extern void sim_checkpoint_mismatch (sim_checkpoint_file *, const char *why);
+
+typedef void (CPU_CHECKPOINT_SAVE_FN) (sim_cpu *, sim_checkpoint_file *);
+typedef void (CPU_CHECKPOINT_RESTORE_FN) (sim_cpu *, sim_checkpoint_file *);
+
+/* Write a checkpoint of SD to FILE_NAME, or restore one.  Return
+   SIM_RC_FAIL and print a message on error.  A failed restore can
+   leave the simulator partly restored.  */
+extern SIM_RC sim_checkpoint_save (SIM_DESC sd, const char *file_name);
+extern SIM_RC sim_checkpoint_restore (SIM_DESC sd, const char *file_name);
+
+/* Install the "checkpoint" module.  */
+MODULE_INSTALL_FN sim_checkpoint_install;
+
+#endif /* SIM_CHECKPOINT_H */
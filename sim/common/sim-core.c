@@ -56,6 +56,18 @@ sim_core_install (SIM_DESC sd)
 #endif
 
 
+/* Discard every cached page lookup in ACCESS_MAP.  Must be called
+   whenever the mapping list changes.  */
+
+#if EXTERN_SIM_CORE_P
+static void
+sim_core_tlb_flush (sim_core_map *access_map)
+{
+  memset (access_map->tlb, 0, sizeof (access_map->tlb));
+}
+#endif
+
+
 /* Uninstall the "core" subsystem from the simulator.  */
 
 #if EXTERN_SIM_CORE_P
@@ -77,6 +89,7 @@ sim_core_uninstall (SIM_DESC sd)
       free (tbd);
     }
     core->common.map[map].first = NULL;
+    sim_core_tlb_flush (&core->common.map[map]);
   }
 }
 #endif
@@ -237,6 +250,7 @@ sim_core_map_attach (SIM_DESC sd,
 					space, addr, nr_bytes, modulo,
 					client, buffer, free_buffer);
   (*last_mapping)->next = next_mapping;
+  sim_core_tlb_flush (access_map);
 }
 #endif
 
@@ -374,6 +388,7 @@ sim_core_map_detach (SIM_DESC sd,
 	  if (dead->free_buffer != NULL)
 	    free (dead->free_buffer);
 	  free (dead);
+	  sim_core_tlb_flush (access_map);
 	  return;
 	}
     }
@@ -409,6 +424,63 @@ sim_core_detach (SIM_DESC sd,
 #endif
 
 
+STATIC_INLINE_SIM_CORE\
+(void *)
+sim_core_translate (sim_core_mapping *mapping,
+		    address_word addr)
+{
+  return (void *)((unsigned8 *) mapping->buffer
+		  + ((addr - mapping->base) & mapping->mask));
+}
+
+
+/* Record that PAGE is entirely covered by MAPPING.  When the page is
+   plain memory that is contiguous on the host (a modulo smaller than
+   the page wraps around), also cache its host address so that
+   aligned accesses can skip the translation.  */
+
+STATIC_INLINE_SIM_CORE\
+(void)
+sim_core_tlb_fill (sim_core_tlb_entry *entry,
+		   address_word page,
+		   sim_core_mapping *mapping)
+{
+  address_word page_base = page << SIM_CORE_TLB_PAGE_BITS;
+  entry->page = page;
+  entry->mapping = mapping;
+  entry->host = NULL;
+  if (mapping->device == NULL)
+    {
+      unsigned8 *first = sim_core_translate (mapping, page_base);
+      unsigned8 *last = sim_core_translate (mapping,
+					    page_base
+					    + (SIM_CORE_TLB_PAGE_SIZE - 1));
+      if (last - first == SIM_CORE_TLB_PAGE_SIZE - 1)
+	entry->host = first;
+    }
+}
+
+
+/* Return the host address of the NR_BYTES at ADDR if they lie in a
+   page of plain memory cached by the TLB, otherwise NULL.  */
+
+STATIC_INLINE_SIM_CORE\
+(void *)
+sim_core_tlb_host (sim_core_common *core,
+		   unsigned map,
+		   address_word addr,
+		   unsigned nr_bytes)
+{
+  address_word page = addr >> SIM_CORE_TLB_PAGE_BITS;
+  sim_core_tlb_entry *entry = &core->map[map].tlb[page % SIM_CORE_TLB_SIZE];
+  if (entry->host != NULL
+      && entry->page == page
+      && ((addr + (nr_bytes - 1)) >> SIM_CORE_TLB_PAGE_BITS) == page)
+    return entry->host + (addr & (SIM_CORE_TLB_PAGE_SIZE - 1));
+  return NULL;
+}
+
+
 STATIC_INLINE_SIM_CORE\
 (sim_core_mapping *)
 sim_core_find_mapping (sim_core_common *core,
@@ -420,16 +492,39 @@ sim_core_find_mapping (sim_core_common *core,
 		       sim_cpu *cpu, /* abort => cpu != NULL */
 		       sim_cia cia)
 {
-  sim_core_mapping *mapping = core->map[map].first;
+  sim_core_map *access_map = &core->map[map];
+  address_word page = addr >> SIM_CORE_TLB_PAGE_BITS;
+  sim_core_tlb_entry *entry = &access_map->tlb[page % SIM_CORE_TLB_SIZE];
+  address_word page_base = page << SIM_CORE_TLB_PAGE_BITS;
+  address_word page_bound = page_base | (SIM_CORE_TLB_PAGE_SIZE - 1);
+  sim_core_mapping *mapping;
+  int page_shadowed;
   ASSERT ((addr & (nr_bytes - 1)) == 0); /* must be aligned */
   ASSERT ((addr + (nr_bytes - 1)) >= addr); /* must not wrap */
   ASSERT (!abort || cpu != NULL); /* abort needs a non null CPU */
-  while (mapping != NULL)
+
+  /* Try the TLB first; the access must not run off the cached page.  */
+  if (entry->mapping != NULL
+      && entry->page == page
+      && ((addr + (nr_bytes - 1)) >> SIM_CORE_TLB_PAGE_BITS) == page)
+    return entry->mapping;
+
+  /* Walk the list, remembering whether any mapping searched before
+     the one found overlaps this page.  */
+  page_shadowed = 0;
+  for (mapping = access_map->first; mapping != NULL; mapping = mapping->next)
     {
       if (addr >= mapping->base
 	  && (addr + (nr_bytes - 1)) <= mapping->bound)
-	return mapping;
-      mapping = mapping->next;
+	{
+	  if (!page_shadowed
+	      && mapping->base <= page_base
+	      && mapping->bound >= page_bound)
+	    sim_core_tlb_fill (entry, page, mapping);
+	  return mapping;
+	}
+      if (mapping->base <= page_bound && mapping->bound >= page_base)
+	page_shadowed = 1;
     }
   if (abort)
     {
@@ -440,16 +535,6 @@ sim_core_find_mapping (sim_core_common *core,
 }
 
 
-STATIC_INLINE_SIM_CORE\
-(void *)
-sim_core_translate (sim_core_mapping *mapping,
-		    address_word addr)
-{
-  return (void *)((unsigned8 *) mapping->buffer
-		  + ((addr - mapping->base) & mapping->mask));
-}
-
-
 #if EXTERN_SIM_CORE_P
 unsigned
 sim_core_read_buffer (SIM_DESC sd,
@@ -64,9 +64,37 @@ struct _sim_core_mapping {
   sim_core_mapping *next;
 };
 
+/* Each access map caches recent page lookups in a small direct mapped
+   table (a TLB) so that the mapping list only needs to be walked on a
+   miss.  An entry is only filled when a single mapping covers the
+   whole page and no mapping ahead of it in the list touches that
+   page, so a hit always returns what the list walk would have.  The
+   table is flushed whenever the mapping list changes.  */
+
+#ifndef SIM_CORE_TLB_PAGE_BITS
+#define SIM_CORE_TLB_PAGE_BITS 12
+#endif
+#define SIM_CORE_TLB_PAGE_SIZE ((address_word) 1 << SIM_CORE_TLB_PAGE_BITS)
+
+#ifndef SIM_CORE_TLB_SIZE
+#define SIM_CORE_TLB_SIZE 64
+#endif
+
+typedef struct _sim_core_tlb_entry sim_core_tlb_entry;
+struct _sim_core_tlb_entry {
+  /* page number (ADDR >> SIM_CORE_TLB_PAGE_BITS); only meaningful
+     when MAPPING is non-NULL */
+  address_word page;
+  sim_core_mapping *mapping;
+  /* host address of the start of the page when it is plain memory
+     laid out contiguously, otherwise NULL */
+  unsigned8 *host;
+};
+
 typedef struct _sim_core_map sim_core_map;
 struct _sim_core_map {
   sim_core_mapping *first;
+  sim_core_tlb_entry tlb[SIM_CORE_TLB_SIZE];
 };
 
 
@@ -120,6 +120,13 @@ typedef struct {
   PC_STORE_FN *pc_store;
 #define CPU_PC_STORE(c) ((c)->base.pc_store)
 
+  /* Routines to save/restore the cpu in a checkpoint.  See
+     sim-checkpoint.h.  */
+  CPU_CHECKPOINT_SAVE_FN *checkpoint_save;
+#define CPU_CHECKPOINT_SAVE(c) ((c)->base.checkpoint_save)
+  CPU_CHECKPOINT_RESTORE_FN *checkpoint_restore;
+#define CPU_CHECKPOINT_RESTORE(c) ((c)->base.checkpoint_restore)
+
 } sim_cpu_base;
 
 /* Create all cpus.  */
@@ -820,6 +820,26 @@ sim_events_deschedule (SIM_DESC sd,
 #endif
 
 
+#if EXTERN_SIM_EVENTS_P
+void
+sim_events_set_time (SIM_DESC sd,
+		     signed64 time)
+{
+  sim_events *events = STATE_EVENTS (sd);
+  signed64 delta = time - sim_events_time (sd);
+  sim_event *event;
+
+  for (event = events->queue; event != NULL; event = event->next)
+    event->time_of_event += delta;
+  events->time_of_event += delta;
+  ETRACE ((_ETRACE,
+	   "event time set to %ld\n",
+	   (long) sim_events_time (sd)));
+  SIM_ASSERT (sim_events_time (sd) == time);
+}
+#endif
+
+
 STATIC_INLINE_SIM_EVENTS\
 (int)
 sim_watch_valid (SIM_DESC sd,
@@ -195,6 +195,13 @@ extern void sim_events_deschedule
 (SIM_DESC sd,
  sim_event *event_to_remove);
 
+/* Move the clock to TIME, as when restoring a checkpoint.  Pending
+   timer events keep their distance from the current time.  */
+
+extern void sim_events_set_time
+(SIM_DESC sd,
+ signed64 time);
+
 
 /* Prepare for main simulator loop.  Ensure that the next thing to do
    is not event processing.
@@ -51,6 +51,8 @@ static MODULE_INSTALL_FN * const modules[] = {
   sim_core_install,
   sim_memopt_install,
   sim_watchpoint_install,
+  sim_checkpoint_install,
+  sim_break_install,
 #if WITH_SCACHE
   scache_install,
 #endif
@@ -28,7 +28,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
    provide a uniform framework for all of the pieces that make up the
    simulator.
 
-   TODO: Add facilities for saving/restoring state to/from a file.  */
+   Saving/restoring state to/from a file is handled by sim-checkpoint.c.  */
 
 #include "gdb/remote-sim.h"
 
@@ -154,6 +154,7 @@ sim_core_read_aligned_N(sim_cpu *cpu,
   sim_core_common *core = &cpu_core->common;
   unsigned_M val;
   sim_core_mapping *mapping;
+  void *host;
   address_word addr;
 #if WITH_XOR_ENDIAN != 0
   if (WITH_XOR_ENDIAN)
@@ -161,6 +162,15 @@ sim_core_read_aligned_N(sim_cpu *cpu,
   else
 #endif
     addr = xaddr;
+  host = sim_core_tlb_host (core, map, addr, N);
+  if (host != NULL)
+    {
+      val = T2H_M (*(unsigned_M*) host);
+      PROFILE_COUNT_CORE (cpu, addr, N, map);
+      if (TRACE_P (cpu, TRACE_CORE_IDX))
+	sim_core_trace_M (cpu, cia, __LINE__, read_transfer, map, addr, val, N);
+      return val;
+    }
   mapping = sim_core_find_mapping (core, map, addr, N, read_transfer, 1 /*abort*/, cpu, cia);
   do
     {
@@ -274,6 +284,7 @@ sim_core_write_aligned_N(sim_cpu *cpu,
   sim_cpu_core *cpu_core = CPU_CORE (cpu);
   sim_core_common *core = &cpu_core->common;
   sim_core_mapping *mapping;
+  void *host;
   address_word addr;
 #if WITH_XOR_ENDIAN != 0
   if (WITH_XOR_ENDIAN)
@@ -281,6 +292,15 @@ sim_core_write_aligned_N(sim_cpu *cpu,
   else
 #endif
     addr = xaddr;
+  host = sim_core_tlb_host (core, map, addr, N);
+  if (host != NULL)
+    {
+      *(unsigned_M*) host = H2T_M (val);
+      PROFILE_COUNT_CORE (cpu, addr, N, map);
+      if (TRACE_P (cpu, TRACE_CORE_IDX))
+	sim_core_trace_M (cpu, cia, __LINE__, write_transfer, map, addr, val, N);
+      return;
+    }
   mapping = sim_core_find_mapping (core, map, addr, N, write_transfer, 1 /*abort*/, cpu, cia);
   do
     {
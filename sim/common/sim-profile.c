@@ -42,6 +42,8 @@ static unsigned int _profile_stub;
 # define PROFILE_PC_SHIFT(p) _profile_stub
 # define PROFILE_PC_START(p) _profile_stub
 # define PROFILE_PC_END(p) _profile_stub
+# define PROFILE_PC_EXACT(p) _profile_stub
+# define PROFILE_PC_CALL_GRAPH(p) _profile_stub
 # define PROFILE_INSN_COUNT(p) &_profile_stub
 #endif
 
@@ -62,6 +64,8 @@ enum {
   OPTION_PROFILE_PC,
   OPTION_PROFILE_PC_RANGE,
   OPTION_PROFILE_PC_GRANULARITY,
+  OPTION_PROFILE_PC_EXACT,
+  OPTION_PROFILE_CALL_GRAPH,
   OPTION_PROFILE_RANGE,
   OPTION_PROFILE_FUNCTION
 };
@@ -106,6 +110,12 @@ static const OPTION profile_options[] = {
   { {"profile-pc-range", required_argument, NULL, OPTION_PROFILE_PC_RANGE},
       '\0', "BASE,BOUND", "Specify PC profiling address range",
       profile_option_handler, NULL },
+  { {"profile-pc-exact", optional_argument, NULL, OPTION_PROFILE_PC_EXACT},
+      '\0', "on|off", "Count every instruction instead of sampling the PC",
+      profile_option_handler, NULL },
+  { {"profile-call-graph", optional_argument, NULL, OPTION_PROFILE_CALL_GRAPH},
+      '\0', "on|off", "Record call arcs for gprof",
+      profile_option_handler, NULL },
 
 #ifdef SIM_HAVE_ADDR_RANGE
   { {"profile-range", required_argument, NULL, OPTION_PROFILE_RANGE},
@@ -121,31 +131,43 @@ static const OPTION profile_options[] = {
   { {NULL, no_argument, NULL, 0}, '\0', NULL, NULL, NULL, NULL }
 };
 
-/* Set/reset the profile options indicated in MASK.  */
+/* Parse the optional on|off argument ARG of `--profile<NAME>' into
+   *VAL.  A missing argument means on.  */
 
-SIM_RC
-set_profile_option_mask (SIM_DESC sd, const char *name, int mask, const char *arg)
+static SIM_RC
+parse_on_off (SIM_DESC sd, const char *name, const char *arg, int *val)
 {
-  int profile_nr;
-  int cpu_nr;
-  int profile_val = 1;
-
+  *val = 1;
   if (arg != NULL)
     {
       if (strcmp (arg, "yes") == 0
 	  || strcmp (arg, "on") == 0
 	  || strcmp (arg, "1") == 0)
-	profile_val = 1;
+	*val = 1;
       else if (strcmp (arg, "no") == 0
 	       || strcmp (arg, "off") == 0
 	       || strcmp (arg, "0") == 0)
-	profile_val = 0;
+	*val = 0;
       else
 	{
 	  sim_io_eprintf (sd, "Argument `%s' for `--profile%s' invalid, one of `on', `off', `yes', `no' expected\n", arg, name);
 	  return SIM_RC_FAIL;
 	}
     }
+  return SIM_RC_OK;
+}
+
+/* Set/reset the profile options indicated in MASK.  */
+
+SIM_RC
+set_profile_option_mask (SIM_DESC sd, const char *name, int mask, const char *arg)
+{
+  int profile_nr;
+  int cpu_nr;
+  int profile_val;
+
+  if (parse_on_off (sd, name, arg, &profile_val) != SIM_RC_OK)
+    return SIM_RC_FAIL;
 
   /* update applicable profile bits */
   for (profile_nr = 0; profile_nr < MAX_PROFILE_VALUES; ++profile_nr)
@@ -421,6 +443,31 @@ profile_option_handler (SIM_DESC sd,
 	sim_io_eprintf (sd, "PC profiling not compiled in, `--profile-pc-range' ignored\n");
       break;
 
+    case OPTION_PROFILE_PC_EXACT:
+    case OPTION_PROFILE_CALL_GRAPH:
+      if (WITH_PROFILE_PC_P)
+	{
+	  int val;
+	  const char *name = (opt == OPTION_PROFILE_PC_EXACT
+			      ? "-pc-exact" : "-call-graph");
+	  if (parse_on_off (sd, name, arg, &val) != SIM_RC_OK)
+	    return SIM_RC_FAIL;
+	  for (cpu_nr = 0; cpu_nr < MAX_NR_PROCESSORS; ++cpu_nr)
+	    {
+	      PROFILE_DATA *data = CPU_PROFILE_DATA (STATE_CPU (sd, cpu_nr));
+	      if (opt == OPTION_PROFILE_PC_EXACT)
+		PROFILE_PC_EXACT (data) = val;
+	      else
+		PROFILE_PC_CALL_GRAPH (data) = val;
+	    }
+	  if (val)
+	    return sim_profile_set_option (sd, "-pc", PROFILE_PC_IDX, NULL);
+	}
+      else
+	sim_io_eprintf (sd, "PC profiling not compiled in, `--profile%s' ignored\n",
+			opt == OPTION_PROFILE_PC_EXACT ? "-pc-exact" : "-call-graph");
+      break;
+
 #ifdef SIM_HAVE_ADDR_RANGE
     case OPTION_PROFILE_RANGE :
       if (WITH_PROFILE)
@@ -490,6 +537,20 @@ profile_printf (SIM_DESC sd, sim_cpu *cpu, const char *fmt, ...)
 
 #if WITH_PROFILE_PC_P
 
+/* One caller/callee pair recorded by the call graph profiler.  */
+
+typedef struct _profile_pc_arc profile_pc_arc;
+struct _profile_pc_arc {
+  address_word from_pc;
+  address_word self_pc;
+  unsigned long count;
+  profile_pc_arc *next;
+};
+
+/* Initial number of hash chains for call arcs; the table doubles
+   whenever the chains get longer than two on average.  */
+#define PROFILE_PC_ARCS_INITIAL_SIZE 1024
+
 static void
 profile_pc_cleanup (SIM_DESC sd)
 {
@@ -504,6 +565,25 @@ profile_pc_cleanup (SIM_DESC sd)
       if (PROFILE_PC_EVENT (data) != NULL)
 	sim_events_deschedule (sd, PROFILE_PC_EVENT (data));
       PROFILE_PC_EVENT (data) = NULL;
+      if (PROFILE_PC_ARCS (data) != NULL)
+	{
+	  unsigned i;
+	  for (i = 0; i < PROFILE_PC_ARCS_SIZE (data); i++)
+	    {
+	      profile_pc_arc *arc = PROFILE_PC_ARCS (data)[i];
+	      while (arc != NULL)
+		{
+		  profile_pc_arc *next = arc->next;
+		  free (arc);
+		  arc = next;
+		}
+	    }
+	  free (PROFILE_PC_ARCS (data));
+	}
+      PROFILE_PC_ARCS (data) = NULL;
+      PROFILE_PC_ARCS_SIZE (data) = 0;
+      PROFILE_PC_NR_ARCS (data) = 0;
+      PROFILE_PC_LAST_ARC (data) = NULL;
     }
 }
 
@@ -514,23 +594,114 @@ profile_pc_uninstall (SIM_DESC sd)
   profile_pc_cleanup (sd);
 }
 
+/* Add one hit for PC to the histogram of PROFILE.  */
+
 static void
-profile_pc_event (SIM_DESC sd,
-		  void *data)
+profile_pc_count (PROFILE_DATA *profile, address_word pc)
 {
-  sim_cpu *cpu = (sim_cpu*) data;
-  PROFILE_DATA *profile = CPU_PROFILE_DATA (cpu);
-  address_word pc = sim_pc_get (cpu);
-  unsigned i;
+  address_word i;
   i = (pc - PROFILE_PC_START (profile)) >> PROFILE_PC_SHIFT (profile);
   if (i < PROFILE_PC_NR_BUCKETS (profile))
     PROFILE_PC_COUNT (profile) [i] += 1; /* Overflow? */
   else
     PROFILE_PC_COUNT (profile) [PROFILE_PC_NR_BUCKETS (profile)] += 1;
+}
+
+static void
+profile_pc_event (SIM_DESC sd,
+		  void *data)
+{
+  sim_cpu *cpu = (sim_cpu*) data;
+  PROFILE_DATA *profile = CPU_PROFILE_DATA (cpu);
+  profile_pc_count (profile, sim_pc_get (cpu));
   PROFILE_PC_EVENT (profile) =
     sim_events_schedule (sd, PROFILE_PC_FREQ (profile), profile_pc_event, cpu);
 }
 
+/* Count the instruction at PC (--profile-pc-exact).  */
+
+void
+sim_profile_pc_insn (sim_cpu *cpu, address_word pc)
+{
+  profile_pc_count (CPU_PROFILE_DATA (cpu), pc);
+}
+
+static unsigned
+profile_pc_arc_hash (address_word from_pc, address_word self_pc,
+		     unsigned size)
+{
+  /* Instructions are at least two byte aligned.  */
+  return ((from_pc >> 1) * 31 + (self_pc >> 1)) & (size - 1);
+}
+
+/* Double the number of hash chains for call arcs in PROFILE.  */
+
+static void
+profile_pc_arcs_grow (PROFILE_DATA *profile)
+{
+  unsigned old_size = PROFILE_PC_ARCS_SIZE (profile);
+  unsigned new_size = old_size * 2;
+  profile_pc_arc **old_arcs = PROFILE_PC_ARCS (profile);
+  profile_pc_arc **new_arcs = NZALLOC (profile_pc_arc *, new_size);
+  unsigned i;
+
+  for (i = 0; i < old_size; i++)
+    {
+      profile_pc_arc *arc = old_arcs[i];
+      while (arc != NULL)
+	{
+	  profile_pc_arc *next = arc->next;
+	  unsigned h = profile_pc_arc_hash (arc->from_pc, arc->self_pc,
+					    new_size);
+	  arc->next = new_arcs[h];
+	  new_arcs[h] = arc;
+	  arc = next;
+	}
+    }
+  free (old_arcs);
+  PROFILE_PC_ARCS (profile) = new_arcs;
+  PROFILE_PC_ARCS_SIZE (profile) = new_size;
+}
+
+/* Record a call from the instruction at FROM_PC to the function at
+   SELF_PC (--profile-call-graph).  */
+
+void
+sim_profile_pc_call (sim_cpu *cpu, address_word from_pc,
+		     address_word self_pc)
+{
+  PROFILE_DATA *profile = CPU_PROFILE_DATA (cpu);
+  profile_pc_arc *arc = PROFILE_PC_LAST_ARC (profile);
+  unsigned h;
+
+  /* Calls from a loop keep hitting the same arc.  */
+  if (arc != NULL && arc->from_pc == from_pc && arc->self_pc == self_pc)
+    {
+      arc->count += 1;
+      return;
+    }
+
+  h = profile_pc_arc_hash (from_pc, self_pc, PROFILE_PC_ARCS_SIZE (profile));
+  for (arc = PROFILE_PC_ARCS (profile)[h]; arc != NULL; arc = arc->next)
+    if (arc->from_pc == from_pc && arc->self_pc == self_pc)
+      break;
+
+  if (arc == NULL)
+    {
+      arc = ZALLOC (profile_pc_arc);
+      arc->from_pc = from_pc;
+      arc->self_pc = self_pc;
+      arc->next = PROFILE_PC_ARCS (profile)[h];
+      PROFILE_PC_ARCS (profile)[h] = arc;
+      PROFILE_PC_NR_ARCS (profile) += 1;
+      if (PROFILE_PC_NR_ARCS (profile) > 2 * PROFILE_PC_ARCS_SIZE (profile))
+	profile_pc_arcs_grow (profile);
+    }
+
+  arc->count += 1;
+  PROFILE_PC_LAST_ARC (profile) = arc;
+}
+
 static SIM_RC
 profile_pc_init (SIM_DESC sd)
 {
@@ -552,6 +723,13 @@ profile_pc_init (SIM_DESC sd)
 	      PROFILE_PC_START (data) = STATE_TEXT_START (sd);
 	      PROFILE_PC_END (data) = STATE_TEXT_END (sd);
 	    }
+	  /* When counting every instruction, default to one bucket per
+	     instruction rather than a fixed number of buckets.  */
+	  if (PROFILE_PC_EXACT (data)
+	      && PROFILE_PC_END (data) != 0
+	      && PROFILE_PC_NR_BUCKETS (data) == 0
+	      && PROFILE_PC_BUCKET_SIZE (data) == 0)
+	    PROFILE_PC_SHIFT (data) = PROFILE_PC_EXACT_SHIFT;
 	  /* Compute the number of buckets if not specified. */
 	  if (PROFILE_PC_NR_BUCKETS (data) == 0)
 	    {
@@ -603,16 +781,153 @@ profile_pc_init (SIM_DESC sd)
 	  /* create the relevant buffers */
 	  PROFILE_PC_COUNT (data) =
 	    NZALLOC (unsigned, PROFILE_PC_NR_BUCKETS (data) + 1);
-	  PROFILE_PC_EVENT (data) =
-	    sim_events_schedule (sd,
-				 PROFILE_PC_FREQ (data),
-				 profile_pc_event,
-				 cpu);
+	  if (!PROFILE_PC_EXACT (data))
+	    PROFILE_PC_EVENT (data) =
+	      sim_events_schedule (sd,
+				   PROFILE_PC_FREQ (data),
+				   profile_pc_event,
+				   cpu);
+	  if (PROFILE_PC_CALL_GRAPH (data))
+	    {
+	      PROFILE_PC_ARCS_SIZE (data) = PROFILE_PC_ARCS_INITIAL_SIZE;
+	      PROFILE_PC_ARCS (data) =
+		NZALLOC (profile_pc_arc *, PROFILE_PC_ARCS_SIZE (data));
+	    }
 	}
     }
   return SIM_RC_OK;
 }
 
+/* Write a gmon.out file in gprof's tagged format (see
+   gprof/gmon_out.h), holding the histogram and any call arcs of CPU.
+   Unlike the BSD format this records addresses at the target's
+   size and accepts call arcs.  Everything is in target byte order.  */
+
+#define GMON_MAGIC "gmon"
+#define GMON_VERSION 1
+#define GMON_TAG_TIME_HIST 0
+#define GMON_TAG_CG_ARC 1
+
+static int
+profile_gmon_write_32 (FILE *pf, unsigned32 val)
+{
+  H2T (val);
+  return fwrite (&val, sizeof (val), 1, pf);
+}
+
+static int
+profile_gmon_write_vma (FILE *pf, int vma_size, address_word vma)
+{
+  if (vma_size == 4)
+    return profile_gmon_write_32 (pf, vma);
+  else
+    {
+      unsigned64 val = vma;
+      H2T (val);
+      return fwrite (&val, sizeof (val), 1, pf);
+    }
+}
+
+static int
+profile_write_gmon (sim_cpu *cpu, FILE *pf)
+{
+  SIM_DESC sd = CPU_STATE (cpu);
+  PROFILE_DATA *profile = CPU_PROFILE_DATA (cpu);
+  bfd *abfd = STATE_PROG_BFD (sd);
+  static const char spare[12];
+  address_word low_pc, high_pc;
+  unsigned long max_count;
+  unsigned long pass;
+  unsigned i;
+  int vma_size;
+  int ok;
+
+  vma_size = abfd != NULL ? bfd_get_arch_size (abfd) : -1;
+  if (vma_size == -1 && abfd != NULL)
+    vma_size = bfd_arch_bits_per_address (abfd);
+  if (vma_size != 32 && vma_size != 64)
+    vma_size = sizeof (address_word) * 8;
+  vma_size /= 8;
+
+  ok = fwrite (GMON_MAGIC, 4, 1, pf);
+  ok = ok && profile_gmon_write_32 (pf, GMON_VERSION);
+  ok = ok && fwrite (spare, sizeof (spare), 1, pf);
+
+  low_pc = PROFILE_PC_START (profile);
+  if (PROFILE_PC_END (profile) != 0)
+    high_pc = PROFILE_PC_END (profile);
+  else
+    high_pc = low_pc + (PROFILE_PC_BUCKET_SIZE (profile)
+			* (address_word) PROFILE_PC_NR_BUCKETS (profile));
+
+  /* Histogram bins are only 16 bits wide, but gprof adds up records
+     that cover the same range, so emit as many as it takes to carry
+     the largest count.  */
+  max_count = 0;
+  for (i = 0; i < PROFILE_PC_NR_BUCKETS (profile); i++)
+    if (PROFILE_PC_COUNT (profile) [i] > max_count)
+      max_count = PROFILE_PC_COUNT (profile) [i];
+
+  for (pass = 0; ok && (pass == 0 || pass * 0xffff < max_count); pass++)
+    {
+      char dimen[15];
+      unsigned char tag = GMON_TAG_TIME_HIST;
+
+      /* Count instructions when every one is counted, otherwise
+	 samples taken every PROFILE_PC_FREQ cycles.  */
+      memset (dimen, 0, sizeof (dimen));
+      strcpy (dimen, PROFILE_PC_EXACT (profile) ? "instructions" : "samples");
+
+      ok = fwrite (&tag, 1, 1, pf);
+      ok = ok && profile_gmon_write_vma (pf, vma_size, low_pc);
+      ok = ok && profile_gmon_write_vma (pf, vma_size, high_pc);
+      ok = ok && profile_gmon_write_32 (pf, PROFILE_PC_NR_BUCKETS (profile));
+      ok = ok && profile_gmon_write_32 (pf, 1);
+      ok = ok && fwrite (dimen, sizeof (dimen), 1, pf);
+      ok = ok && fwrite (dimen, 1, 1, pf);
+      for (i = 0; ok && i < PROFILE_PC_NR_BUCKETS (profile); i++)
+	{
+	  unsigned long count = PROFILE_PC_COUNT (profile) [i];
+	  unsigned16 sample;
+	  if (count <= pass * 0xffff)
+	    sample = 0;
+	  else if (count - pass * 0xffff >= 0xffff)
+	    sample = 0xffff;
+	  else
+	    sample = count - pass * 0xffff;
+	  H2T (sample);
+	  ok = fwrite (&sample, sizeof (sample), 1, pf);
+	}
+    }
+
+  if (PROFILE_PC_ARCS (profile) != NULL)
+    for (i = 0; ok && i < PROFILE_PC_ARCS_SIZE (profile); i++)
+      {
+	profile_pc_arc *arc;
+	for (arc = PROFILE_PC_ARCS (profile)[i];
+	     ok && arc != NULL;
+	     arc = arc->next)
+	  {
+	    unsigned char tag = GMON_TAG_CG_ARC;
+	    unsigned long count = arc->count;
+	    /* Counts are 32 bits too; split any that are larger.  */
+	    do
+	      {
+		unsigned32 chunk = (count > 0xffffffffUL
+				    ? 0xffffffffUL : count);
+		ok = fwrite (&tag, 1, 1, pf);
+		ok = ok && profile_gmon_write_vma (pf, vma_size, arc->from_pc);
+		ok = ok && profile_gmon_write_vma (pf, vma_size, arc->self_pc);
+		ok = ok && profile_gmon_write_32 (pf, chunk);
+		count -= chunk;
+	      }
+	    while (ok && count != 0);
+	  }
+      }
+
+  return ok;
+}
+
 static void
 profile_print_pc (sim_cpu *cpu, int verbose)
 {
@@ -644,8 +959,14 @@ profile_print_pc (sim_cpu *cpu, int verbose)
 		  COMMAS (PROFILE_PC_BUCKET_SIZE (profile)));
   profile_printf (sd, cpu, "  Size: %s buckets\n",
 		  COMMAS (PROFILE_PC_NR_BUCKETS (profile)));
-  profile_printf (sd, cpu, "  Frequency: %s cycles per sample\n",
-		  COMMAS (PROFILE_PC_FREQ (profile)));
+  if (PROFILE_PC_EXACT (profile))
+    profile_printf (sd, cpu, "  Frequency: every instruction\n");
+  else
+    profile_printf (sd, cpu, "  Frequency: %s cycles per sample\n",
+		    COMMAS (PROFILE_PC_FREQ (profile)));
+  if (PROFILE_PC_ARCS (profile) != NULL)
+    profile_printf (sd, cpu, "  Call arcs: %s\n",
+		    COMMAS (PROFILE_PC_NR_ARCS (profile)));
 
   if (PROFILE_PC_END (profile) != 0)
     profile_printf (sd, cpu, "  Range: 0x%lx 0x%lx\n",
@@ -682,7 +1003,8 @@ profile_print_pc (sim_cpu *cpu, int verbose)
     }
 
   /* dump the histogram to the file "gmon.out" using BSD's gprof file
-     format */
+     format, or gprof's own format when there is more than a sampled
+     histogram to record */
   /* Since a profile data file is in the native format of the host on
      which the profile is being, endian issues are not considered in
      the code below. */
@@ -692,6 +1014,12 @@ profile_print_pc (sim_cpu *cpu, int verbose)
 
     if (pf == NULL)
       sim_io_eprintf (sd, "Failed to open \"gmon.out\" profile file\n");
+    else if (PROFILE_PC_EXACT (profile) || PROFILE_PC_ARCS (profile) != NULL)
+      {
+	if (!profile_write_gmon (cpu, pf))
+	  sim_io_eprintf (sd, "Failed to write to \"gmon.out\" profile file\n");
+	fclose (pf);
+      }
     else
       {
 	int ok;
@@ -203,6 +203,22 @@ typedef struct {
 #define PROFILE_PC_COUNT(p) ((p)->profile_pc_count)
   sim_event *profile_pc_event;
 #define PROFILE_PC_EVENT(p) ((p)->profile_pc_event)
+  /* Rather than sampling, count every instruction the simulator
+     reports through PROFILE_PC_INSN.  */
+  int profile_pc_exact;
+#define PROFILE_PC_EXACT(p) ((p)->profile_pc_exact)
+  /* Record the call arcs the simulator reports through PROFILE_PC_CALL,
+     hashed on the caller and callee addresses.  */
+  int profile_pc_call_graph;
+#define PROFILE_PC_CALL_GRAPH(p) ((p)->profile_pc_call_graph)
+  struct _profile_pc_arc **profile_pc_arcs;
+#define PROFILE_PC_ARCS(p) ((p)->profile_pc_arcs)
+  unsigned profile_pc_arcs_size;
+#define PROFILE_PC_ARCS_SIZE(p) ((p)->profile_pc_arcs_size)
+  unsigned profile_pc_nr_arcs;
+#define PROFILE_PC_NR_ARCS(p) ((p)->profile_pc_nr_arcs)
+  struct _profile_pc_arc *profile_pc_last_arc;
+#define PROFILE_PC_LAST_ARC(p) ((p)->profile_pc_last_arc)
 #endif
 
   /* Profile output goes to this or stderr if NULL.
@@ -299,6 +315,34 @@ do { \
 #define PROFILE_BRANCH_UNTAKEN(cpu)
 #endif /* ! model */
 
+#if WITH_PROFILE_PC_P
+/* log2 of the default --profile-pc-exact bucket size; a simulator
+   should define this to match its smallest instruction.  */
+#ifndef PROFILE_PC_EXACT_SHIFT
+#define PROFILE_PC_EXACT_SHIFT 1
+#endif
+
+/* Exact PC profiling.  A simulator that supports it calls
+   PROFILE_PC_INSN with the address of every instruction it executes,
+   and PROFILE_PC_CALL with the address of every call instruction and
+   of its target.  Both feed the gmon.out file written for gprof.  */
+#define PROFILE_PC_INSN(cpu, pc) \
+do { \
+  if (PROFILE_PC_P (cpu) && PROFILE_PC_EXACT (CPU_PROFILE_DATA (cpu))) \
+    sim_profile_pc_insn (cpu, pc); \
+} while (0)
+#define PROFILE_PC_CALL(cpu, from_pc, self_pc) \
+do { \
+  if (PROFILE_PC_P (cpu) && PROFILE_PC_CALL_GRAPH (CPU_PROFILE_DATA (cpu))) \
+    sim_profile_pc_call (cpu, from_pc, self_pc); \
+} while (0)
+extern void sim_profile_pc_insn (sim_cpu *, address_word);
+extern void sim_profile_pc_call (sim_cpu *, address_word, address_word);
+#else
+#define PROFILE_PC_INSN(cpu, pc)
+#define PROFILE_PC_CALL(cpu, from_pc, self_pc)
+#endif /* ! pc */
+
 /* Misc. utilities.  */
 
 extern void sim_profile_print_bar (SIM_DESC, sim_cpu *, unsigned int, unsigned int, unsigned int);
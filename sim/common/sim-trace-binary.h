@@ -0,0 +1,60 @@
+/* Simulator binary trace file format.
+   Copyright (C) 2016 Free Software Foundation, Inc.
+
+This file is part of GDB, the GNU debugger.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* This file is shared by the trace writer in sim-trace.c and the
+   trace-decode tool, so it must not depend on sim-main.h.  */
+
+#ifndef SIM_TRACE_BINARY_H
+#define SIM_TRACE_BINARY_H
+
+/* A trace written by --trace-binary starts with the magic string
+   followed by a version byte.  The rest of the file is a sequence of
+   records, each a tag byte followed by its operands.  Numbers are
+   LEB128 encoded: ULEB for unsigned values and SLEB for signed ones.
+
+   TRACE_BINARY_INSN: the instruction immediately after the previous
+   one.  ULEB length, then that many bytes of the instruction as they
+   appear in target memory.
+
+   TRACE_BINARY_INSN_AT: an instruction anywhere else.  SLEB distance
+   from the address after the previous instruction, then the same as
+   TRACE_BINARY_INSN.
+
+   TRACE_BINARY_REG: a register write.  ULEB register number, then ULEB
+   value.
+
+   TRACE_BINARY_REG_NAME: the name of a register number.  This comes
+   before its first TRACE_BINARY_REG.  ULEB register number, ULEB
+   length, then the name.
+
+   TRACE_BINARY_CPU: the records that follow are for another cpu.  ULEB
+   cpu number.  Until the first one, records are for cpu 0.  */
+
+#define TRACE_BINARY_MAGIC "SIMTRACE"
+#define TRACE_BINARY_MAGIC_SIZE 8
+#define TRACE_BINARY_VERSION 1
+
+enum {
+  TRACE_BINARY_INSN = 1,
+  TRACE_BINARY_INSN_AT,
+  TRACE_BINARY_REG,
+  TRACE_BINARY_REG_NAME,
+  TRACE_BINARY_CPU
+};
+
+#endif /* SIM_TRACE_BINARY_H */
@@ -28,6 +28,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
 #include "dis-asm.h"
 
 #include "sim-assert.h"
+#include "sim-trace-binary.h"
 
 #ifdef HAVE_STRING_H
 #include <string.h>
@@ -39,6 +40,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
 #ifdef HAVE_STDLIB_H
 #include <stdlib.h>
 #endif
+#include <errno.h>
 
 #ifndef SIZE_PHASE
 #define SIZE_PHASE 8
@@ -81,7 +83,8 @@ enum {
   OPTION_TRACE_FILE,
   OPTION_TRACE_VPU,
   OPTION_TRACE_SYSCALL,
-  OPTION_TRACE_REGISTER
+  OPTION_TRACE_REGISTER,
+  OPTION_TRACE_BINARY
 };
 
 static const OPTION trace_options[] =
@@ -154,9 +157,218 @@ static const OPTION trace_options[] =
   { {"trace-file", required_argument, NULL, OPTION_TRACE_FILE},
       '\0', "FILE NAME", "Specify tracing output file",
       trace_option_handler, NULL },
+  { {"trace-binary", required_argument, NULL, OPTION_TRACE_BINARY},
+      '\0', "FILE NAME", "Write a compact binary instruction and register trace",
+      trace_option_handler, NULL },
   { {NULL, no_argument, NULL, 0}, '\0', NULL, NULL, NULL, NULL }
 };
 
+/* Binary trace writer.  Records are built up in a large buffer and
+   written out a buffer at a time; see sim-trace-binary.h for the
+   format.  */
+
+#define TRACE_BINARY_BUFSIZE (1 << 20)
+/* The most a single record other than a register name can take:
+   a tag, two LEB128 numbers and a 16 byte instruction.  */
+#define TRACE_BINARY_MAX_RECORD (1 + 10 + 10 + 16)
+/* Register numbers below this have their names sent only once.  */
+#define TRACE_BINARY_NAMED_REGS 8192
+
+struct trace_binary {
+  SIM_DESC sd;
+  FILE *file;
+  char *name;
+  /* Nonzero once a write has failed and tracing was turned off.  */
+  int failed;
+  unsigned8 *buf;
+  size_t len;
+  /* Address following the last instruction traced.  */
+  address_word next_pc;
+  /* CPU that the last record was for.  */
+  int cpu_nr;
+  /* Bitmap of the register numbers whose names have been sent.  */
+  unsigned8 named[TRACE_BINARY_NAMED_REGS / 8];
+};
+
+/* Report that writing the trace failed, and stop tracing to it.  The
+   writer stays attached to the simulator, so that it is still closed
+   by trace_uninstall.  */
+
+static void
+trace_binary_fail (struct trace_binary *tb)
+{
+  SIM_DESC sd = tb->sd;
+  int n;
+
+  sim_io_eprintf (sd, "Unable to write binary trace output file `%s': %s\n",
+		  tb->name, strerror (errno));
+  for (n = 0; n < MAX_NR_PROCESSORS; ++n)
+    TRACE_BINARY (CPU_TRACE_DATA (STATE_CPU (sd, n))) = NULL;
+  tb->failed = 1;
+}
+
+static void
+trace_binary_flush (struct trace_binary *tb)
+{
+  if (tb->len != 0 && !tb->failed
+      && fwrite (tb->buf, 1, tb->len, tb->file) != tb->len)
+    trace_binary_fail (tb);
+  tb->len = 0;
+}
+
+/* Make room for a record of up to SIZE bytes.  */
+
+static void
+trace_binary_reserve (struct trace_binary *tb, size_t size)
+{
+  if (tb->len + size > TRACE_BINARY_BUFSIZE)
+    trace_binary_flush (tb);
+}
+
+static void
+trace_binary_uleb (struct trace_binary *tb, unsigned64 val)
+{
+  do
+    {
+      unsigned8 byte = val & 0x7f;
+      val >>= 7;
+      if (val != 0)
+	byte |= 0x80;
+      tb->buf[tb->len++] = byte;
+    }
+  while (val != 0);
+}
+
+static void
+trace_binary_sleb (struct trace_binary *tb, signed64 val)
+{
+  int more;
+  do
+    {
+      unsigned8 byte = val & 0x7f;
+      val >>= 7;
+      more = !((val == 0 && (byte & 0x40) == 0)
+	       || (val == -1 && (byte & 0x40) != 0));
+      if (more)
+	byte |= 0x80;
+      tb->buf[tb->len++] = byte;
+    }
+  while (more);
+}
+
+static struct trace_binary *
+trace_binary_open (SIM_DESC sd, const char *name)
+{
+  struct trace_binary *tb;
+  FILE *f = fopen (name, "wb");
+
+  if (f == NULL)
+    {
+      sim_io_eprintf (sd, "Unable to open binary trace output file `%s'\n",
+		      name);
+      return NULL;
+    }
+
+  tb = ZALLOC (struct trace_binary);
+  tb->sd = sd;
+  tb->file = f;
+  tb->name = xstrdup (name);
+  tb->buf = xmalloc (TRACE_BINARY_BUFSIZE);
+  memcpy (tb->buf, TRACE_BINARY_MAGIC, TRACE_BINARY_MAGIC_SIZE);
+  tb->buf[TRACE_BINARY_MAGIC_SIZE] = TRACE_BINARY_VERSION;
+  tb->len = TRACE_BINARY_MAGIC_SIZE + 1;
+  return tb;
+}
+
+static void
+trace_binary_close (struct trace_binary *tb)
+{
+  trace_binary_flush (tb);
+  if (fclose (tb->file) != 0 && !tb->failed)
+    trace_binary_fail (tb);
+  free (tb->name);
+  free (tb->buf);
+  free (tb);
+}
+
+/* Note that the following records are for CPU.  */
+
+static void
+trace_binary_set_cpu (struct trace_binary *tb, sim_cpu *cpu)
+{
+  SIM_DESC sd = CPU_STATE (cpu);
+  int cpu_nr;
+
+  if (MAX_NR_PROCESSORS == 1)
+    return;
+  for (cpu_nr = 0; cpu_nr < MAX_NR_PROCESSORS; cpu_nr++)
+    if (STATE_CPU (sd, cpu_nr) == cpu)
+      break;
+  if (cpu_nr != tb->cpu_nr)
+    {
+      trace_binary_reserve (tb, TRACE_BINARY_MAX_RECORD);
+      tb->buf[tb->len++] = TRACE_BINARY_CPU;
+      trace_binary_uleb (tb, cpu_nr);
+      tb->cpu_nr = cpu_nr;
+    }
+}
+
+/* Record that CPU executed the LEN byte instruction INSN at PC.  */
+
+void
+trace_binary_insn (sim_cpu *cpu, address_word pc, const unsigned8 *insn,
+		   int len)
+{
+  SIM_DESC sd = CPU_STATE (cpu);
+  struct trace_binary *tb = TRACE_BINARY (CPU_TRACE_DATA (cpu));
+
+  SIM_ASSERT (len > 0 && len <= 16);
+  trace_binary_set_cpu (tb, cpu);
+  trace_binary_reserve (tb, TRACE_BINARY_MAX_RECORD);
+  if (pc == tb->next_pc)
+    tb->buf[tb->len++] = TRACE_BINARY_INSN;
+  else
+    {
+      tb->buf[tb->len++] = TRACE_BINARY_INSN_AT;
+      /* Sign-extend from the width of an address, so that a backward
+	 branch gives a negative delta when addresses are 32 bits.  */
+      trace_binary_sleb (tb, (signed_address) (pc - tb->next_pc));
+    }
+  trace_binary_uleb (tb, len);
+  memcpy (tb->buf + tb->len, insn, len);
+  tb->len += len;
+  tb->next_pc = pc + len;
+}
+
+/* Record that CPU wrote VAL to register REGNO, called NAME.  */
+
+void
+trace_binary_reg (sim_cpu *cpu, int regno, const char *name, unsigned64 val)
+{
+  struct trace_binary *tb = TRACE_BINARY (CPU_TRACE_DATA (cpu));
+
+  trace_binary_set_cpu (tb, cpu);
+  if (regno >= TRACE_BINARY_NAMED_REGS
+      || (tb->named[regno / 8] & (1 << (regno % 8))) == 0)
+    {
+      size_t name_len = strlen (name);
+
+      trace_binary_reserve (tb, TRACE_BINARY_MAX_RECORD + name_len);
+      tb->buf[tb->len++] = TRACE_BINARY_REG_NAME;
+      trace_binary_uleb (tb, regno);
+      trace_binary_uleb (tb, name_len);
+      memcpy (tb->buf + tb->len, name, name_len);
+      tb->len += name_len;
+      if (regno < TRACE_BINARY_NAMED_REGS)
+	tb->named[regno / 8] |= 1 << (regno % 8);
+    }
+
+  trace_binary_reserve (tb, TRACE_BINARY_MAX_RECORD);
+  tb->buf[tb->len++] = TRACE_BINARY_REG;
+  trace_binary_uleb (tb, regno);
+  trace_binary_uleb (tb, val);
+}
+
 /* Set/reset the trace options indicated in MASK.  */
 
 static SIM_RC
@@ -435,6 +647,23 @@ trace_option_handler (SIM_DESC sd, sim_cpu *cpu, int opt,
 	  TRACE_FILE (STATE_TRACE_DATA (sd)) = f;
 	}
       break;
+
+    case OPTION_TRACE_BINARY :
+      if (!WITH_TRACE_ANY_P)
+	sim_io_eprintf (sd, "Tracing not compiled in, `--trace-binary' ignored\n");
+      else
+	{
+	  struct trace_binary *tb = trace_binary_open (sd, arg);
+
+	  if (tb == NULL)
+	    return SIM_RC_FAIL;
+	  if (TRACE_BINARY (STATE_TRACE_DATA (sd)) != NULL)
+	    trace_binary_close (TRACE_BINARY (STATE_TRACE_DATA (sd)));
+	  for (n = 0; n < MAX_NR_PROCESSORS; ++n)
+	    TRACE_BINARY (CPU_TRACE_DATA (STATE_CPU (sd, n))) = tb;
+	  TRACE_BINARY (STATE_TRACE_DATA (sd)) = tb;
+	}
+      break;
     }
 
   return SIM_RC_OK;
@@ -496,6 +725,13 @@ trace_uninstall (SIM_DESC sd)
   if (sfile != NULL)
     fclose (sfile);
 
+  /* The binary trace writer is shared by every cpu.  */
+  if (TRACE_BINARY (STATE_TRACE_DATA (sd)) != NULL)
+    trace_binary_close (TRACE_BINARY (STATE_TRACE_DATA (sd)));
+  TRACE_BINARY (STATE_TRACE_DATA (sd)) = NULL;
+  for (i = 0; i < MAX_NR_PROCESSORS; ++i)
+    TRACE_BINARY (CPU_TRACE_DATA (STATE_CPU (sd, i))) = NULL;
+
   for (i = 0; i < MAX_NR_PROCESSORS; ++i)
     {
       FILE *cfile = TRACE_FILE (CPU_TRACE_DATA (STATE_CPU (sd, i)));
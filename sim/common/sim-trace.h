@@ -172,6 +172,11 @@ typedef struct _trace_data {
   FILE *trace_file;
 #define TRACE_FILE(t) ((t)->trace_file)
 
+  /* Binary trace writer (--trace-binary), shared by the system and all
+     cpus, or NULL when not tracing in binary.  */
+  struct trace_binary *trace_binary;
+#define TRACE_BINARY(t) ((t)->trace_binary)
+
   /* Buffer to store the prefix to be printed before any trace line.  */
   char trace_prefix[256];
 #define TRACE_PREFIX(t) ((t)->trace_prefix)
@@ -321,6 +326,28 @@ typedef struct _trace_data {
       trace_disasm (CPU_STATE (cpu), cpu, addr); \
   } while (0)
 
+/* Binary tracing.  Rather than formatting text, a simulator reports
+   each instruction it executes and each register it writes; the
+   trace-decode tool renders the file afterwards.  NAME is only sent
+   the first time REGNO is written.  */
+#define TRACE_BINARY_P(cpu) \
+  (WITH_TRACE_ANY_P && TRACE_BINARY (CPU_TRACE_DATA (cpu)) != NULL)
+#define TRACE_BINARY_INSN(cpu, pc, insn, len) \
+  do { \
+    if (TRACE_BINARY_P (cpu)) \
+      trace_binary_insn (cpu, pc, insn, len); \
+  } while (0)
+#define TRACE_BINARY_REG(cpu, regno, name, val) \
+  do { \
+    if (TRACE_BINARY_P (cpu)) \
+      trace_binary_reg (cpu, regno, name, val); \
+  } while (0)
+
+extern void trace_binary_insn (sim_cpu *cpu, address_word pc,
+			       const unsigned8 *insn, int len);
+extern void trace_binary_reg (sim_cpu *cpu, int regno, const char *name,
+			      unsigned64 val);
+
 /* Tracing functions.  */
 
 /* Prime the trace buffers ready for any trace output.
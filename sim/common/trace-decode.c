@@ -0,0 +1,320 @@
+/* Render a simulator binary trace as text.
+   Copyright (C) 2016 Free Software Foundation, Inc.
+
+This file is part of GDB, the GNU debugger.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* Usage: trace-decode [--raw] PROGRAM TRACE-FILE
+
+   Reads a trace written by the simulator's --trace-binary option and
+   prints one line per instruction, followed by the registers it
+   wrote.  PROGRAM is the executable that was simulated; its
+   architecture selects the disassembler and its symbols label the
+   functions the trace passes through.  --raw prints the instruction
+   bytes instead of disassembling them.  */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ansidecl.h"
+#include "bfd.h"
+#include "dis-asm.h"
+#include "libiberty.h"
+
+#include "sim-trace-binary.h"
+
+static const char *trace_name;
+static FILE *trace_file;
+
+/* Register names announced by the trace, indexed by number.  */
+static char **reg_names;
+static unsigned long nr_reg_names;
+
+/* Function symbols of the program, sorted by address.  */
+static asymbol **funcs;
+static long nr_funcs;
+
+static void
+fatal (const char *msg)
+{
+  fprintf (stderr, "trace-decode: %s: %s\n", trace_name, msg);
+  exit (1);
+}
+
+static int
+read_byte (void)
+{
+  int c = getc (trace_file);
+  if (c == EOF)
+    fatal ("truncated record");
+  return c;
+}
+
+static bfd_vma
+read_uleb (void)
+{
+  bfd_vma val = 0;
+  unsigned shift = 0;
+  int byte;
+
+  do
+    {
+      byte = read_byte ();
+      if (shift < sizeof (val) * 8)
+	val |= (bfd_vma) (byte & 0x7f) << shift;
+      shift += 7;
+    }
+  while (byte & 0x80);
+  return val;
+}
+
+static bfd_signed_vma
+read_sleb (void)
+{
+  bfd_vma val = 0;
+  unsigned shift = 0;
+  int byte;
+
+  do
+    {
+      byte = read_byte ();
+      if (shift < sizeof (val) * 8)
+	val |= (bfd_vma) (byte & 0x7f) << shift;
+      shift += 7;
+    }
+  while (byte & 0x80);
+  if (shift < sizeof (val) * 8 && (byte & 0x40) != 0)
+    val |= -((bfd_vma) 1 << shift);
+  return val;
+}
+
+static int
+compare_symbol_values (const void *a, const void *b)
+{
+  bfd_vma va = bfd_asymbol_value (*(const asymbol **) a);
+  bfd_vma vb = bfd_asymbol_value (*(const asymbol **) b);
+
+  if (va < vb)
+    return -1;
+  return va > vb;
+}
+
+/* Collect the function symbols of ABFD into FUNCS.  */
+
+static void
+load_functions (bfd *abfd)
+{
+  long size, count, i;
+  asymbol **syms;
+
+  size = bfd_get_symtab_upper_bound (abfd);
+  if (size <= 0)
+    return;
+  syms = (asymbol **) xmalloc (size);
+  count = bfd_canonicalize_symtab (abfd, syms);
+
+  funcs = XNEWVEC (asymbol *, count > 0 ? count : 1);
+  for (i = 0; i < count; i++)
+    if (syms[i]->flags & BSF_FUNCTION)
+      funcs[nr_funcs++] = syms[i];
+  qsort (funcs, nr_funcs, sizeof (funcs[0]), compare_symbol_values);
+}
+
+/* Return the function containing PC, or NULL.  */
+
+static asymbol *
+find_function (bfd_vma pc)
+{
+  long lo = 0, hi = nr_funcs;
+
+  /* Find the last function starting at or before PC.  */
+  while (lo < hi)
+    {
+      long mid = lo + (hi - lo) / 2;
+      if (bfd_asymbol_value (funcs[mid]) <= pc)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+  return lo > 0 ? funcs[lo - 1] : NULL;
+}
+
+static const char *
+reg_name (unsigned long regno)
+{
+  static char buf[32];
+
+  if (regno < nr_reg_names && reg_names[regno] != NULL)
+    return reg_names[regno];
+  sprintf (buf, "r%lu", regno);
+  return buf;
+}
+
+static void
+set_reg_name (unsigned long regno, char *name)
+{
+  if (regno >= nr_reg_names)
+    {
+      unsigned long n = regno + 1 > nr_reg_names * 2 ? regno + 1
+						     : nr_reg_names * 2;
+      reg_names = XRESIZEVEC (char *, reg_names, n);
+      memset (reg_names + nr_reg_names, 0,
+	      (n - nr_reg_names) * sizeof (reg_names[0]));
+      nr_reg_names = n;
+    }
+  free (reg_names[regno]);
+  reg_names[regno] = name;
+}
+
+int
+main (int argc, char **argv)
+{
+  const char *prog_name;
+  char magic[TRACE_BINARY_MAGIC_SIZE];
+  int raw = 0;
+  bfd *abfd;
+  disassembler_ftype disasm = NULL;
+  struct disassemble_info info;
+  bfd_byte insn[16];
+  bfd_vma next_pc = 0;
+  bfd_vma addr_mask = ~(bfd_vma) 0;
+  asymbol *last_func = NULL;
+  int c;
+
+  if (argc > 1 && strcmp (argv[1], "--raw") == 0)
+    {
+      raw = 1;
+      argc--;
+      argv++;
+    }
+  if (argc != 3)
+    {
+      fprintf (stderr, "Usage: trace-decode [--raw] PROGRAM TRACE-FILE\n");
+      return 2;
+    }
+  prog_name = argv[1];
+  trace_name = argv[2];
+
+  bfd_init ();
+  abfd = bfd_openr (prog_name, NULL);
+  if (abfd == NULL || !bfd_check_format (abfd, bfd_object))
+    {
+      fprintf (stderr, "trace-decode: %s: %s\n", prog_name,
+	       bfd_errmsg (bfd_get_error ()));
+      return 1;
+    }
+  load_functions (abfd);
+  if (bfd_arch_bits_per_address (abfd) < sizeof (bfd_vma) * 8)
+    addr_mask = ((bfd_vma) 1 << bfd_arch_bits_per_address (abfd)) - 1;
+
+  if (!raw)
+    disasm = disassembler (abfd);
+  if (disasm != NULL)
+    {
+      init_disassemble_info (&info, stdout, (fprintf_ftype) fprintf);
+      info.arch = bfd_get_arch (abfd);
+      info.mach = bfd_get_mach (abfd);
+      info.endian = (bfd_big_endian (abfd)
+		     ? BFD_ENDIAN_BIG : BFD_ENDIAN_LITTLE);
+      info.buffer = insn;
+      disassemble_init_for_target (&info);
+    }
+
+  trace_file = fopen (trace_name, "rb");
+  if (trace_file == NULL)
+    fatal ("cannot open");
+  if (fread (magic, sizeof (magic), 1, trace_file) != 1
+      || memcmp (magic, TRACE_BINARY_MAGIC, sizeof (magic)) != 0)
+    fatal ("not a simulator binary trace");
+  if (read_byte () != TRACE_BINARY_VERSION)
+    fatal ("unsupported trace version");
+
+  while ((c = getc (trace_file)) != EOF)
+    {
+      switch (c)
+	{
+	case TRACE_BINARY_INSN:
+	case TRACE_BINARY_INSN_AT:
+	  {
+	    bfd_vma pc = next_pc;
+	    unsigned long len, i;
+	    asymbol *func;
+
+	    /* The deltas wrap around at the width of an address.  */
+	    if (c == TRACE_BINARY_INSN_AT)
+	      pc = (pc + read_sleb ()) & addr_mask;
+	    len = read_uleb ();
+	    if (len == 0 || len > sizeof (insn))
+	      fatal ("bad instruction length");
+	    for (i = 0; i < len; i++)
+	      insn[i] = read_byte ();
+	    next_pc = pc + len;
+
+	    func = find_function (pc);
+	    if (func != last_func && func != NULL)
+	      printf ("%s:\n", bfd_asymbol_name (func));
+	    last_func = func;
+
+	    printf ("  0x%08lx: ", (unsigned long) pc);
+	    if (disasm != NULL)
+	      {
+		info.buffer_vma = pc;
+		info.buffer_length = len;
+		disasm (pc, &info);
+	      }
+	    else
+	      for (i = 0; i < len; i++)
+		printf ("%02x", insn[i]);
+	    printf ("\n");
+	  }
+	  break;
+
+	case TRACE_BINARY_REG:
+	  {
+	    unsigned long regno = read_uleb ();
+	    bfd_vma val = read_uleb ();
+	    printf ("      %s = 0x%lx\n", reg_name (regno), (unsigned long) val);
+	  }
+	  break;
+
+	case TRACE_BINARY_REG_NAME:
+	  {
+	    unsigned long regno = read_uleb ();
+	    unsigned long len = read_uleb ();
+	    char *name = (char *) xmalloc (len + 1);
+	    if (len != 0 && fread (name, len, 1, trace_file) != 1)
+	      fatal ("truncated record");
+	    name[len] = '\0';
+	    set_reg_name (regno, name);
+	  }
+	  break;
+
+	case TRACE_BINARY_CPU:
+	  printf ("cpu %lu:\n", (unsigned long) read_uleb ());
+	  last_func = NULL;
+	  break;
+
+	default:
+	  fatal ("unknown record");
+	}
+    }
+
+  fclose (trace_file);
+  bfd_close (abfd);
+  return 0;
+}
@@ -465,6 +465,35 @@ sim_complete_command (SIM_DESC sd, const char *text, const char *word)
   return NULL;
 }
 
+/* This simulator has no breakpoints of its own and does not step
+   ranges; the debugger uses memory breakpoints and single steps.  */
+
+int
+sim_resume_range (SIM_DESC sd, SIM_ADDR start, SIM_ADDR end, int siggnal)
+{
+  return 0;
+}
+
+int
+sim_breakpoints_supported (SIM_DESC sd)
+{
+  return 0;
+}
+
+int
+sim_insert_breakpoint (SIM_DESC sd, SIM_ADDR addr, int nr_conditions,
+		       const unsigned char * const *conditions,
+		       const int *lengths)
+{
+  return 0;
+}
+
+int
+sim_remove_breakpoint (SIM_DESC sd, SIM_ADDR addr)
+{
+  return 0;
+}
+
 #if 0 /* FIXME: These shouldn't exist.  */
 
 int
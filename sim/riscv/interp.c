@@ -49,6 +49,8 @@ sim_engine_run (SIM_DESC sd,
 
   while (1)
     {
+      if (SIM_BREAK_ACTIVE (sd))
+	sim_break_check (sd, cpu, cpu->pc);
       step_once (cpu);
       if (sim_events_tick (sd))
 	sim_events_process (sd);
@@ -86,6 +88,13 @@ sim_open (SIM_OPEN_KIND kind, host_callback *callback,
       return 0;
     }
 
+  /* Let PC watchpoints and --checkpoint-at-pc find the PC.  */
+  {
+    SIM_CPU *cpu = STATE_CPU (sd, 0);
+    STATE_WATCHPOINTS (sd)->pc = &cpu->pc;
+    STATE_WATCHPOINTS (sd)->sizeof_pc = sizeof (cpu->pc);
+  }
+
   if (sim_pre_argv_init (sd, argv[0]) != SIM_RC_OK)
     {
       free_state (sd);
@@ -136,6 +145,9 @@ sim_open (SIM_OPEN_KIND kind, host_callback *callback,
       initialize_cpu (sd, cpu, i);
     }
 
+  /* The engine checks breakpoints and stepped ranges for the debugger.  */
+  SIM_BREAK_SUPPORTED (sd) = 1;
+
   /* Allocate external memory if none specified by user.
      Use address 4 here in case the user wanted address 0 unmapped.  */
   if (sim_core_read_buffer (sd, NULL, read_map, &c, 4, 1) == 0)
@@ -37,6 +37,10 @@
 
 
 #define TRACE_REG(cpu, reg) TRACE_REGISTER (cpu, "wrote %s = %#"PRIxTW, riscv_gpr_names_abi[reg], cpu->regs[reg])
+
+/* Register numbers in binary traces: the GPRs are 0-31 and the CSRs
+   follow, numbered by CSR address.  */
+#define BINARY_TRACE_CSR_REGNO(csr) (32 + (csr))
 
 static const struct riscv_opcode *riscv_hash[OP_MASK_OP + 1];
 #define OP_HASH_IDX(i) ((i) & (riscv_insn_length (i) == 2 ? 0x3 : 0x7f))
@@ -68,6 +72,7 @@ store_rd (SIM_CPU *cpu, int rd, unsigned_word val)
     {
       cpu->regs[rd] = val;
       TRACE_REG (cpu, rd);
+      TRACE_BINARY_REG (cpu, rd, riscv_gpr_names_abi[rd], val);
     }
 }
 
@@ -125,6 +130,7 @@ store_csr (SIM_CPU *cpu, const char *name, int csr, unsigned_word *reg,
     }
 
   TRACE_REGISTER (cpu, "wrote CSR %s = %#"PRIxTW, name, val);
+  TRACE_BINARY_REG (cpu, BINARY_TRACE_CSR_REGNO (csr), name, val);
 }
 
 static inline unsigned_word
@@ -141,6 +147,16 @@ ashiftrt64 (unsigned_word val, unsigned_word shift)
   return (val >> shift) | sign;
 }
 
+/* The calling convention links calls through ra, or t0 for the
+   alternate link register; a jump that writes anything else is not a
+   call.  */
+
+static int
+is_call_link (int rd)
+{
+  return rd == SIM_RISCV_RA_REGNUM || rd == SIM_RISCV_T0_REGNUM;
+}
+
 static sim_cia
 execute_i (SIM_CPU *cpu, unsigned_word iw, const struct riscv_opcode *op)
 {
@@ -399,12 +415,17 @@ execute_i (SIM_CPU *cpu, unsigned_word iw, const struct riscv_opcode *op)
       store_rd (cpu, rd, cpu->pc + 4);
       pc = cpu->pc + EXTRACT_UJTYPE_IMM (iw);
       TRACE_BRANCH (cpu, "to %#"PRIxTW, pc);
+      if (is_call_link (rd))
+	PROFILE_PC_CALL (cpu, cpu->pc, pc);
       break;
     case MATCH_JALR:
       TRACE_INSN (cpu, "jalr %s, %s, %"PRIiTW";", rd_name, rs1_name, i_imm);
+      tmp = cpu->regs[rs1];
       store_rd (cpu, rd, cpu->pc + 4);
-      pc = cpu->regs[rs1] + i_imm;
+      pc = (tmp + i_imm) & ~(unsigned_word) 1;
       TRACE_BRANCH (cpu, "to %#"PRIxTW, pc);
+      if (is_call_link (rd))
+	PROFILE_PC_CALL (cpu, cpu->pc, pc);
       break;
 
     case MATCH_LD:
@@ -949,6 +970,8 @@ void step_once (SIM_CPU *cpu)
     trace_prefix (sd, cpu, NULL_CIA, pc, TRACE_LINENUM_P (cpu),
 		  NULL, 0, " "); /* Use a space for gcc warnings.  */
 
+  PROFILE_PC_INSN (cpu, pc);
+
   iw = sim_core_read_aligned_2 (cpu, pc, exec_map, pc);
 
   /* Reject non-32-bit opcodes first.  */
@@ -964,6 +987,16 @@ void step_once (SIM_CPU *cpu)
 
   TRACE_CORE (cpu, "0x%08"PRIxTW, iw);
 
+  if (TRACE_BINARY_P (cpu))
+    {
+      unsigned8 bytes[4];
+      bytes[0] = iw;
+      bytes[1] = iw >> 8;
+      bytes[2] = iw >> 16;
+      bytes[3] = iw >> 24;
+      trace_binary_insn (cpu, pc, bytes, sizeof (bytes));
+    }
+
   op = riscv_hash[OP_HASH_IDX (iw)];
   if (!op)
     sim_engine_halt (sd, cpu, NULL, pc, sim_signalled, SIM_SIGILL);
@@ -1057,6 +1090,63 @@ reg_store (sim_cpu *cpu, int rn, unsigned char *buf, int len)
     }
 }
 
+/* A checkpoint holds the XLEN, the PC, the GPRs, the FPRs and the CSRs.
+   Memory reservations for LR/SC are not saved; an SC is always allowed
+   to fail, so a restored program just retries it.  */
+
+#define NR_CSRS (sizeof (((sim_cpu *) 0)->csr) / sizeof (unsigned_word))
+
+static void
+checkpoint_save (sim_cpu *cpu, sim_checkpoint_file *f)
+{
+  int i;
+
+  sim_checkpoint_write_word (f, RISCV_XLEN (cpu));
+  sim_checkpoint_write_word (f, cpu->pc);
+  for (i = 0; i < 32; ++i)
+    sim_checkpoint_write_word (f, cpu->regs[i]);
+  for (i = 0; i < 32; ++i)
+    sim_checkpoint_write_word (f, cpu->fpregs[i]);
+  sim_checkpoint_write_word (f, NR_CSRS);
+#define DECLARE_CSR(name, num) sim_checkpoint_write_word (f, cpu->csr.name);
+#include "opcode/riscv-opc.h"
+#undef DECLARE_CSR
+}
+
+static void
+checkpoint_restore (sim_cpu *cpu, sim_checkpoint_file *f)
+{
+  SIM_DESC sd = CPU_STATE (cpu);
+  int i;
+
+  if (sim_checkpoint_read_word (f) != RISCV_XLEN (cpu))
+    {
+      sim_checkpoint_mismatch (f, "checkpoint was saved with another XLEN");
+      return;
+    }
+  cpu->pc = sim_checkpoint_read_word (f);
+  for (i = 0; i < 32; ++i)
+    cpu->regs[i] = sim_checkpoint_read_word (f);
+  for (i = 0; i < 32; ++i)
+    cpu->fpregs[i] = sim_checkpoint_read_word (f);
+  if (sim_checkpoint_read_word (f) != NR_CSRS)
+    {
+      sim_checkpoint_mismatch (f, "checkpoint has a different set of CSRs");
+      return;
+    }
+#define DECLARE_CSR(name, num) cpu->csr.name = sim_checkpoint_read_word (f);
+#include "opcode/riscv-opc.h"
+#undef DECLARE_CSR
+
+  while (sd->amo_reserved_list != NULL)
+    {
+      struct atomic_mem_reserved_list *next = sd->amo_reserved_list->next;
+
+      free (sd->amo_reserved_list);
+      sd->amo_reserved_list = next;
+    }
+}
+
 /* Initialize the state for a single cpu.  Usuaully this involves clearing all
    registers back to their reset state.  Should also hook up the fetch/store
    helper functions too.  */
@@ -1071,6 +1161,8 @@ void initialize_cpu (SIM_DESC sd, SIM_CPU *cpu, int mhartid)
   CPU_PC_STORE (cpu) = pc_set;
   CPU_REG_FETCH (cpu) = reg_fetch;
   CPU_REG_STORE (cpu) = reg_store;
+  CPU_CHECKPOINT_SAVE (cpu) = checkpoint_save;
+  CPU_CHECKPOINT_RESTORE (cpu) = checkpoint_restore;
 
   if (!riscv_hash[0])
     {
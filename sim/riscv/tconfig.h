@@ -2,3 +2,7 @@
 
 /* ??? Temporary hack until model support unified.  */
 #define SIM_HAVE_MODEL
+
+/* Every instruction is four bytes, so exact PC profiling needs no
+   finer buckets than that.  */
+#define PROFILE_PC_EXACT_SHIFT 2
@@ -0,0 +1,49 @@
+# check that a program runs on past the point where checkpoint.exp
+# saves a checkpoint, and that restoring the checkpoint in a later run
+# brings back the registers and memory without repeating the setup.
+# mach: riscv
+# output: setup\npass\n
+
+.include "testutils.inc"
+
+	start
+
+	# syscall write().
+	li	a7, 64
+	li	a0, 1
+	lla	a1, setup
+	li	a2, 6
+	ecall
+
+	li	s1, 0x12345678
+	li	s2, -2
+	lla	t0, data
+	li	t1, 0x5a5a
+	sw	t1, 0(t0)
+	j	saved
+
+	# checkpoint.exp links the program at 0x10000 and saves the
+	# checkpoint when the PC reaches 0x10100.
+	.org	0x100
+saved:
+	li	t1, 0x12345678
+	bne	s1, t1, 9f
+	li	t1, -2
+	bne	s2, t1, 9f
+	lla	t0, data
+	lw	t2, 0(t0)
+	li	t1, 0x5a5a
+	bne	t2, t1, 9f
+
+	# Run on, changing the state that was saved.
+	li	s1, 0
+	sw	zero, 0(t0)
+	pass
+
+9:	fail
+
+	.data
+setup:
+	.ascii	"setup\n"
+data:
+	.word	0
@@ -0,0 +1,47 @@
+# check loads and stores across several memory regions, including a
+# region that ends part way through a page and a mirrored region.
+# mach: riscv
+# sim: --memory-region 0x20000000,0x10000 --memory-region 0x20010000,0x800 --memory-region 0x20020000,0x10000,0x1000
+
+.include "testutils.inc"
+
+	start
+
+	# Store a word every 64 bytes of the first region, then
+	# read them all back.
+	li	t0, 0x20000000
+	li	t1, 1024
+	mv	t2, t0
+1:	sw	t1, 0(t2)
+	addi	t2, t2, 64
+	addi	t1, t1, -1
+	bnez	t1, 1b
+
+	li	t1, 1024
+	mv	t2, t0
+2:	lw	t3, 0(t2)
+	bne	t3, t1, 9f
+	addi	t2, t2, 64
+	addi	t1, t1, -1
+	bnez	t1, 2b
+
+	# The last word of the short region.
+	li	t0, 0x200107fc
+	li	t1, 0x1234
+	sw	t1, 0(t0)
+	lw	t3, 0(t0)
+	bne	t3, t1, 9f
+
+	# A store to the mirrored region must be visible every 4K.
+	li	t0, 0x20020008
+	li	t1, 0x5678
+	sw	t1, 0(t0)
+	li	t0, 0x2002f008
+	lw	t3, 0(t0)
+	bne	t3, t1, 9f
+	lhu	t3, 0(t0)
+	bne	t3, t1, 9f
+
+	pass
+
+9:	fail
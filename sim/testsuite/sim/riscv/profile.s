@@ -0,0 +1,28 @@
+# check that the call graph profile.exp writes counts every call of
+# callee, and that jumps which do not link are not taken for calls.
+# mach: riscv
+
+.include "testutils.inc"
+
+	start
+
+	li	s1, 5
+	li	s2, 0
+1:	jal	ra, callee
+	addi	s1, s1, -1
+	bnez	s1, 1b
+
+	# A jump that does not link is not a call.
+	j	2f
+2:	li	t1, 5
+	bne	s2, t1, 9f
+	pass
+
+9:	fail
+
+	# profile.exp links the program at 0x10000 and looks for the arcs
+	# to 0x10100.
+	.org	0x100
+callee:
+	addi	s2, s2, 1
+	ret
@@ -0,0 +1,13 @@
+# check that a loop runs; trace-binary.exp also decodes its trace.
+# mach: riscv
+
+.include "testutils.inc"
+
+	start
+
+	# Take the backward branch twice.
+	li	t1, 3
+1:	addi	t1, t1, -1
+	bnez	t1, 1b
+
+	pass